@@ -0,0 +1,70 @@
+//Titan Engine, by Atlas X Games
+// AllocationTracker.h - header for the hook that counts heap allocations each frame by where they were made
+#pragma once
+
+//precompile header, this file uses vector, array, and atomic
+#include "ttn_pch.h"
+
+namespace Titan {
+	//the allocations made in one place during a frame
+	struct TTN_AllocationSite {
+		//the innermost profiler scope the allocations were made in
+		const char* Name = nullptr;
+		size_t Count = 0;
+		size_t Bytes = 0;
+	};
+
+	//static class that counts every heap allocation, putting each one under the innermost TTN_PROFILE_SCOPE it was made in
+	//it's only compiled in when TTN_TRACK_ALLOCATIONS is defined, as it replaces the global operator new, otherwise it reports nothing
+	class TTN_AllocationTracker {
+	public:
+		//gets wheter or not tracking was compiled in
+		static bool GetAvailable();
+
+		//sets wheter or not allocations are counted
+		static void SetEnabled(bool enabled) { s_enabled.store(enabled, std::memory_order_relaxed); }
+		//gets wheter or not allocations are counted
+		static bool GetEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+		//ends the frame, collecting what each site allocated and starting the counts over, call once a frame on the main thread
+		static void EndFrame();
+
+		//gets what each site allocated last frame, most allocations first
+		static const std::vector<TTN_AllocationSite>& GetLastFrame() { return s_lastFrame; }
+		//gets the total allocations and bytes last frame
+		static size_t GetLastFrameCount() { return s_lastFrameCount; }
+		static size_t GetLastFrameBytes() { return s_lastFrameBytes; }
+
+		//draws a window listing last frame's allocations by site
+		static void DrawImGui(bool* open = nullptr);
+
+		//counts an allocation on the calling thread, used by the replaced operator new
+		static void Record(size_t bytes);
+
+	private:
+		//most sites that can be told apart, anything past that gets counted together
+		static const size_t s_siteCount = 1024;
+
+		//a site's counts for the frame, filled in from any thread without locking
+		//they're only ever static, so they start zeroed without initializers, which also means they're ready before any allocation can happen
+		struct TTN_SiteCounter {
+			std::atomic<const char*> Name;
+			std::atomic<size_t> Count;
+			std::atomic<size_t> Bytes;
+		};
+
+		//open addressed table of sites, keyed on the scope name's pointer
+		inline static std::array<TTN_SiteCounter, s_siteCount> s_sites;
+		//allocations that didn't fit in the table
+		inline static TTN_SiteCounter s_overflow;
+
+		inline static std::atomic<bool> s_enabled = true;
+		//set while the tracker's own code is running, so it doesn't count itself
+		inline static thread_local bool t_inside = false;
+
+		//last frame's counts
+		inline static std::vector<TTN_AllocationSite> s_lastFrame;
+		inline static size_t s_lastFrameCount = 0;
+		inline static size_t s_lastFrameBytes = 0;
+	};
+}
@@ -17,6 +17,17 @@
 #include "Titan/AssetSystem.h"
 //include the backend 
 #include "Titan/Backend.h"
+//include the profiler
+#include "Titan/Profiler.h"
+//include the random number generator
+#include "Titan/Random.h"
+//include the input recorder
+#include "Titan/InputRecorder.h"
+//include the lock-free queue the input events go through
+#include "Titan/SPSCQueue.h"
+//include the per frame allocator and the allocation tracker
+#include "Titan/FrameArena.h"
+#include "Titan/AllocationTracker.h"
  
  
 namespace Titan {
@@ -162,6 +173,17 @@ namespace Titan {
 		//function to initilize the window
 		static void Init(const std::string name, int width, int height, bool fullScreen = false);
 
+		//function to initilize without a window or opengl context, only the simulation side of the scenes (their updates) will run
+		//every frame steps by the fixed delta time, and the random number generator is seeded so runs can be repeated exactly
+		static void InitHeadless(float fixedDeltaTime = 1.0f / 60.0f, uint32_t seed = 0, int width = 1920, int height = 1080);
+		//gets wheter or not the application is running headless
+		static bool GetHeadless() { return m_headless; }
+
+		//sets a fixed delta time every frame steps by instead of the real time between frames, 0 goes back to real time
+		static void SetFixedDeltaTime(float dt) { m_fixedDt = std::max(dt, 0.0f); }
+		//gets the fixed delta time, 0 if it's using real time
+		static float GetFixedDeltaTime() { return m_fixedDt; }
+
 		//gets whether or not the application is closing 
 		static bool GetIsClosing();
 
@@ -201,6 +223,11 @@ namespace Titan {
 		static float m_dt;
 		static float m_previousFrameTime;
 
+		//headless and fixed timestep data
+		inline static bool m_headless = false;
+		inline static bool m_headlessClosing = false;
+		inline static float m_fixedDt = 0.0f;
+
 	public:
 		//input helper class
 		class TTN_Input {
@@ -214,7 +241,7 @@ namespace Titan {
 			//checks if a key button has been released this frame
 			static bool GetKeyUp(TTN_KeyCode key);
 
-			//reset keys
+			//ends the frame for the keys, what's down now is what was down last frame for the next one
 			static void ResetKeys();
 
 			//returns the mouse position in screenspace
@@ -229,35 +256,58 @@ namespace Titan {
 			//checks if a mouse button has been released this frame
 			static bool GetMouseButtonUp(TTN_MouseButton button);
 
-			//reset mouse buttons
+			//ends the frame for the mouse buttons, what's down now is what was down last frame for the next one
 			static void ResetMouseButtons();
 
+			//applies the input events queued since the last frame, call once a frame after glfw has polled it's events
+			static void Update();
+
 			//hides or unhides the cursor based on an inputed bool
 			static void SetCursorHidden(bool hidden);
 
 			//locks or unlocks the cursor to the wind
 			static void SetCursorLocked(bool locked);
 
-			//gets from glfw wheter or not the mouse is in frame, do not call as user
+			//glfw callbacks, they only queue the event so they can be called from whatever thread is polling glfw, do not call as user
 			static void cursorEnterFrameCallback(GLFWwindow *window, int entered);
+			static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
+			static void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
+			static void cursorPosCallback(GLFWwindow* window, double x, double y);
 
 			//gets the window witdth from glfw
 			static glm::ivec2 GetWidth();
 
 		protected:
-			//map of the booleans for if a key has been pressed
-			static std::unordered_map<TTN_KeyCode, bool> KeyWasPressedMap;
-			//map of boolean for if a key is being pressed
-			static std::unordered_map<TTN_KeyCode, bool> KeyPressed;
-			//map of booleans for if a key has been processed
-			static std::unordered_map<TTN_KeyCode, bool> KeyHandled;
-
-			//map of booleans for if a mouse button has been pressed
-			static std::unordered_map<TTN_MouseButton, bool> MouseWasPressedMap;
-			//map of boolean for if a mouse button is being pressed
-			static std::unordered_map<TTN_MouseButton, bool> MousePressed;
-			//map of boolean for if a mouse button has been processed
-			static std::unordered_map<TTN_MouseButton, bool> MouseHandled;
+			//an input event from one of glfw's callbacks
+			struct InputEvent {
+				enum class Type : uint8_t {
+					KEY,
+					MOUSE_BUTTON,
+					CURSOR_POS,
+					CURSOR_ENTER
+				};
+
+				Type EventType = Type::KEY;
+				//the key or button, and wheter it went down or up (or wheter the cursor entered or left)
+				int Code = 0;
+				bool Down = false;
+				//the cursor's position
+				glm::vec2 Pos = glm::vec2(0.0f);
+			};
+
+			//number of keys and mouse buttons glfw has codes for
+			static const size_t s_keyCount = GLFW_KEY_LAST + 1;
+			static const size_t s_mouseButtonCount = GLFW_MOUSE_BUTTON_LAST + 1;
+
+			//bits for each key that's down this frame and last frame, so pressed and released this frame are just comparing the two
+			inline static std::bitset<s_keyCount> KeysDown;
+			inline static std::bitset<s_keyCount> KeysDownLastFrame;
+			//same for the mouse buttons
+			inline static std::bitset<s_mouseButtonCount> MouseDown;
+			inline static std::bitset<s_mouseButtonCount> MouseDownLastFrame;
+
+			//events from the glfw callbacks waiting to be applied, the thread polling glfw pushes and the main thread pops
+			static TTN_SPSCQueue<InputEvent, 1024> Events;
 
 			//position of the mouse
 			static glm::vec2 mousePos;
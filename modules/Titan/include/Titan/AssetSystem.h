@@ -6,6 +6,7 @@
 #include "ttn_pch.h"
 //include all of the various asset classes and their loaders
 #include "Texture2D.h"
+#include "TextureAtlas.h"
 #include "TextureCubeMap.h"
 #include "Mesh.h"
 #include "ObjLoader.h"
@@ -23,6 +24,10 @@ namespace Titan {
 		/////////////functions for loading assets/////////////////////
 		//Adds a 2D texture to the list of assets to be loaded
 		static void AddTexture2DToBeLoaded(std::string accessName, std::string fileName, int set = 0);
+		//Adds a 2D texture to be packed into an atlas when the set loads, GetTexture2D returns it's region of the atlas
+		static void AddTexture2DToAtlas(std::string accessName, std::string fileName, std::string atlasName, int set = 0);
+		//Sets a folder packed atlases are saved in, so they only get repacked when their images change, empty to not cache them
+		static void SetAtlasCacheDirectory(std::string directory) { s_atlasCacheDirectory = directory; }
 		//Adds a Skybox to the list of assets to be loaded
 		static void AddSkyboxToBeLoaded(std::string accessName, std::string fileName, int set = 0);
 		//Adds a mesh to the list of assets to be loaded
@@ -55,6 +60,8 @@ namespace Titan {
 		/////////////functions for accessing assets in the system/////////////////////
 		//Gets a 2D texture pointer from the system 
 		static TTN_Texture2D::st2dptr GetTexture2D(std::string accessName);
+		//Gets a texture atlas pointer from the system
+		static TTN_TextureAtlas::satlasptr GetTextureAtlas(std::string accessName);
 		//Gets a Skybox texture pointer from the system
 		static TTN_TextureCubeMap::stcmptr GetSkybox(std::string accessName);
 		//Gets a mesh pointer from the system
@@ -81,6 +88,9 @@ namespace Titan {
 		static bool GetSetLoaded(int set) { return s_setsLoaded[set]; }
 
 	private:
+		//packs every atlas in a set
+		static void LoadAtlases(int set);
+
 		//structures for storing asset loading data
 		struct AccessAndFileName {
 			std::string m_AccessName;
@@ -145,6 +155,10 @@ namespace Titan {
 
 		//the map of vector of strings for 2D textures to load
 		inline static std::unordered_map<int, std::vector<AccessAndFileName>> s_2DTexturesToLoad = std::unordered_map<int, std::vector<AccessAndFileName>>();
+		//the map of atlases to pack, each with a vector of strings for the textures in it
+		inline static std::unordered_map<int, std::unordered_map<std::string, std::vector<AccessAndFileName>>> s_atlasesToLoad = std::unordered_map<int, std::unordered_map<std::string, std::vector<AccessAndFileName>>>();
+		//the folder atlases are cached in
+		inline static std::string s_atlasCacheDirectory = "";
 		//the map of vector of strings  for cubemaps to load
 		inline static std::unordered_map<int, std::vector<AccessAndFileName>> s_CubemapsToLoad = std::unordered_map<int, std::vector<AccessAndFileName>>();
 		//the map of vector of strings for non-animated meshes to load
@@ -161,6 +175,8 @@ namespace Titan {
 		//unordered maps to store the assets 
 		//2D textures
 		inline static std::unordered_map<std::string, TTN_Texture2D::st2dptr> s_texture2DMap = std::unordered_map<std::string, TTN_Texture2D::st2dptr>();
+		//texture atlases
+		inline static std::unordered_map<std::string, TTN_TextureAtlas::satlasptr> s_atlasMap = std::unordered_map<std::string, TTN_TextureAtlas::satlasptr>();
 		//skyboxes
 		inline static std::unordered_map<std::string, TTN_TextureCubeMap::stcmptr> s_cubemapMap = std::unordered_map<std::string, TTN_TextureCubeMap::stcmptr>();
 		//meshes
@@ -20,15 +20,23 @@ namespace Titan {
 		//gets the window size
 		static glm::ivec2 GetWindowSize();
 
-		//sets the last effect
-		static void SetLastEffect(TTN_PostEffect::spostptr lastEffect) { m_lastEffect = lastEffect; }
-		//gets the last effect
-		static TTN_PostEffect::spostptr GetLastEffect() { return m_lastEffect; }
+		//sets wheter or not the application is running without a window or opengl context, and the size it should pretend the window is
+		static void SetHeadless(bool headless, glm::ivec2 size = glm::ivec2(1920, 1080)) { m_headless = headless; m_headlessSize = size; }
+		//gets wheter or not the application is running without a window or opengl context, nothing should make opengl calls if it is
+		static bool GetHeadless() { return m_headless; }
+
+		//sets the framebuffer holding the last scene's finished image
+		static void SetLastFrame(TTN_Framebuffer::sfboptr lastFrame) { m_lastFrame = lastFrame; }
+		//gets the framebuffer holding the last scene's finished image
+		static TTN_Framebuffer::sfboptr GetLastFrame() { return m_lastFrame; }
 
 	private:
 		//pointer to the window
 		inline static GLFWwindow* m_window = nullptr;
-		//pointer to the last buffer applied
-		inline static TTN_PostEffect::spostptr m_lastEffect = nullptr;
+		//pointer to the last buffer drawn to the screen
+		inline static TTN_Framebuffer::sfboptr m_lastFrame = nullptr;
+		//headless mode, and the size of the window it pretends to have
+		inline static bool m_headless = false;
+		inline static glm::ivec2 m_headlessSize = glm::ivec2(1920, 1080);
 	};
 }
\ No newline at end of file
@@ -24,9 +24,15 @@ namespace Titan {
 		//Init framebuffer
 		void Init(unsigned width, unsigned height) override;
 
-		//Applies effect to this buffer
-		//passes the previous framebuffer with the texture to apply as a parameter
-		void ApplyEffect(TTN_PostEffect::spostptr buffer) override;
+		//Applies effect from the source buffer into the target buffer
+		void ApplyEffect(const TTN_Framebuffer::sfboptr& source, const TTN_Framebuffer::sfboptr& target) override;
+
+		//fused shader support, colour correction only reads the pixel it's writing so it can be merged with other effects like it
+		TTN_FusedEffectType GetFusedType() const override { return TTN_FusedEffectType::COLOR_CORRECT; }
+		int GetFusedTextureCount() const override { return 1; }
+		std::string GetFusedSource(const std::string& name, int firstSlot) const override;
+		void BindFused(const TTN_Shader::sshptr& shader, const std::string& name, int firstSlot) override;
+		void UnbindFused(int firstSlot) override;
 
 		//Getters
 		float GetIntensity() const { return m_intensity; }
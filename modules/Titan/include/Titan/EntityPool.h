@@ -0,0 +1,77 @@
+//Titan Engine, by Atlas X Games 
+// EntityPool.h - header for the class that keeps a pool of reusable entities made from a prefab
+#pragma once
+
+//precompile header, this file uses entt.hpp, vector, and memory
+#include "ttn_pch.h"
+//include the prefabs the pool is built from
+#include "Prefab.h"
+
+namespace Titan {
+	//forward declare the scene so the pool can hold a pointer to it
+	class TTN_Scene;
+	class TTN_EntityPool;
+
+	//component marking an entity as belonging to a pool, the scene uses it to send entities back to their pool instead of deleting them
+	struct TTN_PooledEntity {
+		TTN_EntityPool* pool = nullptr; //the pool the entity belongs to
+		float lifeTime = 0.0f; //the lifetime the entity's delete countdown is reset to when it's reused
+		bool inUse = false; //if the entity has been handed out, it's switched on a little after being acquired so the scene's active state can't be used for this
+	};
+
+	//entity pool class, hands out deactivated entities from a prefab instead of creating and deleting new ones
+	class TTN_EntityPool {
+	public:
+		//defines a special easier to use name for shared(smart) pointers to the class
+		typedef std::shared_ptr<TTN_EntityPool> spoolptr;
+
+		//creates and returns a shared(smart) pointer to the class
+		static inline spoolptr Create(TTN_Scene* scene, TTN_Prefab::sprefabptr prefab, size_t initialSize) {
+			return std::make_shared<TTN_EntityPool>(scene, prefab, initialSize);
+		}
+
+	public:
+		//ensuring copying is not allowed as the pooled entities store a pointer back to the pool
+		TTN_EntityPool(const TTN_EntityPool& other) = delete;
+		TTN_EntityPool& operator=(const TTN_EntityPool& other) = delete;
+
+		//constructor, creates the initial entities
+		TTN_EntityPool(TTN_Scene* scene, TTN_Prefab::sprefabptr prefab, size_t initialSize);
+
+		//default destructor
+		~TTN_EntityPool() = default;
+
+		//gets an entity from the pool and activates it at the given transform, grows the pool if it's empty
+		//the entity is switched on at the start of the scene's next update, so acquiring and releasing entities doesn't reconstruct the scenegraph each time
+		entt::entity Acquire(TTN_Transform trans);
+
+		//deactivates an entity and returns it to the pool
+		void Release(entt::entity entity);
+
+		//creates more entities for the pool
+		void Grow(size_t count);
+
+		//getters
+		//gets the number of entities the pool has created
+		size_t GetSize() const { return m_size; }
+		//gets the number of entities currently in use
+		size_t GetActiveCount() const { return m_size - m_free.size(); }
+		//gets the most entities that have been in use at once
+		size_t GetHighWaterMark() const { return m_highWaterMark; }
+		//gets the name of the prefab the pool makes
+		std::string GetName() const { return m_prefab->GetName(); }
+
+	protected:
+		//the scene the entities live in
+		TTN_Scene* m_scene;
+		//the prefab the entities are made from
+		TTN_Prefab::sprefabptr m_prefab;
+		//the entities that are ready to be used
+		std::vector<entt::entity> m_free;
+
+		//the total number of entities the pool has made
+		size_t m_size;
+		//the most entities that have been in use at once
+		size_t m_highWaterMark;
+	};
+}
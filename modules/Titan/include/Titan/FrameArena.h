@@ -0,0 +1,79 @@
+//Titan Engine, by Atlas X Games
+// FrameArena.h - header for the per thread bump allocator for memory that only has to last until the end of the frame
+#pragma once
+
+//precompile header, this file uses vector, memory, memory_resource, atomic, and mutex
+#include "ttn_pch.h"
+
+namespace Titan {
+	//bump allocator that's thrown away every frame, each thread gets it's own so allocating never locks
+	//it's a std::pmr memory resource, so containers opt in by being std::pmr containers made with GetResource()
+	//anything allocated from it is only valid until the end of the frame it was allocated in
+	class TTN_FrameArena : public std::pmr::memory_resource {
+	public:
+		//gets the calling thread's arena, it's made the first time the thread asks for it and emptied the first time it's asked for each frame
+		static TTN_FrameArena& Get();
+		//gets the calling thread's arena as a memory resource, for std::pmr containers
+		static std::pmr::memory_resource* GetResource() { return &Get(); }
+
+		//starts a new frame, every arena empties itself the next time it's used, call once a frame on the main thread
+		static void NextFrame() { s_frame.fetch_add(1, std::memory_order_release); }
+
+		//sets the size of the blocks the arenas allocate, a frame that doesn't fit gets more blocks and then one big block from the next frame on
+		static void SetBlockSize(size_t size) { s_blockSize.store(size, std::memory_order_relaxed); }
+		//gets the size of the blocks the arenas allocate
+		static size_t GetBlockSize() { return s_blockSize.load(std::memory_order_relaxed); }
+
+		//default constructor
+		TTN_FrameArena() = default;
+		//default destructor
+		~TTN_FrameArena() = default;
+
+		//copying would hand out the same memory twice
+		TTN_FrameArena(const TTN_FrameArena&) = delete;
+		TTN_FrameArena& operator=(const TTN_FrameArena&) = delete;
+
+		//empties the arena, keeping it's memory
+		void Reset();
+
+		//gets the bytes allocated from the arena this frame
+		size_t GetUsed() const { return m_used; }
+		//gets the most bytes allocated from the arena in a single frame
+		size_t GetPeak() const { return m_peak; }
+		//gets the bytes the arena has reserved
+		size_t GetCapacity() const { return m_capacity; }
+
+	protected:
+		//bumps the offset into the current block, adding a new block if it doesn't fit
+		void* do_allocate(size_t bytes, size_t alignment) override;
+		//does nothing, the memory is only given back when the arena resets
+		void do_deallocate(void* p, size_t bytes, size_t alignment) override {}
+		//arenas are only equal to themselves
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+	private:
+		//a block of memory allocations are bumped out of
+		struct TTN_ArenaBlock {
+			std::unique_ptr<std::byte[]> Memory;
+			size_t Size = 0;
+		};
+
+		std::vector<TTN_ArenaBlock> m_blocks;
+		//the block being allocated from and how far into it the next allocation goes
+		size_t m_block = 0;
+		size_t m_offset = 0;
+		size_t m_used = 0;
+		size_t m_peak = 0;
+		size_t m_capacity = 0;
+		//the frame the arena was last emptied on
+		uint64_t m_frame = 0;
+
+		inline static std::atomic<uint64_t> s_frame = 0;
+		inline static std::atomic<size_t> s_blockSize = 256 * 1024;
+
+		//every thread's arena, they're never removed so the pointers threads keep to them stay valid
+		inline static std::mutex s_arenaLock;
+		inline static std::vector<std::unique_ptr<TTN_FrameArena>> s_arenas;
+		inline static thread_local TTN_FrameArena* t_arena = nullptr;
+	};
+}
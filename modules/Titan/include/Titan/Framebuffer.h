@@ -70,12 +70,25 @@ namespace Titan {
 		void BindColorAsTexture(unsigned colorBuffer, int textureSlot) const;
 		//unbinds a texture
 		void UnbindTexture(int textureSlot) const;
+		//gets the depth texture, null if the framebuffer has no depth target or hasn't been initialized
+		const TTN_Texture2D::st2dptr& GetDepthTexture() const { return m_depth.m_texture; }
 
-		//reshapes the framebuffer
+		//reshapes the framebuffer, if the new size fits in the textures it just changes the viewport, otherwise it recreates them with some headroom
 		void Reshape(unsigned width, unsigned height);
 		//sets the size of the frame
 		void SetSize(unsigned width, unsigned height);
 
+		//gets the fraction of the textures the current size covers, multiply uvs by this when sampling the framebuffer
+		glm::vec2 GetUVScale() const { return glm::vec2((float)m_width / (float)m_allocWidth, (float)m_height / (float)m_allocHeight); }
+		//gets the size the textures were actually allocated at
+		glm::uvec2 GetAllocatedSize() const { return glm::uvec2(m_allocWidth, m_allocHeight); }
+
+		//sets the filter used when sampling the framebuffer's textures, linear is needed when it's being scaled up
+		void SetFilter(GLenum filter);
+
+		//how much bigger than the requested size textures are allocated when they have to grow, so small resizes after that don't reallocate
+		inline static float s_headroom = 1.25f;
+
 		//sets the viewport to fullscreen (using size of the framebuffer)
 		void SetViewport() const;
 
@@ -101,11 +114,15 @@ namespace Titan {
 		//Draws our fullscreen quad
 		static void DrawFullScreenQuad();
 
-		//Initial width and height is zero
+		//Initial width and height is zero, this is the size being drawn to
 		unsigned int m_width = 0;
 		unsigned int m_height = 0;
 
 	protected:
+		//the size the textures were allocated at, always at least as big as the width and height
+		unsigned int m_allocWidth = 0;
+		unsigned int m_allocHeight = 0;
+
 		//OpenGL framebuffer handle
 		GLuint m_FBO;
 		//Depth attachment, either one or none
@@ -0,0 +1,128 @@
+//Titan Engine, by Atlas X Games
+// FrustumCuller.h - header for the classes that work out which objects are inside the camera's view
+#pragma once
+
+//precompile header, this file uses vector, unordered_map, and glm
+#include "ttn_pch.h"
+
+namespace Titan {
+	//the six planes of a view frustum, normals point inwards
+	struct TTN_Frustum {
+		//planes as (normal, distance), normalized so distances are in world units
+		glm::vec4 Planes[6];
+
+		//result of testing a box against the frustum
+		enum class TestResult {
+			OUTSIDE,
+			INTERSECTS,
+			INSIDE
+		};
+
+		//extracts the frustum from a view projection matrix
+		static TTN_Frustum FromMatrix(const glm::mat4& viewProj);
+		//tests an axis aligned box against the frustum
+		TestResult TestAABB(const glm::vec3& min, const glm::vec3& max) const;
+	};
+
+	//bounding volume hierarchy over boxes that don't move, so they can be culled without testing every one
+	class TTN_BoundsBVH {
+	public:
+		//default constructor
+		TTN_BoundsBVH() = default;
+		//default destructor
+		~TTN_BoundsBVH() = default;
+
+		//builds the tree, the items are refered to by their index in the lists that were passed in
+		void Build(const std::vector<glm::vec3>& mins, const std::vector<glm::vec3>& maxes);
+		//adds the index of every item inside the frustum to visible, whole subtrees inside the frustum are taken without testing their children
+		void Query(const TTN_Frustum& frustum, std::vector<uint32_t>& visible) const;
+
+		//gets how many nodes the last query tested
+		size_t GetNodesTested() const { return m_nodesTested; }
+		//gets the number of items in the tree
+		size_t GetItemCount() const { return m_items.size(); }
+
+	private:
+		//a node covers a range of the items, leaves have no children
+		struct Node {
+			glm::vec3 Min;
+			glm::vec3 Max;
+			uint32_t First;
+			uint32_t Count;
+			//the left child is always the next node, this is the index of the right child (0 for leaves)
+			uint32_t Right;
+		};
+
+		//recursively builds the node over a range of items
+		uint32_t BuildNode(uint32_t first, uint32_t count, const std::vector<glm::vec3>& mins, const std::vector<glm::vec3>& maxes,
+			const std::vector<glm::vec3>& centers);
+
+		//most items in a leaf
+		static const uint32_t s_leafSize = 4;
+
+		std::vector<Node> m_nodes;
+		//item indices, reordered so every node's items are next to each other
+		std::vector<uint32_t> m_items;
+		mutable size_t m_nodesTested = 0;
+	};
+
+	//class that culls a frame's objects against the camera, moving objects are tested as spheres in packed arrays and
+	//static objects go through a bvh that's only rebuilt when the set of static objects changes
+	class TTN_FrustumCuller {
+	public:
+		//default constructor
+		TTN_FrustumCuller() = default;
+		//default destructor
+		~TTN_FrustumCuller() = default;
+
+		//starts a new frame, objects are numbered in the order they're added after this
+		void Begin();
+		//adds an object that's always drawn
+		void AddAlwaysVisible();
+		//adds a moving object with a world space bounding sphere
+		void AddDynamic(const glm::vec3& center, float radius);
+		//adds an object that doesn't move, the id has to be unique and stay the same every frame
+		void AddStatic(uint32_t id, const glm::vec3& min, const glm::vec3& max);
+		//culls everything added since Begin
+		void Cull(const glm::mat4& viewProj);
+
+		//gets wheter or not an object (numbered by the order it was added) is visible
+		bool IsVisible(size_t index) const { return m_visible[index] != 0; }
+
+		//gets the number of objects that passed the last cull
+		size_t GetVisibleCount() const { return m_visibleCount; }
+		//gets the number of objects that were culled by the last cull
+		size_t GetCulledCount() const { return m_visible.size() - m_visibleCount; }
+		//gets the number of static objects in the bvh
+		size_t GetStaticCount() const { return m_bvh.GetItemCount(); }
+		//gets the number of times the bvh has been rebuilt
+		size_t GetStaticRebuilds() const { return m_rebuilds; }
+
+	private:
+		//visibility of every object this frame
+		std::vector<uint8_t> m_visible;
+		size_t m_visibleCount = 0;
+
+		//packed spheres for the moving objects, and the object each one belongs to
+		std::vector<float> m_centerX, m_centerY, m_centerZ, m_radius;
+		std::vector<uint32_t> m_dynamicObjects;
+		//per sphere results, kept as bytes so the plane tests vectorise
+		std::vector<uint8_t> m_dynamicVisible;
+
+		//static objects added this frame
+		std::vector<uint32_t> m_staticIds;
+		std::vector<uint32_t> m_staticObjects;
+		std::vector<glm::vec3> m_staticMins, m_staticMaxes;
+		//order independent hash of the static ids, when it changes the bvh is rebuilt
+		uint64_t m_staticSignature = 0;
+		uint64_t m_builtSignature = 0;
+		size_t m_builtCount = 0;
+		//which bvh item each static id is
+		std::unordered_map<uint32_t, uint32_t> m_staticItems;
+		//the object each bvh item belongs to this frame
+		std::vector<uint32_t> m_itemObjects;
+		TTN_BoundsBVH m_bvh;
+		std::vector<uint32_t> m_bvhVisible;
+		size_t m_rebuilds = 0;
+	};
+}
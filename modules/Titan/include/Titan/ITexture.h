@@ -31,6 +31,14 @@ namespace Titan {
 		// Gets the underlying OpenGL handle for this texture
 		GLuint& GetHandle() { return _handle; }
 
+		//gets wheter or not the gpu supports bindless textures
+		static bool GetBindlessSupported();
+		//gets a bindless handle shaders can sample the texture through without it being bound to a slot, making it resident the first time
+		//openGL doesn't allow the texture's filters or wrap modes to change once it has a handle, returns 0 if bindless textures aren't supported
+		uint64_t GetBindlessHandle();
+		//gets a counter that goes up every time a texture throws away a bindless handle it gave out, anything that saved handles has to get them again when it changes
+		static uint32_t GetHandleGeneration() { return s_handleGeneration; }
+
 		//clears this texutre to a given colour
 		void Clear(const glm::vec4 color = glm::vec4(1.0f));
 
@@ -42,6 +50,10 @@ namespace Titan {
 		virtual ~TTN_ITexture();
 
 		GLuint _handle;
+		//the resident bindless handle, 0 until one is asked for
+		uint64_t _bindlessHandle;
+		//goes up whenever a handle that was given out is thrown away
+		inline static uint32_t s_handleGeneration = 0;
 
 		static TTN_Texture_Limits _limits;
 		static bool _isStaticInit;
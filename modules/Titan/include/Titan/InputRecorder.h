@@ -0,0 +1,118 @@
+//Titan Engine, by Atlas X Games
+// InputRecorder.h - header for the class that records the input each frame to a file and plays it back
+#pragma once
+
+//precompile header, this file uses string, vector, unordered_map, fstream, memory, and GLM/glm.hpp
+#include "ttn_pch.h"
+
+namespace cereal {
+	class PortableBinaryOutputArchive;
+	class PortableBinaryInputArchive;
+}
+
+namespace Titan {
+	//a key or mouse button changing state
+	struct TTN_InputEvent {
+		//what kind of change it is
+		enum class Type : uint8_t {
+			KEY_UP = 0,
+			KEY_DOWN = 1,
+			MOUSE_UP = 2,
+			MOUSE_DOWN = 3
+		};
+
+		//the glfw key or mouse button code
+		uint16_t Code = 0;
+		Type EventType = Type::KEY_UP;
+
+		template<class Archive>
+		void serialize(Archive& archive) { archive(Code, EventType); }
+	};
+
+	//everything that happened to the input in one frame
+	struct TTN_InputFrame {
+		//the frame's delta time
+		float Dt = 0.0f;
+		//wheter or not the mouse moved, the position is only saved when it did
+		bool MouseMoved = false;
+		glm::vec2 MousePos = glm::vec2(0.0f);
+		//keys and buttons that changed, in the order they were first seen
+		std::vector<TTN_InputEvent> Events;
+
+		template<class Archive>
+		void serialize(Archive& archive) {
+			archive(Dt, MouseMoved);
+			if (MouseMoved) archive(MousePos.x, MousePos.y);
+			archive(Events);
+		}
+	};
+
+	//static class that records what TTN_Input reads from glfw each frame, along with the delta time, and plays it back through TTN_Input
+	//with the random number generator seeded the same way, a played back run does exactly what the recorded run did
+	class TTN_InputRecorder {
+	public:
+		//what the recorder is doing
+		enum class Mode {
+			NONE,
+			RECORDING,
+			PLAYBACK
+		};
+
+		//starts recording to a file, seeding the random number generator so the run can be played back
+		static bool StartRecording(const std::string& path, uint32_t seed = 0);
+		//finishes the recording and closes the file
+		static void StopRecording();
+		//starts playing back a recording, reseeding the random number generator with the seed it was recorded with
+		static bool StartPlayback(const std::string& path);
+		//stops playing back, input goes back to glfw
+		static void StopPlayback();
+
+		//gets what the recorder is doing
+		static Mode GetMode() { return s_mode; }
+		static bool GetRecording() { return s_mode == Mode::RECORDING; }
+		static bool GetPlaying() { return s_mode == Mode::PLAYBACK; }
+		//gets wheter or not the last playback reached the end of it's recording
+		static bool GetPlaybackFinished() { return s_playbackFinished; }
+		//gets how many frames have been recorded or played back
+		static size_t GetFrameCount() { return s_frameCount; }
+
+		//starts a frame, called by TTN_Application once it has the frame's delta time
+		//returns the recorded delta time while playing back, and the delta time that was passed in otherwise
+		static float BeginFrame(float deltaTime);
+		//ends a frame, called by TTN_Application once the frame is done
+		static void EndFrame();
+
+		//gets the state of every key and mouse button that's been pressed, and the mouse's position, as of the last frame that was played back
+		static const std::unordered_map<int, bool>& GetKeys() { return s_keys; }
+		static const std::unordered_map<int, bool>& GetMouseButtons() { return s_buttons; }
+		static glm::vec2 GetMousePosition() { return s_mousePos; }
+		//saves a change to the input while recording, does nothing otherwise
+		static void RecordKey(int key, bool down);
+		static void RecordMouseButton(int button, bool down);
+		static void RecordMousePosition(const glm::vec2& position);
+
+	private:
+		//identifies the file as a titan input recording, and the version of the format
+		static constexpr uint32_t s_magic = 0x494E5454; //"TTNI"
+		static constexpr uint32_t s_version = 1;
+
+		//resets the state between runs
+		static void Reset();
+
+		inline static Mode s_mode = Mode::NONE;
+		inline static bool s_playbackFinished = false;
+		inline static size_t s_frameCount = 0;
+
+		//the file and it's archive, every frame is written or read as it happens so long runs don't sit in memory
+		inline static std::shared_ptr<std::fstream> s_file = nullptr;
+		inline static std::shared_ptr<cereal::PortableBinaryOutputArchive> s_output = nullptr;
+		inline static std::shared_ptr<cereal::PortableBinaryInputArchive> s_input = nullptr;
+
+		//the frame being recorded
+		inline static TTN_InputFrame s_frame;
+		//the state of every key and button as of the last event, and the mouse's position
+		inline static std::unordered_map<int, bool> s_keys;
+		inline static std::unordered_map<int, bool> s_buttons;
+		inline static glm::vec2 s_mousePos = glm::vec2(0.0f);
+	};
+}
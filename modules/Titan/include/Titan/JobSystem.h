@@ -0,0 +1,148 @@
+//Titan Engine, by Atlas X Games 
+// JobSystem.h - header for the classes that run work across worker threads
+#pragma once
+
+//precompile header, this file uses thread, atomic, mutex, condition_variable, deque, functional, and entt.hpp
+#include "ttn_pch.h"
+
+namespace Titan {
+	//class for a single job, jobs that depend on other jobs are only queued once everything they depend on has finished
+	class TTN_Job {
+	public:
+		//defines a special easier to use name for shared(smart) pointers to the class
+		typedef std::shared_ptr<TTN_Job> sjobptr;
+
+	public:
+		//ensuring moving and copying is not allowed as other jobs hold pointers to it
+		TTN_Job(const TTN_Job& other) = delete;
+		TTN_Job& operator=(const TTN_Job& other) = delete;
+
+		//constructor
+		TTN_Job(std::function<void()> work);
+
+		//default destructor
+		~TTN_Job() = default;
+
+		//returns true once the job has run
+		bool GetIsFinished() const { return m_finished.load(); }
+
+	protected:
+		friend class TTN_JobSystem;
+
+		//the work the job does
+		std::function<void()> m_work;
+		//how many of the jobs this job depends on haven't finished yet
+		std::atomic<int> m_unfinishedDependencies;
+		//wheter or not the job has run
+		std::atomic<bool> m_finished;
+		//the jobs waiting on this one, and the lock protecting them
+		std::mutex m_continuationLock;
+		std::vector<sjobptr> m_continuations;
+	};
+
+	//the handle game code gets back when it schedules a job
+	typedef TTN_Job::sjobptr TTN_JobHandle;
+
+	//static job system class, each worker has it's own queue and steals from the others when it runs out of work
+	class TTN_JobSystem {
+	public:
+		//starts the worker threads, 0 uses one worker per hardware thread other than the main thread
+		static void Init(size_t workerCount = 0);
+		//stops the worker threads
+		static void Shutdown();
+
+		//returns true if the worker threads are running, if they aren't every job just runs straight away on the calling thread
+		static bool GetIsRunning() { return s_running.load(); }
+		//gets the number of worker threads (not counting the main thread)
+		static size_t GetWorkerCount() { return s_workers.size(); }
+
+		//schedules a job to run once all of it's dependencies have finished
+		static TTN_JobHandle Schedule(std::function<void()> work, const std::vector<TTN_JobHandle>& dependencies = std::vector<TTN_JobHandle>());
+
+		//waits for a job to finish, the waiting thread runs other jobs in the meantime
+		static void Wait(const TTN_JobHandle& job);
+		//waits for a group of jobs to finish
+		static void WaitAll(const std::vector<TTN_JobHandle>& jobs);
+
+		//splits the range [0, count) into chunks and runs them across the workers, blocks until they're all done
+		//the function gets the start and end of it's chunk, a grain size of 0 picks one based on the number of workers
+		static void ParallelFor(size_t count, const std::function<void(size_t, size_t)>& function, size_t grainSize = 0);
+
+		//runs a function on every entity in an entt view across the workers, blocks until they're all done
+		//the function must only touch the entity it's given, adding or removing components isn't safe from inside it
+		template<typename View, typename Func>
+		static void ParallelForEach(View view, Func function);
+
+	private:
+		//a worker's queue, the owner takes from the back and other workers steal from the front
+		struct TTN_WorkQueue {
+			std::mutex lock;
+			std::deque<TTN_JobHandle> jobs;
+		};
+
+		//the loop each worker thread runs
+		static void WorkerLoop(size_t index);
+		//adds a job to the calling thread's queue
+		static void Enqueue(const TTN_JobHandle& job);
+		//finds a job for a thread, first from it's own queue and then from the others
+		static TTN_JobHandle FindJob(size_t index);
+		//runs a job and queues anything that was waiting on it
+		static void Execute(const TTN_JobHandle& job);
+
+		//the queues, 0 belongs to the main thread and the rest to the workers
+		inline static std::vector<std::unique_ptr<TTN_WorkQueue>> s_queues;
+		//the worker threads
+		inline static std::vector<std::thread> s_workers;
+		//wheter or not the workers are running
+		inline static std::atomic<bool> s_running = false;
+		//number of jobs sitting in queues, used to let idle workers sleep
+		inline static std::atomic<int> s_queuedJobs = 0;
+		//lock and condition variable idle workers sleep on
+		inline static std::mutex s_sleepLock;
+		inline static std::condition_variable s_wake;
+		//the queue that belongs to the current thread
+		inline static thread_local size_t t_queueIndex = 0;
+	};
+
+	//runs a function on every entity in a view across the workers
+	template<typename View, typename Func>
+	inline void TTN_JobSystem::ParallelForEach(View view, Func function)
+	{
+		//copy the entities out so they can be split into chunks
+		std::vector<entt::entity> entities = std::vector<entt::entity>(view.begin(), view.end());
+
+		ParallelFor(entities.size(), [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++)
+				function(entities[i]);
+		});
+	}
+
+	//frame graph class, a set of named systems with dependencies between them that run as jobs each frame
+	class TTN_FrameGraph {
+	public:
+		//default constructor
+		TTN_FrameGraph() = default;
+		//default destructor
+		~TTN_FrameGraph() = default;
+
+		//adds a system, it will only start once all the systems it depends on are done, those have to be added first
+		void AddSystem(const std::string& name, std::function<void()> system, const std::vector<std::string>& dependsOn = std::vector<std::string>());
+
+		//runs all the systems and waits for them to finish
+		void Run();
+
+		//removes all the systems
+		void Clear() { m_systems.clear(); }
+
+	protected:
+		//a single system in the graph
+		struct TTN_FrameGraphSystem {
+			std::string name;
+			std::function<void()> system;
+			std::vector<size_t> dependencies;
+		};
+
+		//the systems in the order they were added
+		std::vector<TTN_FrameGraphSystem> m_systems;
+	};
+}
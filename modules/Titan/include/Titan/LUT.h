@@ -29,7 +29,7 @@ namespace Titan {
 		//constructor that takes the path to a .cube file
 		TTN_LUT3D(std::string path);
 		
-		//load in from a cube file
+		//load in from a cube file, uses the binary cache next to it if it's up to date and writes one if it isn't
 		void loadFromFile(std::string path);
 		//bind and unbind the look up table
 		void bind();
@@ -39,9 +39,25 @@ namespace Titan {
 		void bind(int textureSlot);
 		void unbind(int textureSlot);
 
+		//gets the number of entries along each side of the cube
+		int GetSize() const { return m_size; }
+
 	private:
-		//Gl handle and data
+		//parses a .cube file into packed texels, returns false if the file couldn't be read
+		bool ParseCube(const std::string& path, std::vector<uint32_t>& texels);
+		//reads the binary cache, returns false if it's missing or older than the .cube file
+		bool ReadCache(const std::string& path, std::vector<uint32_t>& texels);
+		//writes the binary cache
+		void WriteCache(const std::string& path, const std::vector<uint32_t>& texels);
+		//uploads the packed texels to the 3D texture
+		void Upload(const std::vector<uint32_t>& texels);
+
+		//packs a colour into the RGB10A2 format the cube is stored and uploaded as
+		static uint32_t PackTexel(glm::vec3 color);
+
+		//Gl handle
 		GLuint m_handle = GL_NONE;
-		std::vector<glm::vec3> data;
+		//number of entries along each side of the cube
+		int m_size = 0;
 	};
 }
\ No newline at end of file
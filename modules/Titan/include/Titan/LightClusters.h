@@ -0,0 +1,82 @@
+//Titan Engine, by Atlas X Games 
+// LightClusters.h - header for the class that sorts the scene's lights into view space clusters for clustered forward lighting
+#pragma once
+
+//precompile header, this file uses vector and glm
+#include "ttn_pch.h"
+//include other titan features
+#include "ShaderStorageBuffer.h"
+#include "Shader.h"
+
+namespace Titan {
+	//a light laid out the way the shaders read it (std430)
+	struct TTN_GPULight {
+		//xyz is the world space position, w is how far the light reaches
+		glm::vec4 PositionRange;
+		//rgb is the colour, a is the ambient strength
+		glm::vec4 ColorAmbient;
+		//x is the specular strength, y, z, and w are the constant, linear, and quadratic attenuation
+		glm::vec4 SpecularAttenuation;
+	};
+
+	//class that splits the view frustum into a grid of clusters and works out which lights touch each one
+	//the shaders then only light each fragment with the lights in it's cluster
+	class TTN_LightClusters {
+	public:
+		//size of the cluster grid, x and y are screen tiles and z is exponential depth slices
+		static const uint32_t s_clustersX = 16;
+		static const uint32_t s_clustersY = 9;
+		static const uint32_t s_clustersZ = 24;
+
+		//the shader storage buffer bindings the clustered lighting uses
+		static const GLuint s_lightBinding = 0;
+		static const GLuint s_gridBinding = 1;
+		static const GLuint s_indexBinding = 2;
+
+	public:
+		//default constructor
+		TTN_LightClusters() = default;
+		//default destructor
+		~TTN_LightClusters() = default;
+
+		//works out how far a light reaches before it's too dim to see, lights that never fade get an infinite range
+		static float CalculateRange(float constant, float linear, float quadratic, float brightness);
+
+		//sorts the lights into clusters for the given camera and uploads the results for the shaders, the lists are usually made with the frame arena
+		void Build(const std::pmr::vector<TTN_GPULight>& lights, const glm::mat4& view, const glm::mat4& projection);
+
+		//binds the light, grid, and index buffers
+		void Bind();
+		//sets the uniforms the shaders need to find their cluster, viewportSize is the size of the target being drawn to
+		void SetUniforms(TTN_Shader* shader, glm::uvec2 viewportSize);
+
+		//gets the number of lights in the last build
+		size_t GetLightCount() const { return m_lightCount; }
+		//gets the total number of light indices across every cluster in the last build
+		size_t GetIndexCount() const { return m_indexCount; }
+
+	private:
+		//rebuilds the view space bounding boxes of the clusters, only needed when the projection changes
+		void BuildClusterBounds(const glm::mat4& projection);
+
+		//the view space bounding boxes of each cluster
+		std::vector<glm::vec3> m_clusterMin;
+		std::vector<glm::vec3> m_clusterMax;
+		//the projection the bounds were built for
+		glm::mat4 m_boundsProjection = glm::mat4(0.0f);
+		//the depth range the slices cover, as positive distances in front of the camera
+		float m_near = 0.1f;
+		float m_far = 1000.0f;
+		//the view matrix from the last build
+		glm::mat4 m_view = glm::mat4(1.0f);
+
+		//the gpu buffers
+		TTN_ShaderStorageBuffer::sssboptr m_lightBuffer = nullptr;
+		TTN_ShaderStorageBuffer::sssboptr m_gridBuffer = nullptr;
+		TTN_ShaderStorageBuffer::sssboptr m_indexBuffer = nullptr;
+
+		//the counts from the last build
+		size_t m_lightCount = 0;
+		size_t m_indexCount = 0;
+	};
+}
@@ -5,8 +5,27 @@
 //include texture class
 #include "Texture2D.h"
 #include "TextureCubeMap.h"
+//include the shader storage buffer class, for the material buffer
+#include "ShaderStorageBuffer.h"
 
 namespace Titan {
+	//a material as it's laid out in the material buffer, matches the Material struct in the default shaders
+	struct TTN_GPUMaterial {
+		//bindless handles for the textures
+		uint64_t Albedo;
+		uint64_t Specular;
+		uint64_t HeightMap;
+		uint64_t DiffuseRamp;
+		uint64_t SpecularRamp;
+		uint64_t Padding;
+		//shininess, height influence, outline size, unused
+		glm::vec4 Params;
+		//has ambient lighting, has specular lighting, no outline (it's reversed in the shaders), unused
+		glm::ivec4 Lighting;
+		//use diffuse ramp, use specular ramp, unused, unused
+		glm::ivec4 Ramps;
+	};
+
 	//class for materials on 3D objects
 	class TTN_Material {
 	public:
@@ -63,6 +82,20 @@ namespace Titan {
 		TTN_Texture2D::st2dptr GetSpecularRamp() { return m_specularRamp; }
 		bool GetUseSpecularRamp() { return m_useSpecularRamp; }
 
+		//gets the material's index in the material buffer
+		uint32_t GetIndex() const { return m_index; }
+		//gets wheter or not two materials use all the same textures, objects with different materials can share an instanced draw if they do
+		bool GetSameTextures(const TTN_Material& other) const;
+
+		//the shader storage buffer binding the material buffer is bound to
+		static const GLuint s_materialBinding = 5;
+		//gets wheter or not the default shaders read materials from the material buffer with bindless textures, instead of having them set and bound for every draw
+		static bool GetUseMaterialBuffer() { return TTN_ITexture::GetBindlessSupported(); }
+		//uploads the materials that have changed and binds the material buffer, called by the scene before it draws
+		static void BindMaterialBuffer();
+		//gets a material with the default settings, for objects drawn without one
+		static const smatptr& GetDefault();
+
 	private:
 		//albedo 
 		TTN_Texture2D::st2dptr m_Albedo;
@@ -87,5 +120,23 @@ namespace Titan {
 		bool m_useDiffuseRamp;
 		TTN_Texture2D::st2dptr m_specularRamp;
 		bool m_useSpecularRamp;
+
+		//marks the material as needing to be uploaded to the material buffer again
+		void MarkDirty();
+		//writes the material into it's slot of the material buffer's data
+		void WriteGPUData();
+
+		//the material's slot in the material buffer, and wheter or not it's changed since it was uploaded
+		uint32_t m_index;
+		bool m_dirty;
+
+		//every material, by their index (nullptr for free slots), and their data for the material buffer
+		inline static std::vector<TTN_Material*> s_materials;
+		inline static std::vector<TTN_GPUMaterial> s_gpuMaterials;
+		inline static std::vector<uint32_t> s_freeIndices;
+		inline static bool s_bufferDirty = false;
+		//the texture handle generation the buffer's handles were written with
+		inline static uint32_t s_textureGeneration = 0;
+		inline static TTN_ShaderStorageBuffer::sssboptr s_materialBuffer = nullptr;
 	};
 }
\ No newline at end of file
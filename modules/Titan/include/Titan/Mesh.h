@@ -6,6 +6,7 @@
 #include "ttn_pch.h"
 //include the opengl wrap around classes
 #include "VertexArrayObject.h"
+#include "ShaderStorageBuffer.h"
 
 
 namespace Titan {
@@ -34,8 +35,14 @@ namespace Titan {
 		//destructor
 		~TTN_Mesh();
 
-		//sets up the VAO for the mesh so it can acutally be rendered, called by the user (as they may change details of the mesh)
-		void SetUpVao(int currentFrame = 0, int nextFrame = 0);
+		//sets up the VAO for the mesh so it can acutally be rendered, it's only built once so calling it again does nothing unless the mesh has changed
+		//morph animated meshes read their frames from the packed frame buffer instead of the VAO
+		void SetUpVao();
+
+		//binds every morph frame, packed into one shader storage buffer, for the morph animation shaders to read by frame index
+		void BindFrames();
+		//the shader storage buffer binding the frames are bound to
+		static const GLuint s_frameBinding = 3;
 
 		//SETTERS 
 		//sets the list of uvs for the mesh
@@ -62,6 +69,32 @@ namespace Titan {
 		std::vector<glm::vec3> GetVertexNormals() { return m_Normals[0]; }
 		//Gets a list of the uvs
 		std::vector<glm::vec2> GetVertexUvs() { return m_Uvs; }
+		//Gets a list of the vertex colors, empty if the mesh doesn't have them
+		const std::vector<glm::vec3>& GetVertexColors() { return m_Colors; }
+		//Gets the vertex positions and normals of one morph animation frame
+		const std::vector<glm::vec3>& GetFrameVertices(int frame) { return m_Vertices[frame]; }
+		const std::vector<glm::vec3>& GetFrameNormals(int frame) { return m_Normals[frame]; }
+
+		//LEVELS OF DETAIL
+		//adds a simpler version of the mesh, used once the mesh covers less than screenSize of the screen's height
+		//a negative screen size picks a default that halves with each level, returns false if the frame counts don't match
+		bool AddLOD(smptr lod, float screenSize = -1.0f);
+		//Gets the number of levels of detail, including the full mesh
+		int GetLODCount() { return m_lods.size() + 1; }
+		//Gets a level of detail, level 0 is this mesh so it starts at 1
+		const smptr& GetLOD(int level) { return m_lods[level - 1]; }
+		//Gets the screen size a level of detail is used below, level 0 is always used above the level 1 size
+		float GetLODScreenSize(int level) { return (level == 0) ? std::numeric_limits<float>::max() : m_lodScreenSizes[level - 1]; }
+		//Gets the corners of the local space bounding box around every frame of the mesh
+		const glm::vec3& GetBoundsMin() const { return m_boundsMin; }
+		const glm::vec3& GetBoundsMax() const { return m_boundsMax; }
+		//Gets the number of morph animation frames the mesh has
+		int GetFrameCount() { return m_Vertices.size(); }
+		//Gets the number of triangles in the mesh
+		int GetTriangleCount() { return m_Vertices.empty() ? 0 : m_Vertices[0].size() / 3; }
+		//Gets the local space bounding sphere around every frame of the mesh, centered on the bounding box
+		const glm::vec3& GetBoundingCenter() const { return m_boundingCenter; }
+		float GetBoundingRadius() const { return m_boundingRadius; }
 
 	protected:
 		//a vector containing all the vertices on the mesh 
@@ -74,6 +107,15 @@ namespace Titan {
 		std::vector<glm::vec3> m_Colors;
 		//a boolean for if the mesh has colors
 		bool m_HasVertColors;
+		//local space bounding box, grown by every set of vertices added so it covers every morph frame
+		glm::vec3 m_boundsMin = glm::vec3(0.0f);
+		glm::vec3 m_boundsMax = glm::vec3(0.0f);
+		//simpler versions of the mesh and the screen sizes they're used below
+		std::vector<smptr> m_lods;
+		std::vector<float> m_lodScreenSizes;
+		//local space bounding sphere
+		glm::vec3 m_boundingCenter = glm::vec3(0.0f);
+		float m_boundingRadius = 0.0f;
 
 		//vbo smart pointers
 		std::vector<TTN_VertexBuffer::svbptr> m_vertVbos;
@@ -82,5 +124,10 @@ namespace Titan {
 		TTN_VertexBuffer::svbptr m_ColVbo;
 		//smart pointer with the VAO for the mesh 
 		TTN_VertexArrayObject::svaptr m_vao;
+		//every frame's positions and normals packed together
+		TTN_ShaderStorageBuffer::sssboptr m_frameBuffer;
+		//wheter or not the vao and frame buffer need rebuilding because the mesh changed
+		bool m_vaoDirty = true;
+		bool m_framesDirty = true;
 	};
 }
\ No newline at end of file
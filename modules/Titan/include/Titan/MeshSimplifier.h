@@ -0,0 +1,24 @@
+//Titan Engine, by Atlas X Games
+// MeshSimplifier.h - header for the class that builds simpler levels of detail from a mesh
+#pragma once
+
+//include the mesh class so it can read and build them
+#include "Mesh.h"
+
+namespace Titan {
+	//builds levels of detail by collapsing the edges that change the surface the least (Garland and Heckbert's quadric error metric)
+	class TTN_MeshSimplifier {
+	public:
+		//returns a copy of the mesh with about ratio of it's triangles, every morph frame collapses the same edges so it still animates
+		//open edges and uv seams are never collapsed so the silhouette and textures don't tear
+		static TTN_Mesh::smptr Simplify(const TTN_Mesh::smptr& mesh, float ratio);
+
+		//adds up to levels levels of detail to the mesh, each with about ratio of the last one's triangles
+		//meshes that already have levels of detail, like ones loaded from name_lod1.obj files, are left alone
+		static void GenerateLODs(const TTN_Mesh::smptr& mesh, int levels, float ratio = 0.5f);
+
+	protected:
+		TTN_MeshSimplifier() = default;
+		~TTN_MeshSimplifier() = default;
+	};
+}
@@ -10,9 +10,11 @@ namespace Titan {
 	//class to parse ObjFiles into TTN_Model objects
 	class TTN_ObjLoader {
 	public:
-		static TTN_Mesh::smptr LoadFromFile(const std::string& fileName);
+		//loads a mesh, if there are files next to it named name_lod1.obj, name_lod2.obj, etc. they're loaded as it's levels of detail
+		static TTN_Mesh::smptr LoadFromFile(const std::string& fileName, bool loadLODs = true);
 
-		static TTN_Mesh::smptr LoadAnimatedMeshFromFiles(const std::string& fileName, int numOfFiles);
+		//loads a morph animated mesh from name_1.obj, name_2.obj, etc. levels of detail are loaded from name_lod1_1.obj, name_lod1_2.obj, etc.
+		static TTN_Mesh::smptr LoadAnimatedMeshFromFiles(const std::string& fileName, int numOfFiles, bool loadLODs = true);
 
 	protected:
 		TTN_ObjLoader() = default;
@@ -196,6 +196,9 @@ namespace Titan {
 		//emits that number of particles at that time
 		void Burst(size_t numOfParticles);
 
+		//kills all the particles and restarts the system, lets a system be reused without reallocating it
+		void Reset();
+
 	private:
 		//particle artibutes
 		glm::vec3* Positions;
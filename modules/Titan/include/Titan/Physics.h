@@ -78,6 +78,9 @@ namespace Titan {
 		void AddImpulse(glm::vec3 impulseForce);
 		void ClearForces();
 
+		//moves the body to a position and clears all of it's motion, used when a pooled entity is reused
+		void Reset(glm::vec3 position);
+
 		//identifier
 		void SetEntity(entt::entity entity);
 
@@ -132,7 +135,7 @@ namespace Titan {
 		void SetCollisionPoint(const glm::vec3 point);
 
 		//checks if two collisions pointers represent a collision between the same objects
-		static bool same(scolptr collision1, scolptr collision2) {
+		static bool same(const scolptr& collision1, const scolptr& collision2) {
 			//compare the entity numbers
 			if ((collision1->b1 == collision2->b1 && collision1->b2 == collision2->b2) ||
 				(collision1->b1 == collision2->b2 && collision1->b2 == collision2->b1)) {
@@ -150,4 +153,36 @@ namespace Titan {
 		entt::entity b2;
 		glm::vec3 collisionPoint;
 	};
+
+	//enum for the different kinds of spatial queries a scene can run against it's physics bodies
+	enum class TTN_QueryType {
+		RAYCAST = 0,
+		SPHERE_OVERLAP = 1,
+		BOX_OVERLAP = 2,
+		SWEEP_SPHERE = 3
+	};
+
+	//struct describing a single spatial query, used so several queries can be batched together
+	struct TTN_SpatialQuery {
+		TTN_QueryType type = TTN_QueryType::RAYCAST;
+		glm::vec3 start = glm::vec3(0.0f); //start of a ray or sweep, or the center of an overlap
+		glm::vec3 end = glm::vec3(0.0f); //end of a ray or sweep
+		glm::vec3 halfExtents = glm::vec3(0.0f); //half extents of an axis aligned box overlap
+		float radius = 0.0f; //radius of a sphere overlap or sweep
+	};
+
+	//struct for the closest hit of a raycast or sweep
+	struct TTN_RaycastHit {
+		entt::entity entity = entt::null; //the entity that was hit
+		glm::vec3 point = glm::vec3(0.0f); //the point in world space where the hit happened
+		glm::vec3 normal = glm::vec3(0.0f); //the surface normal at the hit
+		float fraction = 1.0f; //how far along the ray the hit happened, 0 is the start and 1 is the end
+	};
+
+	//struct for the result of a single query in a batch
+	struct TTN_QueryResult {
+		bool hit = false; //true if anything was hit or overlapped
+		TTN_RaycastHit closest; //the closest hit, only filled in for raycasts and sweeps
+		std::vector<entt::entity> entities; //every entity overlapped, only filled in for overlaps
+	};
 }
\ No newline at end of file
@@ -9,6 +9,13 @@
 #include "Shader.h"
 
 namespace Titan {
+	//types of the effects that only read the pixel they're writing, these can be fused into a single shader pass
+	//a fused shader is cached on the types of the effects in it, in order, so the same type can appear in a run more than once
+	enum class TTN_FusedEffectType : uint32_t {
+		NONE = 0,
+		COLOR_CORRECT = 1
+	};
+
 	//base class for post processing effects
 	class TTN_PostEffect
 	{
@@ -25,14 +32,16 @@ namespace Titan {
 		//destructor, just calls unload
 		~TTN_PostEffect() { Unload(); }
 
-		//init effect (override in each derived class)
+		//init effect (override in each derived class), full screen effects get their targets from the render graph so this only sets up shaders
 		virtual void Init(unsigned width, unsigned height);
 
-		//applies effect
-		virtual void ApplyEffect(spostptr prevBuffer);
+		//applies effect, reading from the source and writing over every pixel of the target
+		virtual void ApplyEffect(const TTN_Framebuffer::sfboptr& source, const TTN_Framebuffer::sfboptr& target);
 
-		//renders the effect to the screen
-		virtual void DrawToScreen();
+		//draws a framebuffer to the screen with the passthrough shader
+		static void DrawToScreen(const TTN_Framebuffer::sfboptr& source);
+		//copies one framebuffer into another with the passthrough shader
+		static void Copy(const TTN_Framebuffer::sfboptr& source, const TTN_Framebuffer::sfboptr& target);
 
 		//reshapes buffer
 		virtual void Reshape(unsigned width, unsigned height);
@@ -56,13 +65,31 @@ namespace Titan {
 		void BindShader(int index);
 		void UnbindShader();
 
+		//gets the effect's fused type, effects that sample neighbouring pixels return NONE and always get their own pass
+		virtual TTN_FusedEffectType GetFusedType() const { return TTN_FusedEffectType::NONE; }
+		//gets how many texture slots the effect uses in a fused shader
+		virtual int GetFusedTextureCount() const { return 0; }
+		//gets the glsl for the fused shader, the uniforms the effect needs and a vec4 function called name that takes and returns the colour
+		//everything it declares should start with name so the same effect can be in the shader more than once, and it's textures use the slots from firstSlot on
+		virtual std::string GetFusedSource(const std::string& name, int firstSlot) const { return ""; }
+		//sets the effect's uniforms and binds it's textures on a fused shader
+		virtual void BindFused(const TTN_Shader::sshptr& shader, const std::string& name, int firstSlot) {}
+		//unbinds the effect's textures after a fused pass
+		virtual void UnbindFused(int firstSlot) {}
+
 		//get if the effect should be applied 
 		bool GetShouldApply() { return m_shouldRender; }
 		//set if the effect should be applied
 		void SetShouldApply(bool shouldApply) { m_shouldRender = shouldApply; }
 
 	protected:
-		//holds all our buffers for the effects
+		//loads the passthrough shader every effect shares if it hasn't been loaded yet
+		static void InitPassthrough();
+
+		//passthrough shader shared by every effect
+		inline static TTN_Shader::sshptr s_passthroughShader = nullptr;
+
+		//holds any buffers an effect needs to keep between frames, the output of the effect comes from the render graph instead
 		std::vector <TTN_Framebuffer::sfboptr> m_buffers;
 
 		//holds all our shaders for the effects
@@ -0,0 +1,144 @@
+//Titan Engine, by Atlas X Games 
+// Prefab.h - header for the class that represents a reusable set of components that can be stamped onto many entities at once
+#pragma once
+
+//precompile header, this file uses entt.hpp, functional, typeindex, and memory
+#include "ttn_pch.h"
+//include the transform, as every prefab instance gets one
+#include "Transform.h"
+
+namespace Titan {
+	//prefab class, stores a set of component templates that get stamped onto new entities in bulk
+	class TTN_Prefab {
+	public:
+		//defines a special easier to use name for shared(smart) pointers to the class
+		typedef std::shared_ptr<TTN_Prefab> sprefabptr;
+
+		//creates and returns a shared(smart) pointer to the class
+		static inline sprefabptr Create(std::string name = std::string()) {
+			return std::make_shared<TTN_Prefab>(name);
+		}
+
+		//function type for building a component for a single instance, gets the new entity and it's transform
+		template<typename T>
+		using Builder = std::function<T(entt::entity, const TTN_Transform&)>;
+
+	public:
+		//constructor
+		TTN_Prefab(std::string name = std::string());
+
+		//default destructor
+		~TTN_Prefab() = default;
+
+		//sets a component that will be copied onto every instance of the prefab
+		template<typename T>
+		void Add(const T& component);
+
+		//sets a function that will build a component for each instance, use this for components that own something that
+		//can't be shared between entities (physics bodies, particle systems, etc.)
+		template<typename T>
+		void AddBuilder(Builder<T> builder);
+
+		//removes a component from the prefab
+		template<typename T>
+		void Remove();
+
+		//returns true if the prefab has a given component
+		template<typename T>
+		bool Has() const;
+
+		//sets the transform used when instances aren't given one of their own
+		void SetTransform(const TTN_Transform& trans) { m_transform = trans; }
+		//gets the transform used when instances aren't given one of their own
+		const TTN_Transform& GetTransform() const { return m_transform; }
+
+		//gets the name of the prefab, every instance gets this as it's name
+		std::string GetName() const { return m_name; }
+
+		//stamps all the prefab's components onto a range of entities, the entities should already have their transforms
+		void Stamp(entt::registry& registry, const std::vector<entt::entity>& entities) const;
+
+	protected:
+		//base for the type erased component templates
+		struct TTN_ComponentTemplate {
+			virtual ~TTN_ComponentTemplate() = default;
+			virtual void Stamp(entt::registry& registry, const std::vector<entt::entity>& entities) const = 0;
+		};
+
+		//component template that copies the same value onto every instance with a single bulk insert
+		template<typename T>
+		struct TTN_CopyTemplate : TTN_ComponentTemplate {
+			T value;
+
+			TTN_CopyTemplate(const T& component) : value(component) {}
+
+			void Stamp(entt::registry& registry, const std::vector<entt::entity>& entities) const override {
+				registry.insert<T>(entities.begin(), entities.end(), value);
+			}
+		};
+
+		//component template that builds a new value for each instance
+		template<typename T>
+		struct TTN_BuilderTemplate : TTN_ComponentTemplate {
+			Builder<T> builder;
+
+			TTN_BuilderTemplate(Builder<T> build) : builder(build) {}
+
+			void Stamp(entt::registry& registry, const std::vector<entt::entity>& entities) const override {
+				for (auto entity : entities)
+					registry.emplace<T>(entity, builder(entity, registry.get<TTN_Transform>(entity)));
+			}
+		};
+
+		//name of the prefab
+		std::string m_name;
+		//transform for instances that aren't given one
+		TTN_Transform m_transform;
+		//the component templates, in the order they were added so builders can rely on earlier components
+		std::vector<std::pair<std::type_index, std::shared_ptr<TTN_ComponentTemplate>>> m_components;
+
+		//finds the index of a component template, -1 if the prefab doesn't have one
+		int Find(std::type_index type) const;
+	};
+
+	//adds a component that's copied onto every instance, replacing any template already set for that type
+	template<typename T>
+	inline void TTN_Prefab::Add(const T& component)
+	{
+		//the transform is always handled seperately
+		static_assert(!std::is_same_v<T, TTN_Transform>, "Use SetTransform to set a prefab's transform");
+
+		std::shared_ptr<TTN_ComponentTemplate> temp = std::make_shared<TTN_CopyTemplate<T>>(component);
+		int index = Find(std::type_index(typeid(T)));
+		if (index == -1) m_components.push_back(std::make_pair(std::type_index(typeid(T)), temp));
+		else m_components[index].second = temp;
+	}
+
+	//adds a component that's built for each instance, replacing any template already set for that type
+	template<typename T>
+	inline void TTN_Prefab::AddBuilder(Builder<T> builder)
+	{
+		//the transform is always handled seperately
+		static_assert(!std::is_same_v<T, TTN_Transform>, "Use SetTransform to set a prefab's transform");
+
+		std::shared_ptr<TTN_ComponentTemplate> temp = std::make_shared<TTN_BuilderTemplate<T>>(builder);
+		int index = Find(std::type_index(typeid(T)));
+		if (index == -1) m_components.push_back(std::make_pair(std::type_index(typeid(T)), temp));
+		else m_components[index].second = temp;
+	}
+
+	//removes a component template
+	template<typename T>
+	inline void TTN_Prefab::Remove()
+	{
+		int index = Find(std::type_index(typeid(T)));
+		if (index != -1) m_components.erase(m_components.begin() + index);
+	}
+
+	//checks if the prefab has a component template
+	template<typename T>
+	inline bool TTN_Prefab::Has() const
+	{
+		return Find(std::type_index(typeid(T))) != -1;
+	}
+}
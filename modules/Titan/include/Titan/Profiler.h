@@ -0,0 +1,219 @@
+//Titan Engine, by Atlas X Games
+// Profiler.h - header for the frame profiler that times scopes on the cpu and gpu and shows them as a timeline
+#pragma once
+
+//precompile header, this file uses vector, deque, array, atomic, mutex, string, and glad
+#include "ttn_pch.h"
+
+//the profiler is compiled in unless TTN_PROFILER_DISABLED is defined, then the macros compile to nothing
+#ifndef TTN_PROFILER_DISABLED
+#define TTN_PROFILER_ENABLED
+#endif
+
+#ifdef TTN_PROFILER_ENABLED
+#define TTN_PROFILE_CONCAT_INNER(a, b) a##b
+#define TTN_PROFILE_CONCAT(a, b) TTN_PROFILE_CONCAT_INNER(a, b)
+//times the rest of the scope on the cpu, the name has to be a string literal (or otherwise live for the whole program)
+#define TTN_PROFILE_SCOPE(name) Titan::TTN_ProfileScope TTN_PROFILE_CONCAT(ttnProfileScope, __LINE__)(name)
+//times the rest of the scope on the gpu, only use it on the thread with the opengl context
+#define TTN_PROFILE_GPU_SCOPE(name) Titan::TTN_GPUProfileScope TTN_PROFILE_CONCAT(ttnGPUProfileScope, __LINE__)(name)
+#else
+#define TTN_PROFILE_SCOPE(name)
+#define TTN_PROFILE_GPU_SCOPE(name)
+#endif
+
+namespace Titan {
+	//a single timed scope
+	struct TTN_ProfileEvent {
+		//the name of the scope
+		const char* Name = nullptr;
+		//start and end in nanoseconds since the profiler started
+		uint64_t Start = 0;
+		uint64_t End = 0;
+		//how many scopes it's nested inside of
+		uint32_t Depth = 0;
+		//the track it's on, the thread it ran on for cpu scopes or TTN_Profiler::s_gpuTrack for gpu scopes
+		uint32_t Track = 0;
+	};
+
+	//everything recorded during one frame
+	struct TTN_ProfileFrame {
+		//the frame's number
+		uint64_t Index = 0;
+		//start and end in nanoseconds since the profiler started
+		uint64_t Start = 0;
+		uint64_t End = 0;
+		//every scope that finished during the frame, gpu scopes get added a few frames later once their queries are ready
+		std::vector<TTN_ProfileEvent> Events;
+	};
+
+	//static profiler class, every thread writes it's scopes into it's own ring buffer without locking and the main thread collects them at the end of each frame
+	class TTN_Profiler {
+	public:
+		//the track gpu scopes are put on
+		static const uint32_t s_gpuTrack = 0xFFFFFFFF;
+		//how many frames are kept
+		static const size_t s_historySize = 300;
+
+		//starts a new frame, call on the main thread before anything is timed
+		static void BeginFrame();
+		//ends the frame, collecting every thread's scopes and any gpu timings that are ready
+		static void EndFrame();
+
+		//sets wheter or not scopes are recorded, turning it off leaves only a check of this flag in each scope
+		static void SetEnabled(bool enabled) { s_enabled.store(enabled, std::memory_order_relaxed); }
+		//gets wheter or not scopes are recorded
+		static bool GetEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+		//sets wheter or not new frames are added to the history, so a frame can be looked at without it scrolling away
+		static void SetPaused(bool paused) { s_paused = paused; }
+		//gets wheter or not the history is paused
+		static bool GetPaused() { return s_paused; }
+		//sets wheter or not gpu scopes are timed, has to be off when there's no opengl context
+		static void SetGPUTiming(bool timing) { s_gpuTiming = timing; }
+		//gets wheter or not gpu scopes are timed
+		static bool GetGPUTiming() { return s_gpuTiming; }
+
+		//names the calling thread on the timeline
+		static void SetThreadName(const std::string& name);
+
+		//gets the frames in the history, oldest first
+		static const std::deque<TTN_ProfileFrame>& GetFrames() { return s_frames; }
+		//gets the number of scopes that were dropped because a thread's ring buffer was full
+		static size_t GetDroppedCount() { return s_dropped.load(std::memory_order_relaxed); }
+
+		//writes every frame in the history as a chrome trace json file, which can be opened in perfetto or chrome://tracing
+		static bool ExportChromeTrace(const std::string& path);
+
+		//draws the profiler window, with the frame times, a timeline of the selected frame, and it's flame graph
+		static void DrawImGui(bool* open = nullptr);
+
+		//records a finished cpu scope on the calling thread, used by TTN_ProfileScope
+		static void RecordEvent(const char* name, uint64_t start, uint64_t end, uint32_t depth);
+		//starts and ends a gpu scope, used by TTN_GPUProfileScope
+		static int BeginGPUEvent(const char* name);
+		static void EndGPUEvent(int event);
+
+		//gets the time in nanoseconds since the profiler started
+		static uint64_t Now();
+
+		//gets the name of the innermost cpu scope the calling thread is in, nullptr if it's not in one
+		static const char* GetCurrentScope() { return t_scope; }
+
+	protected:
+		friend class TTN_ProfileScope;
+
+		//most scopes a thread can record in a frame before they start getting dropped
+		static const size_t s_ringSize = 8192;
+
+		//a thread's scopes, written by that thread and read by the main thread
+		struct TTN_ProfileRing {
+			std::array<TTN_ProfileEvent, s_ringSize> Events;
+			//the writer only moves the head and the reader only moves the tail
+			std::atomic<size_t> Head = 0;
+			std::atomic<size_t> Tail = 0;
+			uint32_t Track = 0;
+			std::string Name;
+		};
+
+		//a gpu scope waiting on it's timestamp queries
+		struct TTN_GPUEvent {
+			const char* Name = nullptr;
+			GLuint StartQuery = 0;
+			GLuint EndQuery = 0;
+			uint32_t Depth = 0;
+			uint64_t Frame = 0;
+			//the cpu time and gpu timestamp at the start of the frame, used to put the gpu scope on the cpu's clock
+			uint64_t CpuBase = 0;
+			int64_t GpuBase = 0;
+		};
+
+		//gets the calling thread's ring, making it the first time the thread records something
+		static TTN_ProfileRing* GetThreadRing();
+		//moves any finished gpu scopes into their frames
+		static void ReadGPUEvents();
+		//gets a frame in the history by it's number, nullptr if it's not in the history anymore
+		static TTN_ProfileFrame* FindFrame(uint64_t index);
+		//gets the name shown for a track
+		static std::string GetTrackName(uint32_t track);
+
+		inline static std::atomic<bool> s_enabled = true;
+		inline static bool s_paused = false;
+		inline static bool s_gpuTiming = true;
+		inline static std::atomic<size_t> s_dropped = 0;
+
+		//every thread's ring, they're never removed so the pointers threads keep to them stay valid
+		inline static std::mutex s_ringLock;
+		inline static std::vector<std::unique_ptr<TTN_ProfileRing>> s_rings;
+		//the calling thread's ring and how many cpu scopes it's currently inside
+		inline static thread_local TTN_ProfileRing* t_ring = nullptr;
+		inline static thread_local uint32_t t_depth = 0;
+		inline static thread_local const char* t_scope = nullptr;
+
+		//the frame being recorded and the history
+		inline static TTN_ProfileFrame s_currentFrame;
+		inline static std::deque<TTN_ProfileFrame> s_frames;
+		inline static uint64_t s_frameCount = 0;
+		//the main thread's track, frames are shown on it in exported traces
+		inline static uint32_t s_mainTrack = 0;
+
+		//gpu scopes waiting on their queries, and the queries that can be reused
+		inline static std::deque<TTN_GPUEvent> s_gpuEvents;
+		inline static std::vector<GLuint> s_freeQueries;
+		inline static uint32_t s_gpuDepth = 0;
+		inline static uint64_t s_gpuFrameCpuBase = 0;
+		inline static int64_t s_gpuFrameGpuBase = 0;
+
+		//the frame picked in the window, -1 follows the newest frame, and the file traces are exported to
+		inline static int s_selectedFrame = -1;
+		inline static char s_exportPath[256] = "profile.json";
+	};
+
+	//times the scope it's made in on the cpu, use TTN_PROFILE_SCOPE instead of making these directly
+	class TTN_ProfileScope {
+	public:
+		//starts the timer
+		TTN_ProfileScope(const char* name) : m_name(TTN_Profiler::GetEnabled() ? name : nullptr) {
+			if (m_name == nullptr) return;
+			m_depth = TTN_Profiler::t_depth++;
+			m_parent = TTN_Profiler::t_scope;
+			TTN_Profiler::t_scope = m_name;
+			m_start = TTN_Profiler::Now();
+		}
+		//stops the timer and records the scope
+		~TTN_ProfileScope() {
+			if (m_name == nullptr) return;
+			TTN_Profiler::t_depth--;
+			TTN_Profiler::t_scope = m_parent;
+			TTN_Profiler::RecordEvent(m_name, m_start, TTN_Profiler::Now(), m_depth);
+		}
+
+		//copying would record the scope twice
+		TTN_ProfileScope(const TTN_ProfileScope&) = delete;
+		TTN_ProfileScope& operator=(const TTN_ProfileScope&) = delete;
+
+	private:
+		//name is nullptr if the profiler was off when the scope started
+		const char* m_name;
+		//the scope it's nested inside of
+		const char* m_parent = nullptr;
+		uint64_t m_start = 0;
+		uint32_t m_depth = 0;
+	};
+
+	//times the scope it's made in on the gpu with timestamp queries, use TTN_PROFILE_GPU_SCOPE instead of making these directly
+	class TTN_GPUProfileScope {
+	public:
+		//writes the start timestamp
+		TTN_GPUProfileScope(const char* name) : m_event(TTN_Profiler::BeginGPUEvent(name)) {}
+		//writes the end timestamp
+		~TTN_GPUProfileScope() { TTN_Profiler::EndGPUEvent(m_event); }
+
+		//copying would end the scope twice
+		TTN_GPUProfileScope(const TTN_GPUProfileScope&) = delete;
+		TTN_GPUProfileScope& operator=(const TTN_GPUProfileScope&) = delete;
+
+	private:
+		//the waiting gpu scope, -1 if the profiler was off when the scope started
+		int m_event;
+	};
+}
@@ -2,6 +2,9 @@
 // Random.h - header for the class that gives static templates for random number generation
 #pragma once
 
+//precompile header, this file uses random and cstdint
+#include "ttn_pch.h"
+
 namespace Titan {
 	class TTN_Random {
 	public:
@@ -11,8 +14,14 @@ namespace Titan {
 		//generates a pseudo-random float between a min and max value
 		static float RandomFloat(float min, float max);
 
+		//seeds the generator, and c's rand() that the game code uses, so a run can be repeated exactly
+		static void SetSeed(uint32_t seed);
+		//gets the last seed the generator was given
+		static uint32_t GetSeed() { return s_seed; }
+
 	private:
-		//boolean for checking if it needs to set the seed
-		inline static bool firstCall = false;
+		//the generator, it's the same on every platform unlike rand()
+		inline static uint32_t s_seed = 5489u;
+		inline static std::mt19937 s_engine = std::mt19937(5489u);
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,97 @@
+//Titan Engine, by Atlas X Games
+// RenderCommands.h - header for the list of draws a scene records before they're submitted to openGL
+#pragma once
+
+//precompile header, this file uses vector, memory, entt.hpp, and glm
+#include "ttn_pch.h"
+//include the mesh, shader, and material the draws use
+#include "Mesh.h"
+#include "Shader.h"
+#include "Material.h"
+
+namespace Titan {
+	//one object's draw, everything needed to draw it without going back to the registry
+	//it's plain data, the mesh, shader, and material are indices into it's list's tables so copying and clearing packets never touches a reference count
+	struct TTN_DrawPacket {
+		//the entity it was recorded from
+		entt::entity Entity = entt::null;
+		//where the level of detail being drawn, the shader, and the material are in the list's tables
+		uint32_t Mesh = 0;
+		uint32_t Shader = 0;
+		uint32_t Material = 0;
+		//the object's global transform
+		glm::mat4 Model = glm::mat4(1.0f);
+
+		//wheter or not it uses one of the morph animation shaders, and if it can join an instanced batch
+		bool Morph = false;
+		bool Instanced = false;
+		//the morph frames it's blending between and how far along it is, the first frame if it has no animator
+		int CurrentFrame = 0;
+		int NextFrame = 0;
+		float T = 0.0f;
+	};
+
+	//the camera and target a list of draws was recorded for, and the scene's lighting at the time, so drawing the list doesn't read the scene
+	struct TTN_RenderView {
+		glm::mat4 View = glm::mat4(1.0f);
+		glm::mat4 Projection = glm::mat4(1.0f);
+		glm::mat4 ViewProjection = glm::mat4(1.0f);
+		glm::vec3 CameraPosition = glm::vec3(0.0f);
+		//the size of the target being drawn to
+		glm::uvec2 TargetSize = glm::uvec2(1);
+
+		//the scene's ambient light
+		glm::vec3 AmbientColor = glm::vec3(1.0f);
+		float AmbientStrength = 0.0f;
+		//the directional light, and wheter or not it's shadows were drawn
+		glm::vec3 SunDirection = glm::vec3(0.0f, -1.0f, 0.0f);
+		glm::vec3 SunColor = glm::vec3(1.0f);
+		float SunStrength = 0.0f;
+		bool SunShadows = false;
+	};
+
+	//a frame's worth of draws, the packets are written one after another into memory that's kept between frames so recording doesn't allocate once it's warmed up
+	//a list is self-contained, it holds references to every mesh, shader, and material it draws, so it stays valid after the entities it came from change or are destroyed
+	//recording never touches openGL, so a scene's draws can be recorded and checked without a gpu
+	class TTN_RenderCommandList {
+	public:
+		//defines a special easier to use name for shared(smart) pointers to the class
+		typedef std::shared_ptr<TTN_RenderCommandList> scmdlistptr;
+
+		//creates a new shared(smart) pointer to the class and returns it
+		static inline scmdlistptr Create() {
+			return std::make_shared<TTN_RenderCommandList>();
+		}
+
+		//default constructor
+		TTN_RenderCommandList() = default;
+		//default destructor
+		~TTN_RenderCommandList() = default;
+
+		//starts a new recording for a view, throwing out the old packets but keeping their memory
+		void Begin(const TTN_RenderView& view);
+		//adds a packet for a mesh, shader, and material to the end of the list and returns it to be filled in
+		//the render group's sorted by shader and material, so the tables only grow when they change from the last packet
+		TTN_DrawPacket& AddDraw(const TTN_Mesh::smptr& mesh, const TTN_Shader::sshptr& shader, const TTN_Material::smatptr& material);
+
+		//gets the view the list was recorded for
+		const TTN_RenderView& GetView() const { return m_view; }
+		//gets the recorded packets, in the order they'll be drawn
+		const std::vector<TTN_DrawPacket>& GetDraws() const { return m_draws; }
+		//gets the number of recorded packets
+		size_t GetDrawCount() const { return m_draws.size(); }
+		//gets a packet's mesh, shader, and material, the material can be nullptr
+		TTN_Mesh* GetMesh(const TTN_DrawPacket& packet) const { return m_meshes[packet.Mesh].get(); }
+		TTN_Shader* GetShader(const TTN_DrawPacket& packet) const { return m_shaders[packet.Shader].get(); }
+		TTN_Material* GetMaterial(const TTN_DrawPacket& packet) const { return m_materials[packet.Material].get(); }
+
+	private:
+		TTN_RenderView m_view;
+		//the packets, cleared between recordings without giving back their capacity
+		std::vector<TTN_DrawPacket> m_draws;
+		//the meshes, shaders, and materials the packets use, holding them keeps them alive for as long as the list is
+		std::vector<TTN_Mesh::smptr> m_meshes;
+		std::vector<TTN_Shader::sshptr> m_shaders;
+		std::vector<TTN_Material::smatptr> m_materials;
+	};
+}
@@ -0,0 +1,90 @@
+//Titan Engine by Atlas X Games
+//RenderGraph.h - Header for the classes that schedule full screen passes and share the render targets between them
+#pragma once
+
+//include the precompile header, this file uses functional and unordered_map
+#include "ttn_pch.h"
+//include the graphics features needed
+#include "Framebuffer.h"
+
+namespace Titan {
+	//static pool of colour only render targets, passes borrow targets from here for as long as their output is needed
+	class TTN_RenderTargetPool {
+	public:
+		//gets a free target of the given size and format, creating a new one if there isn't one
+		static TTN_Framebuffer::sfboptr Acquire(unsigned width, unsigned height, GLenum format = GL_RGBA8);
+		//gives a target back to the pool so another pass can use it
+		static void Release(const TTN_Framebuffer::sfboptr& target);
+
+		//deletes all the targets that aren't in use, call after the window changes size so the old sizes don't stick around
+		static void Trim();
+		//deletes every target in the pool
+		static void Clear();
+
+		//gets the number of targets the pool has created
+		static size_t GetTargetCount() { return s_targets.size(); }
+		//gets the number of targets currently in use
+		static size_t GetActiveCount();
+
+	private:
+		//a target and the data used to match it
+		struct TTN_PooledTarget {
+			TTN_Framebuffer::sfboptr target;
+			GLenum format;
+			bool inUse;
+		};
+
+		//all the targets the pool owns
+		inline static std::vector<TTN_PooledTarget> s_targets;
+	};
+
+	//render graph class, passes declare what they read and write, passes that nothing reads are culled, and targets get reused once the last pass reading them is done
+	class TTN_RenderGraph {
+	public:
+		//the function a pass runs, gets the targets for it's inputs and the target it should write into
+		typedef std::function<void(const std::vector<TTN_Framebuffer::sfboptr>&, const TTN_Framebuffer::sfboptr&)> PassFunction;
+
+	public:
+		//default constructor
+		TTN_RenderGraph() = default;
+		//default destructor
+		~TTN_RenderGraph() = default;
+
+		//adds a target that lives outside the graph (like the scene's main target) so passes can read it
+		void ImportTarget(const std::string& name, const TTN_Framebuffer::sfboptr& target);
+
+		//adds a pass, clearOutput should only be set for passes that don't write every pixel of their target
+		void AddPass(const std::string& name, const std::vector<std::string>& inputs, const std::string& output, PassFunction function,
+			bool clearOutput = false, GLenum format = GL_RGBA8);
+
+		//culls the passes the result doesn't depend on, runs the rest, and returns the target holding the result
+		//the returned target stays valid until the next graph executes
+		TTN_Framebuffer::sfboptr Execute(const std::string& result, unsigned width, unsigned height);
+
+		//removes all the passes and imported targets so the graph can be built again for the next frame
+		void Reset();
+
+		//gets the number of passes that have been added
+		size_t GetPassCount() const { return m_passes.size(); }
+		//gets the number of passes that ran the last time the graph executed
+		size_t GetExecutedPassCount() const { return m_executedPasses; }
+
+	protected:
+		//a single pass in the graph
+		struct TTN_RenderPass {
+			std::string name;
+			std::vector<std::string> inputs;
+			std::string output;
+			PassFunction function;
+			bool clearOutput;
+			GLenum format;
+		};
+
+		//the passes in the order they were added
+		std::vector<TTN_RenderPass> m_passes;
+		//targets from outside the graph
+		std::unordered_map<std::string, TTN_Framebuffer::sfboptr> m_imported;
+		//number of passes that ran last time
+		size_t m_executedPasses = 0;
+	};
+}
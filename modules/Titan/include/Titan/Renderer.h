@@ -34,17 +34,37 @@ namespace Titan {
 		void SetMat(TTN_Material::smatptr mat);
 		//sets the renderlayer
 		void SetRenderLayer(int renderLayer);
+		//sets wheter or not the object is drawn into the scene's shadow map
+		void SetCastShadows(bool castShadows) { m_castShadows = castShadows; }
+		//marks the object as never moving, static objects are culled through a tree that's only rebuilt when static objects are added or removed
+		void SetStatic(bool isStatic) { m_static = isStatic; }
 
 		//gets the mesh
 		const TTN_Mesh::smptr GetMesh() const { return m_mesh; }
 		//gets the shader
-		const TTN_Shader::sshptr GetShader() const { return m_Shader;  }
+		const TTN_Shader::sshptr& GetShader() const { return m_Shader;  }
 		//gets the material 
-		const TTN_Material::smatptr GetMat() const { return m_Mat; }
+		const TTN_Material::smatptr& GetMat() const { return m_Mat; }
 		//gets the render layer
 		const int GetRenderLayer() const { return m_RenderLayer; }
+		//gets wheter or not the object is drawn into the scene's shadow map
+		bool GetCastShadows() const { return m_castShadows; }
+		//gets wheter or not the object is marked as never moving
+		bool GetStatic() const { return m_static; }
+
+		//picks the mesh's level of detail from how much of the screen's height the object covers
+		void UpdateLOD(float screenSize);
+		//gets the level of detail being drawn, 0 is the full mesh
+		int GetLODLevel() const { return m_lodLevel; }
+		//gets the mesh for the level of detail being drawn
+		const TTN_Mesh::smptr& GetActiveMesh() const { return (m_lodLevel == 0) ? m_mesh : m_mesh->GetLOD(m_lodLevel); }
+
+		//how far past a level's screen size an object has to go before it switches, as a fraction of the size, so objects don't flicker between levels
+		inline static float s_lodHysteresis = 0.1f;
 
 		void Render(glm::mat4 model, glm::mat4 VP);
+		//draws a mesh with a shader, setting the default shaders' transform uniforms, used for draws that were recorded ahead of time
+		static void Render(TTN_Mesh* mesh, TTN_Shader* shader, const glm::mat4& model, const glm::mat4& VP);
 
 	private:
 		//a pointer to the shader that should be used to render this object
@@ -55,5 +75,11 @@ namespace Titan {
 		TTN_Material::smatptr m_Mat;
 		//the render layer, to help control the order things should render
 		int m_RenderLayer;
+		//wheter or not the object casts shadows
+		bool m_castShadows = true;
+		//wheter or not the object never moves
+		bool m_static = false;
+		//the level of detail being drawn
+		int m_lodLevel = 0;
 	};
 }
\ No newline at end of file
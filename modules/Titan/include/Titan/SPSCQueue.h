@@ -0,0 +1,62 @@
+//Titan Engine, by Atlas X Games
+// SPSCQueue.h - header for the fixed size lock-free queue between one producer thread and one consumer thread
+#pragma once
+
+//precompile header, this file uses array and atomic
+#include "ttn_pch.h"
+
+namespace Titan {
+	//fixed size ring buffer queue, one thread pushes and one thread pops without either ever locking
+	//the size has to be a power of two, one slot is always left empty to tell a full queue from an empty one
+	template<typename T, size_t Size>
+	class TTN_SPSCQueue {
+		static_assert(Size >= 2 && (Size & (Size - 1)) == 0, "TTN_SPSCQueue's size has to be a power of two");
+
+	public:
+		//default constructor
+		TTN_SPSCQueue() = default;
+		//default destructor
+		~TTN_SPSCQueue() = default;
+
+		//the atomics can't be copied or moved
+		TTN_SPSCQueue(const TTN_SPSCQueue&) = delete;
+		TTN_SPSCQueue& operator=(const TTN_SPSCQueue&) = delete;
+
+		//adds an item, only call from the producer thread, returns false if the queue is full
+		bool Push(const T& item) {
+			size_t head = m_head.load(std::memory_order_relaxed);
+			size_t next = (head + 1) & (Size - 1);
+			if (next == m_tail.load(std::memory_order_acquire)) return false;
+
+			m_items[head] = item;
+			m_head.store(next, std::memory_order_release);
+			return true;
+		}
+
+		//gets the oldest item without removing it, only call from the consumer thread, returns nullptr if the queue is empty
+		const T* Peek() const {
+			size_t tail = m_tail.load(std::memory_order_relaxed);
+			if (tail == m_head.load(std::memory_order_acquire)) return nullptr;
+			return &m_items[tail];
+		}
+
+		//removes the oldest item, only call from the consumer thread, returns false if the queue is empty
+		bool Pop(T& item) {
+			const T* front = Peek();
+			if (front == nullptr) return false;
+
+			item = *front;
+			m_tail.store((m_tail.load(std::memory_order_relaxed) + 1) & (Size - 1), std::memory_order_release);
+			return true;
+		}
+
+		//gets wheter or not the queue is empty, only exact on the consumer thread
+		bool Empty() const { return m_tail.load(std::memory_order_acquire) == m_head.load(std::memory_order_acquire); }
+
+	private:
+		std::array<T, Size> m_items;
+		//the producer only moves the head and the consumer only moves the tail, kept on seperate cache lines so they don't fight over one
+		alignas(64) std::atomic<size_t> m_head = 0;
+		alignas(64) std::atomic<size_t> m_tail = 0;
+	};
+}
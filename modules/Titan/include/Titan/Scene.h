@@ -16,9 +16,21 @@
 #include "Physics.h"
 #include "MAnimator.h"
 #include "Particle.h"
+#include "Prefab.h"
+#include "EntityPool.h"
+#include "JobSystem.h"
 //include all the graphics features we need
 #include "Shader.h"
 #include "ColorCorrect.h"
+#include "RenderGraph.h"
+#include "UberPost.h"
+#include "LightClusters.h"
+#include "ShadowMap.h"
+#include "FrustumCuller.h"
+#include "RenderCommands.h"
+#include "SpriteBatcher.h"
+#include "Profiler.h"
+#include "FrameArena.h"
 //include ImGui stuff
 #define IMGUI_IMPL_OPENGL_LOADER_GLAD
 #include "imgui.h"
@@ -26,7 +38,7 @@
 #include "imgui_impl_opengl3.h"
 
 namespace Titan {
-	typedef entt::basic_group<entt::entity, entt::exclude_t<>, entt::get_t<>, TTN_Transform, TTN_Renderer> RenderGroupType;
+	typedef entt::basic_group<entt::entity, entt::exclude_t<TTN_Inactive>, entt::get_t<>, TTN_Transform, TTN_Renderer> RenderGroupType;
 
 	//scene class, handles the ECS, render class, etc. 
 	class TTN_Scene
@@ -43,8 +55,8 @@ namespace Titan {
 		TTN_Scene(TTN_Scene&&) = default;
 		TTN_Scene& operator=(TTN_Scene&) = default;
 
-		//destrutor 
-		~TTN_Scene();
+		//destrutor, virtual as the application deletes it's scenes through base class pointers
+		virtual ~TTN_Scene();
 
 #pragma region ECS_functions_dec
 		//creates a new entity 
@@ -52,8 +64,33 @@ namespace Titan {
 		//creates a new entity with a limit lifetime
 		entt::entity CreateEntity(float lifeTime, std::string name = "");
 
+		//creates a number of new entities from a prefab in one go, transforms can be given for each instance, otherwise the prefab's transform is used
+		std::vector<entt::entity> Instantiate(const TTN_Prefab::sprefabptr& prefab, size_t count = 1,
+			const std::vector<TTN_Transform>& transforms = std::vector<TTN_Transform>());
+
 		//deletes an entity
 		void DeleteEntity(entt::entity entity);
+		//queues an entity to be deleted at the end of the frame, much cheaper than DeleteEntity when deleting a lot of entities
+		void QueueDestroy(entt::entity entity);
+		//deletes all the queued entities at once, called by the application at the end of every frame
+		void FlushDestroyQueue();
+
+		//switches an entity on or off, switched off entities stay in the registry but are skipped by rendering, physics, etc.
+		void SetActive(entt::entity entity, bool active);
+		//switches a group of entities on or off
+		void SetActive(const std::vector<entt::entity>& entities, bool active);
+		//returns true if the entity is switched on
+		bool GetActive(entt::entity entity);
+		//queues an entity to be switched on or off at the start of the next update or the end of the frame, whichever comes first
+		//switching entities on and off shuffles entt, so queueing them means the scenegraph only has to be reconstructed once for all of them
+		void QueueSetActive(entt::entity entity, bool active);
+		//makes room in the queue for count more entities, pools call it as they grow so acquiring and releasing never allocates
+		void ReserveActiveQueue(size_t count) { m_ActiveQueue.reserve(m_ActiveQueue.capacity() + count); }
+
+		//creates a pool of reusable entities from a prefab
+		TTN_EntityPool::spoolptr CreatePool(TTN_Prefab::sprefabptr prefab, size_t initialSize);
+		//gets all of the scene's entity pools
+		const std::vector<TTN_EntityPool::spoolptr>& GetPools() { return m_Pools; }
 
 		//attaches a compontent to an entity 
 		template<typename T>
@@ -121,6 +158,50 @@ namespace Titan {
 		//gets the strength of the ambient lighting in the scene
 		float GetSceneAmbientLightStrength();
 
+		//sets the direction the scene's directional light shines in
+		void SetSunDirection(glm::vec3 direction) { m_sunDirection = direction; }
+		//sets the colour of the scene's directional light
+		void SetSunColor(glm::vec3 color) { m_sunColor = color; }
+		//sets the strength of the scene's directional light, 0 turns it and it's shadows off
+		void SetSunStrength(float strength) { m_sunStrength = strength; }
+		//sets wheter or not the directional light casts shadows
+		void SetSunCastShadows(bool castShadows) { m_sunCastShadows = castShadows; }
+
+		//gets the direction the scene's directional light shines in
+		glm::vec3 GetSunDirection() { return m_sunDirection; }
+		//gets the colour of the scene's directional light
+		glm::vec3 GetSunColor() { return m_sunColor; }
+		//gets the strength of the scene's directional light
+		float GetSunStrength() { return m_sunStrength; }
+		//gets wheter or not the directional light casts shadows
+		bool GetSunCastShadows() { return m_sunCastShadows; }
+		//gets the directional light's shadow map, for changing it's settings and reading it's timings
+		TTN_ShadowMap& GetShadowMap() { return m_shadowMap; }
+
+		//sets wheter or not objects outside the camera's view are skipped when rendering
+		void SetFrustumCulling(bool cull) { m_frustumCulling = cull; }
+		//gets wheter or not objects outside the camera's view are skipped when rendering
+		bool GetFrustumCulling() { return m_frustumCulling; }
+		//gets the number of objects that were drawn last frame
+		size_t GetVisibleCount() { return m_culler.GetVisibleCount(); }
+		//gets the number of objects that were skipped for being outside the camera's view last frame
+		size_t GetCulledCount() { return m_culler.GetCulledCount(); }
+		//gets the number of triangles the render group drew last frame, after culling and level of detail
+		size_t GetTrianglesDrawn() { return m_trianglesDrawn; }
+		//sets wheter or not morph animated objects that share a mesh, shader, and material are drawn together in one instanced draw
+		void SetInstancedMorphs(bool instanced) { m_instancedMorphs = instanced; }
+		//gets wheter or not morph animated objects are drawn instanced
+		bool GetInstancedMorphs() { return m_instancedMorphs; }
+		//gets the number of instanced draws the morph animated objects took last frame
+		size_t GetMorphDrawCalls() { return m_morphDrawCalls; }
+		//gets the number of morph animated objects drawn instanced last frame
+		size_t GetMorphInstancesDrawn() { return m_morphInstancesDrawn; }
+		//gets the number of draws the 2D sprites took last frame
+		size_t GetSpriteDrawCalls() { return m_spriteDrawCalls; }
+		//gets the draws the render group recorded in the last call to render, in the order they were drawn
+		//headless scenes still record them, so what a scene draws can be checked without a gpu
+		const TTN_RenderCommandList& GetRenderCommands() const { return m_renderCommands[m_renderCommandIndex]; }
+
 #pragma endregion Graphics_functions_dec
 
 		//sets the camera entity reference
@@ -135,7 +216,19 @@ namespace Titan {
 		glm::vec3 GetGravity();
 
 		//gets all the collisions for the frame
-		std::vector<TTN_Collision::scolptr> GetCollisions() { return collisions; }
+		const std::vector<TTN_Collision::scolptr>& GetCollisions() { return collisions; }
+
+		//spatial queries, these walk bullet's broadphase tree so they only test bodies near the query
+		//casts a ray from one point to another, returns true and fills in the closest hit if it hit anything
+		bool Raycast(glm::vec3 from, glm::vec3 to, TTN_RaycastHit& hit);
+		//gets all the entities whose physics bodies overlap a sphere
+		std::vector<entt::entity> SphereOverlap(glm::vec3 center, float radius);
+		//gets all the entities whose physics bodies overlap an axis aligned box
+		std::vector<entt::entity> BoxOverlap(glm::vec3 center, glm::vec3 halfExtents);
+		//sweeps a sphere from one point to another, returns true and fills in the closest hit if it hit anything
+		bool SweepSphere(glm::vec3 from, glm::vec3 to, float radius, TTN_RaycastHit& hit);
+		//runs a batch of queries, splitting them across worker threads, results are in the same order as the queries
+		std::vector<TTN_QueryResult> BatchQuery(const std::vector<TTN_SpatialQuery>& queries);
 
 		//set wheter or not the scene is paused
 		void SetPaused(bool paused) { m_Paused = paused; }
@@ -143,12 +236,27 @@ namespace Titan {
 		//get wheter or not the scene is paused
 		bool GetPaused() { return m_Paused; }
 
+		//sets the fraction of the window size the scene is rendered at, the final post processing pass scales it back up to the window
+		void SetResolutionScale(float scale) { m_resolutionScale = std::clamp(scale, m_minResolutionScale, m_maxResolutionScale); }
+		//gets the fraction of the window size the scene is rendered at
+		float GetResolutionScale() { return m_resolutionScale; }
+
+		//turns on or off the controller that changes the resolution scale to try to hold a target frame time (in seconds)
+		void SetAutoResolutionScale(bool autoScale, float targetFrameTime = 1.0f / 60.0f, float minScale = 0.5f, float maxScale = 1.0f);
+		//gets wheter or not the resolution scale is being controlled automatically
+		bool GetAutoResolutionScale() { return m_autoResolutionScale; }
+
 	protected:
 		//vector to store the entities of the lights
 		std::vector<entt::entity> m_Lights;
 
 		//vector to store the post processing effects
 		std::vector<TTN_PostEffect::spostptr> m_PostProcessingEffects;
+
+		//binds the clustered light buffers and sets the uniforms for them on a shader, for custom shaders that want the scene's lights
+		void SetClusteredLightingUniforms(const TTN_Shader::sshptr& shader);
+		//binds the shadow atlas and sets the sun and shadow uniforms on a shader, for custom shaders that want the scene's directional light
+		void SetSunLightingUniforms(const TTN_Shader::sshptr& shader);
 	private:
 		//name of the scene
 		std::string m_sceneName;
@@ -173,6 +281,57 @@ namespace Titan {
 		//the strenght of that ambient color
 		float m_AmbientStrength;
 
+		//the scene's directional light, off until it's given a strength
+		glm::vec3 m_sunDirection = glm::vec3(-0.3f, -1.0f, 0.4f);
+		glm::vec3 m_sunColor = glm::vec3(1.0f);
+		float m_sunStrength = 0.0f;
+		bool m_sunCastShadows = true;
+		//cascaded shadow map for the directional light
+		TTN_ShadowMap m_shadowMap;
+		//culls the render group against the camera
+		TTN_FrustumCuller m_culler;
+		bool m_frustumCulling = true;
+		//triangles drawn by the render group last frame
+		size_t m_trianglesDrawn = 0;
+
+		//a morph animated object in an instanced draw, matches the MorphInstance struct in the morph animation shaders
+		struct TTN_MorphInstance {
+			glm::mat4 Model;
+			glm::mat4 NormalMat;
+			//current frame, next frame, interpolation parameter, index in the material buffer
+			glm::vec4 Frames;
+		};
+		//the shader storage buffer binding the instances are bound to
+		static const GLuint s_morphInstanceBinding = 4;
+		//the batch of morph animated objects waiting to be drawn, and the mesh, shader, and material (or with the material buffer, the textures) they all share
+		std::vector<TTN_MorphInstance> m_morphBatch;
+		TTN_Mesh* m_morphBatchMesh = nullptr;
+		TTN_Shader* m_morphBatchShader = nullptr;
+		TTN_Material* m_morphBatchMat = nullptr;
+		TTN_ShaderStorageBuffer::sssboptr m_morphInstanceBuffer = nullptr;
+		bool m_instancedMorphs = true;
+		size_t m_morphDrawCalls = 0;
+		size_t m_morphInstancesDrawn = 0;
+		size_t m_spriteDrawCalls = 0;
+		//the render group's draws, double buffered so a frame's list can still be drawn while the next frame's is recorded
+		//the lists are self-contained, but openGL is still only used from the main thread, so for now each frame's list is drawn right after it's recorded
+		TTN_RenderCommandList m_renderCommands[2];
+		int m_renderCommandIndex = 0;
+		//records the visible objects in the render group into the list that isn't the latest one, and makes it the latest, without touching openGL
+		void RecordRenderGroup(const TTN_RenderView& view);
+		//draws a recorded command list, it only reads the list and the scene's gpu objects (the light clusters, shadow map, and morph batch), never the registry
+		void SubmitRenderGroup(const TTN_RenderCommandList& commands);
+		//draws the waiting batch of morph animated objects in one instanced draw
+		void FlushMorphBatch(const glm::mat4& viewProj);
+		//adds every object in the render group to the culler, in the order they'll be drawn, and culls them
+		void CullRenderGroup(const glm::mat4& viewProj);
+		//draws the shadow casters in the render group into the shadow map
+		void RenderShadows(const glm::mat4& view, const glm::mat4& projection);
+		//sets the directional light and shadow uniforms on one of the default shaders, from the lighting a view was recorded with
+		void SetSunUniforms(TTN_Shader* shader, const TTN_RenderView& view);
+		//gets a view with the scene's current lighting, the camera parts are left for the caller
+		TTN_RenderView GetLightingView() const;
+
 		//physics world properties
 		btDefaultCollisionConfiguration* collisionConfig;
 		btCollisionDispatcher* dispatcher;
@@ -181,92 +340,53 @@ namespace Titan {
 		//physics world
 		btDiscreteDynamicsWorld* m_physicsWorld;
 
+		//entities waiting to be deleted at the end of the frame
+		std::vector<entt::entity> m_DestroyQueue;
+
+		//pools of reusable entities
+		std::vector<TTN_EntityPool::spoolptr> m_Pools;
+
+		//entities waiting to be switched on or off, and what to switch them to
+		std::vector<std::pair<entt::entity, bool>> m_ActiveQueue;
+
+		//switches an entity on or off without reconstructing the scenegraph
+		void SetActiveInternal(entt::entity entity, bool active);
+		//switches all the queued entities on or off, returns true if any were switched so the caller knows to reconstruct the scenegraph
+		bool ApplyActiveQueue();
+
 		//vector of titan collision objects, containing pointers to the rigid bodies (from which you can get entity numbers) and glm vec3s for collision normals
 		std::vector<TTN_Collision::scolptr> collisions;
-
-		//empty post processing effect that just draws to a framebuffer
-		TTN_PostEffect::spostptr m_emptyEffect;
+		//every collision object that's been made, they're reused each frame unless something outside the scene is still holding onto one
+		std::vector<TTN_Collision::scolptr> m_collisionPool;
+
+		//framebuffer the scene gets rendered into before post processing
+		TTN_Framebuffer::sfboptr m_sceneTarget;
+		//render graph the post processing effects get scheduled through each frame
+		TTN_RenderGraph m_postGraph;
+		//the scene's lights sorted into view space clusters for the default shaders
+		TTN_LightClusters m_lightClusters;
+
+		//fraction of the window size the scene is rendered at, and the range it's allowed to be in
+		float m_resolutionScale = 1.0f;
+		float m_minResolutionScale = 0.25f;
+		float m_maxResolutionScale = 1.0f;
+		//automatic resolution scale controller
+		bool m_autoResolutionScale = false;
+		float m_targetFrameTime = 1.0f / 60.0f;
+		float m_smoothedFrameTime = 1.0f / 60.0f;
+		//updates the automatic resolution scale from the last frame's time
+		void UpdateResolutionScale(float deltaTime);
 		//color correct effect
 		TTN_PostEffect::spostptr m_colorCorrectEffect;
 
 		//constructs the TTN_Collision objects
 		void ConstructCollisions();
 
+		//runs a single spatial query against the broadphase, only reads from the physics world so it's safe to run on worker threads
+		TTN_QueryResult RunQuery(const TTN_SpatialQuery& query) const;
+
 		//reconstructs the scenegraph, use every time entt reshuffles
 		void ReconstructScenegraph();
-
-#pragma region Sorts
-		//functions to perform a merge sort on a vector of entities based on their z positions 
-		//slightly modified from code from GeeksForGeeks: https://www.geeksforgeeks.org/merge-sort/
-
-		//merge function
-		void mergeEntitiesZ(std::vector<entt::entity>& list, int left, int middle, int right) {
-			//calculate the lenghts of 2 temprorary vectors
-			int lenght1 = middle - left + 1;
-			int lenght2 = right - middle;
-
-			//create the temporary vectors
-			std::vector<entt::entity> tempLeftList = std::vector<entt::entity>(lenght1);
-			std::vector<entt::entity> tempRightList = std::vector<entt::entity>(lenght2);
-
-			//copy data over to the temp vectors
-			for (int i = 0; i < lenght1; i++)
-				tempLeftList[i] = list[left + i];
-			for (int i = 0; i < lenght2; i++)
-				tempRightList[i] = list[middle + 1 + i];
-
-			//set inital indexes for each vector
-			int leftIndex = 0; //left temp
-			int rightIndex = 0; //right temp
-			int mergedIndex = left; //merged subvector
-
-			//merge the temp vectors back into list
-
-			//loop through comparing both sides
-			while (leftIndex < lenght1 && rightIndex < lenght2) {
-				//if the left has a smaller or equal z value, add it back to the merged vector 
-				if (Get<TTN_Transform>(tempLeftList[leftIndex]).GetGlobalPos().z <= Get<TTN_Transform>(tempRightList[rightIndex]).GetGlobalPos().z) {
-					list[mergedIndex] = tempLeftList[leftIndex];
-					leftIndex++;
-				}
-				//otherwise add the right back to the merged vector
-				else {
-					list[mergedIndex] = tempRightList[rightIndex];
-					rightIndex++;
-				}
-				//either way increment the merged index
-				mergedIndex++;
-			}
-
-			//when one side has completed, add any remaining elements from either side
-			while (leftIndex < lenght1) {
-				list[mergedIndex] = tempLeftList[leftIndex];
-				leftIndex++;
-				mergedIndex++;
-			}
-			while (rightIndex < lenght2) {
-				list[mergedIndex] = tempRightList[rightIndex];
-				rightIndex++;
-				mergedIndex++;
-			}
-		}
-
-		//merge sort function
-		void mergeSortEntitiesZ(std::vector<entt::entity>& list, int left, int right) {
-			//base case, returns recursively 
-			if (left >= right) {
-				return;
-			}
-			//calculate a middle value
-			int middle = (left + right - 1) / 2;
-			//call mergesort on both sides
-			mergeSortEntitiesZ(list, left, middle);
-			mergeSortEntitiesZ(list, middle + 1, right);
-			//merge the two sides
-			mergeEntitiesZ(list, left, middle, right);
-		}
-
-#pragma endregion Sorts
 	};
 
 #pragma region ECS_functions_def
@@ -124,15 +124,15 @@ namespace Titan {
 			}
 		}
 
-		//template function for setting a uniform matrix based on just name and data
+		//template function for setting a uniform matrix based on just name and data, count sets an array starting from value
 		template <typename T>
-		void SetUniformMatrix(const std::string& name, const T& value, bool transposed = false) {
+		void SetUniformMatrix(const std::string& name, const T& value, bool transposed = false, int count = 1) {
 			//finds the location that the uniform of that name is stored at
 			int location = __GetUniformLocation(name);
 			//check if the location exists
 			if (location != -1) {
 				//if it does, then set the uniform matrix at that location
-				SetUniformMatrix(location, &value, 1, transposed);
+				SetUniformMatrix(location, &value, count, transposed);
 			}
 			else {
 				//if it doesn't log a warning
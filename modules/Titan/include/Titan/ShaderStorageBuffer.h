@@ -0,0 +1,38 @@
+//Titan Engine, by Atlas X Games 
+// ShaderStorageBuffer.h - header for the class that stores a buffer shaders can read large arrays from
+#pragma once
+
+//precompile header, this file uses memory
+#include "ttn_pch.h"
+//import the buffer base class
+#include "IBuffer.h"
+
+namespace Titan {
+
+	//class for a shader storage buffer
+	class TTN_ShaderStorageBuffer : public TTN_IBuffer {
+	public:
+		//defines a special easier to use name for shared(smart) pointers to the class 
+		typedef std::shared_ptr<TTN_ShaderStorageBuffer> sssboptr;
+
+		//creates and returns a shared(smart) pointer to the class 
+		static inline sssboptr Create(GLenum usage = GL_DYNAMIC_DRAW) {
+			return std::make_shared<TTN_ShaderStorageBuffer>(usage);
+		}
+
+	public:
+		//constructor, creates a new shader storage buffer with the given usage, data will be still need be loaded before it can be used though
+		TTN_ShaderStorageBuffer(GLenum usage = GL_DYNAMIC_DRAW) : TTN_IBuffer(GL_SHADER_STORAGE_BUFFER, usage)
+			{ }
+
+		//binds the buffer to a binding point so shaders can read it with layout(binding = x)
+		void BindBase(GLuint binding) {
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, _handle);
+		}
+
+		//unbinds the current shader storage buffer
+		static void UnBind() {
+			TTN_IBuffer::UnBind(GL_SHADER_STORAGE_BUFFER);
+		}
+	};
+}
@@ -0,0 +1,152 @@
+//Titan Engine, by Atlas X Games
+// ShadowMap.h - header for the class that renders cascaded shadow maps for the scene's directional light
+#pragma once
+
+//precompile header, this file uses vector, array, and glm
+#include "ttn_pch.h"
+//include other titan features
+#include "Framebuffer.h"
+#include "Shader.h"
+#include "Mesh.h"
+#include "Texture2D.h"
+
+namespace Titan {
+	//everything the shadow pass needs to draw an object into the shadow map
+	struct TTN_ShadowCaster {
+		//id used to tell if the caster has changed since the cascade was last drawn, usually the entity
+		uint32_t Id = 0;
+		//the object's model matrix
+		glm::mat4 Model = glm::mat4(1.0f);
+		//world space bounding box
+		glm::vec3 BoundsMin = glm::vec3(0.0f);
+		glm::vec3 BoundsMax = glm::vec3(0.0f);
+		//the mesh to draw
+		TTN_Mesh::smptr Mesh = nullptr;
+		//morph animation frames and how far between them it is
+		int CurrentFrame = 0;
+		int NextFrame = 0;
+		float T = 0.0f;
+		//displacement map, if the object uses one
+		TTN_Texture2D::st2dptr HeightMap = nullptr;
+		float HeightInfluence = 0.0f;
+		//wheter or not the object never moves, static casters are cached apart from the rest so moving objects don't make them redraw
+		bool Static = false;
+	};
+
+	//class that splits the camera's view into cascades, fits a shadow map from the light to each one, and packs them into one depth atlas
+	class TTN_ShadowMap {
+	public:
+		//the most cascades the atlas can hold, they're laid out in a 2x2 grid
+		static const int s_maxCascades = 4;
+		//the texture slot the atlas is bound to for the default shaders
+		static const int s_atlasSlot = 12;
+
+	public:
+		//default constructor
+		TTN_ShadowMap() = default;
+		//destructor, deletes the timer queries
+		~TTN_ShadowMap();
+
+		//copying would share the timer queries
+		TTN_ShadowMap(const TTN_ShadowMap&) = delete;
+		TTN_ShadowMap& operator=(const TTN_ShadowMap&) = delete;
+
+		//sets the width and height of the whole atlas in pixels, each cascade gets a quarter of it
+		void SetResolution(unsigned atlasSize);
+		//gets the width and height of the atlas
+		unsigned GetResolution() const { return m_resolution; }
+
+		//sets how many cascades the view is split into (1 to 4)
+		void SetCascadeCount(int count);
+		//gets how many cascades the view is split into
+		int GetCascadeCount() const { return m_cascadeCount; }
+
+		//sets how far from the camera shadows are drawn
+		void SetMaxDistance(float distance) { m_maxDistance = std::max(distance, 0.01f); }
+		//gets how far from the camera shadows are drawn
+		float GetMaxDistance() const { return m_maxDistance; }
+
+		//sets the blend between uniform (0) and logarithmic (1) splits
+		void SetSplitLambda(float lambda) { m_splitLambda = std::clamp(lambda, 0.0f, 1.0f); }
+		//gets the blend between uniform and logarithmic splits
+		float GetSplitLambda() const { return m_splitLambda; }
+
+		//sets how far behind each cascade (towards the light) casters are still drawn
+		void SetCasterDistance(float distance) { m_casterDistance = std::max(distance, 0.0f); }
+		//gets how far behind each cascade casters are still drawn
+		float GetCasterDistance() const { return m_casterDistance; }
+
+		//sets the depth bias, in texels of the cascade, used to stop surfaces shadowing themselves
+		void SetBias(float bias) { m_bias = bias; }
+		//gets the depth bias
+		float GetBias() const { return m_bias; }
+
+		//fits the cascades to the camera and redraws any cascade whose light matrix or casters have changed
+		void Render(const std::vector<TTN_ShadowCaster>& casters, glm::vec3 lightDirection, const glm::mat4& view, const glm::mat4& projection);
+		//forces every cascade to be redrawn next frame
+		void Invalidate();
+
+		//binds the atlas to it's texture slot
+		void Bind() const;
+		//sets the uniforms the default shaders need to sample the cascades
+		void SetUniforms(TTN_Shader* shader) const;
+
+		//gets how long the gpu took to draw a cascade in the last finished frame, in milliseconds (0 if it was cached)
+		float GetCascadeTime(int cascade) const { return m_gpuTimes[cascade]; }
+		//gets wheter or not a cascade was reused from the last frame instead of being redrawn
+		bool GetCascadeCached(int cascade) const { return m_cached[cascade]; }
+		//gets wheter or not a cascade's static casters were reused from the last frame, even if the moving ones had to be redrawn
+		bool GetCascadeStaticCached(int cascade) const { return m_staticCached[cascade]; }
+		//gets how many casters were drawn into a cascade the last time it was drawn
+		size_t GetCascadeCasterCount(int cascade) const { return m_casterCounts[cascade]; }
+		//gets the view depth each cascade ends at
+		float GetCascadeSplit(int cascade) const { return m_splits[cascade]; }
+
+	private:
+		//creates the atlas and depth shader
+		void Init();
+		//reads back any timer queries that have finished
+		void ReadTimers();
+		//draws some of the casters into a cascade's tile of an atlas, clearing the tile first if asked to
+		void DrawCasters(const TTN_Framebuffer::sfboptr& atlas, int cascade, const std::vector<TTN_ShadowCaster>& casters,
+			const std::vector<size_t>& indices, bool clear);
+
+		//atlas framebuffer, depth only
+		TTN_Framebuffer::sfboptr m_atlas = nullptr;
+		//atlas with just the static casters in each cascade, copied into the main atlas before the moving casters are drawn over them
+		TTN_Framebuffer::sfboptr m_staticAtlas = nullptr;
+		//shader that draws casters depth only
+		TTN_Shader::sshptr m_depthShader = nullptr;
+
+		//settings
+		unsigned m_resolution = 4096;
+		int m_cascadeCount = 4;
+		float m_maxDistance = 150.0f;
+		float m_splitLambda = 0.75f;
+		float m_casterDistance = 100.0f;
+		float m_bias = 1.5f;
+
+		//the light view projection of each cascade, the atlas tile offset is added when they're sent to the shaders
+		std::array<glm::mat4, s_maxCascades> m_lightMatrices;
+		//the view depth each cascade ends at
+		std::array<float, s_maxCascades> m_splits = { 0.0f, 0.0f, 0.0f, 0.0f };
+		//the world size of a texel in each cascade
+		std::array<float, s_maxCascades> m_texelSizes = { 0.0f, 0.0f, 0.0f, 0.0f };
+		//hash of the light matrix and casters each cascade was last drawn with, 0 means it needs drawing
+		std::array<uint64_t, s_maxCascades> m_signatures = { 0, 0, 0, 0 };
+		//hash of the light matrix and static casters each cascade's static tile was last drawn with, 0 means it needs drawing
+		std::array<uint64_t, s_maxCascades> m_staticSignatures = { 0, 0, 0, 0 };
+		//wheter or not each cascade was reused this frame
+		std::array<bool, s_maxCascades> m_cached = { false, false, false, false };
+		//wheter or not each cascade's static casters were reused this frame
+		std::array<bool, s_maxCascades> m_staticCached = { false, false, false, false };
+		//how many casters were drawn into each cascade
+		std::array<size_t, s_maxCascades> m_casterCounts = { 0, 0, 0, 0 };
+
+		//timer queries for each cascade, double buffered so reading them back never stalls
+		GLuint m_queries[2][s_maxCascades] = {};
+		bool m_queryPending[2][s_maxCascades] = {};
+		int m_queryFrame = 0;
+		std::array<float, s_maxCascades> m_gpuTimes = { 0.0f, 0.0f, 0.0f, 0.0f };
+	};
+}
@@ -0,0 +1,81 @@
+//Titan Engine, by Atlas X Games
+// SpriteBatcher.h - header for the class that sorts 2D sprites and draws them in batches
+#pragma once
+
+//precompile header, this file uses vector and glm
+#include "ttn_pch.h"
+//include the texture2D, shader, and VAO classes
+#include "Shader.h"
+#include "Texture2D.h"
+#include "VertexArrayObject.h"
+
+namespace Titan {
+	//static class that collects every sprite a scene draws in a frame, radix sorts them on their depth, layer, and texture,
+	//and draws them as quads packed into a streaming vertex buffer, each batch can sample from several textures so it only breaks when it runs out of texture slots
+	class TTN_SpriteBatcher {
+	public:
+		//the most textures a single batch can use
+		static const int s_maxTextures = 8;
+
+		//sets up the shader and buffers (called on engine side)
+		static void Init();
+
+		//starts collecting sprites for a view projection matrix
+		static void Begin(const glm::mat4& VP);
+		//adds a sprite, it's a 1x1 quad centered on the model matrix's origin, higher z values are drawn first, and the layer only orders sprites at the same z
+		static void Submit(TTN_Texture2D* sprite, const glm::mat4& model, const glm::vec4& color, int layer = 0);
+		//sorts and draws every sprite submitted since Begin
+		static void End();
+
+		//gets the number of draws and sprites the last End took
+		static size_t GetDrawCalls() { return s_drawCalls; }
+		static size_t GetSpritesDrawn() { return s_spritesDrawn; }
+
+	private:
+		//a submitted sprite
+		struct TTN_SpriteEntry {
+			TTN_Texture2D* Sprite;
+			glm::mat4 Model;
+			glm::vec4 Color;
+		};
+
+		//a sprite's sort key, packed as depth (32 bits), layer (16 bits), and texture (16 bits), and where it is in the entries
+		struct TTN_SpriteKey {
+			uint64_t Key;
+			uint32_t Index;
+		};
+
+		//a corner of a quad in the vertex buffer, matches the inputs of the sprite batch vertex shader
+		struct TTN_SpriteVertex {
+			glm::vec3 Position;
+			glm::vec2 Uv;
+			glm::vec4 Color;
+			//the slot of the batch's texture it samples from
+			float Texture;
+		};
+
+		//sorts the keys with a least significant digit radix sort, a byte at a time, skipping bytes every key shares
+		static void RadixSort();
+		//draws the quads and textures waiting in the current batch
+		static void Flush();
+
+		//the sprites and their keys, kept between frames so they don't reallocate
+		inline static std::vector<TTN_SpriteEntry> s_entries;
+		inline static std::vector<TTN_SpriteKey> s_keys;
+		inline static std::vector<TTN_SpriteKey> s_sortScratch;
+		inline static glm::mat4 s_viewProjection = glm::mat4(1.0f);
+
+		//the batch being built
+		inline static std::vector<TTN_SpriteVertex> s_vertices;
+		inline static TTN_Texture2D* s_batchTextures[s_maxTextures];
+		inline static int s_batchTextureCount = 0;
+
+		inline static size_t s_drawCalls = 0;
+		inline static size_t s_spritesDrawn = 0;
+
+		//the shader program, streaming vertex buffer, and vao for the batches
+		inline static TTN_Shader::sshptr s_shader = nullptr;
+		inline static TTN_VertexBuffer::svbptr s_vbo = nullptr;
+		inline static TTN_VertexArrayObject::svaptr s_vao = nullptr;
+	};
+}
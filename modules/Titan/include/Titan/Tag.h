@@ -91,4 +91,7 @@ namespace Titan {
 	private:
 		float m_lifeLeft;
 	};
-}
\ No newline at end of file
+
+	//empty marker component for entities that are switched off (such as pooled entities waiting to be reused), the scene's systems skip them
+	struct TTN_Inactive {};
+}
@@ -24,6 +24,11 @@ namespace Titan {
 
 		/// Loads image data from an external file
 		static TTN_Texture2DData::st2ddptr LoadFromFile(const std::string& file, bool flipped = true, bool forceRgba = false);
+		/// Loads image data from an external file without changing stbi's flip setting, which is shared by every thread
+		/// Used to decode several files on different threads at once, call SetFlipOnLoad once before starting them
+		static TTN_Texture2DData::st2ddptr DecodeFile(const std::string& file, bool forceRgba = false);
+		/// Sets wheter or not stbi flips the images it loads vertically, for every thread
+		static void SetFlipOnLoad(bool flipped);
 		
 		/// Gets the width of the texture data, in pixels
 		uint32_t GetWidth() const { return _width; }
@@ -96,6 +101,10 @@ namespace Titan {
 			return std::make_shared<TTN_Texture2D>();
 		}
 
+		//creates a texture that's a region of an atlas page, binding it binds the page and sprites drawn with it remap their uvs to the region
+		//the uv rect is the region's offset in xy and it's size in zw, both in the page's uvs
+		static st2dptr CreateAtlasRegion(const st2dptr& page, const glm::vec4& uvRect, uint32_t width, uint32_t height);
+
 	public:
 		//ensuring moving and copying is not allowed so we can control destructor calls through pointers
 		TTN_Texture2D(const TTN_Texture2D& other) = delete;
@@ -108,8 +117,8 @@ namespace Titan {
 		TTN_Texture2D();
 		//constructor that takes in a descpiriton for the texture
 		TTN_Texture2D(const TTN_Texture2DDesc& description);
-		//default destrcutor
-		~TTN_Texture2D() = default;
+		//destrcutor, atlas regions leave their page's texture alone
+		~TTN_Texture2D();
 
 		//loads a texture from a file
 		static st2dptr LoadFromFile(const std::string& fileName, bool flipped = true, bool forceRgba = false);
@@ -133,6 +142,12 @@ namespace Titan {
 		Texture_Wrap_Mode GetVertWrapMode() const { return m_data.vertWrapMode; }
 		//underlying data
 		const TTN_Texture2DDesc& GetDescription() const { return m_data; }
+		//wheter or not it's a region of an atlas page
+		bool GetIsAtlasRegion() const { return m_atlasPage != nullptr; }
+		//gets the texture that holds the pixels, the atlas page for a region or the texture itself otherwise
+		TTN_Texture2D* GetAtlasPage() { return (m_atlasPage != nullptr) ? m_atlasPage.get() : this; }
+		//gets the part of the page's uvs the texture covers, offset in xy and size in zw, (0, 0, 1, 1) if it's not a region
+		const glm::vec4& GetUVRect() const { return m_uvRect; }
 
 
 		//setters for the filters and wrap mode
@@ -150,6 +165,10 @@ namespace Titan {
 	private:
 		TTN_Texture2DDesc m_data;
 
+		//the atlas page a region's pixels are in, and where in it they are
+		st2dptr m_atlasPage = nullptr;
+		glm::vec4 m_uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+
 		void RecreateTexture();
 	};
 }
\ No newline at end of file
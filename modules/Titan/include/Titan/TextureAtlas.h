@@ -0,0 +1,65 @@
+//Titan Engine, by Atlas X Games
+// TextureAtlas.h - header for the class that packs many small images into a few large textures
+#pragma once
+
+//precompile header, this file uses string, vector, unordered_map, and memory
+#include "ttn_pch.h"
+//include the texture2D class
+#include "Texture2D.h"
+
+namespace Titan {
+	//class that packs a group of images into one or a few atlas pages with a skyline packer, and hands out a region texture for each of them
+	//the regions can be used anywhere a texture2D is used for sprites, drawing them binds the page so sprites from the same atlas don't rebind textures
+	class TTN_TextureAtlas {
+	public:
+		//defines a special easier to use name for shared(smart) pointers to the class
+		typedef std::shared_ptr<TTN_TextureAtlas> satlasptr;
+
+		//creates and returns a shared(smart) pointer to the class
+		static inline satlasptr Create() {
+			return std::make_shared<TTN_TextureAtlas>();
+		}
+
+		//the biggest a page can be on either side
+		static const int s_maxPageSize = 4096;
+		//the pixels left around each image, filled with copies of it's edges so filtering doesn't pull in it's neighbours
+		static const int s_padding = 2;
+
+		//default constructor and destructor
+		TTN_TextureAtlas() = default;
+		~TTN_TextureAtlas() = default;
+
+		//packs the images, given as pairs of access names and file names, into pages
+		//if a cache path is given the packed pages are saved there and loaded back instead of repacking as long as none of the images have changed
+		bool Build(const std::vector<std::pair<std::string, std::string>>& images, const std::string& cachePath = "");
+
+		//gets the region for an image, nullptr if it isn't in the atlas
+		TTN_Texture2D::st2dptr GetRegion(const std::string& accessName) const;
+		//gets every region, keyed on it's access name
+		const std::unordered_map<std::string, TTN_Texture2D::st2dptr>& GetRegions() const { return m_regions; }
+		//gets the pages
+		const std::vector<TTN_Texture2D::st2dptr>& GetPages() const { return m_pages; }
+
+	private:
+		//where an image ended up
+		struct TTN_AtlasRegion {
+			std::string AccessName;
+			int Page;
+			int X, Y, Width, Height;
+		};
+
+		//fills the pages and regions from packed rgba pixels
+		void CreateTextures(const std::vector<std::vector<uint8_t>>& pixels, const std::vector<glm::ivec2>& sizes, const std::vector<TTN_AtlasRegion>& placements);
+
+		//saves the packed pages and where each image is in them
+		static void SaveCache(const std::string& cachePath, const std::vector<std::pair<std::string, std::string>>& images,
+			const std::vector<std::vector<uint8_t>>& pixels, const std::vector<glm::ivec2>& sizes, const std::vector<TTN_AtlasRegion>& placements);
+		//loads the cache back, returns false if it's missing or any of the images have changed since it was saved
+		static bool LoadCache(const std::string& cachePath, const std::vector<std::pair<std::string, std::string>>& images,
+			std::vector<std::vector<uint8_t>>& pixels, std::vector<glm::ivec2>& sizes, std::vector<TTN_AtlasRegion>& placements);
+
+		//the pages and the regions in them
+		std::vector<TTN_Texture2D::st2dptr> m_pages;
+		std::unordered_map<std::string, TTN_Texture2D::st2dptr> m_regions;
+	};
+}
@@ -7,6 +7,7 @@
 //include other titan features
 #include "TextureEnums.h"
 #include "Texture2D.h"
+#include "JobSystem.h"
 
 namespace Titan {
 	//enum for the face of each cube
@@ -39,8 +40,12 @@ namespace Titan {
 		static TTN_TextureCubeMapData::stcmdptr CreateFromImages(const std::vector<TTN_Texture2DData::st2ddptr>& images);
 
 		//loads a cubemap for a set of 6 images stored in different files, the files should follow the naming convention image_(dir, pos/neg)_(axis, x/y/z).png
+		//the faces are decoded at the same time on the job system
 		static TTN_TextureCubeMapData::stcmdptr LoadFromImages(const std::string& rootImagePath);
 
+		//gets the paths of the 6 face images for a root image path
+		static std::vector<std::string> GetFacePaths(const std::string& rootImagePath);
+
 		//loads an indivual face
 		void LoadFaceData(const TTN_Texture2DData::st2ddptr& data, CubeMapFace face);
 
@@ -78,13 +83,15 @@ namespace Titan {
 		Texture_Min_Filter      MinificationFilter;
 		Texture_Mag_Filter      MagnificationFilter;
 		bool           GenerateMipMaps;
+		uint32_t       MipLevels;
 
 		TTN_TextureCubeMapDesc() :
 			Size(0),
 			Format(Texture_Internal_Format::Interal_Format_Unknown),
 			MinificationFilter(Texture_Min_Filter::Min_Linear),
 			MagnificationFilter(Texture_Mag_Filter::Mag_Linear),
-			GenerateMipMaps(false)
+			GenerateMipMaps(false),
+			MipLevels(1)
 		{ }
 	};
 
@@ -117,9 +124,20 @@ namespace Titan {
 		//loads data into the texture
 		void LoadData(const TTN_TextureCubeMapData::stcmdptr& data);
 
-		//loads from a series of 6 images
+		//loads from a series of 6 images, if there's an up to date baked cubemap next to them it loads that instead
 		static stcmptr LoadFromImages(const std::string& filePath);
 
+		//loads a baked cubemap (all 6 faces and every mip level in a single file), returns nullptr if it couldn't be read
+		static stcmptr LoadBaked(const std::string& filePath);
+		//saves the texture as a baked cubemap, reading every mip level back from the gpu
+		bool SaveBaked(const std::string& filePath) const;
+
+		//gets the path of the baked cubemap for a root image path
+		static std::string GetBakedPath(const std::string& rootImagePath);
+
+		//wheter or not loading from images writes a baked cubemap so the next load is faster
+		inline static bool s_bakeOnLoad = true;
+
 		//Getters
 		uint32_t GetSize() const { return m_data.Size; }
 		Texture_Internal_Format GetFormat() { return m_data.Format; }
@@ -133,6 +151,9 @@ namespace Titan {
 
 	private:
 		TTN_TextureCubeMapDesc m_data;
+		//the pixel format and type the data was uploaded in, saved so it can be read back in the same layout
+		Texture_Pixel_Format m_pixelFormat = Texture_Pixel_Format::RGBA;
+		Texture_Pixel_Data_Type m_pixelType = Texture_Pixel_Data_Type::UByte;
 
 		void RecreateTexture();
 	};
@@ -0,0 +1,45 @@
+//Titan Engine by Atlas X Games
+//UberPost.h - Header for the class that fuses per pixel post processing effects into a single shader pass
+#pragma once
+
+//include the precompile header, this file uses unordered_map
+#include "ttn_pch.h"
+//include the graphics features needed
+#include "PostEffect.h"
+
+namespace Titan {
+	//static class that builds, caches, and applies fused post processing shaders
+	class TTN_UberPost {
+	public:
+		//the texture slots fused effects can bind their textures to, slot 0 is the frame being processed
+		static const int s_firstTextureSlot = 16;
+		static const int s_maxTextures = 16;
+		//the most effects one fused pass can have, each one gets a byte of the cache key
+		static const size_t s_maxEffects = 8;
+
+		//checks if an effect can join a fused run, it has to be fusable, the run can't be full, and there have to be enough texture slots left for it
+		static bool CanFuse(const std::vector<TTN_PostEffect::spostptr>& run, const TTN_PostEffect::spostptr& effect);
+
+		//gets the key a run of effects' fused shader is cached under, each effect's type in the byte for it's place in the run
+		//so the same effects in a different order, or the same effect more than once, get their own shaders, and looking one up never allocates
+		static uint64_t GetKey(const std::vector<TTN_PostEffect::spostptr>& effects);
+
+		//applies a run of fusable effects from the source into the target in one full screen pass
+		static void Apply(const std::vector<TTN_PostEffect::spostptr>& effects, const TTN_Framebuffer::sfboptr& source, const TTN_Framebuffer::sfboptr& target);
+
+		//gets the fused shader for a run of effects, generating and compiling it the first time that set of effects is used
+		static TTN_Shader::sshptr GetShader(const std::vector<TTN_PostEffect::spostptr>& effects);
+
+		//gets the number of fused shaders that have been compiled
+		static size_t GetVariantCount() { return s_variants.size(); }
+		//deletes all the fused shaders
+		static void ClearCache() { s_variants.clear(); }
+
+	private:
+		//gets the name of the i-th effect's function and uniforms in a fused shader
+		static const std::string& GetFusedName(size_t index);
+
+		//the compiled fused shaders, keyed by the types of the effects in them
+		inline static std::unordered_map<uint64_t, TTN_Shader::sshptr> s_variants;
+	};
+}
@@ -96,8 +96,8 @@ namespace Titan {
 		//Gets the OpenGL handle this is wrapping around
 		GLuint GetHandle() const { return 0; }
 
-		//Renders the VAO
-		void Render() const;
+		//Renders the VAO, only the first numOfVerts vertices if it's not 0 and there's no IBO
+		void Render(size_t numOfVerts = 0) const;
 		void RenderInstanced(size_t numOfObjects, size_t numOfVerts = 0) const;
 
 	private:
@@ -5,10 +5,13 @@
 #include <sstream>
 #include <fstream>
 #include <vector>
+#include <array>
+#include <bitset>
 #include <unordered_map>
 
 //functionality
 #include <memory>
+#include <memory_resource>
 #include <algorithm>
 #include <cstdint>
 #include <stdexcept>
@@ -17,6 +20,17 @@
 #include <stdlib.h> 
 #include <time.h>
 #include <filesystem>
+#include <thread>
+#include <functional>
+#include <typeindex>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <charconv>
+#include <limits>
+#include <random>
+#include <chrono>
 #include "Logging.h"
 
 //math
@@ -93,6 +93,11 @@ project "Titan"
         runtime "Debug"
         symbols "on"
 
+        --count every heap allocation by profiler scope in debug builds
+        defines {
+            "TTN_TRACK_ALLOCATIONS"
+        }
+
 
     filter "configurations:Release"
         runtime "Release"
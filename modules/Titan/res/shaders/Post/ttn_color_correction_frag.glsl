@@ -18,9 +18,10 @@ void main()
 	//sample the framebuffer texture
 	vec4 textureColor = texture(u_FinishedFrame, inUV);
 
-	//grab some scale and offset vectors
-	vec3 scale = vec3((64.0 - 1.0) / 64.0);
-	vec3 offset = vec3(1.0 / (2.0 * 64.0));
+	//grab some scale and offset vectors based on the size of the cube
+	float size = float(textureSize(u_TextColorGrade, 0).x);
+	vec3 scale = vec3((size - 1.0) / size);
+	vec3 offset = vec3(1.0 / (2.0 * size));
 
 	//and mix the base color with the corrected color based on the intensity and pass it on as the fragment color
 	frag_color = vec4(mix(textureColor.rgb, texture(u_TextColorGrade, scale * textureColor.rgb + offset).rgb, u_Intensity), textureColor.a);
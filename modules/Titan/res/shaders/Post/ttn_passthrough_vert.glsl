@@ -4,13 +4,16 @@
 layout (location = 0) in vec3 inPosition;
 layout (location = 1) in vec2 inUV;
 
+//fraction of the source framebuffer's textures that are actually in use
+uniform vec2 u_UVScale = vec2(1.0);
+
 //data to pass on to the fragment shader
 layout(location = 0) out vec2 outUV;
 
 void main()
 { 
-	//just pass on the uvs
-	outUV = inUV;
+	//pass on the uvs, scaled to the part of the source that's in use
+	outUV = inUV * u_UVScale;
 	//and keep the fullscreen quad as is
 	gl_Position = vec4(inPosition, 1.0);
 }
\ No newline at end of file
@@ -1,4 +1,7 @@
-#version 420
+#version 430
+#ifdef TTN_BINDLESS
+#extension GL_ARB_bindless_texture : require
+#endif
 
 //mesh data from vert shader
 layout(location = 0) in vec3 inPos;
@@ -7,12 +10,39 @@ layout(location = 2) in vec2 inUV;
 layout(location = 3) in vec3 inColor;
 
 //material stuff
+#ifdef TTN_BINDLESS
+//the engine keeps every material in a shader storage buffer, with it's textures as bindless handles, so nothing is set or bound per draw
+struct Material {
+	uvec2 albedo;
+	uvec2 specular;
+	uvec2 heightMap;
+	uvec2 diffuseRamp;
+	uvec2 specularRamp;
+	uvec2 padding;
+	//shininess, height influence, outline size, unused
+	vec4 params;
+	//has ambient lighting, has specular lighting, no outline, unused
+	ivec4 lighting;
+	//use diffuse ramp, use specular ramp, unused, unused
+	ivec4 ramps;
+};
+layout(std430, binding = 5) readonly buffer MaterialBuffer { Material u_Materials[]; };
+//the material this object uses, from the vertex shader
+layout(location = 4) flat in int inMaterial;
+
+//read the material data from the buffer wherever the rest of the shader uses it
+#define u_Shininess u_Materials[inMaterial].params.x
+#define u_OutlineSize u_Materials[inMaterial].params.z
+#define u_hasAmbientLighting u_Materials[inMaterial].lighting.x
+#define u_hasSpecularLighting u_Materials[inMaterial].lighting.y
+#define u_hasOutline u_Materials[inMaterial].lighting.z
+#define s_diffuseRamp sampler2D(u_Materials[inMaterial].diffuseRamp)
+#define u_useDiffuseRamp u_Materials[inMaterial].ramps.x
+#define s_specularRamp sampler2D(u_Materials[inMaterial].specularRamp)
+#define u_useSpecularRamp u_Materials[inMaterial].ramps.y
+#else
 uniform float u_Shininess;
 
-//scene ambient lighting
-uniform vec3  u_AmbientCol;
-uniform float u_AmbientStrength;
-
 //uniforms for different lighting effects
 uniform int u_hasAmbientLighting;
 uniform int u_hasSpecularLighting;
@@ -24,17 +54,39 @@ layout(binding = 10)uniform sampler2D s_diffuseRamp;
 uniform int u_useDiffuseRamp;
 layout(binding = 11)uniform sampler2D s_specularRamp;
 uniform int u_useSpecularRamp;
+#endif
 
-//Specfic light stuff
-uniform vec3  u_LightPos[16];
-uniform vec3  u_LightCol[16];
-uniform float u_AmbientLightStrength[16];
-uniform float u_SpecularLightStrength[16];
-uniform float u_LightAttenuationConstant[16];
-uniform float u_LightAttenuationLinear[16];
-uniform float u_LightAttenuationQuadratic[16];
+//scene ambient lighting
+uniform vec3  u_AmbientCol;
+uniform float u_AmbientStrength;
 
-uniform int u_NumOfLights;
+//Specfic light stuff, the engine sorts the lights into clusters and stores them in shader storage buffers
+struct Light {
+	vec4 positionRange;
+	vec4 colorAmbient;
+	vec4 specularAttenuation;
+};
+layout(std430, binding = 0) readonly buffer LightBuffer { Light u_Lights[]; };
+layout(std430, binding = 1) readonly buffer ClusterBuffer { uvec2 u_Clusters[]; };
+layout(std430, binding = 2) readonly buffer LightIndexBuffer { uint u_LightIndices[]; };
+
+//data to find which cluster a fragment is in
+uniform mat4  u_View;
+uniform ivec3 u_ClusterGrid;
+uniform vec2  u_ClusterViewport;
+uniform float u_ClusterNear;
+uniform float u_ClusterFar;
+
+//the scene's directional light and it's cascaded shadow map
+uniform vec3  u_SunDirection;
+uniform vec3  u_SunColor;
+uniform float u_SunStrength;
+layout(binding = 12) uniform sampler2DShadow s_ShadowAtlas;
+uniform mat4  u_ShadowMatrices[4];
+uniform float u_CascadeSplits[4];
+uniform float u_ShadowNormalOffset[4];
+uniform int   u_NumCascades;
+uniform float u_ShadowTexelSize;
 
 //camera data
 uniform vec3  u_CamPos;
@@ -43,6 +95,9 @@ uniform vec3  u_CamPos;
 out vec4 frag_color;
 
 //functions 
+uint GetCluster();
+float GetShadow(vec3 norm);
+vec3 CalcSun(vec3 norm, vec3 viewDir, float textSpec);
 vec3 CalcLight(vec3 pos, vec3 col, float ambStr, float specStr, float attenConst, float attenLine, float attenQuad, vec3 norm, vec3 viewDir, float textSpec);
 
 void main() {
@@ -53,13 +108,18 @@ void main() {
 	//combine everything
 	vec3 result = u_AmbientCol * u_AmbientStrength * u_hasAmbientLighting; // global ambient light
 
-	//add the results from all the lights
-	for(int i = 0; i < u_NumOfLights; i++) {
-		result = result + CalcLight(u_LightPos[i], u_LightCol[i], u_AmbientLightStrength[i], u_SpecularLightStrength[i], 
-					u_LightAttenuationConstant[i], u_LightAttenuationLinear[i], u_LightAttenuationQuadratic[i], 
+	//add the results from the lights in this fragment's cluster
+	uvec2 cluster = u_Clusters[GetCluster()];
+	for(uint i = 0u; i < cluster.y; i++) {
+		Light light = u_Lights[u_LightIndices[cluster.x + i]];
+		result = result + CalcLight(light.positionRange.xyz, light.colorAmbient.rgb, light.colorAmbient.a, light.specularAttenuation.x, 
+					light.specularAttenuation.y, light.specularAttenuation.z, light.specularAttenuation.w, 
 					N, viewDir, 1.0);
 	}
 
+	//add the directional light, shadowed by the cascades
+	result = result + CalcSun(N, viewDir, 1.0);
+
 	//add that to the texture color
 	result = result * inColor;
 
@@ -96,4 +156,61 @@ vec3 CalcLight(vec3 pos, vec3 col, float ambStr, float specStr, float attenConst
 	specular = specular * u_hasSpecularLighting;
 	
 	return ((ambient + diffuse + specular) * attenuation);
+}
+
+uint GetCluster() {
+	//the depth slice, slices get exponentially deeper further from the camera
+	float depth = -(u_View * vec4(inPos, 1.0)).z;
+	int slice = int(floor(log(max(depth, u_ClusterNear) / u_ClusterNear) / log(u_ClusterFar / u_ClusterNear) * float(u_ClusterGrid.z)));
+	slice = clamp(slice, 0, u_ClusterGrid.z - 1);
+
+	//the screen tile
+	ivec2 tile = clamp(ivec2(gl_FragCoord.xy / u_ClusterViewport * vec2(u_ClusterGrid.xy)), ivec2(0), u_ClusterGrid.xy - 1);
+
+	return uint(tile.x + tile.y * u_ClusterGrid.x + slice * u_ClusterGrid.x * u_ClusterGrid.y);
+}
+
+float GetShadow(vec3 norm) {
+	//no cascades means the shadows are off
+	if(u_NumCascades == 0) return 1.0;
+
+	//pick the cascade from the view depth, past the last one there's no shadow
+	float depth = -(u_View * vec4(inPos, 1.0)).z;
+	if(depth > u_CascadeSplits[u_NumCascades - 1]) return 1.0;
+	int cascade = 0;
+	while(cascade < u_NumCascades - 1 && depth > u_CascadeSplits[cascade])
+		cascade++;
+
+	//push the point out along the normal so surfaces don't shadow themselves, then move into the cascade's tile of the atlas
+	vec3 shadowCoord = (u_ShadowMatrices[cascade] * vec4(inPos + norm * u_ShadowNormalOffset[cascade], 1.0)).xyz;
+	vec2 tileMin = vec2(cascade % 2, cascade / 2) * 0.5 + vec2(u_ShadowTexelSize);
+	vec2 tileMax = tileMin + vec2(0.5 - 2.0 * u_ShadowTexelSize);
+
+	//3x3 pcf, each tap is already a 2x2 bilinear comparison, clamped so it never reads the next cascade over
+	float lit = 0.0;
+	for(int x = -1; x <= 1; x++) {
+		for(int y = -1; y <= 1; y++) {
+			vec2 uv = clamp(shadowCoord.xy + vec2(x, y) * u_ShadowTexelSize, tileMin, tileMax);
+			lit += texture(s_ShadowAtlas, vec3(uv, shadowCoord.z));
+		}
+	}
+	return lit / 9.0;
+}
+
+vec3 CalcSun(vec3 norm, vec3 viewDir, float textSpec) {
+	//diffuse
+	vec3 lightDir = normalize(-u_SunDirection);
+	float dif = max(dot(norm, lightDir), 0.0);
+	vec3 diffuse = dif * u_SunColor;
+	diffuse = mix(diffuse, texture(s_diffuseRamp, vec2(dif, dif)).xyz, u_useDiffuseRamp);
+	diffuse = diffuse * u_hasAmbientLighting * u_hasSpecularLighting;
+
+	//specular
+	vec3 halfWay =  normalize(lightDir + viewDir);
+	float spec = pow(max(dot(norm, halfWay), 0.0), u_Shininess); 
+	vec3 specular = textSpec * spec * u_SunColor;
+	specular = mix(specular, (texture(s_specularRamp, vec2(spec, spec)).xyz), u_useSpecularRamp);
+	specular = specular * u_hasSpecularLighting;
+
+	return (diffuse + specular) * u_SunStrength * GetShadow(norm);
 }
\ No newline at end of file
@@ -0,0 +1,5 @@
+#version 410
+
+//depth only, nothing to write
+void main() {
+}
\ No newline at end of file
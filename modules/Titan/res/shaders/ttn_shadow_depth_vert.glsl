@@ -0,0 +1,44 @@
+#version 430
+
+//mesh data from c++ program, the next frame is the same as the current one for meshes that aren't animated
+layout(location = 0) in vec3 inPos;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec2 inUV;
+layout(location = 4) in vec3 inPosNextFrame;
+
+//displacement map, for objects using the heightmap shaders
+layout(binding = 0) uniform sampler2D Texture;
+uniform int u_useHeightMap;
+uniform float u_influence;
+
+//light view projection times the model matrix
+uniform mat4 MVP;
+//normal matrix
+uniform mat3 NormalMat;
+
+//uniform with the value of the morph interpolation
+uniform float t;
+
+//morph animated casters read their frames from the mesh's packed frame buffer instead
+layout(std430, binding = 3) readonly buffer MorphFrames {
+	vec4 u_MorphFrames[];
+};
+uniform int u_Morph;
+uniform int u_CurrentFrame;
+uniform int u_NextFrame;
+uniform int u_FrameVertexCount;
+
+void main() {
+	//lerp the positions
+	vec3 vert = mix(inPos, inPosNextFrame, t);
+	if (u_Morph == 1) {
+		vert = mix(u_MorphFrames[(u_CurrentFrame * u_FrameVertexCount + gl_VertexID) * 2].xyz,
+			u_MorphFrames[(u_NextFrame * u_FrameVertexCount + gl_VertexID) * 2].xyz, t);
+	}
+
+	//displace it the same way the heightmap shaders do
+	if(u_useHeightMap == 1)
+		vert = vert + texture(Texture, inUV).r * u_influence * (NormalMat * inNormal);
+
+	gl_Position = MVP * vec4(vert, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#version 410
+
+//data from the vert shader
+layout(location = 0) in vec2 inUv;
+layout(location = 1) in vec4 inColor;
+layout(location = 2) flat in int inTexture;
+
+//the batch's textures, they can only be indexed with constants so the slot is picked with a switch
+uniform sampler2D s_Textures[8];
+
+//result
+out vec4 frag_color;
+
+void main() {
+	vec4 texColor;
+	switch (inTexture) {
+		case 0: texColor = texture(s_Textures[0], inUv); break;
+		case 1: texColor = texture(s_Textures[1], inUv); break;
+		case 2: texColor = texture(s_Textures[2], inUv); break;
+		case 3: texColor = texture(s_Textures[3], inUv); break;
+		case 4: texColor = texture(s_Textures[4], inUv); break;
+		case 5: texColor = texture(s_Textures[5], inUv); break;
+		case 6: texColor = texture(s_Textures[6], inUv); break;
+		default: texColor = texture(s_Textures[7], inUv); break;
+	}
+
+	//set the fragment color from the texture and the sprite's colour
+	frag_color = texColor * inColor;
+}
\ No newline at end of file
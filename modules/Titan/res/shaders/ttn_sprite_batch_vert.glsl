@@ -0,0 +1,23 @@
+#version 410
+//sprite quads from the batcher, already in world space
+layout(location = 0) in vec3 inPos;
+layout(location = 1) in vec2 inUv;
+layout(location = 2) in vec4 inColor;
+layout(location = 3) in float inTexture;
+
+//data to pass to the frag shader
+layout(location = 0) out vec2 outUV;
+layout(location = 1) out vec4 outColor;
+layout(location = 2) flat out int outTexture;
+
+//view projection matrix, shared by every sprite in the batch
+uniform mat4 u_ViewProjection;
+
+void main() {
+	//send the uvs, colour, and texture slot onto the frag shader 
+	outUV = inUv;
+	outColor = inColor;
+	outTexture = int(inTexture + 0.5);
+	//set the vertex position
+	gl_Position = u_ViewProjection * vec4(inPos, 1.0);
+}
\ No newline at end of file
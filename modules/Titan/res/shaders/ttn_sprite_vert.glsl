@@ -8,10 +8,12 @@ layout(location = 0) out vec2 outUV;
 
 //model view projection matrix
 uniform mat4 MVP;
+//the part of the texture to use, offset in xy and size in zw, for sprites in an atlas
+uniform vec4 u_UvRect;
 
 void main() {
 	//send the uvs onto the frag shader 
-	outUV = inUv;
+	outUV = u_UvRect.xy + inUv * u_UvRect.zw;
 	//set the vertex position
 	gl_Position = MVP * vec4(inPos, 1.0);
 }
\ No newline at end of file
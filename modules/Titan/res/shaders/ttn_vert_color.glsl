@@ -11,6 +11,8 @@ layout(location = 0) out vec3 outPos;
 layout(location = 1) out vec3 outNormal;
 layout(location = 2) out vec2 outUV;
 layout(location = 3) out vec3 outColor;
+//the object's material, passed on so the frag shader can read it from the material buffer
+layout(location = 4) flat out int outMaterial;
 
 //model, view, projection matrix
 uniform mat4 MVP;
@@ -18,6 +20,8 @@ uniform mat4 MVP;
 uniform mat4 Model; 
 //normal matrix
 uniform mat3 NormalMat;
+//the object's index in the material buffer
+uniform int u_MaterialIndex;
 
 void main() {
 	//calculate the position
@@ -27,6 +31,7 @@ void main() {
 	outPos = (Model * vec4(inPos, 1.0)).xyz;
 	outNormal = NormalMat * inNormal;
 	outUV = inUV;
+	outMaterial = u_MaterialIndex;
 	outColor = inColor;
 
 	//set the position of the vertex
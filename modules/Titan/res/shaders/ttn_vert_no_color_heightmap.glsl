@@ -1,4 +1,7 @@
-#version 410
+#version 430
+#ifdef TTN_BINDLESS
+#extension GL_ARB_bindless_texture : require
+#endif
 //mesh data from c++ program
 layout(location = 0) in vec3 inPos;
 layout(location = 1) in vec3 inNormal;
@@ -9,12 +12,38 @@ layout(location = 0) out vec3 outPos;
 layout(location = 1) out vec3 outNormal;
 layout(location = 2) out vec2 outUV;
 layout(location = 3) out vec3 outColor;
+//the object's material, passed on so the frag shader can read it from the material buffer
+layout(location = 4) flat out int outMaterial;
 
+//the object's index in the material buffer
+uniform int u_MaterialIndex;
+
+#ifdef TTN_BINDLESS
+//the engine keeps every material in a shader storage buffer, the height map and it's influence come from the object's material
+struct Material {
+	uvec2 albedo;
+	uvec2 specular;
+	uvec2 heightMap;
+	uvec2 diffuseRamp;
+	uvec2 specularRamp;
+	uvec2 padding;
+	//shininess, height influence, outline size, unused
+	vec4 params;
+	//has ambient lighting, has specular lighting, no outline, unused
+	ivec4 lighting;
+	//use diffuse ramp, use specular ramp, unused, unused
+	ivec4 ramps;
+};
+layout(std430, binding = 5) readonly buffer MaterialBuffer { Material u_Materials[]; };
+#define Texture sampler2D(u_Materials[u_MaterialIndex].heightMap)
+#define u_influence u_Materials[u_MaterialIndex].params.y
+#else
 //texture
 uniform sampler2D Texture;
 
 //influnce the displacement map should have 
 uniform float u_influence;
+#endif
 
 //model, view, projection matrix
 uniform mat4 MVP;
@@ -29,6 +58,7 @@ void main() {
 	outPos = (Model * vec4(inPos, 1.0)).xyz;
 	outNormal = NormalMat * inNormal;
 	outUV = inUV;
+	outMaterial = u_MaterialIndex;
 	outColor = vec3(1.0, 1.0, 1.0);
 
 	vec3 vert = inPos;
@@ -1,17 +1,31 @@
-#version 410
+#version 430
 
-//mesh data from c++ program
-layout(location = 0) in vec3 inPos;
-layout(location = 1) in vec3 inNormal;
+//mesh data from c++ program, the positions and normals come from the packed frames instead
 layout(location = 2) in vec2 inUV;
-layout(location = 4) in vec3 inPosNextFrame;
-layout(location = 5) in vec3 inNormalNextFrame;
 
 //mesh data to pass to the frag shader
 layout(location = 0) out vec3 outPos;
 layout(location = 1) out vec3 outNormal;
 layout(location = 2) out vec2 outUV;
 layout(location = 3) out vec3 outColor;
+//the object's material, passed on so the frag shader can read it from the material buffer
+layout(location = 4) flat out int outMaterial;
+
+//every frame of the mesh, each vertex is a position then a normal and each frame is every vertex in order
+layout(std430, binding = 3) readonly buffer MorphFrames {
+	vec4 u_MorphFrames[];
+};
+
+//an animated object drawn as part of an instanced batch
+struct MorphInstance {
+	mat4 model;
+	mat4 normalMat;
+	//current frame, next frame, interpolation parameter, index in the material buffer
+	vec4 frames;
+};
+layout(std430, binding = 4) readonly buffer MorphInstances {
+	MorphInstance u_Instances[];
+};
 
 //model, view, projection matrix
 uniform mat4 MVP;
@@ -19,22 +33,56 @@ uniform mat4 MVP;
 uniform mat4 Model; 
 //normal matrix
 uniform mat3 NormalMat;
+//the object's index in the material buffer
+uniform int u_MaterialIndex;
 
+//the frames being blended and how many vertices are in each frame
+uniform int u_CurrentFrame;
+uniform int u_NextFrame;
+uniform int u_FrameVertexCount;
 //uniform with the value of the interpolation 
 uniform float t; 
 
+//wheter or not the matrices and frames should come from the instance buffer, and the view projection they use
+uniform int u_UseInstances;
+uniform mat4 u_ViewProjection;
+
 void main() {
+	//get the matrices and frames for this object
+	mat4 model = Model;
+	mat3 normalMat = NormalMat;
+	mat4 mvp = MVP;
+	int currentFrame = u_CurrentFrame;
+	int nextFrame = u_NextFrame;
+	float blend = t;
+	int material = u_MaterialIndex;
+	if (u_UseInstances == 1) {
+		MorphInstance instance = u_Instances[gl_InstanceID];
+		model = instance.model;
+		normalMat = mat3(instance.normalMat);
+		mvp = u_ViewProjection * model;
+		currentFrame = int(instance.frames.x);
+		nextFrame = int(instance.frames.y);
+		blend = instance.frames.z;
+		material = int(instance.frames.w);
+	}
+
+	//fetch the vertex from both frames
+	int current = (currentFrame * u_FrameVertexCount + gl_VertexID) * 2;
+	int next = (nextFrame * u_FrameVertexCount + gl_VertexID) * 2;
+
 	//lerp the positions and normals 
-	vec3 pos = mix(inPos, inPosNextFrame, t);
-	vec3 normal = normalize(mix(inNormal, inNormalNextFrame, t));
+	vec3 pos = mix(u_MorphFrames[current].xyz, u_MorphFrames[next].xyz, blend);
+	vec3 normal = normalize(mix(u_MorphFrames[current + 1].xyz, u_MorphFrames[next + 1].xyz, blend));
 
 	//apply the mvp matrix to the position
-	vec4 newPos = MVP * vec4(pos, 1.0);
+	vec4 newPos = mvp * vec4(pos, 1.0);
 
 	//pass data onto the frag shader
-	outPos = (Model * vec4(pos, 1.0)).xyz;
-	outNormal = NormalMat * normal;
+	outPos = (model * vec4(pos, 1.0)).xyz;
+	outNormal = normalMat * normal;
 	outUV = inUV;
+	outMaterial = material;
 	outColor = vec3(1.0f, 1.0f, 1.0f);
 
 	//set the position of the vertex
@@ -0,0 +1,153 @@
+//Titan Engine, by Atlas X Games
+// AllocationTracker.cpp - source file for the hook that counts heap allocations each frame by where they were made
+
+//precompile header, this file uses vector, array, atomic, and algorithm
+#include "Titan/ttn_pch.h"
+//include the header
+#include "Titan/AllocationTracker.h"
+//include the profiler, it's scopes are the sites allocations get put under
+#include "Titan/Profiler.h"
+//include imgui for the allocations window
+#include "imgui.h"
+
+#ifdef TTN_TRACK_ALLOCATIONS
+//replace the global operator new and delete so every allocation goes through the tracker
+//the nothrow versions call these, aligned allocations keep the default versions and don't get counted
+void* operator new(std::size_t size)
+{
+	Titan::TTN_AllocationTracker::Record(size);
+	void* memory = std::malloc((size > 0) ? size : 1);
+	if (memory == nullptr) throw std::bad_alloc();
+	return memory;
+}
+
+void* operator new[](std::size_t size)
+{
+	Titan::TTN_AllocationTracker::Record(size);
+	void* memory = std::malloc((size > 0) ? size : 1);
+	if (memory == nullptr) throw std::bad_alloc();
+	return memory;
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+#endif
+
+namespace Titan {
+	//gets wheter or not tracking was compiled in
+	bool TTN_AllocationTracker::GetAvailable()
+	{
+#ifdef TTN_TRACK_ALLOCATIONS
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	//counts an allocation
+	void TTN_AllocationTracker::Record(size_t bytes)
+	{
+		if (t_inside || !GetEnabled()) return;
+
+		//the scope names are string literals, so their pointers can be used as the key
+		const char* name = TTN_Profiler::GetCurrentScope();
+		if (name == nullptr) name = "(no scope)";
+
+		//find the site's slot, or claim an empty one
+		size_t start = (reinterpret_cast<uintptr_t>(name) >> 3) & (s_siteCount - 1);
+		for (size_t i = 0; i < s_siteCount; i++) {
+			TTN_SiteCounter& site = s_sites[(start + i) & (s_siteCount - 1)];
+			const char* existing = site.Name.load(std::memory_order_acquire);
+			if (existing == nullptr && site.Name.compare_exchange_strong(existing, name, std::memory_order_acq_rel))
+				existing = name;
+
+			if (existing == name) {
+				site.Count.fetch_add(1, std::memory_order_relaxed);
+				site.Bytes.fetch_add(bytes, std::memory_order_relaxed);
+				return;
+			}
+		}
+
+		//the table's full
+		s_overflow.Count.fetch_add(1, std::memory_order_relaxed);
+		s_overflow.Bytes.fetch_add(bytes, std::memory_order_relaxed);
+	}
+
+	//ends the frame
+	void TTN_AllocationTracker::EndFrame()
+	{
+		t_inside = true;
+
+		s_lastFrame.clear();
+		s_lastFrameCount = 0;
+		s_lastFrameBytes = 0;
+
+		//take every site's counts, sites keep their slots so they never have to be claimed again
+		auto collect = [](TTN_SiteCounter& counter, const char* name) {
+			TTN_AllocationSite site;
+			site.Name = name;
+			site.Count = counter.Count.exchange(0, std::memory_order_relaxed);
+			site.Bytes = counter.Bytes.exchange(0, std::memory_order_relaxed);
+			if (site.Count == 0) return;
+
+			s_lastFrame.push_back(site);
+			s_lastFrameCount += site.Count;
+			s_lastFrameBytes += site.Bytes;
+		};
+		for (TTN_SiteCounter& counter : s_sites) {
+			const char* name = counter.Name.load(std::memory_order_acquire);
+			if (name != nullptr) collect(counter, name);
+		}
+		collect(s_overflow, "(too many sites)");
+
+		//most allocations first
+		std::sort(s_lastFrame.begin(), s_lastFrame.end(), [](const TTN_AllocationSite& l, const TTN_AllocationSite& r) {
+			return l.Count > r.Count;
+		});
+
+		t_inside = false;
+	}
+
+	//draws the allocations window
+	void TTN_AllocationTracker::DrawImGui(bool* open)
+	{
+		if (!ImGui::Begin("Allocations", open)) {
+			ImGui::End();
+			return;
+		}
+
+		if (!GetAvailable()) {
+			ImGui::Text("Allocation tracking isn't compiled in, define TTN_TRACK_ALLOCATIONS to turn it on");
+			ImGui::End();
+			return;
+		}
+
+		bool enabled = GetEnabled();
+		if (ImGui::Checkbox("Track Allocations", &enabled)) SetEnabled(enabled);
+		ImGui::Text("Last frame: %d allocations, %.1f KB", (int)s_lastFrameCount, (float)s_lastFrameBytes / 1024.0f);
+		ImGui::Separator();
+
+		//one row per site
+		ImGui::Columns(3, "AllocationSites");
+		ImGui::Text("Site");
+		ImGui::NextColumn();
+		ImGui::Text("Allocations");
+		ImGui::NextColumn();
+		ImGui::Text("KB");
+		ImGui::NextColumn();
+		ImGui::Separator();
+		for (const TTN_AllocationSite& site : s_lastFrame) {
+			ImGui::Text("%s", site.Name);
+			ImGui::NextColumn();
+			ImGui::Text("%d", (int)site.Count);
+			ImGui::NextColumn();
+			ImGui::Text("%.1f", (float)site.Bytes / 1024.0f);
+			ImGui::NextColumn();
+		}
+		ImGui::Columns(1);
+
+		ImGui::End();
+	}
+}
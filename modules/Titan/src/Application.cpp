@@ -18,12 +18,7 @@ namespace Titan {
 	float TTN_Application::m_dt = 0.0f;
 	float TTN_Application::m_previousFrameTime = 0.0f;
 	std::vector<TTN_Scene*> TTN_Application::scenes = std::vector<TTN_Scene*>();
-	std::unordered_map<TTN_KeyCode, bool> TTN_Application::TTN_Input::KeyWasPressedMap;
-	std::unordered_map<TTN_KeyCode, bool> TTN_Application::TTN_Input::KeyPressed;
-	std::unordered_map<TTN_KeyCode, bool> TTN_Application::TTN_Input::KeyHandled;
-	std::unordered_map<TTN_MouseButton, bool> TTN_Application::TTN_Input::MouseWasPressedMap;
-	std::unordered_map<TTN_MouseButton, bool> TTN_Application::TTN_Input::MousePressed;
-	std::unordered_map<TTN_MouseButton, bool> TTN_Application::TTN_Input::MouseHandled;
+	TTN_SPSCQueue<TTN_Application::TTN_Input::InputEvent, 1024> TTN_Application::TTN_Input::Events;
 	glm::vec2 TTN_Application::TTN_Input::mousePos = glm::vec2(0.0f);
 	bool TTN_Application::TTN_Input::inFrame = false;
 	std::vector<std::function<void()>> imGuiCallbacks; 
@@ -59,8 +54,11 @@ namespace Titan {
 			throw std::runtime_error("glad init failed");
 		}
 
-		//set the cursor callbacks so we can get the cursor position
+		//set the input callbacks, they're set before imgui's so imgui passes the events on to them
 		glfwSetCursorEnterCallback(m_window, TTN_Input::cursorEnterFrameCallback);
+		glfwSetKeyCallback(m_window, TTN_Input::keyCallback);
+		glfwSetMouseButtonCallback(m_window, TTN_Input::mouseButtonCallback);
+		glfwSetCursorPosCallback(m_window, TTN_Input::cursorPosCallback);
 
 		//enable depth test so things don't get drawn on top of objects behind them 
 		glEnable(GL_DEPTH_TEST);
@@ -85,12 +83,45 @@ namespace Titan {
 		//Set the background colour for our scene to the base black
 		glClearColor(1.0f, 0.0f, 0.0f, 0.0f);
 
+		//name this thread on the profiler before the workers start so it's the first track
+		TTN_Profiler::SetThreadName("Main");
+
+		//start the worker threads for the job system, all the opengl calls stay on this thread
+		TTN_JobSystem::Init();
+
 		
 	}
 
+	//function to initialize without a window
+	void TTN_Application::InitHeadless(float fixedDeltaTime, uint32_t seed, int width, int height)
+	{
+		m_headless = true;
+		m_headlessClosing = false;
+
+		//step by a fixed time every frame
+		m_fixedDt = (fixedDeltaTime > 0.0f) ? fixedDeltaTime : 1.0f / 60.0f;
+
+		//tell the rest of titan there's no window or opengl context
+		TTN_Backend::SetHeadless(true, glm::ivec2(width, height));
+		//there's no context to time the gpu with
+		TTN_Profiler::SetGPUTiming(false);
+
+		//seed the random number generator so the run can be repeated
+		TTN_Random::SetSeed(seed);
+
+		//name this thread on the profiler before the workers start so it's the first track
+		TTN_Profiler::SetThreadName("Main");
+
+		//start the worker threads for the job system
+		TTN_JobSystem::Init();
+	}
+
 	//function to check if the window is being closed
 	bool TTN_Application::GetIsClosing()
 	{
+		//without a window it only closes when it's told to quit
+		if (m_headless) return m_headlessClosing;
+
 		//have glfw check if the user has tried to close the window, return what it says
 		return glfwWindowShouldClose(m_window);
 	}
@@ -98,10 +129,16 @@ namespace Titan {
 	//function that cleans things up when the window closes so there are no memory leaks and everything goes cleanly 
 	void TTN_Application::Closing()
 	{
-		//have glfw destroy the window 
-		glfwDestroyWindow(m_window);
-		//close glfw
-		glfwTerminate();
+		//finish any input recording so the file is complete
+		TTN_InputRecorder::StopRecording();
+		//stop the job system's worker threads
+		TTN_JobSystem::Shutdown();
+		//if there's a window, have glfw destroy the window and close
+		if (!m_headless) {
+			glfwDestroyWindow(m_window);
+			glfwTerminate();
+		}
+		m_headlessClosing = true;
 		//delete scene pointers
 		for (auto x : scenes)
 			delete x;
@@ -110,15 +147,25 @@ namespace Titan {
 	void TTN_Application::NewFrameStart()
 	{
 		//Find deltatime for the frame 
-		//first grab the current time from glfw
-		float Currenttime = (float)glfwGetTime();
-		//calculate deltatime by subtracting the time at the last frame
-		m_dt = Currenttime - m_previousFrameTime;
-		//save time in the previous frame time variable so we can calculate deltatime correctly next frame 
-		m_previousFrameTime = Currenttime;
+		//if it's using a fixed timestep, every frame is the same length
+		if (m_fixedDt > 0.0f || m_headless) {
+			m_dt = m_fixedDt;
+			m_previousFrameTime += m_fixedDt;
+		}
+		else {
+			//first grab the current time from glfw
+			float Currenttime = (float)glfwGetTime();
+			//calculate deltatime by subtracting the time at the last frame
+			m_dt = Currenttime - m_previousFrameTime;
+			//save time in the previous frame time variable so we can calculate deltatime correctly next frame 
+			m_previousFrameTime = Currenttime;
+		}
+
+		//let the input recorder save the delta time, or replace it with the recorded one when it's playing back
+		m_dt = TTN_InputRecorder::BeginFrame(m_dt);
 
 		//Clear our window 
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		if (!m_headless) glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	}
 
 	//function to get the delta time so it can be used for other operations and systems
@@ -136,34 +183,88 @@ namespace Titan {
 	//function to run each frame 
 	void TTN_Application::Update()
 	{
+		//start a new profiler frame
+		TTN_Profiler::BeginFrame();
+
 		//start a new frame 
 		TTN_Application::NewFrameStart();
 
+		//without a window there's no input, ui, or rendering, so just step the scenes
+		if (m_headless) {
+			for (size_t i = 0; i < TTN_Application::scenes.size(); i++) {
+				if (TTN_Application::scenes[i]->GetShouldRender()) {
+					{
+						TTN_PROFILE_SCOPE("Scene::Update");
+						TTN_Application::scenes[i]->Update(m_dt);
+					}
+					{
+						TTN_PROFILE_SCOPE("Scene::FlushDestroyQueue");
+						TTN_Application::scenes[i]->FlushDestroyQueue();
+					}
+				}
+			}
+
+			TTN_InputRecorder::EndFrame();
+			TTN_Profiler::EndFrame();
+			TTN_AllocationTracker::EndFrame();
+			TTN_FrameArena::NextFrame();
+			return;
+		}
+
 		//start ImGui
 		StartImgui();
 
 		//check for events from glfw 
-		glfwPollEvents();
+		{
+			TTN_PROFILE_SCOPE("PollEvents");
+			glfwPollEvents();
+		}
+
+		//apply the input events glfw just sent
+		TTN_Input::Update();
 
 		//update the asset system
-		TTN_AssetSystem::Update();
+		{
+			TTN_PROFILE_SCOPE("AssetSystem::Update");
+			TTN_AssetSystem::Update();
+		}
 
 		//go through each scene 
 		for (int i = 0; i < TTN_Application::scenes.size(); i++) {
 			//and check if they should be rendered
 			if (TTN_Application::scenes[i]->GetShouldRender()) {
 				//if they should, then check input, update, and render them 
-				TTN_Application::scenes[i]->KeyDownChecks();
-				TTN_Application::scenes[i]->KeyChecks();
-				TTN_Application::scenes[i]->KeyUpChecks();
-
-				TTN_Application::scenes[i]->MouseButtonDownChecks();
-				TTN_Application::scenes[i]->MouseButtonChecks();
-				TTN_Application::scenes[i]->MouseButtonUpChecks();
-
-				TTN_Application::scenes[i]->Update(m_dt);
-				TTN_Application::scenes[i]->Render();
-				TTN_Application::scenes[i]->PostRender();
+				{
+					TTN_PROFILE_SCOPE("Scene::Input");
+					TTN_Application::scenes[i]->KeyDownChecks();
+					TTN_Application::scenes[i]->KeyChecks();
+					TTN_Application::scenes[i]->KeyUpChecks();
+
+					TTN_Application::scenes[i]->MouseButtonDownChecks();
+					TTN_Application::scenes[i]->MouseButtonChecks();
+					TTN_Application::scenes[i]->MouseButtonUpChecks();
+				}
+
+				{
+					TTN_PROFILE_SCOPE("Scene::Update");
+					TTN_Application::scenes[i]->Update(m_dt);
+				}
+				{
+					TTN_PROFILE_SCOPE("Scene::Render");
+					TTN_PROFILE_GPU_SCOPE("Scene::Render");
+					TTN_Application::scenes[i]->Render();
+				}
+				{
+					TTN_PROFILE_SCOPE("Scene::PostRender");
+					TTN_PROFILE_GPU_SCOPE("Scene::PostRender");
+					TTN_Application::scenes[i]->PostRender();
+				}
+
+				//delete any entities that were queued for deletion during the frame
+				{
+					TTN_PROFILE_SCOPE("Scene::FlushDestroyQueue");
+					TTN_Application::scenes[i]->FlushDestroyQueue();
+				}
 			}
 		}
 
@@ -172,17 +273,34 @@ namespace Titan {
 		//reset the mouse buttons so they work properly on the next frame
 		TTN_Application::TTN_Input::ResetMouseButtons();
 
+		//that's the last time the input is read this frame, so the input recorder can save it
+		TTN_InputRecorder::EndFrame();
+
 		//now all the scenes that should be rendered (current gameplay scene, ui, etc.) will be rendered
 		//while anything that doesn't need to be rendered (such as a prefabs scene) will not 
 		
 		//end Imgui, rendering it
-		EndImgui();
+		{
+			TTN_PROFILE_SCOPE("ImGui");
+			TTN_PROFILE_GPU_SCOPE("ImGui");
+			EndImgui();
+		}
 
-		//set the last effect to nullpointer so it's set up correctly for the next frame
-		TTN_Backend::SetLastEffect(nullptr);
+		//set the last frame to nullpointer so it's set up correctly for the next frame
+		TTN_Backend::SetLastFrame(nullptr);
 
 		//swap the buffers so all the drawings that the scenes just did are acutally visible 
-		glfwSwapBuffers(m_window);
+		{
+			TTN_PROFILE_SCOPE("SwapBuffers");
+			glfwSwapBuffers(m_window);
+		}
+
+		//end the profiler frame, collecting everything that was timed
+		TTN_Profiler::EndFrame();
+		//collect the frame's allocations
+		TTN_AllocationTracker::EndFrame();
+		//and throw away everything the frame allocated from the frame arenas
+		TTN_FrameArena::NextFrame();
 	}
 
 	//quits the application
@@ -275,190 +393,121 @@ namespace Titan {
 	//checks if a key is being pressed
 	bool TTN_Application::TTN_Input::GetKey(TTN_KeyCode key)
 	{
-		//check if the keyinputted currently exists in the map
-		if (KeyWasPressedMap.find(key) == KeyWasPressedMap.end())
-		{
-			//if it doesn't, add it to the map (doing this here means we only add keys to the map if the user acutally wants to use them) 
-			KeyWasPressedMap[key] = false;
-			KeyHandled[key] = false;
-			KeyPressed[key] = false;
-		}
-		//check if the key has been pressed
-		if (glfwGetKey(m_window, static_cast<int>(key)))
-		{
-			//if it has, set it's place in the map to true
-			KeyWasPressedMap.at(key) = true;
-			//return true as the key is being pressed
-			return true;
-		}
-		//if it hasn't been pressed, return false
-		return false;
+		//keys glfw doesn't know (Key_Unknown) are never down
+		size_t code = static_cast<size_t>(key);
+		return code < s_keyCount && KeysDown[code];
 	}
 
 	//checks if this is the first frame a key is being pressed
 	bool TTN_Application::TTN_Input::GetKeyDown(TTN_KeyCode key)
 	{
-		//check first if the key exists in the map
-		if (KeyWasPressedMap.find(key) == KeyWasPressedMap.end())
-		{
-			//if it doesn't, pass it onto the getKey so it can create a place in the map, and check if it is being pressed
-			if (GetKey(key))
-			{
-				//if it sets the flag and return true that means the key has been pressed this frame
-				KeyHandled.at(key) = true;
-				KeyPressed.at(key) = true;
-				return true;
-			}
-		}
-		//if it does exist in the map, check if it was already handled this frame
-		else if (KeyHandled.at(key)) {
-			return true;
-		}
-		//if it does exist in the map and was not handled yet this frame, check if the value in the map is false and if the key is being pressed
-		else if (GetKey(key) && !KeyPressed.at(key)) {
-			//if it is, then this is the first frame where it's being pressed so set the flags and return true
-			KeyHandled.at(key) = true;
-			KeyPressed.at(key) = true;
-
-			return true;
-		}
-		//if it's not being pressed make sure the flag reflects that
-		else if (!GetKey(key)) {
-			KeyPressed.at(key) = false;
-		}
-
-		//and return false as it's not being pressed
-		return false;
+		//it's the first frame if it's down now but wasn't last frame
+		size_t code = static_cast<size_t>(key);
+		return code < s_keyCount && KeysDown[code] && !KeysDownLastFrame[code];
 	}
 
-	//checks if a key was pressed down, but has now been released
+	//checks if a key has been pressed but has now been released
 	bool TTN_Application::TTN_Input::GetKeyUp(TTN_KeyCode key)
 	{
-		//check if the key is currently down, if it isn't, and it was marked as being down, that means it's been release this frame
-		if (!GetKey(key) && KeyWasPressedMap.at(key))
-		{
-			//return true to say it's been released
-			return true;
-		}
-		//if not then the key is either still down, or was never put down in the first place, so just return false
-		return false;
+		//it's been released this frame if it isn't down now but was last frame
+		size_t code = static_cast<size_t>(key);
+		return code < s_keyCount && !KeysDown[code] && KeysDownLastFrame[code];
 	}
 
 	//call once a frame to make the input system work
 	void TTN_Application::TTN_Input::ResetKeys()
 	{
-		//reset each key
-		for (auto& it : KeyWasPressedMap) {
-			//if it's not currently being pressed, we need to reset the was pressed flag
-			if (!glfwGetKey(m_window, static_cast<int>(it.first)))
-				it.second = false;
-		}
-		for (auto& it : KeyHandled) {
-			it.second = false;
-		}
+		//save what's down so the next frame can tell what's changed
+		KeysDownLastFrame = KeysDown;
 	}
 
 	//returns the mouse position in screenspace
 	glm::vec2 TTN_Application::TTN_Input::GetMousePosition()
 	{
-		//check if the mous is in the window
-		if (inFrame)
-		{
-			//if it is get the position of it from glfw (if it's not this will just return the pos as of the last frame the mouse
-			//was in the window)
-			double tempX, tempY;
-			glfwGetCursorPos(m_window, &tempX, &tempY);
-			mousePos = glm::vec2(tempX, tempY);
-		}
-			
-		//pass the mouse position to the user
+		//pass the mouse position to the user, it's only updated while the mouse is in the window so otherwise it's the
+		//position as of the last frame the mouse was in the window
 		return mousePos;
 	}
 
 	//checks if a mouse button is being pressed
 	bool TTN_Application::TTN_Input::GetMouseButton(TTN_MouseButton button)
 	{
-		//check if the button inputted currently exists in the map
-		if (MouseWasPressedMap.find(button) == MouseWasPressedMap.end())
-		{
-			//if it doesn't, add it to the map (doing this here means we only add buttons to the map if the user acutally wants to use them) 
-			MouseWasPressedMap[button] = false;
-			MouseHandled[button] = false;
-			MousePressed[button] = false;
-		}
-		//check if the button has been pressed
-		if (glfwGetMouseButton(m_window, static_cast<int>(button)))
-		{
-			//if it has, set it's place in the map to true
-			MouseWasPressedMap.at(button) = true;
-			//return true as the button is being pressed
-			return true;
-		}
-		//if it hasn't been pressed, return false
-		return false;
+		size_t code = static_cast<size_t>(button);
+		return code < s_mouseButtonCount && MouseDown[code];
 	}
 
 	//checks if this is the first frame a mouse button is being pressed
 	bool TTN_Application::TTN_Input::GetMouseButtonDown(TTN_MouseButton button)
 	{
-		//check first if the button exists in the map
-		if (MouseWasPressedMap.find(button) == MouseWasPressedMap.end())
-		{
-			//if it doesn't, pass it onto the getMouseButton so it can create a place in the map, and check if it is being pressed
-			if (GetMouseButton(button))
-			{
-				//if it sets the flag and return true that means the key has been pressed this frame
-				MouseHandled.at(button) = true;
-				MousePressed.at(button) = true;
-				return true;
-			}
-		}
-		//if it does exist in the map, check if it was handleded already this frame
-		else if (MouseHandled.at(button)) {
-			//if it was, then return true
-			return true;
-		}
-		//if it does exist in the map and was not yet handleded in this frame, check if the value in the map is false and if the button is being pressed
-		else if (GetMouseButton(button) && !MousePressed.at(button)) {
-			//if it is, then this is the first frame where it's being pressed so set the flags and return true
-			MouseHandled.at(button) = true;
-			MousePressed.at(button) = true;
-
-			return true;
-		}
-		//if it's not being pressed make sure the flag reflects that
-		else if (!GetMouseButton(button)) {
-			MousePressed.at(button) = false;
-		}
-
-		//and return false as it's not being pressed
-		return false;
+		size_t code = static_cast<size_t>(button);
+		return code < s_mouseButtonCount && MouseDown[code] && !MouseDownLastFrame[code];
 	}
 
 	//checks if a mouse button has been pressed but has now been released
 	bool TTN_Application::TTN_Input::GetMouseButtonUp(TTN_MouseButton button)
 	{
-		//check if the button is currently down, if it isn't, and it was marked as being down, that means it's been release this frame
-		if (!GetMouseButton(button) && MouseWasPressedMap.at(button))
-		{
-			//return true to say it's been released
-			return true;
-		}
-		//if not then the button is either still down, or was never put down in the first place, so just return false
-		return false;
+		size_t code = static_cast<size_t>(button);
+		return code < s_mouseButtonCount && !MouseDown[code] && MouseDownLastFrame[code];
 	}
 
 	//call once a frame to make the input system work
 	void TTN_Application::TTN_Input::ResetMouseButtons()
 	{
-		//reset each mouse button
-		for (auto& it : MouseWasPressedMap) {
-			//if it's not currently being pressed, we need to reset the was pressed flag
-			if (!glfwGetMouseButton(m_window, static_cast<int>(it.first)))
-				it.second = false;
+		//save what's down so the next frame can tell what's changed
+		MouseDownLastFrame = MouseDown;
+	}
+
+	//applies the queued input events
+	void TTN_Application::TTN_Input::Update()
+	{
+		//keys and buttons that have already changed this frame
+		std::bitset<s_keyCount> keysChanged;
+		std::bitset<s_mouseButtonCount> mouseChanged;
+
+		const InputEvent* event = nullptr;
+		while ((event = Events.Peek()) != nullptr) {
+			if (event->EventType == InputEvent::Type::KEY) {
+				//if the key has already changed this frame, leave the rest of the events for the next frame so a quick tap
+				//is still seen as a press then a release instead of cancelling out
+				if (keysChanged[event->Code]) break;
+				keysChanged[event->Code] = true;
+				KeysDown[event->Code] = event->Down;
+			}
+			else if (event->EventType == InputEvent::Type::MOUSE_BUTTON) {
+				//same for the mouse buttons
+				if (mouseChanged[event->Code]) break;
+				mouseChanged[event->Code] = true;
+				MouseDown[event->Code] = event->Down;
+			}
+			else if (event->EventType == InputEvent::Type::CURSOR_POS) {
+				//the mouse's position is only kept while it's in the window
+				if (inFrame) mousePos = event->Pos;
+			}
+			else if (event->EventType == InputEvent::Type::CURSOR_ENTER) {
+				inFrame = event->Down;
+			}
+
+			InputEvent popped;
+			Events.Pop(popped);
+		}
+
+		//while playing back, the recording replaces what was actually pressed
+		if (TTN_InputRecorder::GetPlaying()) {
+			KeysDown.reset();
+			for (auto& it : TTN_InputRecorder::GetKeys())
+				if (it.first >= 0 && it.first < (int)s_keyCount) KeysDown[it.first] = it.second;
+			MouseDown.reset();
+			for (auto& it : TTN_InputRecorder::GetMouseButtons())
+				if (it.first >= 0 && it.first < (int)s_mouseButtonCount) MouseDown[it.first] = it.second;
+			mousePos = TTN_InputRecorder::GetMousePosition();
 		}
-		for (auto& it : MouseHandled) {
-			it.second = false;
+		//while recording, save anything that changed
+		else if (TTN_InputRecorder::GetRecording()) {
+			for (size_t i = 0; i < s_keyCount; i++)
+				if (KeysDown[i] != KeysDownLastFrame[i]) TTN_InputRecorder::RecordKey((int)i, KeysDown[i]);
+			for (size_t i = 0; i < s_mouseButtonCount; i++)
+				if (MouseDown[i] != MouseDownLastFrame[i]) TTN_InputRecorder::RecordMouseButton((int)i, MouseDown[i]);
+			TTN_InputRecorder::RecordMousePosition(mousePos);
 		}
 	}
 
@@ -482,8 +531,46 @@ namespace Titan {
 	//gets from glfw wheter or not the mouse is in the frame, do not call as user
 	void TTN_Application::TTN_Input::cursorEnterFrameCallback(GLFWwindow* window, int entered)
 	{
-		//set wheter or not the mouse is in the frame
-		inFrame = entered;
+		//queue wheter or not the mouse is in the frame
+		InputEvent event;
+		event.EventType = InputEvent::Type::CURSOR_ENTER;
+		event.Down = (entered != 0);
+		Events.Push(event);
+	}
+
+	//gets a key changing from glfw, do not call as user
+	void TTN_Application::TTN_Input::keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
+	{
+		//repeats don't change anything, and unknown keys can't be stored
+		if (action == GLFW_REPEAT || key < 0 || key >= (int)s_keyCount) return;
+
+		InputEvent event;
+		event.EventType = InputEvent::Type::KEY;
+		event.Code = key;
+		event.Down = (action == GLFW_PRESS);
+		//if the queue is full the event is dropped, it's big enough that only a very long hitch would fill it
+		Events.Push(event);
+	}
+
+	//gets a mouse button changing from glfw, do not call as user
+	void TTN_Application::TTN_Input::mouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
+	{
+		if (button < 0 || button >= (int)s_mouseButtonCount) return;
+
+		InputEvent event;
+		event.EventType = InputEvent::Type::MOUSE_BUTTON;
+		event.Code = button;
+		event.Down = (action == GLFW_PRESS);
+		Events.Push(event);
+	}
+
+	//gets the mouse moving from glfw, do not call as user
+	void TTN_Application::TTN_Input::cursorPosCallback(GLFWwindow* window, double x, double y)
+	{
+		InputEvent event;
+		event.EventType = InputEvent::Type::CURSOR_POS;
+		event.Pos = glm::vec2(x, y);
+		Events.Push(event);
 	}
 
 	//gets the window width from glfw
@@ -18,6 +18,18 @@ namespace Titan {
 		s_setsLoaded[set] = false;
 	}
 
+	//adds a 2D texture to an atlas to be packed
+	void TTN_AssetSystem::AddTexture2DToAtlas(std::string accessName, std::string fileName, std::string atlasName, int set) {
+		//ensure the set is a atleast zero
+		if (set < 0)
+			LOG_ERROR("Asset Sets cannot be a number below 0");
+
+		//push the asset back in the approriate atlas
+		s_atlasesToLoad[set][atlasName].push_back(AccessAndFileName(accessName, fileName));
+
+		s_setsLoaded[set] = false;
+	}
+
 	//adds a cubemap to the list of assets to be loaded
 	void TTN_AssetSystem::AddSkyboxToBeLoaded(std::string accessName, std::string fileName, int set) {
 		//ensure the set is a atleast zero
@@ -136,6 +148,16 @@ namespace Titan {
 		return nullptr;
 	}
 
+	//gets a texture atlas pointer from the system
+	TTN_TextureAtlas::satlasptr TTN_AssetSystem::GetTextureAtlas(std::string accessName) {
+		//if there is an atlas in that slot return it
+		if (s_atlasMap.count(accessName))
+			return s_atlasMap[accessName];
+
+		//otherwise return a nullpointer
+		return nullptr;
+	}
+
 	//gets an existing cubemap texture poitner from the system
 	TTN_TextureCubeMap::stcmptr TTN_AssetSystem::GetSkybox(std::string accessName) {
 		//if there is a cubemap texture in that slot return it 
@@ -197,6 +219,9 @@ namespace Titan {
 			}
 		}
 
+		//pack the set's atlases
+		LoadAtlases(set);
+
 		//confirm there are cubemaps in the set 
 		if (s_CubemapsToLoad.size() > set) {
 			//iterate through all the cubemap textures in the set next
@@ -299,14 +324,16 @@ namespace Titan {
 						s_texture2DMap[s_2DTexturesToLoad[s_loadQueue[0]][s_CurrentAssetIndex].m_AccessName] =
 							TTN_Texture2D::LoadFromFile(s_2DTexturesToLoad[s_loadQueue[0]][s_CurrentAssetIndex].m_FileName);
 					}
-					//if it is, then move onto cubemaps
+					//if it is, then pack the atlases and move onto cubemaps
 					else {
+						LoadAtlases(s_loadQueue[0]);
 						s_CurrentAssetType = 1;
 						s_CurrentAssetIndex = -1;
 					}
 				}
-				//if there aren't, move onto cubemaps
+				//if there aren't, pack the atlases and move onto cubemaps
 				else {
+					LoadAtlases(s_loadQueue[0]);
 					s_CurrentAssetType = 1;
 					s_CurrentAssetIndex = -1;
 				}
@@ -480,4 +507,27 @@ namespace Titan {
 		//otherwise return -1
 		return -1;
 	}
-}
\ No newline at end of file
+
+	//packs every atlas in a set
+	void TTN_AssetSystem::LoadAtlases(int set) {
+		//confirm there are atlases in the set
+		if (!s_atlasesToLoad.count(set))
+			return;
+
+		for (auto& atlas : s_atlasesToLoad[set]) {
+			//gather the textures going into it
+			std::vector<std::pair<std::string, std::string>> images;
+			for (auto& it : atlas.second)
+				images.push_back(std::make_pair(it.m_AccessName, it.m_FileName));
+
+			//pack them, cached under the atlas's name if there's a cache folder
+			TTN_TextureAtlas::satlasptr temp = TTN_TextureAtlas::Create();
+			temp->Build(images, s_atlasCacheDirectory.empty() ? "" : s_atlasCacheDirectory + "/" + atlas.first);
+			s_atlasMap[atlas.first] = temp;
+
+			//and store each region as a texture, so they're accessed the same way as any other texture
+			for (auto& region : temp->GetRegions())
+				s_texture2DMap[region.first] = region.second;
+		}
+	}
+}
@@ -4,6 +4,9 @@
 namespace Titan {
 	glm::ivec2 Titan::TTN_Backend::GetWindowSize()
 	{
+		//there's no window to ask when running headless
+		if (m_headless) return m_headlessSize;
+
 		int width, height;
 		glfwGetWindowSize(m_window, &width, &height);
 		return glm::ivec2(width, height);
@@ -11,16 +11,8 @@ namespace Titan {
 	//initliazes the color correction effect
 	void TTN_ColorCorrect::Init(unsigned width, unsigned height)
 	{
-		//Set up framebuffers
-		//creates a new framebuffer with a basic color and depth target
-		int index = (int)m_buffers.size();
-		m_buffers.push_back(TTN_Framebuffer::Create());
-		m_buffers[index]->AddColorTarget(GL_RGBA8);
-		m_buffers[index]->AddDepthTarget();
-		//initliaze the framebuffer
-		m_buffers[index]->Init(width, height);
-
-		index = (int)m_shaders.size();
+		//the output comes from the render graph so all this needs is the shader
+		int index = (int)m_shaders.size();
 		//set up color correction shader
 		m_shaders.push_back(TTN_Shader::Create());
 		//load in the shader
@@ -33,20 +25,51 @@ namespace Titan {
 	}
 
 	//applies the effect to the full screen quad
-	void TTN_ColorCorrect::ApplyEffect(TTN_PostEffect::spostptr buffer)
+	void TTN_ColorCorrect::ApplyEffect(const TTN_Framebuffer::sfboptr& source, const TTN_Framebuffer::sfboptr& target)
 	{
-		//binds the shader (size() - 2 because we're loading the pass through as the last shader, and thus this is the second last shader)
-		BindShader(m_shaders.size() - 2);
-		m_shaders[m_shaders.size() - 2]->SetUniform("u_Intensity", m_intensity);
+		//binds the shader
+		BindShader(0);
+		m_shaders[0]->SetUniform("u_Intensity", m_intensity);
+		m_shaders[0]->SetUniform("u_UVScale", source->GetUVScale());
 		//binds the color 
-		buffer->BindColorAsTexture(0, 0, 0);
+		source->BindColorAsTexture(0, 0);
 		//binds the cube 
 		m_cube->bind(30);
 		//renders to the full screen quad
-		m_buffers[0]->RenderToFSQ();
+		target->RenderToFSQ();
 		//unbinds everything
 		m_cube->unbind(30);
-		buffer->UnbindTexture(0);
+		source->UnbindTexture(0);
 		UnbindShader();
 	}
+
+	//gets the glsl for the fused shader
+	std::string TTN_ColorCorrect::GetFusedSource(const std::string& name, int firstSlot) const
+	{
+		//the cube and intensity are named after the function, so each colour correction in the shader gets it's own
+		std::string cube = name + "_Cube";
+		std::string intensity = name + "_Intensity";
+		return
+			"layout (binding = " + std::to_string(firstSlot) + ") uniform sampler3D " + cube + ";\n"
+			"uniform float " + intensity + " = 1.0;\n"
+			"vec4 " + name + "(vec4 color) {\n"
+			"	float size = float(textureSize(" + cube + ", 0).x);\n"
+			"	vec3 scale = vec3((size - 1.0) / size);\n"
+			"	vec3 offset = vec3(1.0 / (2.0 * size));\n"
+			"	return vec4(mix(color.rgb, texture(" + cube + ", scale * color.rgb + offset).rgb, " + intensity + "), color.a);\n"
+			"}\n";
+	}
+
+	//sets the uniforms and binds the cube for a fused pass
+	void TTN_ColorCorrect::BindFused(const TTN_Shader::sshptr& shader, const std::string& name, int firstSlot)
+	{
+		shader->SetUniform(name + "_Intensity", m_intensity);
+		m_cube->bind(firstSlot);
+	}
+
+	//unbinds the cube after a fused pass
+	void TTN_ColorCorrect::UnbindFused(int firstSlot)
+	{
+		m_cube->unbind(firstSlot);
+	}
 }
\ No newline at end of file
@@ -0,0 +1,107 @@
+//Titan Engine, by Atlas X Games 
+// EntityPool.cpp - source file for the class that keeps a pool of reusable entities made from a prefab
+
+//precompile header, this file uses entt.hpp and algorithm
+#include "Titan/ttn_pch.h"
+//include the header
+#include "Titan/EntityPool.h"
+//include the scene the entities live in
+#include "Titan/Scene.h"
+
+namespace Titan {
+	//constructor, creates the inital entities
+	TTN_EntityPool::TTN_EntityPool(TTN_Scene* scene, TTN_Prefab::sprefabptr prefab, size_t initialSize)
+		: m_scene(scene), m_prefab(prefab), m_size(0), m_highWaterMark(0)
+	{
+		m_free = std::vector<entt::entity>();
+		Grow(initialSize);
+	}
+
+	//gets an entity from the pool and activates it
+	entt::entity TTN_EntityPool::Acquire(TTN_Transform trans)
+	{
+		TTN_PROFILE_SCOPE("EntityPool::Acquire");
+
+		//throw away any entities that have been deleted from outside the pool
+		while (!m_free.empty() && !m_scene->GetScene()->valid(m_free.back())) {
+			m_free.pop_back();
+			m_size--;
+		}
+
+		//if there's nothing left, grow the pool by half again
+		if (m_free.empty()) Grow(std::max<size_t>(1, m_size / 2));
+
+		//take the entity off the free list
+		entt::entity entity = m_free.back();
+		m_free.pop_back();
+
+		//move it into place
+		TTN_Transform& entityTrans = m_scene->Get<TTN_Transform>(entity);
+		entityTrans.SetPos(trans.GetPos());
+		entityTrans.SetRotationQuat(trans.GetRotQuat());
+		entityTrans.SetScale(trans.GetScale());
+
+		//reset the physics body, it was kept allocated while it was out of the world
+		if (m_scene->Has<TTN_Physics>(entity))
+			m_scene->Get<TTN_Physics>(entity).Reset(trans.GetPos());
+
+		//clear out any particles left over from the last time it was used
+		if (m_scene->Has<TTN_ParticeSystemComponent>(entity))
+			m_scene->Get<TTN_ParticeSystemComponent>(entity).GetParticleSystemPointer()->Reset();
+
+		//restart it's lifetime
+		if (m_scene->Has<TTN_DeleteCountDown>(entity))
+			m_scene->Get<TTN_DeleteCountDown>(entity).SetLifeLeft(m_scene->Get<TTN_PooledEntity>(entity).lifeTime);
+
+		//and queue it to be activated
+		m_scene->Get<TTN_PooledEntity>(entity).inUse = true;
+		m_scene->QueueSetActive(entity, true);
+
+		//update the high water mark
+		m_highWaterMark = std::max(m_highWaterMark, GetActiveCount());
+
+		return entity;
+	}
+
+	//deactivates an entity and returns it to the pool
+	void TTN_EntityPool::Release(entt::entity entity)
+	{
+		TTN_PROFILE_SCOPE("EntityPool::Release");
+
+		//if the entity has already been released don't add it again
+		if (!m_scene->GetScene()->valid(entity) || !m_scene->Get<TTN_PooledEntity>(entity).inUse) return;
+
+		m_scene->Get<TTN_PooledEntity>(entity).inUse = false;
+		m_scene->QueueSetActive(entity, false);
+		m_free.push_back(entity);
+	}
+
+	//creates more entities for the pool
+	void TTN_EntityPool::Grow(size_t count)
+	{
+		if (count == 0) return;
+
+		//make the entities from the prefab in one go
+		std::vector<entt::entity> entities = m_scene->Instantiate(m_prefab, count);
+
+		//save the lifetime their countdowns should be reset to
+		float lifeTime = 0.0f;
+		if (m_scene->Has<TTN_DeleteCountDown>(entities[0]))
+			lifeTime = m_scene->Get<TTN_DeleteCountDown>(entities[0]).GetLifeLeft();
+
+		//mark them as belonging to this pool
+		TTN_PooledEntity pooled;
+		pooled.pool = this;
+		pooled.lifeTime = lifeTime;
+		m_scene->GetScene()->insert<TTN_PooledEntity>(entities.begin(), entities.end(), pooled);
+
+		//deactivate them all and add them to the free list
+		m_scene->SetActive(entities, false);
+		m_free.reserve(m_size + count);
+		m_free.insert(m_free.end(), entities.begin(), entities.end());
+		m_size += count;
+
+		//each entity can be queued to switch on and back off in the same frame, so make room for both
+		m_scene->ReserveActiveQueue(count * 2);
+	}
+}
@@ -0,0 +1,71 @@
+//Titan Engine, by Atlas X Games
+// FrameArena.cpp - source file for the per thread bump allocator for memory that only has to last until the end of the frame
+
+//precompile header, this file uses vector, memory, memory_resource, atomic, and mutex
+#include "Titan/ttn_pch.h"
+//include the header
+#include "Titan/FrameArena.h"
+
+namespace Titan {
+	//gets the calling thread's arena
+	TTN_FrameArena& TTN_FrameArena::Get()
+	{
+		//the lock is only taken the first time a thread asks for it's arena
+		if (t_arena == nullptr) {
+			std::lock_guard<std::mutex> guard(s_arenaLock);
+			s_arenas.push_back(std::make_unique<TTN_FrameArena>());
+			t_arena = s_arenas.back().get();
+			t_arena->m_frame = s_frame.load(std::memory_order_acquire);
+		}
+
+		//if a new frame has started since it was last used, empty it
+		if (t_arena->m_frame != s_frame.load(std::memory_order_acquire)) t_arena->Reset();
+
+		return *t_arena;
+	}
+
+	//empties the arena
+	void TTN_FrameArena::Reset()
+	{
+		//if the last frame needed more than one block, swap them for one block big enough for all of it so the next frame stays in one block
+		if (m_blocks.size() > 1) {
+			size_t total = m_capacity;
+			m_blocks.clear();
+			m_blocks.push_back({ std::unique_ptr<std::byte[]>(new std::byte[total]), total });
+		}
+
+		m_block = 0;
+		m_offset = 0;
+		m_used = 0;
+		m_frame = s_frame.load(std::memory_order_acquire);
+	}
+
+	//allocates from the arena
+	void* TTN_FrameArena::do_allocate(size_t bytes, size_t alignment)
+	{
+		//try the current block, then any blocks after it
+		while (m_block < m_blocks.size()) {
+			TTN_ArenaBlock& block = m_blocks[m_block];
+			uintptr_t base = reinterpret_cast<uintptr_t>(block.Memory.get());
+			//round the offset up to the alignment
+			size_t aligned = (size_t)(((base + m_offset + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base);
+			if (aligned + bytes <= block.Size) {
+				m_offset = aligned + bytes;
+				m_used += bytes;
+				m_peak = std::max(m_peak, m_used);
+				return reinterpret_cast<void*>(base + aligned);
+			}
+
+			m_block++;
+			m_offset = 0;
+		}
+
+		//nothing's got room, add a block with enough space for the allocation even after it's aligned
+		size_t size = std::max(GetBlockSize(), bytes + alignment);
+		m_blocks.push_back({ std::unique_ptr<std::byte[]>(new std::byte[size]), size });
+		m_capacity += size;
+		m_block = m_blocks.size() - 1;
+
+		return do_allocate(bytes, alignment);
+	}
+}
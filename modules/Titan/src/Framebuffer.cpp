@@ -72,6 +72,10 @@ namespace Titan {
 		if (!m_isInitFSQ)
 			InitFullScreenQuad();
 
+		//make sure the textures are at least as big as the size being drawn to
+		m_allocWidth = std::max(m_allocWidth, m_width);
+		m_allocHeight = std::max(m_allocHeight, m_height);
+
 		//Generates the FBO
 		glGenFramebuffers(1, &m_FBO);
 		//Bind it
@@ -90,7 +94,7 @@ namespace Titan {
 			//Binds the texture
 			glBindTexture(GL_TEXTURE_2D, m_depth.m_texture->GetHandle());
 			//Sets the texture data
-			glTexStorage2D(GL_TEXTURE_2D, 1, GL_DEPTH_COMPONENT24, m_width, m_height);
+			glTexStorage2D(GL_TEXTURE_2D, 1, GL_DEPTH_COMPONENT24, m_allocWidth, m_allocHeight);
 
 			//Set texture parameters
 			glTextureParameteri(m_depth.m_texture->GetHandle(), GL_TEXTURE_MIN_FILTER, m_filter);
@@ -127,7 +131,7 @@ namespace Titan {
 				//Binds the texture
 				glBindTexture(GL_TEXTURE_2D, m_color.m_textures[i]->GetHandle());
 				//Sets the texture storage
-				glTexStorage2D(GL_TEXTURE_2D, 1, m_color.m_formats[i], m_width, m_height);
+				glTexStorage2D(GL_TEXTURE_2D, 1, m_color.m_formats[i], m_allocWidth, m_allocHeight);
 
 				//Set texture parameters
 				glTextureParameteri(m_color.m_textures[i]->GetHandle(), GL_TEXTURE_MIN_FILTER, m_filter);
@@ -195,21 +199,44 @@ namespace Titan {
 		glBindTexture(GL_TEXTURE_2D, GL_NONE);
 	}
 
-	//dynamically change the shape of the framebuffer and recreate it
+	//dynamically change the shape of the framebuffer
 	void TTN_Framebuffer::Reshape(unsigned width, unsigned height)
 	{
 		//Set size
 		SetSize(width, height);
+
+		//if it still fits in the textures that are already there, that's all that's needed, the viewport and uv scale handle the rest
+		if (_isInit && width <= m_allocWidth && height <= m_allocHeight)
+			return;
+
+		//otherwise grow the textures with some headroom so the next few resizes don't have to do this again
+		m_allocWidth = std::max(m_allocWidth, (unsigned)(width * s_headroom));
+		m_allocHeight = std::max(m_allocHeight, (unsigned)(height * s_headroom));
+
 		//Unloads the framebuffer
 		Unload();
 		//Unload the depth target
-		m_depth.Unload();
+		if (m_depthActive) m_depth.Unload();
 		//Unloads the color target
 		m_color.Unload();
 		//Inits the framebuffer
 		Init();
 	}
 
+	//sets the filter used when sampling the textures
+	void TTN_Framebuffer::SetFilter(GLenum filter)
+	{
+		m_filter = filter;
+
+		//if the textures already exist update them
+		if (_isInit) {
+			for (unsigned i = 0; i < m_color.m_numAttachments; i++) {
+				glTextureParameteri(m_color.m_textures[i]->GetHandle(), GL_TEXTURE_MIN_FILTER, m_filter);
+				glTextureParameteri(m_color.m_textures[i]->GetHandle(), GL_TEXTURE_MAG_FILTER, m_filter);
+			}
+		}
+	}
+
 	//sets the side of the framebuffer
 	void TTN_Framebuffer::SetSize(unsigned width, unsigned height)
 	{
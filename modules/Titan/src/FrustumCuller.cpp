@@ -0,0 +1,246 @@
+//Titan Engine, by Atlas X Games
+// FrustumCuller.cpp - source file for the classes that work out which objects are inside the camera's view
+
+//precompile header, this file uses vector, unordered_map, algorithm, and glm
+#include "Titan/ttn_pch.h"
+//include the header
+#include "Titan/FrustumCuller.h"
+
+namespace Titan {
+	//extracts the planes from a view projection matrix (Gribb and Hartmann)
+	TTN_Frustum TTN_Frustum::FromMatrix(const glm::mat4& viewProj)
+	{
+		TTN_Frustum frustum;
+		//glm is column major, so get the rows first
+		glm::vec4 rows[4];
+		for (int i = 0; i < 4; i++) rows[i] = glm::vec4(viewProj[0][i], viewProj[1][i], viewProj[2][i], viewProj[3][i]);
+
+		frustum.Planes[0] = rows[3] + rows[0]; //left
+		frustum.Planes[1] = rows[3] - rows[0]; //right
+		frustum.Planes[2] = rows[3] + rows[1]; //bottom
+		frustum.Planes[3] = rows[3] - rows[1]; //top
+		frustum.Planes[4] = rows[3] + rows[2]; //near
+		frustum.Planes[5] = rows[3] - rows[2]; //far
+
+		//normalize them so the distances are real distances
+		for (int i = 0; i < 6; i++) {
+			float length = glm::length(glm::vec3(frustum.Planes[i]));
+			if (length > 0.0f) frustum.Planes[i] /= length;
+		}
+
+		return frustum;
+	}
+
+	//tests a box against the frustum
+	TTN_Frustum::TestResult TTN_Frustum::TestAABB(const glm::vec3& min, const glm::vec3& max) const
+	{
+		glm::vec3 center = (min + max) * 0.5f;
+		glm::vec3 extents = (max - min) * 0.5f;
+
+		TestResult result = TestResult::INSIDE;
+		for (int i = 0; i < 6; i++) {
+			glm::vec3 normal = glm::vec3(Planes[i]);
+			//distance from the plane to the center, and how far the box reaches towards the plane
+			float distance = glm::dot(normal, center) + Planes[i].w;
+			float reach = glm::dot(glm::abs(normal), extents);
+
+			if (distance < -reach) return TestResult::OUTSIDE;
+			if (distance < reach) result = TestResult::INTERSECTS;
+		}
+
+		return result;
+	}
+
+	//builds the bvh
+	void TTN_BoundsBVH::Build(const std::vector<glm::vec3>& mins, const std::vector<glm::vec3>& maxes)
+	{
+		m_nodes.clear();
+		m_items.resize(mins.size());
+		std::vector<glm::vec3> centers(mins.size());
+		for (uint32_t i = 0; i < mins.size(); i++) {
+			m_items[i] = i;
+			centers[i] = (mins[i] + maxes[i]) * 0.5f;
+		}
+
+		if (!m_items.empty()) {
+			m_nodes.reserve(2 * m_items.size() / s_leafSize + 1);
+			BuildNode(0, (uint32_t)m_items.size(), mins, maxes, centers);
+		}
+	}
+
+	//builds a node and it's children
+	uint32_t TTN_BoundsBVH::BuildNode(uint32_t first, uint32_t count, const std::vector<glm::vec3>& mins, const std::vector<glm::vec3>& maxes,
+		const std::vector<glm::vec3>& centers)
+	{
+		uint32_t index = (uint32_t)m_nodes.size();
+		m_nodes.push_back(Node());
+
+		//the node's box covers all of it's items
+		glm::vec3 nodeMin = glm::vec3(std::numeric_limits<float>::max());
+		glm::vec3 nodeMax = glm::vec3(-std::numeric_limits<float>::max());
+		glm::vec3 centerMin = nodeMin, centerMax = nodeMax;
+		for (uint32_t i = first; i < first + count; i++) {
+			nodeMin = glm::min(nodeMin, mins[m_items[i]]);
+			nodeMax = glm::max(nodeMax, maxes[m_items[i]]);
+			centerMin = glm::min(centerMin, centers[m_items[i]]);
+			centerMax = glm::max(centerMax, centers[m_items[i]]);
+		}
+		m_nodes[index].Min = nodeMin;
+		m_nodes[index].Max = nodeMax;
+		m_nodes[index].First = first;
+		m_nodes[index].Count = count;
+		m_nodes[index].Right = 0;
+
+		if (count <= s_leafSize) return index;
+
+		//split at the median along the axis the centers are most spread out on
+		glm::vec3 spread = centerMax - centerMin;
+		int axis = (spread.x > spread.y && spread.x > spread.z) ? 0 : ((spread.y > spread.z) ? 1 : 2);
+		uint32_t half = count / 2;
+		std::nth_element(m_items.begin() + first, m_items.begin() + first + half, m_items.begin() + first + count,
+			[&](uint32_t a, uint32_t b) { return centers[a][axis] < centers[b][axis]; });
+
+		//the left child is built straight after this node, so only the right one needs to be stored
+		BuildNode(first, half, mins, maxes, centers);
+		uint32_t right = BuildNode(first + half, count - half, mins, maxes, centers);
+		m_nodes[index].Right = right;
+
+		return index;
+	}
+
+	//finds the items inside the frustum
+	void TTN_BoundsBVH::Query(const TTN_Frustum& frustum, std::vector<uint32_t>& visible) const
+	{
+		m_nodesTested = 0;
+		if (m_nodes.empty()) return;
+
+		uint32_t stack[64];
+		int stackSize = 0;
+		stack[stackSize++] = 0;
+		while (stackSize > 0) {
+			const Node& node = m_nodes[stack[--stackSize]];
+			m_nodesTested++;
+
+			TTN_Frustum::TestResult result = frustum.TestAABB(node.Min, node.Max);
+			if (result == TTN_Frustum::TestResult::OUTSIDE) continue;
+
+			//if the whole node is inside, or it's a leaf, take all of it's items
+			//leaves that only intersect are taken whole too, they're small enough that testing each item isn't worth it
+			if (result == TTN_Frustum::TestResult::INSIDE || node.Right == 0) {
+				visible.insert(visible.end(), m_items.begin() + node.First, m_items.begin() + node.First + node.Count);
+				continue;
+			}
+
+			//otherwise check the children, the left child is the next node
+			uint32_t nodeIndex = (uint32_t)(&node - m_nodes.data());
+			stack[stackSize++] = node.Right;
+			stack[stackSize++] = nodeIndex + 1;
+		}
+	}
+
+	//starts a new frame
+	void TTN_FrustumCuller::Begin()
+	{
+		m_visible.clear();
+		m_visibleCount = 0;
+
+		m_centerX.clear();
+		m_centerY.clear();
+		m_centerZ.clear();
+		m_radius.clear();
+		m_dynamicObjects.clear();
+
+		m_staticIds.clear();
+		m_staticObjects.clear();
+		m_staticMins.clear();
+		m_staticMaxes.clear();
+		m_staticSignature = 0;
+	}
+
+	//adds an object that's always drawn
+	void TTN_FrustumCuller::AddAlwaysVisible()
+	{
+		m_visible.push_back(1);
+	}
+
+	//adds a moving object
+	void TTN_FrustumCuller::AddDynamic(const glm::vec3& center, float radius)
+	{
+		m_dynamicObjects.push_back((uint32_t)m_visible.size());
+		m_visible.push_back(0);
+
+		m_centerX.push_back(center.x);
+		m_centerY.push_back(center.y);
+		m_centerZ.push_back(center.z);
+		m_radius.push_back(radius);
+	}
+
+	//adds a static object
+	void TTN_FrustumCuller::AddStatic(uint32_t id, const glm::vec3& min, const glm::vec3& max)
+	{
+		m_staticObjects.push_back((uint32_t)m_visible.size());
+		m_visible.push_back(0);
+
+		m_staticIds.push_back(id);
+		m_staticMins.push_back(min);
+		m_staticMaxes.push_back(max);
+
+		//mix the id so the sum doesn't care about the order they're added in
+		uint64_t mixed = (uint64_t)id * 0x9E3779B97F4A7C15ull;
+		m_staticSignature += mixed ^ (mixed >> 29);
+	}
+
+	//culls everything added this frame
+	void TTN_FrustumCuller::Cull(const glm::mat4& viewProj)
+	{
+		TTN_Frustum frustum = TTN_Frustum::FromMatrix(viewProj);
+
+		//moving objects, each plane is tested against every sphere in a straight loop over the packed arrays so the compiler can vectorise it
+		size_t dynamicCount = m_dynamicObjects.size();
+		m_dynamicVisible.assign(dynamicCount, 1);
+		const float* centerX = m_centerX.data();
+		const float* centerY = m_centerY.data();
+		const float* centerZ = m_centerZ.data();
+		const float* radius = m_radius.data();
+		uint8_t* dynamicVisible = m_dynamicVisible.data();
+		for (int p = 0; p < 6; p++) {
+			const float a = frustum.Planes[p].x, b = frustum.Planes[p].y, c = frustum.Planes[p].z, d = frustum.Planes[p].w;
+			for (size_t i = 0; i < dynamicCount; i++) {
+				float distance = a * centerX[i] + b * centerY[i] + c * centerZ[i] + d;
+				dynamicVisible[i] &= (uint8_t)(distance >= -radius[i]);
+			}
+		}
+		for (size_t i = 0; i < dynamicCount; i++) m_visible[m_dynamicObjects[i]] = dynamicVisible[i];
+
+		//static objects, the tree is kept as long as the same set of them are added each frame
+		bool rebuild = (m_staticSignature != m_builtSignature || m_staticIds.size() != m_builtCount);
+		//they might not have been added in the same order as when the tree was built, so find which object each item is this frame
+		m_itemObjects.resize(m_staticIds.size());
+		for (size_t i = 0; i < m_staticIds.size() && !rebuild; i++) {
+			auto item = m_staticItems.find(m_staticIds[i]);
+			if (item == m_staticItems.end()) rebuild = true;
+			else m_itemObjects[item->second] = m_staticObjects[i];
+		}
+
+		//if the set has changed, rebuild the tree, the items are then in the order they were added
+		if (rebuild) {
+			m_bvh.Build(m_staticMins, m_staticMaxes);
+			m_staticItems.clear();
+			for (uint32_t i = 0; i < m_staticIds.size(); i++) {
+				m_staticItems[m_staticIds[i]] = i;
+				m_itemObjects[i] = m_staticObjects[i];
+			}
+			m_builtSignature = m_staticSignature;
+			m_builtCount = m_staticIds.size();
+			m_rebuilds++;
+		}
+
+		m_bvhVisible.clear();
+		m_bvh.Query(frustum, m_bvhVisible);
+		for (uint32_t item : m_bvhVisible) m_visible[m_itemObjects[item]] = 1;
+
+		//count the results
+		m_visibleCount = 0;
+		for (uint8_t visible : m_visible) m_visibleCount += visible;
+	}
+}
@@ -13,7 +13,7 @@ namespace Titan {
 
 	//constructor, sets a default handle, and if the limits haven't been read in from openGL yet, read them in
 	TTN_ITexture::TTN_ITexture()
-		: _handle(0) {
+		: _handle(0), _bindlessHandle(0) {
 		if (!_isStaticInit) {
 			// Example of reading limits from the OpenGL renderer
 			glGetIntegerv(GL_MAX_TEXTURE_SIZE, &_limits.MAX_TEXTURE_SIZE);
@@ -37,6 +37,10 @@ namespace Titan {
 
 	//destructor, deletes the texture
 	TTN_ITexture::~TTN_ITexture() {
+		//handles have to stop being resident before their texture is deleted
+		if (_bindlessHandle != 0 && glIsTextureHandleResidentARB(_bindlessHandle)) {
+			glMakeTextureHandleNonResidentARB(_bindlessHandle);
+		}
 		if (glIsTexture(_handle)) {
 			glDeleteTextures(1, &_handle);
 		}
@@ -49,6 +53,23 @@ namespace Titan {
 		}
 	}
 
+	//gets wheter or not bindless textures are supported
+	bool TTN_ITexture::GetBindlessSupported() {
+		return GLAD_GL_ARB_bindless_texture != 0;
+	}
+
+	//gets the texture's bindless handle
+	uint64_t TTN_ITexture::GetBindlessHandle() {
+		if (_bindlessHandle == 0 && _handle != 0 && GetBindlessSupported()) {
+			_bindlessHandle = glGetTextureHandleARB(_handle);
+			//textures that share a handle (like atlas regions and their page) might have already made it resident
+			if (!glIsTextureHandleResidentARB(_bindlessHandle)) {
+				glMakeTextureHandleResidentARB(_bindlessHandle);
+			}
+		}
+		return _bindlessHandle;
+	}
+
 	//Unbinds whatever texture is in the given slot
 	void TTN_ITexture::Unbind(int slot) {
 		glBindTextureUnit(slot, 0);
@@ -0,0 +1,210 @@
+//Titan Engine, by Atlas X Games
+// InputRecorder.cpp - source file for the class that records the input each frame to a file and plays it back
+
+//precompile header, this file uses string, vector, unordered_map, fstream, and memory
+#include "Titan/ttn_pch.h"
+//include the header
+#include "Titan/InputRecorder.h"
+//include the random number generator, to seed it
+#include "Titan/Random.h"
+
+//cereal, recordings are written with the portable binary archive so they can be played back on any machine
+#include <cereal/archives/portable_binary.hpp>
+#include <cereal/types/vector.hpp>
+#include <cereal/types/common.hpp>
+
+namespace Titan {
+	//starts recording
+	bool TTN_InputRecorder::StartRecording(const std::string& path, uint32_t seed)
+	{
+		if (s_mode == Mode::RECORDING) StopRecording();
+		if (s_mode == Mode::PLAYBACK) StopPlayback();
+		Reset();
+
+		s_file = std::make_shared<std::fstream>(path, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!s_file->is_open()) {
+			LOG_ERROR("Could not open {} to record input", path);
+			s_file = nullptr;
+			return false;
+		}
+
+		s_output = std::make_shared<cereal::PortableBinaryOutputArchive>(*s_file);
+		(*s_output)(s_magic, s_version, seed);
+
+		//seed everything so playing it back does the same thing
+		TTN_Random::SetSeed(seed);
+
+		s_mode = Mode::RECORDING;
+		LOG_INFO("Recording input to {} with seed {}", path, seed);
+		return true;
+	}
+
+	//finishes the recording
+	void TTN_InputRecorder::StopRecording()
+	{
+		if (s_mode != Mode::RECORDING) return;
+
+		//mark the end of the frames, the archive has to be destroyed before the file so it finishes writing
+		(*s_output)(false);
+		s_output = nullptr;
+		s_file = nullptr;
+
+		s_mode = Mode::NONE;
+		LOG_INFO("Recorded {} frames of input", s_frameCount);
+	}
+
+	//starts playing back a recording
+	bool TTN_InputRecorder::StartPlayback(const std::string& path)
+	{
+		if (s_mode == Mode::RECORDING) StopRecording();
+		if (s_mode == Mode::PLAYBACK) StopPlayback();
+		Reset();
+
+		s_file = std::make_shared<std::fstream>(path, std::ios::in | std::ios::binary);
+		if (!s_file->is_open()) {
+			LOG_ERROR("Could not open input recording {}", path);
+			s_file = nullptr;
+			return false;
+		}
+
+		//check the header
+		uint32_t magic = 0, version = 0, seed = 0;
+		s_input = std::make_shared<cereal::PortableBinaryInputArchive>(*s_file);
+		try {
+			(*s_input)(magic, version, seed);
+		}
+		catch (cereal::Exception&) {}
+		if (magic != s_magic || version != s_version) {
+			LOG_ERROR("{} is not a titan input recording, or was made with a different version", path);
+			s_input = nullptr;
+			s_file = nullptr;
+			return false;
+		}
+
+		//seed everything the same way the recording was
+		TTN_Random::SetSeed(seed);
+
+		s_mode = Mode::PLAYBACK;
+		LOG_INFO("Playing back input from {} with seed {}", path, seed);
+		return true;
+	}
+
+	//stops playing back
+	void TTN_InputRecorder::StopPlayback()
+	{
+		if (s_mode != Mode::PLAYBACK) return;
+
+		s_input = nullptr;
+		s_file = nullptr;
+		s_mode = Mode::NONE;
+	}
+
+	//starts a frame
+	float TTN_InputRecorder::BeginFrame(float deltaTime)
+	{
+		if (s_mode == Mode::RECORDING) {
+			//start a new frame
+			s_frame = TTN_InputFrame();
+			s_frame.Dt = deltaTime;
+			return deltaTime;
+		}
+
+		if (s_mode == Mode::PLAYBACK) {
+			//read the next frame, running out of frames (or a recording that was cut off) ends the playback
+			bool hasFrame = false;
+			TTN_InputFrame frame;
+			try {
+				(*s_input)(hasFrame);
+				if (hasFrame) (*s_input)(frame);
+			}
+			catch (cereal::Exception&) {
+				hasFrame = false;
+			}
+
+			if (!hasFrame) {
+				LOG_INFO("Finished playing back {} frames of input", s_frameCount);
+				StopPlayback();
+				s_playbackFinished = true;
+				return deltaTime;
+			}
+
+			//apply the frame's changes
+			if (frame.MouseMoved) s_mousePos = frame.MousePos;
+			for (const TTN_InputEvent& event : frame.Events) {
+				switch (event.EventType) {
+				case TTN_InputEvent::Type::KEY_UP:
+				case TTN_InputEvent::Type::KEY_DOWN:
+					s_keys[event.Code] = (event.EventType == TTN_InputEvent::Type::KEY_DOWN);
+					break;
+				case TTN_InputEvent::Type::MOUSE_UP:
+				case TTN_InputEvent::Type::MOUSE_DOWN:
+					s_buttons[event.Code] = (event.EventType == TTN_InputEvent::Type::MOUSE_DOWN);
+					break;
+				}
+			}
+
+			s_frameCount++;
+			return frame.Dt;
+		}
+
+		return deltaTime;
+	}
+
+	//ends a frame
+	void TTN_InputRecorder::EndFrame()
+	{
+		if (s_mode != Mode::RECORDING) return;
+
+		//write the frame
+		(*s_output)(true, s_frame);
+		s_frameCount++;
+	}
+
+	//records a key
+	void TTN_InputRecorder::RecordKey(int key, bool down)
+	{
+		if (s_mode != Mode::RECORDING) return;
+
+		//only save it if it's changed, keys that have never been seen start released
+		auto it = s_keys.find(key);
+		bool wasDown = (it != s_keys.end()) ? it->second : false;
+		if (wasDown != down)
+			s_frame.Events.push_back({ (uint16_t)key, (down) ? TTN_InputEvent::Type::KEY_DOWN : TTN_InputEvent::Type::KEY_UP });
+		s_keys[key] = down;
+	}
+
+	//records a mouse button
+	void TTN_InputRecorder::RecordMouseButton(int button, bool down)
+	{
+		if (s_mode != Mode::RECORDING) return;
+
+		auto it = s_buttons.find(button);
+		bool wasDown = (it != s_buttons.end()) ? it->second : false;
+		if (wasDown != down)
+			s_frame.Events.push_back({ (uint16_t)button, (down) ? TTN_InputEvent::Type::MOUSE_DOWN : TTN_InputEvent::Type::MOUSE_UP });
+		s_buttons[button] = down;
+	}
+
+	//records the mouse's position
+	void TTN_InputRecorder::RecordMousePosition(const glm::vec2& position)
+	{
+		if (s_mode != Mode::RECORDING) return;
+
+		if (position != s_mousePos) {
+			s_frame.MouseMoved = true;
+			s_frame.MousePos = position;
+		}
+		s_mousePos = position;
+	}
+
+	//resets the state between runs
+	void TTN_InputRecorder::Reset()
+	{
+		s_playbackFinished = false;
+		s_frameCount = 0;
+		s_frame = TTN_InputFrame();
+		s_keys.clear();
+		s_buttons.clear();
+		s_mousePos = glm::vec2(0.0f);
+	}
+}
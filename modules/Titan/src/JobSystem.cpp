@@ -0,0 +1,290 @@
+//Titan Engine, by Atlas X Games 
+// JobSystem.cpp - source file for the classes that run work across worker threads
+
+//precompile header, this file uses thread, atomic, mutex, condition_variable, and deque
+#include "Titan/ttn_pch.h"
+//include the header
+#include "Titan/JobSystem.h"
+//include the profiler so jobs show up on the worker's track
+#include "Titan/Profiler.h"
+
+namespace Titan {
+	//job constructor
+	TTN_Job::TTN_Job(std::function<void()> work)
+		: m_work(work), m_unfinishedDependencies(0), m_finished(false)
+	{
+		m_continuations = std::vector<sjobptr>();
+	}
+
+	//starts the worker threads
+	void TTN_JobSystem::Init(size_t workerCount)
+	{
+		//if it's already running don't start it again
+		if (s_running) return;
+
+		//by default use every hardware thread other than the main thread
+		if (workerCount == 0) {
+			size_t hardwareThreads = std::thread::hardware_concurrency();
+			workerCount = (hardwareThreads > 1) ? hardwareThreads - 1 : 1;
+		}
+
+		//make a queue for the main thread and one for each worker
+		s_queues.clear();
+		for (size_t i = 0; i < workerCount + 1; i++)
+			s_queues.push_back(std::make_unique<TTN_WorkQueue>());
+
+		//the main thread uses the first queue
+		t_queueIndex = 0;
+		s_queuedJobs = 0;
+		s_running = true;
+
+		//start the workers
+		for (size_t i = 1; i < workerCount + 1; i++)
+			s_workers.emplace_back(WorkerLoop, i);
+
+		LOG_INFO("Job system started with {} worker threads", workerCount);
+	}
+
+	//stops the worker threads
+	void TTN_JobSystem::Shutdown()
+	{
+		if (!s_running) return;
+
+		//tell the workers to stop and wake any that are sleeping
+		{
+			std::lock_guard<std::mutex> guard(s_sleepLock);
+			s_running = false;
+		}
+		s_wake.notify_all();
+
+		//wait for them to finish
+		for (auto& worker : s_workers)
+			worker.join();
+		s_workers.clear();
+
+		//run anything left over on this thread so nothing waiting on it is left hanging
+		TTN_JobHandle job = FindJob(0);
+		while (job != nullptr) {
+			Execute(job);
+			job = FindJob(0);
+		}
+		s_queues.clear();
+	}
+
+	//schedules a job
+	TTN_JobHandle TTN_JobSystem::Schedule(std::function<void()> work, const std::vector<TTN_JobHandle>& dependencies)
+	{
+		TTN_JobHandle job = std::make_shared<TTN_Job>(work);
+
+		//if there are no workers, wait for the dependencies and just run it now
+		if (!s_running) {
+			WaitAll(dependencies);
+			Execute(job);
+			return job;
+		}
+
+		//hold an extra count while the dependencies are hooked up so it can't be queued early
+		job->m_unfinishedDependencies = 1;
+		for (auto& dependency : dependencies) {
+			if (dependency == nullptr) continue;
+
+			//if the dependency hasn't finished yet, have it queue this job when it does
+			std::lock_guard<std::mutex> guard(dependency->m_continuationLock);
+			if (!dependency->m_finished) {
+				dependency->m_continuations.push_back(job);
+				job->m_unfinishedDependencies++;
+			}
+		}
+
+		//release the extra count, if everything it depends on is already done queue it now
+		if (--job->m_unfinishedDependencies == 0)
+			Enqueue(job);
+
+		return job;
+	}
+
+	//waits for a job to finish
+	void TTN_JobSystem::Wait(const TTN_JobHandle& job)
+	{
+		if (job == nullptr) return;
+
+		//help out with other jobs while waiting
+		while (!job->m_finished) {
+			TTN_JobHandle other = (s_running) ? FindJob(t_queueIndex) : nullptr;
+			if (other != nullptr) Execute(other);
+			else std::this_thread::yield();
+		}
+	}
+
+	//waits for a group of jobs to finish
+	void TTN_JobSystem::WaitAll(const std::vector<TTN_JobHandle>& jobs)
+	{
+		for (auto& job : jobs)
+			Wait(job);
+	}
+
+	//splits a range into chunks and runs them across the workers
+	void TTN_JobSystem::ParallelFor(size_t count, const std::function<void(size_t, size_t)>& function, size_t grainSize)
+	{
+		if (count == 0) return;
+
+		//if there are no workers just run it all here
+		if (!s_running) {
+			function(0, count);
+			return;
+		}
+
+		//by default split the work into a few chunks per thread so faster threads can steal the leftovers
+		if (grainSize == 0) grainSize = std::max<size_t>(1, count / ((s_workers.size() + 1) * 4));
+
+		//if it all fits in one chunk don't bother with jobs
+		if (count <= grainSize) {
+			function(0, count);
+			return;
+		}
+
+		//schedule all but the first chunk, and run the first one on this thread
+		std::vector<TTN_JobHandle> chunks;
+		chunks.reserve(count / grainSize + 1);
+		for (size_t begin = grainSize; begin < count; begin += grainSize) {
+			size_t end = std::min(begin + grainSize, count);
+			chunks.push_back(Schedule([&function, begin, end]() { function(begin, end); }));
+		}
+		function(0, grainSize);
+
+		//wait for the rest
+		WaitAll(chunks);
+	}
+
+	//the loop each worker thread runs
+	void TTN_JobSystem::WorkerLoop(size_t index)
+	{
+		t_queueIndex = index;
+		TTN_Profiler::SetThreadName("Worker " + std::to_string(index));
+
+		while (s_running) {
+			//find a job and run it
+			TTN_JobHandle job = FindJob(index);
+			if (job != nullptr) {
+				Execute(job);
+				continue;
+			}
+
+			//if there's nothing to do, sleep until more work is queued
+			std::unique_lock<std::mutex> lock(s_sleepLock);
+			s_wake.wait_for(lock, std::chrono::milliseconds(1), [] { return s_queuedJobs > 0 || !s_running; });
+		}
+	}
+
+	//adds a job to the calling thread's queue
+	void TTN_JobSystem::Enqueue(const TTN_JobHandle& job)
+	{
+		//threads that aren't part of the job system use the main thread's queue
+		size_t index = (t_queueIndex < s_queues.size()) ? t_queueIndex : 0;
+		{
+			std::lock_guard<std::mutex> guard(s_queues[index]->lock);
+			s_queues[index]->jobs.push_back(job);
+		}
+		s_queuedJobs++;
+
+		//wake a sleeping worker to pick it up
+		s_wake.notify_one();
+	}
+
+	//finds a job for a thread
+	TTN_JobHandle TTN_JobSystem::FindJob(size_t index)
+	{
+		//first try the thread's own queue, taking the most recently added job as it's most likely to still be in cache
+		{
+			std::lock_guard<std::mutex> guard(s_queues[index]->lock);
+			if (!s_queues[index]->jobs.empty()) {
+				TTN_JobHandle job = s_queues[index]->jobs.back();
+				s_queues[index]->jobs.pop_back();
+				s_queuedJobs--;
+				return job;
+			}
+		}
+
+		//then try to steal the oldest job from one of the other queues
+		for (size_t i = 1; i < s_queues.size(); i++) {
+			size_t victim = (index + i) % s_queues.size();
+			std::lock_guard<std::mutex> guard(s_queues[victim]->lock);
+			if (!s_queues[victim]->jobs.empty()) {
+				TTN_JobHandle job = s_queues[victim]->jobs.front();
+				s_queues[victim]->jobs.pop_front();
+				s_queuedJobs--;
+				return job;
+			}
+		}
+
+		//if there was nothing anywhere return nothing
+		return nullptr;
+	}
+
+	//runs a job and queues anything waiting on it
+	void TTN_JobSystem::Execute(const TTN_JobHandle& job)
+	{
+		//do the work
+		if (job->m_work) {
+			TTN_PROFILE_SCOPE("Job");
+			job->m_work();
+		}
+
+		//mark the job as done and take the list of jobs waiting on it
+		std::vector<TTN_JobHandle> continuations;
+		{
+			std::lock_guard<std::mutex> guard(job->m_continuationLock);
+			job->m_finished = true;
+			continuations.swap(job->m_continuations);
+		}
+
+		//queue any of them that aren't waiting on anything else
+		for (auto& continuation : continuations) {
+			if (--continuation->m_unfinishedDependencies == 0)
+				Enqueue(continuation);
+		}
+	}
+
+	//adds a system to the frame graph
+	void TTN_FrameGraph::AddSystem(const std::string& name, std::function<void()> system, const std::vector<std::string>& dependsOn)
+	{
+		TTN_FrameGraphSystem newSystem;
+		newSystem.name = name;
+		newSystem.system = system;
+
+		//find the systems it depends on
+		for (auto& dependency : dependsOn) {
+			bool found = false;
+			for (size_t i = 0; i < m_systems.size(); i++) {
+				if (m_systems[i].name == dependency) {
+					newSystem.dependencies.push_back(i);
+					found = true;
+					break;
+				}
+			}
+
+			//if it couldn't find it log an error, the dependencies have to be added before the systems that use them
+			if (!found) LOG_ERROR("Frame graph system {} depends on {}, which hasn't been added", name, dependency);
+		}
+
+		m_systems.push_back(newSystem);
+	}
+
+	//runs all the systems and waits for them to finish
+	void TTN_FrameGraph::Run()
+	{
+		//schedule every system with jobs for the systems it depends on
+		std::vector<TTN_JobHandle> jobs;
+		jobs.reserve(m_systems.size());
+		for (auto& system : m_systems) {
+			std::vector<TTN_JobHandle> dependencies;
+			for (size_t index : system.dependencies)
+				dependencies.push_back(jobs[index]);
+
+			jobs.push_back(TTN_JobSystem::Schedule(system.system, dependencies));
+		}
+
+		//and wait for all of them
+		TTN_JobSystem::WaitAll(jobs);
+	}
+}
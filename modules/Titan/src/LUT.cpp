@@ -1,7 +1,7 @@
 //Titan Engine by Atlas X Games
 //LUT.cpp - source file for the class that represents 3D look up tables for color correction
 
-//include the precompile header
+//include the precompile header, this file uses fstream, charconv, and filesystem
 #include "Titan/ttn_pch.h"
 //include the class
 #include "Titan/LUT.h"
@@ -25,43 +25,195 @@ namespace Titan {
 	//function to load in a .cube file from a file path
 	void TTN_LUT3D::loadFromFile(std::string path)
 	{
-		//open the file
-		std::string filePath = path;
-		std::ifstream LUTstream;
-		LUTstream.open(filePath);
-
-		//loop through every line of the file
-		while (!LUTstream.eof())
-		{
-			//get each line
-			std::string _line;
-			std::getline(LUTstream, _line);
-
-			//if the line is empty just skip to the next line
-			if (_line.empty())
+		//the texels are packed as RGB10A2, 4 bytes each, which is plenty for colour grading and a third the size of the floats
+		std::vector<uint32_t> texels;
+
+		//try the binary cache first, if it's missing or out of date parse the .cube file and make a new cache
+		if (!ReadCache(path, texels)) {
+			if (!ParseCube(path, texels)) {
+				LOG_ERROR("Failed to load LUT {}", path);
+				return;
+			}
+			WriteCache(path, texels);
+		}
+
+		//upload it to the gpu
+		Upload(texels);
+	}
+
+	//parses a .cube file
+	bool TTN_LUT3D::ParseCube(const std::string& path, std::vector<uint32_t>& texels)
+	{
+		//read the whole file in at once
+		std::ifstream LUTstream(path, std::ios::binary | std::ios::ate);
+		if (!LUTstream.is_open()) return false;
+		std::string contents;
+		contents.resize((size_t)LUTstream.tellg());
+		LUTstream.seekg(0);
+		LUTstream.read(contents.data(), contents.size());
+
+		//the default domain is 0 to 1 but files can change it
+		glm::vec3 domainMin = glm::vec3(0.0f);
+		glm::vec3 domainMax = glm::vec3(1.0f);
+		m_size = 0;
+
+		//reads three floats from a point in the file, returns false if there weren't three numbers there
+		auto readVec3 = [](const char*& cursor, const char* end, glm::vec3& out) -> bool {
+			for (int i = 0; i < 3; i++) {
+				while (cursor < end && (*cursor == ' ' || *cursor == '\t')) cursor++;
+				auto result = std::from_chars(cursor, end, out[i]);
+				if (result.ec != std::errc()) return false;
+				cursor = result.ptr;
+			}
+			return true;
+		};
+
+		//go through the file line by line
+		const char* cursor = contents.data();
+		const char* end = cursor + contents.size();
+		while (cursor < end) {
+			//find the end of the line
+			const char* lineEnd = std::find(cursor, end, '\n');
+			const char* lineStart = cursor;
+			cursor = (lineEnd < end) ? lineEnd + 1 : end;
+
+			//skip leading whitespace
+			while (lineStart < lineEnd && (*lineStart == ' ' || *lineStart == '\t' || *lineStart == '\r')) lineStart++;
+
+			//skip empty lines and comments
+			if (lineStart == lineEnd || *lineStart == '#') continue;
+
+			//if the line is a number it's data
+			if ((*lineStart >= '0' && *lineStart <= '9') || *lineStart == '-' || *lineStart == '.') {
+				//the size has to come before the data
+				if (m_size == 0) {
+					LOG_ERROR("LUT {} has data before LUT_3D_SIZE", path);
+					return false;
+				}
+
+				glm::vec3 lineData;
+				if (readVec3(lineStart, lineEnd, lineData))
+					texels.push_back(PackTexel((lineData - domainMin) / (domainMax - domainMin)));
 				continue;
+			}
 
-			//if it has data extract and store it
-			glm::vec3 lineData;
-			if (sscanf(_line.c_str(), "%f %f %f", &lineData.x, &lineData.y, &lineData.z) == 3)
-				data.push_back(lineData);
+			//otherwise it's a keyword, read the ones that matter and skip the rest (like TITLE)
+			std::string_view line = std::string_view(lineStart, lineEnd - lineStart);
+			if (line.rfind("LUT_3D_SIZE", 0) == 0) {
+				const char* number = lineStart + 11;
+				while (number < lineEnd && (*number == ' ' || *number == '\t')) number++;
+				std::from_chars(number, lineEnd, m_size);
+				//reserve space for all the data so it doesn't keep reallocating
+				texels.reserve((size_t)m_size * m_size * m_size);
+			}
+			else if (line.rfind("DOMAIN_MIN", 0) == 0) {
+				const char* numbers = lineStart + 10;
+				readVec3(numbers, lineEnd, domainMin);
+			}
+			else if (line.rfind("DOMAIN_MAX", 0) == 0) {
+				const char* numbers = lineStart + 10;
+				readVec3(numbers, lineEnd, domainMax);
+			}
+			else if (line.rfind("LUT_1D_SIZE", 0) == 0) {
+				LOG_ERROR("LUT {} is a 1D LUT, only 3D LUTs are supported", path);
+				return false;
+			}
 		}
 
-		//create a 3D texture for the cube
-		glEnable(GL_TEXTURE_3D);
+		//make sure it got the right amount of data
+		if (m_size <= 0 || texels.size() != (size_t)m_size * m_size * m_size) {
+			LOG_ERROR("LUT {} has {} entries, expected {}", path, texels.size(), (size_t)m_size * m_size * m_size);
+			return false;
+		}
+
+		return true;
+	}
+
+	//the header at the start of the binary cache, the source's size and write time are saved so it can tell when the cache is stale
+	struct TTN_LUTCacheHeader {
+		char magic[4];
+		uint32_t version;
+		int32_t size;
+		uint64_t sourceBytes;
+		int64_t sourceTime;
+	};
+
+	//gets the path of the binary cache for a .cube file
+	static std::string CachePath(const std::string& path) {
+		return path + ".lutcache";
+	}
+
+	//gets the write time of a file as a number
+	static int64_t WriteTime(const std::string& path) {
+		std::error_code error;
+		auto time = std::filesystem::last_write_time(path, error);
+		return (error) ? 0 : (int64_t)time.time_since_epoch().count();
+	}
+
+	//reads the binary cache
+	bool TTN_LUT3D::ReadCache(const std::string& path, std::vector<uint32_t>& texels)
+	{
+		std::ifstream cache(CachePath(path), std::ios::binary);
+		if (!cache.is_open()) return false;
+
+		//read the header and make sure it matches the source file
+		TTN_LUTCacheHeader header;
+		cache.read(reinterpret_cast<char*>(&header), sizeof(header));
+		std::error_code error;
+		uint64_t sourceBytes = (uint64_t)std::filesystem::file_size(path, error);
+		if (!cache || std::string(header.magic, 4) != "TLUT" || header.version != 1 || header.size <= 0 ||
+			(!error && (header.sourceBytes != sourceBytes || header.sourceTime != WriteTime(path))))
+			return false;
+
+		//read the texels
+		m_size = header.size;
+		texels.resize((size_t)m_size * m_size * m_size);
+		cache.read(reinterpret_cast<char*>(texels.data()), texels.size() * sizeof(uint32_t));
+		return (bool)cache;
+	}
+
+	//writes the binary cache
+	void TTN_LUT3D::WriteCache(const std::string& path, const std::vector<uint32_t>& texels)
+	{
+		std::ofstream cache(CachePath(path), std::ios::binary | std::ios::trunc);
+		//if it can't write the cache (like if the folder is read only) it just parses the .cube every time
+		if (!cache.is_open()) return;
+
+		TTN_LUTCacheHeader header;
+		memcpy(header.magic, "TLUT", 4);
+		header.version = 1;
+		header.size = m_size;
+		std::error_code error;
+		header.sourceBytes = (uint64_t)std::filesystem::file_size(path, error);
+		header.sourceTime = WriteTime(path);
+
+		cache.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		cache.write(reinterpret_cast<const char*>(texels.data()), texels.size() * sizeof(uint32_t));
+	}
+
+	//uploads the packed texels to the 3D texture
+	void TTN_LUT3D::Upload(const std::vector<uint32_t>& texels)
+	{
 		//generate the handle, bind it and set the texture parameters
 		glGenTextures(1, &m_handle);
 		bind();
 		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_REPEAT);
-		//load the data into the openGL texture
-		glTexImage3D(GL_TEXTURE_3D, 0, GL_RGB, 64, 64, 64, 0, GL_RGB, GL_FLOAT, &data[0]);
-		//unbind it and stop creating 3D textures
+		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+		//load the data into the openGL texture, the rows are tightly packed 4 byte texels
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		glTexImage3D(GL_TEXTURE_3D, 0, GL_RGB10_A2, m_size, m_size, m_size, 0, GL_RGBA, GL_UNSIGNED_INT_2_10_10_10_REV, texels.data());
+		//unbind it
 		unbind();
-		glDisable(GL_TEXTURE_3D);
+	}
+
+	//packs a colour into RGB10A2, red in the lowest bits to match GL_UNSIGNED_INT_2_10_10_10_REV
+	uint32_t TTN_LUT3D::PackTexel(glm::vec3 color)
+	{
+		glm::uvec3 packed = glm::uvec3(glm::clamp(color, 0.0f, 1.0f) * 1023.0f + 0.5f);
+		return packed.r | (packed.g << 10) | (packed.b << 20) | (3u << 30);
 	}
 
 	//bind the look up table as a 3D texture
@@ -0,0 +1,212 @@
+//Titan Engine, by Atlas X Games 
+// LightClusters.cpp - source file for the class that sorts the scene's lights into view space clusters for clustered forward lighting
+
+//precompile header, this file uses vector, memory_resource, limits, and glm
+#include "Titan/ttn_pch.h"
+//include the header
+#include "Titan/LightClusters.h"
+#include "Titan/JobSystem.h"
+//the lists built each frame are allocated from the frame arena
+#include "Titan/FrameArena.h"
+//each slice's list is made on the thread that fills it
+#include <optional>
+
+namespace Titan {
+	//works out how far a light reaches
+	float TTN_LightClusters::CalculateRange(float constant, float linear, float quadratic, float brightness)
+	{
+		//the light is cut off once it's contribution drops under 1/256, so solve constant + linear*d + quadratic*d^2 = brightness * 256
+		float target = std::max(brightness, 0.0f) * 256.0f;
+		if (constant >= target) return 0.0f;
+
+		//if it has a quadratic term use the quadratic formula
+		if (quadratic > 0.0f)
+			return (-linear + std::sqrt(linear * linear - 4.0f * quadratic * (constant - target))) / (2.0f * quadratic);
+
+		//if it's only linear
+		if (linear > 0.0f)
+			return (target - constant) / linear;
+
+		//if it doesn't fade at all it reaches everywhere
+		return std::numeric_limits<float>::infinity();
+	}
+
+	//rebuilds the view space bounding boxes of the clusters
+	void TTN_LightClusters::BuildClusterBounds(const glm::mat4& projection)
+	{
+		m_boundsProjection = projection;
+		glm::mat4 inverseProj = glm::inverse(projection);
+
+		//unprojects a point from normalized device coordinates to view space
+		auto unproject = [&](glm::vec3 ndc) {
+			glm::vec4 point = inverseProj * glm::vec4(ndc, 1.0f);
+			return glm::vec3(point) / point.w;
+		};
+
+		//find the depth range, slices are exponential so the near distance has to be above zero (orthographic cameras can start at zero)
+		m_near = std::max(-unproject(glm::vec3(0.0f, 0.0f, -1.0f)).z, 0.01f);
+		m_far = std::max(-unproject(glm::vec3(0.0f, 0.0f, 1.0f)).z, m_near + 0.01f);
+
+		m_clusterMin.resize(s_clustersX * s_clustersY * s_clustersZ);
+		m_clusterMax.resize(s_clustersX * s_clustersY * s_clustersZ);
+
+		for (uint32_t y = 0; y < s_clustersY; y++) {
+			for (uint32_t x = 0; x < s_clustersX; x++) {
+				//get the four edges of the tile on the near and far planes, this works for both perspective and orthographic projections
+				glm::vec2 tileMin = glm::vec2(-1.0f + 2.0f * x / s_clustersX, -1.0f + 2.0f * y / s_clustersY);
+				glm::vec2 tileMax = glm::vec2(-1.0f + 2.0f * (x + 1) / s_clustersX, -1.0f + 2.0f * (y + 1) / s_clustersY);
+				glm::vec2 corners[4] = { tileMin, glm::vec2(tileMax.x, tileMin.y), glm::vec2(tileMin.x, tileMax.y), tileMax };
+				glm::vec3 nearPoints[4], farPoints[4];
+				for (int i = 0; i < 4; i++) {
+					nearPoints[i] = unproject(glm::vec3(corners[i], -1.0f));
+					farPoints[i] = unproject(glm::vec3(corners[i], 1.0f));
+				}
+
+				for (uint32_t z = 0; z < s_clustersZ; z++) {
+					//the depth range of the slice
+					float sliceNear = m_near * std::pow(m_far / m_near, (float)z / s_clustersZ);
+					float sliceFar = m_near * std::pow(m_far / m_near, (float)(z + 1) / s_clustersZ);
+
+					//find where each edge of the tile crosses the slice's near and far depths and take the box around them
+					glm::vec3 boxMin = glm::vec3(std::numeric_limits<float>::max());
+					glm::vec3 boxMax = glm::vec3(-std::numeric_limits<float>::max());
+					for (int i = 0; i < 4; i++) {
+						float edgeNear = -nearPoints[i].z;
+						float edgeFar = -farPoints[i].z;
+						for (float depth : { sliceNear, sliceFar }) {
+							float t = (edgeFar - edgeNear != 0.0f) ? (depth - edgeNear) / (edgeFar - edgeNear) : 0.0f;
+							glm::vec3 point = glm::mix(nearPoints[i], farPoints[i], t);
+							boxMin = glm::min(boxMin, point);
+							boxMax = glm::max(boxMax, point);
+						}
+					}
+
+					uint32_t index = x + y * s_clustersX + z * s_clustersX * s_clustersY;
+					m_clusterMin[index] = boxMin;
+					m_clusterMax[index] = boxMax;
+				}
+			}
+		}
+	}
+
+	//sorts the lights into clusters
+	void TTN_LightClusters::Build(const std::pmr::vector<TTN_GPULight>& lights, const glm::mat4& view, const glm::mat4& projection)
+	{
+		//the cluster bounds only change with the projection
+		if (projection != m_boundsProjection || m_clusterMin.empty())
+			BuildClusterBounds(projection);
+		m_view = view;
+		m_lightCount = lights.size();
+
+		//everything built here is thrown away once it's uploaded, so it all comes from the frame arenas instead of the heap
+		std::pmr::memory_resource* arena = TTN_FrameArena::GetResource();
+
+		//put the lights in view space, stored as separate arrays so the tests below can be vectorized by the compiler
+		size_t lightCount = lights.size();
+		std::pmr::vector<float> centerX(lightCount, arena), centerY(lightCount, arena), centerZ(lightCount, arena), range(lightCount, arena), rangeSq(lightCount, arena);
+		for (size_t i = 0; i < lightCount; i++) {
+			glm::vec3 center = glm::vec3(view * glm::vec4(glm::vec3(lights[i].PositionRange), 1.0f));
+			centerX[i] = center.x;
+			centerY[i] = center.y;
+			centerZ[i] = center.z;
+			range[i] = lights[i].PositionRange.w;
+			rangeSq[i] = range[i] * range[i];
+		}
+
+		//each slice collects it's own light indices so the slices can be culled in parallel without sharing anything
+		//the arenas aren't shared between threads, so each slice's list is made from the arena of the thread that fills it
+		std::pmr::vector<std::optional<std::pmr::vector<uint32_t>>> sliceIndices(s_clustersZ, arena);
+		std::pmr::vector<glm::uvec2> grid(s_clustersX * s_clustersY * s_clustersZ, arena);
+
+		TTN_JobSystem::ParallelFor(s_clustersZ, [&](size_t begin, size_t end) {
+			std::pmr::memory_resource* threadArena = TTN_FrameArena::GetResource();
+			std::pmr::vector<uint32_t> candidates(threadArena);
+			candidates.reserve(lightCount);
+
+			for (size_t z = begin; z < end; z++) {
+				//first find the lights that overlap the slice's depth range at all, view space looks down -z
+				float sliceNear = m_near * std::pow(m_far / m_near, (float)z / s_clustersZ);
+				float sliceFar = m_near * std::pow(m_far / m_near, (float)(z + 1) / s_clustersZ);
+				candidates.clear();
+				for (size_t i = 0; i < lightCount; i++) {
+					float depth = -centerZ[i];
+					if (depth + range[i] >= sliceNear && depth - range[i] <= sliceFar)
+						candidates.push_back((uint32_t)i);
+				}
+
+				//then test those against every cluster in the slice
+				std::pmr::vector<uint32_t>& indices = sliceIndices[z].emplace(threadArena);
+				for (uint32_t y = 0; y < s_clustersY; y++) {
+					for (uint32_t x = 0; x < s_clustersX; x++) {
+						uint32_t cluster = x + y * s_clustersX + (uint32_t)z * s_clustersX * s_clustersY;
+						glm::vec3 boxMin = m_clusterMin[cluster];
+						glm::vec3 boxMax = m_clusterMax[cluster];
+
+						uint32_t offset = (uint32_t)indices.size();
+						for (uint32_t i : candidates) {
+							//sphere vs box, find the closest point on the box to the light and see if it's in range
+							float dx = std::max(std::max(boxMin.x - centerX[i], 0.0f), centerX[i] - boxMax.x);
+							float dy = std::max(std::max(boxMin.y - centerY[i], 0.0f), centerY[i] - boxMax.y);
+							float dz = std::max(std::max(boxMin.z - centerZ[i], 0.0f), centerZ[i] - boxMax.z);
+							if (dx * dx + dy * dy + dz * dz <= rangeSq[i])
+								indices.push_back(i);
+						}
+
+						//save where the cluster's lights are in the slice's list, this gets offset by the slice's start later
+						grid[cluster] = glm::uvec2(offset, (uint32_t)indices.size() - offset);
+					}
+				}
+			}
+		}, 1);
+
+		//join the slice lists together and move each cluster's offset to where it's slice starts
+		std::pmr::vector<uint32_t> allIndices(arena);
+		size_t total = 0;
+		for (auto& indices : sliceIndices)
+			total += indices->size();
+		allIndices.reserve(std::max<size_t>(total, 1));
+		for (uint32_t z = 0; z < s_clustersZ; z++) {
+			uint32_t sliceStart = (uint32_t)allIndices.size();
+			for (uint32_t i = 0; i < s_clustersX * s_clustersY; i++)
+				grid[i + z * s_clustersX * s_clustersY].x += sliceStart;
+			allIndices.insert(allIndices.end(), sliceIndices[z]->begin(), sliceIndices[z]->end());
+		}
+		m_indexCount = allIndices.size();
+
+		//buffers can't be empty, so give them a placeholder if there's nothing to put in them
+		if (allIndices.empty()) allIndices.push_back(0);
+		//only copy the lights if the placeholder is needed
+		TTN_GPULight placeholder;
+		const TTN_GPULight* gpuLights = lights.empty() ? &placeholder : lights.data();
+
+		//upload everything
+		if (m_lightBuffer == nullptr) {
+			m_lightBuffer = TTN_ShaderStorageBuffer::Create();
+			m_gridBuffer = TTN_ShaderStorageBuffer::Create();
+			m_indexBuffer = TTN_ShaderStorageBuffer::Create();
+		}
+		m_lightBuffer->LoadData(gpuLights, std::max<size_t>(lights.size(), 1));
+		m_gridBuffer->LoadData(grid.data(), grid.size());
+		m_indexBuffer->LoadData(allIndices.data(), allIndices.size());
+	}
+
+	//binds the buffers
+	void TTN_LightClusters::Bind()
+	{
+		if (m_lightBuffer == nullptr) return;
+
+		m_lightBuffer->BindBase(s_lightBinding);
+		m_gridBuffer->BindBase(s_gridBinding);
+		m_indexBuffer->BindBase(s_indexBinding);
+	}
+
+	//sets the uniforms the shaders need to find their cluster
+	void TTN_LightClusters::SetUniforms(TTN_Shader* shader, glm::uvec2 viewportSize)
+	{
+		shader->SetUniformMatrix("u_View", m_view);
+		shader->SetUniform("u_ClusterGrid", glm::ivec3(s_clustersX, s_clustersY, s_clustersZ));
+		shader->SetUniform("u_ClusterViewport", glm::vec2(viewportSize));
+		shader->SetUniform("u_ClusterNear", m_near);
+		shader->SetUniform("u_ClusterFar", m_far);
+	}
+}
@@ -7,120 +7,234 @@
 #include "Titan/Material.h"
 
 namespace Titan {
+	namespace {
+		//makes a 1x1 texture of a single colour, used for the textures a material hasn't been given
+		TTN_Texture2D::st2dptr CreateSolidTexture(const glm::vec4& color)
+		{
+			TTN_Texture2DDesc desc;
+			desc.width = 1;
+			desc.height = 1;
+			desc.format = Texture_Internal_Format::RGBA8;
+			TTN_Texture2D::st2dptr texture = std::make_shared<TTN_Texture2D>(desc);
+			texture->Clear(color);
+			return texture;
+		}
+	}
+
 	//default constructor
 	TTN_Material::TTN_Material() 
 		: m_Shininess(0), m_HeightInfluence(1.0f), m_hasAmbientLighting(true), m_hasSpecularLighting(true), 
-		m_hasOutline(false), m_outlineSize(0.0f), m_useDiffuseRamp(false), m_useSpecularRamp(false)
+		m_hasOutline(false), m_outlineSize(0.0f), m_useDiffuseRamp(false), m_useSpecularRamp(false), m_index(0), m_dirty(true)
 	{
 		//set the albedo to an all white texture by default
-		m_Albedo = TTN_Texture2D::Create();
-		m_Albedo->Clear(glm::vec4(1.0f));
+		m_Albedo = CreateSolidTexture(glm::vec4(1.0f));
 
 		//set the specular to an all white texture by default
-		m_SpecularMap = TTN_Texture2D::Create();
-		m_SpecularMap->Clear(glm::vec4(1.0f));
+		m_SpecularMap = CreateSolidTexture(glm::vec4(1.0f));
 		//set the cube map to an all white texture by default
 		m_SkyboxTexture = TTN_TextureCubeMap::Create();
 		m_SkyboxTexture->Clear(glm::vec4(1.0f));
 
 		//set the height map to an all black texture by default 
-		m_HeightMap = TTN_Texture2D::Create();
-		m_HeightMap->Clear(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+		m_HeightMap = CreateSolidTexture(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
 
 		//set the diffuse ramp to an all white texture by default
-		m_diffuseRamp = TTN_Texture2D::Create();
-		m_diffuseRamp->Clear(glm::vec4(1.0f));
+		m_diffuseRamp = CreateSolidTexture(glm::vec4(1.0f));
 
 		//set the specular ramp to an all white texture by default
-		m_specularRamp = TTN_Texture2D::Create();
-		m_specularRamp->Clear(glm::vec4(1.0f));
+		m_specularRamp = CreateSolidTexture(glm::vec4(1.0f));
+
+		//take a slot in the material buffer, reusing one from a deleted material if there is one
+		if (!s_freeIndices.empty()) {
+			m_index = s_freeIndices.back();
+			s_freeIndices.pop_back();
+			s_materials[m_index] = this;
+		}
+		else {
+			m_index = (uint32_t)s_materials.size();
+			s_materials.push_back(this);
+			s_gpuMaterials.push_back(TTN_GPUMaterial());
+		}
+		MarkDirty();
 	}
 
 	//default desctructor
 	TTN_Material::~TTN_Material()
-	{ }
+	{
+		//give the slot back
+		s_materials[m_index] = nullptr;
+		s_freeIndices.push_back(m_index);
+	}
 
 	//sets the albedo texture
 	void TTN_Material::SetAlbedo(TTN_Texture2D::st2dptr albedo)
 	{
 		m_Albedo = albedo;
+		MarkDirty();
 	}
 
 	//sets the shininess
 	void TTN_Material::SetShininess(float shininess)
 	{
 		m_Shininess = shininess;
+		MarkDirty();
 	}
 
 	//sets the specular map texture
 	void TTN_Material::SetSpecularMap(TTN_Texture2D::st2dptr specular)
 	{
 		m_SpecularMap = specular;
+		MarkDirty();
 	}
 
 	//sets a cube map texture for a skybox
 	void TTN_Material::SetSkybox(TTN_TextureCubeMap::stcmptr Skybox)
 	{
 		m_SkyboxTexture = Skybox;
+		MarkDirty();
 	}
 
 	//sets the height map texture
 	void TTN_Material::SetHeightMap(TTN_Texture2D::st2dptr height)
 	{
 		m_HeightMap = height;
+		MarkDirty();
 	}
 
 	//sets a multipliers for how how influence the height map should have
 	void TTN_Material::SetHeightInfluence(float influence)
 	{
 		m_HeightInfluence = influence;
+		MarkDirty();
 	}
 
 	//Sets wheter or not this material has ambient lighting
 	void TTN_Material::SetHasAmbient(bool hasAmbient)
 	{
 		m_hasAmbientLighting = hasAmbient;
+		MarkDirty();
 	}
 
 	//Sets wheter or not this material has specular lighting
 	void TTN_Material::SetHasSpecular(bool hasSpecular)
 	{
 		m_hasSpecularLighting = hasSpecular;
+		MarkDirty();
 	}
 
 	//Sets wheter or not this material has a line art like outline effect
 	void TTN_Material::SetHasOutline(bool hasOutline)
 	{
 		m_hasOutline = hasOutline;
+		MarkDirty();
 	}
 
 	//Sets the size (from 0.0 to 1.0) of the line art outline
 	void TTN_Material::SetOutlineSize(float outlineSize)
 	{
 		m_outlineSize = outlineSize;
+		MarkDirty();
 	}
 
 	//set the diffuse ramp for toon shading
 	void TTN_Material::SetDiffuseRamp(TTN_Texture2D::st2dptr ramp)
 	{
 		m_diffuseRamp = ramp;
+		MarkDirty();
 	}
 
 	//set wheter or not the diffuse ramp should be sampled by the default shaders
 	void TTN_Material::SetUseDiffuseRamp(bool useRamp)
 	{
 		m_useDiffuseRamp = useRamp;
+		MarkDirty();
 	}
 
 	//set the specular ramp for toon shading
 	void TTN_Material::SetSpecularRamp(TTN_Texture2D::st2dptr ramp)
 	{
 		m_specularRamp = ramp;
+		MarkDirty();
 	}
 
 	//set wheter or not the specular ramp should be sampled by the default shaders
 	void TTN_Material::SetUseSpecularRamp(bool useRamp)
 	{
 		m_useSpecularRamp = useRamp;
+		MarkDirty();
+	}
+
+	//checks if two materials use the same textures
+	bool TTN_Material::GetSameTextures(const TTN_Material& other) const
+	{
+		return m_Albedo == other.m_Albedo && m_SpecularMap == other.m_SpecularMap && m_HeightMap == other.m_HeightMap
+			&& m_diffuseRamp == other.m_diffuseRamp && m_specularRamp == other.m_specularRamp;
+	}
+
+	//gets the default material
+	const TTN_Material::smatptr& TTN_Material::GetDefault()
+	{
+		//made the first time it's asked for, with the same shininess the default shaders get for objects without a material
+		static smatptr defaultMaterial = nullptr;
+		if (defaultMaterial == nullptr) {
+			defaultMaterial = Create();
+			defaultMaterial->SetShininess(128.0f);
+		}
+		return defaultMaterial;
+	}
+
+	//marks the material as changed
+	void TTN_Material::MarkDirty()
+	{
+		m_dirty = true;
+		s_bufferDirty = true;
+	}
+
+	//writes the material's data
+	void TTN_Material::WriteGPUData()
+	{
+		//the textures are only made resident once they're drawn with, so they can still be set up before then
+		auto handle = [](const TTN_Texture2D::st2dptr& texture) { return (texture != nullptr) ? texture->GetBindlessHandle() : (uint64_t)0; };
+
+		TTN_GPUMaterial& data = s_gpuMaterials[m_index];
+		data.Albedo = handle(m_Albedo);
+		data.Specular = handle(m_SpecularMap);
+		data.HeightMap = handle(m_HeightMap);
+		data.DiffuseRamp = handle(m_diffuseRamp);
+		data.SpecularRamp = handle(m_specularRamp);
+		data.Padding = 0;
+		data.Params = glm::vec4(m_Shininess, m_HeightInfluence, m_outlineSize, 0.0f);
+		data.Lighting = glm::ivec4((int)m_hasAmbientLighting, (int)m_hasSpecularLighting, (int)!m_hasOutline, 0);
+		data.Ramps = glm::ivec4((int)m_useDiffuseRamp, (int)m_useSpecularRamp, 0, 0);
+
+		m_dirty = false;
+	}
+
+	//uploads and binds the material buffer
+	void TTN_Material::BindMaterialBuffer()
+	{
+		if (!GetUseMaterialBuffer()) return;
+
+		//if a texture was recreated since the handles were written, the buffer could be holding it's old handle, so every material writes them again
+		if (s_textureGeneration != TTN_ITexture::GetHandleGeneration()) {
+			for (TTN_Material* material : s_materials) {
+				if (material != nullptr) material->m_dirty = true;
+			}
+			s_bufferDirty = true;
+			s_textureGeneration = TTN_ITexture::GetHandleGeneration();
+		}
+
+		//only the materials that changed need their handles and data written again, but the buffer's small enough to upload whole
+		if (s_bufferDirty) {
+			for (TTN_Material* material : s_materials) {
+				if (material != nullptr && material->m_dirty) material->WriteGPUData();
+			}
+
+			if (s_materialBuffer == nullptr) s_materialBuffer = TTN_ShaderStorageBuffer::Create();
+			s_materialBuffer->LoadData(s_gpuMaterials.data(), s_gpuMaterials.size());
+			s_bufferDirty = false;
+		}
+
+		if (s_materialBuffer != nullptr) s_materialBuffer->BindBase(s_materialBinding);
 	}
 }
\ No newline at end of file
@@ -22,9 +22,13 @@ namespace Titan {
 	{
 	}
 
-	//sets up the VAO for the mesh so it can acutally be rendered, needs to be called by the user in case they change the mesh
-	void TTN_Mesh::SetUpVao(int currentFrame, int nextFrame)
+	//sets up the VAO for the mesh so it can acutally be rendered, it only needs rebuilding if the mesh has changed
+	void TTN_Mesh::SetUpVao()
 	{
+		//if it's already built for the current data there's nothing to do
+		if (m_vao != nullptr && !m_vaoDirty)
+			return;
+
 		//if we don't have a vao, creates a new vao
 		if (m_vao == nullptr)
 			m_vao = TTN_VertexArrayObject::Create();
@@ -32,13 +36,37 @@ namespace Titan {
 		else
 			m_vao->ClearVertexBuffers();
 
-		//load the vbos from the mesh into the vao 
-		m_vao->AddVertexBuffer(m_vertVbos[currentFrame], { BufferAttribute(0, 3, GL_FLOAT, false, sizeof(float) * 3, 0, AttribUsage::Position) });
-		m_vao->AddVertexBuffer(m_normVbos[currentFrame], { BufferAttribute(1, 3, GL_FLOAT, false, sizeof(float) * 3, 0, AttribUsage::Normal) });
+		//load the vbos from the mesh into the vao, the next frame slots get the first frame so shaders that still read them see a still mesh
+		m_vao->AddVertexBuffer(m_vertVbos[0], { BufferAttribute(0, 3, GL_FLOAT, false, sizeof(float) * 3, 0, AttribUsage::Position) });
+		m_vao->AddVertexBuffer(m_normVbos[0], { BufferAttribute(1, 3, GL_FLOAT, false, sizeof(float) * 3, 0, AttribUsage::Normal) });
 		m_vao->AddVertexBuffer(m_UVsVbo, { BufferAttribute(2, 2, GL_FLOAT, false, sizeof(float) * 2, 0, AttribUsage::Texture) });
 		if (m_HasVertColors) m_vao->AddVertexBuffer(m_ColVbo, { BufferAttribute(3, 3, GL_FLOAT, false, sizeof(float) * 2, 0, AttribUsage::Color) });
-		m_vao->AddVertexBuffer(m_vertVbos[nextFrame], {BufferAttribute(4, 3, GL_FLOAT, false, sizeof(float) * 3, 0, AttribUsage::Position) });
-		m_vao->AddVertexBuffer(m_normVbos[nextFrame], { BufferAttribute(5, 3, GL_FLOAT, false, sizeof(float) * 3, 0, AttribUsage::Normal) });
+		m_vao->AddVertexBuffer(m_vertVbos[0], {BufferAttribute(4, 3, GL_FLOAT, false, sizeof(float) * 3, 0, AttribUsage::Position) });
+		m_vao->AddVertexBuffer(m_normVbos[0], { BufferAttribute(5, 3, GL_FLOAT, false, sizeof(float) * 3, 0, AttribUsage::Normal) });
+
+		m_vaoDirty = false;
+	}
+
+	//binds the packed frames
+	void TTN_Mesh::BindFrames()
+	{
+		//pack them if they've changed, each vertex is a position then a normal, and each frame is every vertex in order
+		if (m_frameBuffer == nullptr || m_framesDirty) {
+			std::vector<glm::vec4> packed;
+			packed.reserve(m_Vertices.size() * GetVertCount() * 2);
+			for (size_t frame = 0; frame < m_Vertices.size(); frame++) {
+				for (size_t i = 0; i < m_Vertices[frame].size(); i++) {
+					packed.push_back(glm::vec4(m_Vertices[frame][i], 1.0f));
+					packed.push_back((frame < m_Normals.size() && i < m_Normals[frame].size()) ? glm::vec4(m_Normals[frame][i], 0.0f) : glm::vec4(0.0f));
+				}
+			}
+
+			if (m_frameBuffer == nullptr) m_frameBuffer = TTN_ShaderStorageBuffer::Create(GL_STATIC_DRAW);
+			if (!packed.empty()) m_frameBuffer->LoadData(packed.data(), packed.size());
+			m_framesDirty = false;
+		}
+
+		m_frameBuffer->BindBase(s_frameBinding);
 	}
 
 	void TTN_Mesh::SetUVs(std::vector<glm::vec2>& uvs)
@@ -48,6 +76,7 @@ namespace Titan {
 
 		//copy the list of uvs
 		m_Uvs = uvs;
+		m_vaoDirty = true;
 
 		//add the uvs to the vbo
 		if (uvs.size() != 0) {
@@ -65,6 +94,7 @@ namespace Titan {
 
 			//copy the colors
 			m_Colors = colors;
+			m_vaoDirty = true;
 			//set the mesh to have vertex colors (note, they still won't render if the shader is not set to render them)
 			m_HasVertColors = true;
 			//send them to a vbo
@@ -87,6 +117,26 @@ namespace Titan {
 
 		//copy the list of verts
 		m_Vertices.push_back(verts);
+		m_vaoDirty = true;
+		m_framesDirty = true;
+
+		//grow the bounding box to fit them, the first set replaces the empty box
+		for (size_t i = 0; i < verts.size(); i++) {
+			bool first = (m_Vertices.size() == 1 && i == 0);
+			m_boundsMin = first ? verts[i] : glm::min(m_boundsMin, verts[i]);
+			m_boundsMax = first ? verts[i] : glm::max(m_boundsMax, verts[i]);
+		}
+
+		//the sphere is centered on the box, so if the box moved every frame has to be measured again
+		m_boundingCenter = (m_boundsMin + m_boundsMax) * 0.5f;
+		float radiusSquared = 0.0f;
+		for (const auto& frame : m_Vertices) {
+			for (const auto& vert : frame) {
+				glm::vec3 offset = vert - m_boundingCenter;
+				radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+			}
+		}
+		m_boundingRadius = std::sqrt(radiusSquared);
 
 		//add those verts to the new vbo
 		if (verts.size() != 0) {
@@ -105,6 +155,8 @@ namespace Titan {
 
 		//copy the list of normals
 		m_Normals.push_back(norms);
+		m_vaoDirty = true;
+		m_framesDirty = true;
 
 		//add those normals to the new vbo
 		if (norms.size() != 0) {
@@ -115,6 +167,28 @@ namespace Titan {
 		m_normVbos.push_back(newNormVbo);
 	}
 
+	//adds a level of detail
+	bool TTN_Mesh::AddLOD(smptr lod, float screenSize)
+	{
+		//the renderer uses the same animation frames on every level, so they all need the same number
+		if (lod == nullptr || lod->GetFrameCount() != GetFrameCount()) {
+			LOG_ERROR("Level of detail does not have the same number of frames as the mesh");
+			return false;
+		}
+
+		//by default each level is used at half the size of the last one, starting when the mesh is a quarter of the screen's height
+		if (screenSize < 0.0f)
+			screenSize = 0.25f * std::pow(0.5f, (float)m_lods.size());
+
+		//make sure the levels get used in order
+		if (!m_lodScreenSizes.empty())
+			screenSize = std::min(screenSize, m_lodScreenSizes.back());
+
+		m_lods.push_back(lod);
+		m_lodScreenSizes.push_back(screenSize);
+		return true;
+	}
+
 	//gets the pointer to the meshes vao 
 	TTN_VertexArrayObject::svaptr TTN_Mesh::GetVAOPointer()
 	{
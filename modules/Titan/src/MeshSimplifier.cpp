@@ -0,0 +1,247 @@
+//Titan Engine, by Atlas X Games
+// MeshSimplifier.cpp - source file for the class that builds simpler levels of detail from a mesh
+
+//precompile header, this file uses vector, unordered_map, array, and glm
+#include "Titan/ttn_pch.h"
+//include the header
+#include "Titan/MeshSimplifier.h"
+//the collapses are picked cheapest first from a priority queue, and the corners are welded with a map
+#include <queue>
+#include <map>
+
+namespace Titan {
+	namespace {
+		//an edge collapse waiting in the queue, moves the vertex from onto the vertex to
+		struct Collapse {
+			double cost;
+			uint32_t from;
+			uint32_t to;
+			//the versions of both vertices when it was queued, if either has changed since the cost is out of date
+			uint32_t fromVersion;
+			uint32_t toVersion;
+
+			//the queue pops the largest, so compare backwards to get the cheapest
+			bool operator<(const Collapse& other) const { return cost > other.cost; }
+		};
+
+		//the error of a point against the sum of the planes in a quadric
+		double QuadricError(const glm::dmat4& quadric, const glm::vec3& point) {
+			glm::dvec4 p = glm::dvec4(glm::dvec3(point), 1.0);
+			return glm::dot(p, quadric * p);
+		}
+
+		//the normal of a triangle, not normalized so it's length is twice the area
+		glm::vec3 FaceNormal(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+			return glm::cross(b - a, c - a);
+		}
+	}
+
+	//simplifies a mesh
+	TTN_Mesh::smptr TTN_MeshSimplifier::Simplify(const TTN_Mesh::smptr& mesh, float ratio)
+	{
+		int frameCount = mesh->GetFrameCount();
+		const std::vector<glm::vec3>& corners = mesh->GetFrameVertices(0);
+		std::vector<glm::vec2> uvs = mesh->GetVertexUvs();
+		const std::vector<glm::vec3>& colors = mesh->GetVertexColors();
+		bool hasUvs = (uvs.size() == corners.size());
+		bool hasColors = (mesh->GetHasVertColors() && colors.size() == corners.size());
+
+		//the mesh is stored as a plain triangle list, so weld corners with the same position and uv into shared vertices
+		//corners in the same place with different uvs stay apart, which leaves the seam as an open edge
+		std::map<std::array<float, 5>, uint32_t> weldMap;
+		std::vector<uint32_t> cornerVertex(corners.size());
+		//the first corner each vertex was welded from, that's where it's position in each frame, uv and color are copied from
+		std::vector<uint32_t> vertexCorner;
+		for (size_t i = 0; i < corners.size(); i++) {
+			glm::vec2 uv = hasUvs ? uvs[i] : glm::vec2(0.0f);
+			std::array<float, 5> key = { corners[i].x, corners[i].y, corners[i].z, uv.x, uv.y };
+			auto it = weldMap.find(key);
+			if (it == weldMap.end()) {
+				it = weldMap.emplace(key, (uint32_t)vertexCorner.size()).first;
+				vertexCorner.push_back((uint32_t)i);
+			}
+			cornerVertex[i] = it->second;
+		}
+		size_t vertexCount = vertexCorner.size();
+
+		//welded corners can have different normals (flat shaded faces), so each vertex gets the average of them in every frame
+		std::vector<std::vector<glm::vec3>> normals(frameCount, std::vector<glm::vec3>(vertexCount, glm::vec3(0.0f)));
+		for (int frame = 0; frame < frameCount; frame++) {
+			const std::vector<glm::vec3>& frameNormals = mesh->GetFrameNormals(frame);
+			for (size_t i = 0; i < corners.size() && i < frameNormals.size(); i++)
+				normals[frame][cornerVertex[i]] += frameNormals[i];
+			for (auto& normal : normals[frame])
+				normal = (glm::length(normal) > 0.0f) ? glm::normalize(normal) : glm::vec3(0.0f, 1.0f, 0.0f);
+		}
+
+		//the first frame's positions are the ones the errors are measured with
+		std::vector<glm::vec3> positions(vertexCount);
+		for (size_t v = 0; v < vertexCount; v++)
+			positions[v] = corners[vertexCorner[v]];
+
+		//build the triangles out of the welded vertices, dropping any that welded down to a line
+		std::vector<std::array<uint32_t, 3>> triangles;
+		triangles.reserve(corners.size() / 3);
+		for (size_t i = 0; i + 2 < corners.size(); i += 3) {
+			std::array<uint32_t, 3> tri = { cornerVertex[i], cornerVertex[i + 1], cornerVertex[i + 2] };
+			if (tri[0] != tri[1] && tri[1] != tri[2] && tri[0] != tri[2])
+				triangles.push_back(tri);
+		}
+		std::vector<bool> triangleRemoved(triangles.size(), false);
+		size_t liveTriangles = triangles.size();
+		size_t targetTriangles = std::max((size_t)1, (size_t)(corners.size() / 3 * std::clamp(ratio, 0.0f, 1.0f)));
+
+		//work out which triangles use each vertex, and count how many triangles use each edge
+		std::vector<std::vector<uint32_t>> vertexTriangles(vertexCount);
+		std::unordered_map<uint64_t, int> edgeUses;
+		for (size_t t = 0; t < triangles.size(); t++) {
+			for (int k = 0; k < 3; k++) {
+				uint32_t a = triangles[t][k], b = triangles[t][(k + 1) % 3];
+				vertexTriangles[a].push_back((uint32_t)t);
+				edgeUses[((uint64_t)std::min(a, b) << 32) | std::max(a, b)]++;
+			}
+		}
+
+		//vertices on an open edge (the border of the mesh or a uv seam) are locked in place
+		std::vector<bool> locked(vertexCount, false);
+		for (const auto& edge : edgeUses) {
+			if (edge.second == 1) {
+				locked[(uint32_t)(edge.first >> 32)] = true;
+				locked[(uint32_t)(edge.first & 0xFFFFFFFF)] = true;
+			}
+		}
+
+		//each vertex's quadric is the sum of the planes of the triangles around it, weighted by their area
+		std::vector<glm::dmat4> quadrics(vertexCount, glm::dmat4(0.0));
+		for (const auto& tri : triangles) {
+			glm::vec3 normal = FaceNormal(positions[tri[0]], positions[tri[1]], positions[tri[2]]);
+			float doubleArea = glm::length(normal);
+			if (doubleArea <= 0.0f) continue;
+			normal /= doubleArea;
+			glm::dvec4 plane = glm::dvec4(glm::dvec3(normal), -glm::dot(normal, positions[tri[0]]));
+			glm::dmat4 quadric = glm::outerProduct(plane, plane) * (double)(doubleArea * 0.5f);
+			for (int k = 0; k < 3; k++)
+				quadrics[tri[k]] += quadric;
+		}
+
+		//collapses only ever move a vertex onto one of it's neighbours, so the kept vertex still has it's position in every morph frame
+		std::vector<bool> vertexRemoved(vertexCount, false);
+		std::vector<uint32_t> versions(vertexCount, 0);
+		std::priority_queue<Collapse> queue;
+		auto QueueCollapse = [&](uint32_t from, uint32_t to) {
+			if (locked[from]) return;
+			queue.push({ QuadricError(quadrics[from] + quadrics[to], positions[to]), from, to, versions[from], versions[to] });
+		};
+		for (const auto& tri : triangles) {
+			for (int k = 0; k < 3; k++) {
+				QueueCollapse(tri[k], tri[(k + 1) % 3]);
+				QueueCollapse(tri[(k + 1) % 3], tri[k]);
+			}
+		}
+
+		//collapse the cheapest edges until the mesh is small enough
+		while (liveTriangles > targetTriangles && !queue.empty()) {
+			Collapse collapse = queue.top();
+			queue.pop();
+
+			//skip it if either end has been removed or changed since it was queued
+			if (vertexRemoved[collapse.from] || vertexRemoved[collapse.to] ||
+				versions[collapse.from] != collapse.fromVersion || versions[collapse.to] != collapse.toVersion)
+				continue;
+
+			//don't collapse if any triangle that moves would flip over
+			bool flips = false;
+			for (uint32_t t : vertexTriangles[collapse.from]) {
+				const auto& tri = triangles[t];
+				if (triangleRemoved[t] || tri[0] == collapse.to || tri[1] == collapse.to || tri[2] == collapse.to) continue;
+
+				glm::vec3 moved[3];
+				for (int k = 0; k < 3; k++)
+					moved[k] = positions[(tri[k] == collapse.from) ? collapse.to : tri[k]];
+				glm::vec3 before = FaceNormal(positions[tri[0]], positions[tri[1]], positions[tri[2]]);
+				glm::vec3 after = FaceNormal(moved[0], moved[1], moved[2]);
+				if (glm::dot(before, after) <= 0.0f) {
+					flips = true;
+					break;
+				}
+			}
+			if (flips) continue;
+
+			//triangles using the edge disappear, the rest move over to the kept vertex
+			for (uint32_t t : vertexTriangles[collapse.from]) {
+				if (triangleRemoved[t]) continue;
+				auto& tri = triangles[t];
+				if (tri[0] == collapse.to || tri[1] == collapse.to || tri[2] == collapse.to) {
+					triangleRemoved[t] = true;
+					liveTriangles--;
+					continue;
+				}
+				for (int k = 0; k < 3; k++)
+					if (tri[k] == collapse.from) tri[k] = collapse.to;
+				vertexTriangles[collapse.to].push_back(t);
+			}
+			vertexRemoved[collapse.from] = true;
+			quadrics[collapse.to] += quadrics[collapse.from];
+			versions[collapse.to]++;
+
+			//the kept vertex's quadric changed, so queue the edges around it again with their new costs
+			for (uint32_t t : vertexTriangles[collapse.to]) {
+				if (triangleRemoved[t]) continue;
+				for (uint32_t other : triangles[t]) {
+					if (other == collapse.to) continue;
+					QueueCollapse(collapse.to, other);
+					QueueCollapse(other, collapse.to);
+				}
+			}
+		}
+
+		//write the triangles that are left back out as a triangle list
+		std::vector<std::vector<glm::vec3>> outVerts(frameCount);
+		std::vector<std::vector<glm::vec3>> outNorms(frameCount);
+		std::vector<glm::vec2> outUvs;
+		std::vector<glm::vec3> outColors;
+		for (size_t t = 0; t < triangles.size(); t++) {
+			if (triangleRemoved[t]) continue;
+			for (uint32_t v : triangles[t]) {
+				uint32_t corner = vertexCorner[v];
+				for (int frame = 0; frame < frameCount; frame++) {
+					outVerts[frame].push_back(mesh->GetFrameVertices(frame)[corner]);
+					outNorms[frame].push_back(normals[frame][v]);
+				}
+				if (hasUvs) outUvs.push_back(uvs[corner]);
+				if (hasColors) outColors.push_back(colors[corner]);
+			}
+		}
+
+		TTN_Mesh::smptr simplified = TTN_Mesh::Create();
+		for (int frame = 0; frame < frameCount; frame++) {
+			simplified->AddVertices(outVerts[frame]);
+			simplified->AddNormals(outNorms[frame]);
+		}
+		simplified->SetUVs(outUvs);
+		if (hasColors) simplified->SetColors(outColors);
+
+		return simplified;
+	}
+
+	//generates levels of detail for a mesh
+	void TTN_MeshSimplifier::GenerateLODs(const TTN_Mesh::smptr& mesh, int levels, float ratio)
+	{
+		//authored levels of detail win over generated ones
+		if (mesh == nullptr || mesh->GetLODCount() > 1)
+			return;
+
+		//each level is simplified from the one before it, which is cheaper than starting from the full mesh every time
+		TTN_Mesh::smptr last = mesh;
+		for (int level = 1; level <= levels; level++) {
+			TTN_Mesh::smptr lod = Simplify(last, ratio);
+
+			//stop once it can't get any simpler, a level that doesn't save triangles isn't worth switching to
+			if (lod->GetTriangleCount() >= last->GetTriangleCount())
+				break;
+
+			mesh->AddLOD(lod);
+			last = lod;
+		}
+	}
+}
@@ -33,7 +33,7 @@ namespace Titan {
 
 #pragma endregion 
 
-	TTN_Mesh::smptr TTN_ObjLoader::LoadFromFile(const std::string& fileName)
+	TTN_Mesh::smptr TTN_ObjLoader::LoadFromFile(const std::string& fileName, bool loadLODs)
 	{
 		//Vectors for storing data parsed in 
 		std::vector<glm::vec3> vertexPos;
@@ -161,14 +161,22 @@ namespace Titan {
 		newMesh->AddNormals(meshVertNorms);
 		newMesh->SetUVs(meshVertUvs);
 
+		//load any levels of detail saved next to the file
+		if (loadLODs) {
+			std::filesystem::path path = fileName;
+			std::string base = (path.parent_path() / path.stem()).string();
+			for (int level = 1; std::filesystem::exists(base + "_lod" + std::to_string(level) + path.extension().string()); level++)
+				newMesh->AddLOD(LoadFromFile(base + "_lod" + std::to_string(level) + path.extension().string(), false));
+		}
+
 		return newMesh;
 	}
 
 	//loads a series of meshes for morph target animations, assumes the files are named with the convention: fileName_1, fileName_2, etc.
-	TTN_Mesh::smptr TTN_ObjLoader::LoadAnimatedMeshFromFiles(const std::string& fileName, int numOfFiles)
+	TTN_Mesh::smptr TTN_ObjLoader::LoadAnimatedMeshFromFiles(const std::string& fileName, int numOfFiles, bool loadLODs)
 	{
 		//start by loading the first mesh, this will handle the first set of vertices and normals along with the uvs
-		TTN_Mesh::smptr newMesh = LoadFromFile(fileName + "_1.obj");
+		TTN_Mesh::smptr newMesh = LoadFromFile(fileName + "_1.obj", false);
 
 		//from there loop through the next couple of files, loading in vertices and normals and adding them to newMesh
 		for (int i = 2; i <= numOfFiles; i++) {
@@ -279,6 +287,12 @@ namespace Titan {
 			newMesh->AddNormals(meshVertNorms);
 		}
 
+		//load any levels of detail saved next to the files, they need the same number of frames
+		if (loadLODs) {
+			for (int level = 1; std::filesystem::exists(fileName + "_lod" + std::to_string(level) + "_1.obj"); level++)
+				newMesh->AddLOD(LoadAnimatedMeshFromFiles(fileName + "_lod" + std::to_string(level), numOfFiles, false));
+		}
+
 		//at the end of the for loop all the animation files will be loaded into a single mesh object, so you can just return that mesh
 		return newMesh;
 	}
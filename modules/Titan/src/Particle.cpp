@@ -5,6 +5,8 @@
 #include "Titan/ttn_pch.h"
 //include the header
 #include "Titan/Particle.h"
+//include the backend, to check if it's running headless
+#include "Titan/Backend.h"
 
 //code refernce: https://www.youtube.com/watch?v=GK0jHlv3e3w&t=515s
 
@@ -26,7 +28,6 @@ namespace Titan {
 		m_maxParticlesCount = 1000;
 		m_durationRemaining = m_duration;
 		m_activeParticleIndex = m_maxParticlesCount - 1;
-		m_vao = TTN_VertexArrayObject::Create();
 
 		//reverse memory space for all the particle data
 		SetUpData();
@@ -38,7 +39,8 @@ namespace Titan {
 		readGraphRotation = &defaultReadGraph;
 		readGraphScale = &defaultReadGraph;
 
-		SetUpRenderingStuff();
+		//the buffers are only needed to draw, which never happens headless
+		if (!TTN_Backend::GetHeadless()) SetUpRenderingStuff();
 	}
 
 	//constructor that takes in data
@@ -55,7 +57,6 @@ namespace Titan {
 		//setup the rest of the data
 		m_durationRemaining = 0.0f;
 		m_activeParticleIndex = m_maxParticlesCount - 1;
-		m_vao = TTN_VertexArrayObject::Create();
 		m_rotation = glm::vec3(0.0f);
 		m_emitterShape = TTN_ParticleEmitterShape::SPHERE;
 		m_EmitterAngle = 15.0f;
@@ -68,8 +69,11 @@ namespace Titan {
 		readGraphRotation = &defaultReadGraph;
 		readGraphScale = &defaultReadGraph;
 
+		//the buffers are only needed to draw, which never happens headless
+		if (TTN_Backend::GetHeadless()) return;
+
 		SetUpRenderingStuff();
-		
+
 		VertexPosVBO->LoadData(m_particle._mesh->GetVertexPositions().data(), m_particle._mesh->GetVertexPositions().size());
 		VertexNormVBO->LoadData(m_particle._mesh->GetVertexNormals().data(), m_particle._mesh->GetVertexNormals().size());
 		VertexUVVBO->LoadData(m_particle._mesh->GetVertexUvs().data(), m_particle._mesh->GetVertexUvs().size());
@@ -163,6 +167,8 @@ namespace Titan {
 	{
 		m_particle = particleTemplate;
 
+		if (TTN_Backend::GetHeadless()) return;
+
 		VertexPosVBO->LoadData(m_particle._mesh->GetVertexPositions().data(), m_particle._mesh->GetVertexPositions().size());
 		VertexNormVBO->LoadData(m_particle._mesh->GetVertexNormals().data(), m_particle._mesh->GetVertexNormals().size());
 		VertexUVVBO->LoadData(m_particle._mesh->GetVertexUvs().data(), m_particle._mesh->GetVertexUvs().size());
@@ -449,6 +455,19 @@ namespace Titan {
 		}
 	}
 
+	//kills all the particles and restarts the system
+	void TTN_ParticleSystem::Reset()
+	{
+		//deactivate all the particles
+		for (size_t i = 0; i < m_maxParticlesCount; i++)
+			Active[i] = false;
+
+		//and restart the timers the same way the constructor sets them
+		m_activeParticleIndex = m_maxParticlesCount - 1;
+		m_durationRemaining = 0.0f;
+		m_emissionTimer = 0.0f;
+	}
+
 	//sets up vao and vbos
 	void TTN_ParticleSystem::SetUpRenderingStuff()
 	{
@@ -214,6 +214,23 @@ namespace Titan {
 	{
 		m_body->clearForces();
 	}
+	//moves the body and clears all of it's motion
+	void TTN_Physics::Reset(glm::vec3 position)
+	{
+		//move both the body and the motion state, as bullet reads the body's transform when it's added back to the world
+		btTransform Trans = m_body->getWorldTransform();
+		Trans.setOrigin(btVector3(position.x, position.y, position.z));
+		m_body->setWorldTransform(Trans);
+		m_body->setInterpolationWorldTransform(Trans);
+		m_body->getMotionState()->setWorldTransform(Trans);
+		m_trans.SetPos(position);
+
+		//clear the velocities and any forces
+		m_body->setLinearVelocity(btVector3(0.0f, 0.0f, 0.0f));
+		m_body->setAngularVelocity(btVector3(0.0f, 0.0f, 0.0f));
+		m_body->clearForces();
+	}
+
 	void TTN_Physics::SetEntity(entt::entity entity)
 	{
 		//save the entity in titan
@@ -5,49 +5,56 @@ namespace Titan {
 	//initliazes the post processing effect
 	void TTN_PostEffect::Init(unsigned width, unsigned height)
 	{
-		//Set up framebuffers
-		if (!m_shaders.size() > 0) {
-			//creates a new framebuffer with a basic color and depth target
-			int index = int(m_buffers.size());
-			m_buffers.push_back(TTN_Framebuffer::Create());
-			m_buffers[index]->AddColorTarget(GL_RGBA8);
-			m_buffers[index]->AddDepthTarget();
-			//initliaze the framebuffer
-			m_buffers[index]->Init(width, height);
-		}
+		//the base effect just passes the image through, so all it needs is the shared passthrough shader
+		InitPassthrough();
+	}
+
+	//loads the passthrough shader
+	void TTN_PostEffect::InitPassthrough()
+	{
+		//only load it once for every effect
+		if (s_passthroughShader != nullptr) return;
 
-		//set up the basic post effect shader
-		m_shaders.push_back(TTN_Shader::Create());
-		//load in a basic passthrough shader (maybe try to make another system later to manage the shader pointers better)
-		m_shaders[m_shaders.size() - 1]->LoadShaderStageFromFile("shaders/Post/ttn_passthrough_vert.glsl", GL_VERTEX_SHADER);
-		m_shaders[m_shaders.size() - 1]->LoadShaderStageFromFile("shaders/Post/ttn_passthrough_frag.glsl", GL_FRAGMENT_SHADER);
-		m_shaders[m_shaders.size() - 1]->Link();
+		s_passthroughShader = TTN_Shader::Create();
+		s_passthroughShader->LoadShaderStageFromFile("shaders/Post/ttn_passthrough_vert.glsl", GL_VERTEX_SHADER);
+		s_passthroughShader->LoadShaderStageFromFile("shaders/Post/ttn_passthrough_frag.glsl", GL_FRAGMENT_SHADER);
+		s_passthroughShader->Link();
 	}
 
 	//applies the effect to the full screen quad
-	void TTN_PostEffect::ApplyEffect(TTN_PostEffect::spostptr prevBuffer) {
-		//binds the shader
-		BindShader(m_shaders.size() - 1);
-		//binds the color
-		prevBuffer->BindColorAsTexture(0, 0, 0);
-		//renders to the full screen quad
-		m_buffers[0]->RenderToFSQ();
-		//unbind everything
-		prevBuffer->UnbindTexture(0);
-		UnbindShader();
+	void TTN_PostEffect::ApplyEffect(const TTN_Framebuffer::sfboptr& source, const TTN_Framebuffer::sfboptr& target) {
+		//the base effect is just a copy
+		Copy(source, target);
 	}
 
-	//draws the effect to the screen
-	void TTN_PostEffect::DrawToScreen() {
+	//draws a framebuffer to the screen
+	void TTN_PostEffect::DrawToScreen(const TTN_Framebuffer::sfboptr& source) {
+		InitPassthrough();
 		//binds the shader
-		BindShader(m_shaders.size() - 1);
+		s_passthroughShader->Bind();
+		s_passthroughShader->SetUniform("u_UVScale", source->GetUVScale());
 		//binds the color
-		BindColorAsTexture(0, 0, 0);
+		source->BindColorAsTexture(0, 0);
 		//draws the full screen quad to the screen
-		m_buffers[0]->DrawFullScreenQuad();
+		TTN_Framebuffer::DrawFullScreenQuad();
 		//and unbinds everything
-		UnbindTexture(0);
-		UnbindShader();
+		source->UnbindTexture(0);
+		glUseProgram(GL_NONE);
+	}
+
+	//copies one framebuffer into another
+	void TTN_PostEffect::Copy(const TTN_Framebuffer::sfboptr& source, const TTN_Framebuffer::sfboptr& target) {
+		InitPassthrough();
+		//binds the shader
+		s_passthroughShader->Bind();
+		s_passthroughShader->SetUniform("u_UVScale", source->GetUVScale());
+		//binds the color
+		source->BindColorAsTexture(0, 0);
+		//renders to the full screen quad
+		target->RenderToFSQ();
+		//unbind everything
+		source->UnbindTexture(0);
+		glUseProgram(GL_NONE);
 	}
 
 	//resizes the framebuffers
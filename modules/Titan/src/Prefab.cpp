@@ -0,0 +1,33 @@
+//Titan Engine, by Atlas X Games 
+// Prefab.cpp - source file for the class that represents a reusable set of components that can be stamped onto many entities at once
+
+//precompile header, this file uses entt.hpp and typeindex
+#include "Titan/ttn_pch.h"
+//include the header
+#include "Titan/Prefab.h"
+
+namespace Titan {
+	//constructor
+	TTN_Prefab::TTN_Prefab(std::string name)
+		: m_name(name), m_transform(TTN_Transform())
+	{
+		m_components = std::vector<std::pair<std::type_index, std::shared_ptr<TTN_ComponentTemplate>>>();
+	}
+
+	//stamps all of the component templates onto the entities
+	void TTN_Prefab::Stamp(entt::registry& registry, const std::vector<entt::entity>& entities) const
+	{
+		for (auto& component : m_components)
+			component.second->Stamp(registry, entities);
+	}
+
+	//finds the index of a component template
+	int TTN_Prefab::Find(std::type_index type) const
+	{
+		for (size_t i = 0; i < m_components.size(); i++) {
+			if (m_components[i].first == type) return (int)i;
+		}
+
+		return -1;
+	}
+}
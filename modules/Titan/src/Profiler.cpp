@@ -0,0 +1,494 @@
+//Titan Engine, by Atlas X Games
+// Profiler.cpp - source file for the frame profiler that times scopes on the cpu and gpu and shows them as a timeline
+
+//precompile header, this file uses vector, deque, unordered_map, algorithm, fstream, thread, mutex, and glad
+#include "Titan/ttn_pch.h"
+//include the header
+#include "Titan/Profiler.h"
+//include imgui for the profiler window
+#include "imgui.h"
+
+namespace Titan {
+	namespace {
+		//the time the profiler started, every timestamp is relative to it
+		const std::chrono::steady_clock::time_point s_epoch = std::chrono::steady_clock::now();
+
+		//a scope in a frame's flame graph, every call with the same name under the same parent is merged into one node
+		struct TTN_FlameNode {
+			const char* Name;
+			uint64_t Total;
+			uint32_t Depth;
+			std::vector<int> Children;
+		};
+
+		//escapes a name so it can go in a json string
+		std::string EscapeJson(const char* name)
+		{
+			std::string escaped;
+			for (const char* c = name; *c != '\0'; c++) {
+				if (*c == '"' || *c == '\\') escaped += '\\';
+				if ((unsigned char)*c < 0x20) continue;
+				escaped += *c;
+			}
+			return escaped;
+		}
+
+		//gives every scope name it's own colour so the same scope is easy to spot between frames
+		ImU32 NameColor(const char* name)
+		{
+			uint32_t hash = 2166136261u;
+			for (const char* c = name; *c != '\0'; c++) hash = (hash ^ (uint8_t)*c) * 16777619u;
+			return ImColor::HSV((float)(hash % 360) / 360.0f, 0.5f, 0.75f);
+		}
+
+		//draws a box for a scope with it's name clipped inside it, and a tooltip when it's hovered
+		void DrawScopeBox(ImDrawList* drawList, ImVec2 min, ImVec2 max, const char* name, uint64_t duration, bool hovered)
+		{
+			drawList->AddRectFilled(min, max, NameColor(name));
+			drawList->AddRect(min, max, IM_COL32(0, 0, 0, 128));
+			if (max.x - min.x > 8.0f) {
+				drawList->PushClipRect(min, max, true);
+				drawList->AddText(ImVec2(min.x + 2.0f, min.y), IM_COL32(0, 0, 0, 255), name);
+				drawList->PopClipRect();
+			}
+
+			ImVec2 mouse = ImGui::GetMousePos();
+			if (hovered && mouse.x >= min.x && mouse.x < max.x && mouse.y >= min.y && mouse.y < max.y)
+				ImGui::SetTooltip("%s: %.3f ms", name, (double)duration / 1000000.0);
+		}
+
+		//draws a flame graph node and it's children
+		void DrawFlameNode(ImDrawList* drawList, const std::vector<TTN_FlameNode>& nodes, int index, float x, ImVec2 origin, float scale,
+			float rowHeight, bool hovered)
+		{
+			const TTN_FlameNode& node = nodes[index];
+			ImVec2 min = ImVec2(x, origin.y + node.Depth * rowHeight);
+			ImVec2 max = ImVec2(x + std::max((float)node.Total * scale, 1.0f), min.y + rowHeight - 1.0f);
+			DrawScopeBox(drawList, min, max, node.Name, node.Total, hovered);
+
+			//the children sit under their parent, one after another
+			for (int child : node.Children) {
+				DrawFlameNode(drawList, nodes, child, x, origin, scale, rowHeight, hovered);
+				x += (float)nodes[child].Total * scale;
+			}
+		}
+	}
+
+	//gets the time since the profiler started
+	uint64_t TTN_Profiler::Now()
+	{
+		return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_epoch).count();
+	}
+
+	//starts a new frame
+	void TTN_Profiler::BeginFrame()
+	{
+		s_currentFrame.Index = s_frameCount;
+		s_currentFrame.Start = Now();
+		s_currentFrame.Events.clear();
+		s_mainTrack = GetThreadRing()->Track;
+
+		//save where the gpu's clock is compared to the cpu's so this frame's gpu scopes can be put on the same timeline
+		if (GetEnabled() && s_gpuTiming) {
+			GLint64 gpuNow = 0;
+			glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+			s_gpuFrameGpuBase = gpuNow;
+			s_gpuFrameCpuBase = Now();
+		}
+	}
+
+	//ends the frame
+	void TTN_Profiler::EndFrame()
+	{
+		s_currentFrame.End = Now();
+
+		//empty every thread's ring, even when paused so they don't fill up
+		{
+			std::lock_guard<std::mutex> guard(s_ringLock);
+			for (auto& ring : s_rings) {
+				size_t tail = ring->Tail.load(std::memory_order_relaxed);
+				size_t head = ring->Head.load(std::memory_order_acquire);
+				for (; tail != head; tail++) {
+					if (!s_paused) s_currentFrame.Events.push_back(ring->Events[tail % s_ringSize]);
+				}
+				ring->Tail.store(tail, std::memory_order_release);
+			}
+		}
+
+		//add the frame to the history
+		if (!s_paused) {
+			s_frames.push_back(std::move(s_currentFrame));
+			if (s_frames.size() > s_historySize) s_frames.pop_front();
+		}
+		s_currentFrame = TTN_ProfileFrame();
+
+		//and pick up any gpu scopes from earlier frames that have finished
+		ReadGPUEvents();
+		s_frameCount++;
+	}
+
+	//names the calling thread
+	void TTN_Profiler::SetThreadName(const std::string& name)
+	{
+		TTN_ProfileRing* ring = GetThreadRing();
+		std::lock_guard<std::mutex> guard(s_ringLock);
+		ring->Name = name;
+	}
+
+	//records a finished cpu scope
+	void TTN_Profiler::RecordEvent(const char* name, uint64_t start, uint64_t end, uint32_t depth)
+	{
+		TTN_ProfileRing* ring = GetThreadRing();
+
+		//if the main thread hasn't emptied the ring yet, drop the scope rather than waiting
+		size_t head = ring->Head.load(std::memory_order_relaxed);
+		if (head - ring->Tail.load(std::memory_order_acquire) >= s_ringSize) {
+			s_dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		TTN_ProfileEvent& event = ring->Events[head % s_ringSize];
+		event.Name = name;
+		event.Start = start;
+		event.End = end;
+		event.Depth = depth;
+		event.Track = ring->Track;
+		ring->Head.store(head + 1, std::memory_order_release);
+	}
+
+	//gets the calling thread's ring
+	TTN_Profiler::TTN_ProfileRing* TTN_Profiler::GetThreadRing()
+	{
+		//the lock is only taken the first time a thread records something
+		if (t_ring == nullptr) {
+			std::lock_guard<std::mutex> guard(s_ringLock);
+			s_rings.push_back(std::make_unique<TTN_ProfileRing>());
+			t_ring = s_rings.back().get();
+			t_ring->Track = (uint32_t)(s_rings.size() - 1);
+			t_ring->Name = "Thread " + std::to_string(t_ring->Track);
+		}
+
+		return t_ring;
+	}
+
+	//starts a gpu scope
+	int TTN_Profiler::BeginGPUEvent(const char* name)
+	{
+		if (!GetEnabled() || !s_gpuTiming) return -1;
+
+		TTN_GPUEvent event;
+		event.Name = name;
+		event.Depth = s_gpuDepth++;
+		event.Frame = s_currentFrame.Index;
+		event.CpuBase = s_gpuFrameCpuBase;
+		event.GpuBase = s_gpuFrameGpuBase;
+
+		//reuse queries from finished scopes where possible
+		GLuint queries[2];
+		for (int i = 0; i < 2; i++) {
+			if (s_freeQueries.empty()) glGenQueries(1, &queries[i]);
+			else {
+				queries[i] = s_freeQueries.back();
+				s_freeQueries.pop_back();
+			}
+		}
+		event.StartQuery = queries[0];
+		event.EndQuery = queries[1];
+
+		//timestamps rather than elapsed time queries, as elapsed time queries can't be nested
+		glQueryCounter(event.StartQuery, GL_TIMESTAMP);
+		s_gpuEvents.push_back(event);
+		return (int)s_gpuEvents.size() - 1;
+	}
+
+	//ends a gpu scope
+	void TTN_Profiler::EndGPUEvent(int event)
+	{
+		if (event < 0) return;
+
+		s_gpuDepth--;
+		glQueryCounter(s_gpuEvents[event].EndQuery, GL_TIMESTAMP);
+	}
+
+	//moves finished gpu scopes into their frames
+	void TTN_Profiler::ReadGPUEvents()
+	{
+		//queries finish in order, so stop at the first one that isn't ready rather than waiting on it
+		while (!s_gpuEvents.empty()) {
+			TTN_GPUEvent& event = s_gpuEvents.front();
+			GLint available = 0;
+			glGetQueryObjectiv(event.EndQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+			if (!available) break;
+
+			GLuint64 start = 0, end = 0;
+			glGetQueryObjectui64v(event.StartQuery, GL_QUERY_RESULT, &start);
+			glGetQueryObjectui64v(event.EndQuery, GL_QUERY_RESULT, &end);
+
+			//move it onto the cpu's clock and add it to it's frame, if the frame is still around
+			TTN_ProfileFrame* frame = FindFrame(event.Frame);
+			if (frame != nullptr) {
+				TTN_ProfileEvent gpuEvent;
+				gpuEvent.Name = event.Name;
+				gpuEvent.Start = (uint64_t)std::max((int64_t)event.CpuBase + ((int64_t)start - event.GpuBase), (int64_t)0);
+				gpuEvent.End = gpuEvent.Start + (end - start);
+				gpuEvent.Depth = event.Depth;
+				gpuEvent.Track = s_gpuTrack;
+				frame->Events.push_back(gpuEvent);
+			}
+
+			s_freeQueries.push_back(event.StartQuery);
+			s_freeQueries.push_back(event.EndQuery);
+			s_gpuEvents.pop_front();
+		}
+	}
+
+	//finds a frame in the history
+	TTN_ProfileFrame* TTN_Profiler::FindFrame(uint64_t index)
+	{
+		//the frame is almost always one of the newest, so search from the back
+		for (auto frame = s_frames.rbegin(); frame != s_frames.rend(); frame++) {
+			if (frame->Index == index) return &(*frame);
+			if (frame->Index < index) break;
+		}
+		return nullptr;
+	}
+
+	//gets the name shown for a track
+	std::string TTN_Profiler::GetTrackName(uint32_t track)
+	{
+		if (track == s_gpuTrack) return "GPU";
+
+		std::lock_guard<std::mutex> guard(s_ringLock);
+		return (track < s_rings.size()) ? s_rings[track]->Name : "Thread " + std::to_string(track);
+	}
+
+	//writes the history as a chrome trace
+	bool TTN_Profiler::ExportChromeTrace(const std::string& path)
+	{
+		std::ofstream file(path);
+		if (!file.is_open()) {
+			LOG_ERROR("Could not open {} to write the profiler trace", path);
+			return false;
+		}
+
+		//chrome traces need integer thread ids, so the gpu goes after the last thread
+		uint32_t gpuTid;
+		{
+			std::lock_guard<std::mutex> guard(s_ringLock);
+			gpuTid = (uint32_t)s_rings.size();
+		}
+
+		char buffer[512];
+		file << "{\"traceEvents\":[\n";
+		bool first = true;
+		auto writeLine = [&](const char* line) {
+			if (!first) file << ",\n";
+			file << line;
+			first = false;
+		};
+
+		//name the tracks
+		for (uint32_t track = 0; track <= gpuTid; track++) {
+			std::string name = EscapeJson(GetTrackName((track == gpuTid) ? s_gpuTrack : track).c_str());
+			snprintf(buffer, sizeof(buffer), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+				track, name.c_str());
+			writeLine(buffer);
+		}
+
+		//then every frame and it's scopes, times are in microseconds
+		for (const TTN_ProfileFrame& frame : s_frames) {
+			snprintf(buffer, sizeof(buffer), "{\"name\":\"Frame\",\"cat\":\"frame\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"index\":%llu}}",
+				frame.Start / 1000.0, (frame.End - frame.Start) / 1000.0, s_mainTrack, (unsigned long long)frame.Index);
+			writeLine(buffer);
+
+			for (const TTN_ProfileEvent& event : frame.Events) {
+				std::string name = EscapeJson(event.Name);
+				snprintf(buffer, sizeof(buffer), "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+					name.c_str(), (event.Track == s_gpuTrack) ? "gpu" : "cpu", event.Start / 1000.0, (event.End - event.Start) / 1000.0,
+					(event.Track == s_gpuTrack) ? gpuTid : event.Track);
+				writeLine(buffer);
+			}
+		}
+		file << "\n]}\n";
+
+		LOG_INFO("Wrote {} profiled frames to {}", s_frames.size(), path);
+		return true;
+	}
+
+	//draws the profiler window
+	void TTN_Profiler::DrawImGui(bool* open)
+	{
+		if (!ImGui::Begin("Profiler", open)) {
+			ImGui::End();
+			return;
+		}
+
+		//controls
+		bool enabled = GetEnabled();
+		if (ImGui::Checkbox("Enabled", &enabled)) SetEnabled(enabled);
+		ImGui::SameLine();
+		if (ImGui::Checkbox("Pause", &s_paused) && !s_paused) s_selectedFrame = -1;
+		ImGui::SameLine();
+		ImGui::Text("Dropped scopes: %d", (int)GetDroppedCount());
+
+		ImGui::InputText("Trace File", s_exportPath, sizeof(s_exportPath));
+		ImGui::SameLine();
+		if (ImGui::Button("Export Chrome Trace")) ExportChromeTrace(s_exportPath);
+
+		if (s_frames.empty()) {
+			ImGui::Text("No frames recorded yet");
+			ImGui::End();
+			return;
+		}
+
+		//frame times, clicking one pauses on it
+		std::vector<float> frameTimes(s_frames.size());
+		float longest = 0.0f;
+		for (size_t i = 0; i < s_frames.size(); i++) {
+			frameTimes[i] = (float)(s_frames[i].End - s_frames[i].Start) / 1000000.0f;
+			longest = std::max(longest, frameTimes[i]);
+		}
+		float width = ImGui::GetContentRegionAvail().x;
+		ImGui::PlotHistogram("##FrameTimes", frameTimes.data(), (int)frameTimes.size(), 0, "Frame times (ms)", 0.0f, longest * 1.1f, ImVec2(width, 60.0f));
+		if (ImGui::IsItemHovered() && ImGui::IsMouseClicked(0)) {
+			float along = (ImGui::GetMousePos().x - ImGui::GetItemRectMin().x) / std::max(ImGui::GetItemRectSize().x, 1.0f);
+			s_selectedFrame = std::clamp((int)(along * frameTimes.size()), 0, (int)frameTimes.size() - 1);
+			s_paused = true;
+		}
+		if (s_paused) {
+			if (s_selectedFrame < 0) s_selectedFrame = (int)s_frames.size() - 1;
+			ImGui::SliderInt("Frame", &s_selectedFrame, 0, (int)s_frames.size() - 1);
+		}
+
+		const TTN_ProfileFrame& frame = s_frames[(s_selectedFrame < 0) ? s_frames.size() - 1 : std::min((size_t)s_selectedFrame, s_frames.size() - 1)];
+		ImGui::Text("Frame %llu: %.3f ms", (unsigned long long)frame.Index, (double)(frame.End - frame.Start) / 1000000.0);
+
+		//the tracks in the frame, the gpu is always last
+		std::vector<uint32_t> tracks;
+		for (const TTN_ProfileEvent& event : frame.Events) {
+			if (std::find(tracks.begin(), tracks.end(), event.Track) == tracks.end()) tracks.push_back(event.Track);
+		}
+		std::sort(tracks.begin(), tracks.end());
+
+		float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+		ImDrawList* drawList = ImGui::GetWindowDrawList();
+
+		//every scope on it's thread, at the time it ran
+		if (ImGui::CollapsingHeader("Timeline", ImGuiTreeNodeFlags_DefaultOpen)) {
+			//gpu scopes can finish after the frame does, so stretch the timeline to fit them
+			uint64_t start = frame.Start, end = frame.End;
+			for (const TTN_ProfileEvent& event : frame.Events) {
+				start = std::min(start, event.Start);
+				end = std::max(end, event.End);
+			}
+			float scale = width / (float)std::max(end - start, (uint64_t)1);
+
+			for (uint32_t track : tracks) {
+				ImGui::Text("%s", GetTrackName(track).c_str());
+
+				uint32_t maxDepth = 0;
+				for (const TTN_ProfileEvent& event : frame.Events)
+					if (event.Track == track) maxDepth = std::max(maxDepth, event.Depth);
+
+				ImVec2 origin = ImGui::GetCursorScreenPos();
+				ImGui::PushID((int)track);
+				ImGui::InvisibleButton("##Track", ImVec2(width, (maxDepth + 1) * rowHeight));
+				bool hovered = ImGui::IsItemHovered();
+				ImGui::PopID();
+
+				for (const TTN_ProfileEvent& event : frame.Events) {
+					if (event.Track != track) continue;
+					ImVec2 min = ImVec2(origin.x + (float)(event.Start - start) * scale, origin.y + event.Depth * rowHeight);
+					ImVec2 max = ImVec2(std::max(origin.x + (float)(event.End - start) * scale, min.x + 1.0f), min.y + rowHeight - 1.0f);
+					DrawScopeBox(drawList, min, max, event.Name, event.End - event.Start, hovered);
+				}
+			}
+		}
+
+		//every call of the same scope with the same parents merged together, so the expensive paths stand out
+		if (ImGui::CollapsingHeader("Flame Graph", ImGuiTreeNodeFlags_DefaultOpen)) {
+			for (uint32_t track : tracks) {
+				//the events in the order they started, parents before their children
+				std::vector<const TTN_ProfileEvent*> events;
+				for (const TTN_ProfileEvent& event : frame.Events)
+					if (event.Track == track) events.push_back(&event);
+				std::sort(events.begin(), events.end(), [](const TTN_ProfileEvent* a, const TTN_ProfileEvent* b) {
+					return (a->Start != b->Start) ? a->Start < b->Start : a->Depth < b->Depth;
+				});
+
+				//node 0 is the root holding the top level scopes
+				std::vector<TTN_FlameNode> nodes = { TTN_FlameNode{ "", 0, 0, {} } };
+				struct Open { const TTN_ProfileEvent* Event; int Node; };
+				std::vector<Open> stack;
+				uint32_t maxDepth = 0;
+				for (const TTN_ProfileEvent* event : events) {
+					//close any scope this one isn't inside of
+					while (!stack.empty() && (stack.back().Event->End <= event->Start || stack.back().Event->Depth >= event->Depth))
+						stack.pop_back();
+					int parent = stack.empty() ? 0 : stack.back().Node;
+
+					//merge it with a sibling of the same name if there is one
+					int node = -1;
+					for (int child : nodes[parent].Children) {
+						if (strcmp(nodes[child].Name, event->Name) == 0) {
+							node = child;
+							break;
+						}
+					}
+					if (node == -1) {
+						node = (int)nodes.size();
+						uint32_t depth = stack.empty() ? 0 : nodes[parent].Depth + 1;
+						nodes.push_back(TTN_FlameNode{ event->Name, 0, depth, {} });
+						nodes[parent].Children.push_back(node);
+						maxDepth = std::max(maxDepth, depth);
+					}
+					nodes[node].Total += event->End - event->Start;
+					if (parent == 0) nodes[0].Total += event->End - event->Start;
+					stack.push_back(Open{ event, node });
+				}
+
+				ImGui::Text("%s", GetTrackName(track).c_str());
+				ImVec2 origin = ImGui::GetCursorScreenPos();
+				ImGui::PushID((int)track);
+				ImGui::InvisibleButton("##Flame", ImVec2(width, (maxDepth + 1) * rowHeight));
+				bool hovered = ImGui::IsItemHovered();
+				ImGui::PopID();
+
+				//the whole width is the frame, or everything on the track if that took longer
+				float scale = width / (float)std::max(std::max(frame.End - frame.Start, nodes[0].Total), (uint64_t)1);
+				float x = origin.x;
+				for (int child : nodes[0].Children) {
+					DrawFlameNode(drawList, nodes, child, x, origin, scale, rowHeight, hovered);
+					x += (float)nodes[child].Total * scale;
+				}
+			}
+		}
+
+		//totals for each scope name
+		if (ImGui::CollapsingHeader("Scopes")) {
+			struct Totals { int Calls = 0; uint64_t Time = 0; };
+			std::unordered_map<std::string, Totals> totals;
+			for (const TTN_ProfileEvent& event : frame.Events) {
+				std::string name = (event.Track == s_gpuTrack) ? std::string("[GPU] ") + event.Name : event.Name;
+				totals[name].Calls++;
+				totals[name].Time += event.End - event.Start;
+			}
+			std::vector<std::pair<std::string, Totals>> sorted(totals.begin(), totals.end());
+			std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.second.Time > b.second.Time; });
+
+			ImGui::Columns(3, "##ScopeTotals");
+			ImGui::Text("Scope"); ImGui::NextColumn();
+			ImGui::Text("Calls"); ImGui::NextColumn();
+			ImGui::Text("Total (ms)"); ImGui::NextColumn();
+			ImGui::Separator();
+			for (const auto& scope : sorted) {
+				ImGui::Text("%s", scope.first.c_str()); ImGui::NextColumn();
+				ImGui::Text("%d", scope.second.Calls); ImGui::NextColumn();
+				ImGui::Text("%.3f", (double)scope.second.Time / 1000000.0); ImGui::NextColumn();
+			}
+			ImGui::Columns(1);
+		}
+
+		ImGui::End();
+	}
+}
@@ -1,7 +1,7 @@
 //Titan Engine, by Atlas X Games 
 // Random.cpp - source file for the class that gives static templates for random number generation
 
-//precompile header, this file uses stdio.h, stdlib.h, and time.h
+//precompile header, this file uses stdlib.h and random
 #include "Titan/ttn_pch.h"
 //include the header
 #include "Titan/Random.h"
@@ -10,13 +10,8 @@ namespace Titan {
 	//generates a pseudo-random integer between a min and max value
 	int TTN_Random::RandomInt(int min, int max)
 	{
-		if (firstCall) {
-			srand(time(NULL));
-			firstCall = false;
-		}
-		
 		//generate number
-		int randomInt = rand() % (max - min + 1) + min;
+		int randomInt = (int)(s_engine() % (uint32_t)(max - min + 1)) + min;
 		//return number
 		return randomInt;
 	}
@@ -24,12 +19,7 @@ namespace Titan {
 	//generates a pseudo-random float between a min and max value
 	float TTN_Random::RandomFloat(float min, float max)
 	{
-		if (firstCall) {
-			srand(time(NULL));
-			firstCall = false;
-		}
-
-		float randomFloat = (float)(rand()) / (float)(RAND_MAX);
+		float randomFloat = (float)((double)s_engine() / (double)std::mt19937::max());
 
 		//convert to range
 		float floatInRange = (randomFloat * (max - min)) + min;
@@ -38,4 +28,12 @@ namespace Titan {
 		//return converted number
 		return floatInRange;
 	}
-}
\ No newline at end of file
+
+	//seeds the generator
+	void TTN_Random::SetSeed(uint32_t seed)
+	{
+		s_seed = seed;
+		s_engine.seed(seed);
+		srand(seed);
+	}
+}
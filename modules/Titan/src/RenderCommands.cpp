@@ -0,0 +1,35 @@
+//Titan Engine, by Atlas X Games
+// RenderCommands.cpp - source file for the list of draws a scene records before they're submitted to openGL
+
+//precompile header, this file uses vector
+#include "Titan/ttn_pch.h"
+//include the header
+#include "Titan/RenderCommands.h"
+
+namespace Titan {
+	//starts a new recording
+	void TTN_RenderCommandList::Begin(const TTN_RenderView& view)
+	{
+		m_view = view;
+		//clearing keeps the capacity, so after the first few frames recording never allocates
+		m_draws.clear();
+		m_meshes.clear();
+		m_shaders.clear();
+		m_materials.clear();
+	}
+
+	//adds a packet
+	TTN_DrawPacket& TTN_RenderCommandList::AddDraw(const TTN_Mesh::smptr& mesh, const TTN_Shader::sshptr& shader, const TTN_Material::smatptr& material)
+	{
+		//only add to the tables when it's different from the last packet's
+		if (m_meshes.empty() || m_meshes.back() != mesh) m_meshes.push_back(mesh);
+		if (m_shaders.empty() || m_shaders.back() != shader) m_shaders.push_back(shader);
+		if (m_materials.empty() || m_materials.back() != material) m_materials.push_back(material);
+
+		TTN_DrawPacket& packet = m_draws.emplace_back();
+		packet.Mesh = (uint32_t)m_meshes.size() - 1;
+		packet.Shader = (uint32_t)m_shaders.size() - 1;
+		packet.Material = (uint32_t)m_materials.size() - 1;
+		return packet;
+	}
+}
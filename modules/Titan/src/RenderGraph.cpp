@@ -0,0 +1,181 @@
+//Titan Engine by Atlas X Games
+//RenderGraph.cpp - Source file for the classes that schedule full screen passes and share the render targets between them
+
+//include the precompile header, this file uses functional and unordered_map
+#include "Titan/ttn_pch.h"
+//include the header
+#include "Titan/RenderGraph.h"
+
+namespace Titan {
+	//gets a free target of the given size and format
+	TTN_Framebuffer::sfboptr TTN_RenderTargetPool::Acquire(unsigned width, unsigned height, GLenum format)
+	{
+		//look for a free target that's big enough, it just gets resized in place to the size that's needed
+		for (auto& pooled : s_targets) {
+			glm::uvec2 allocated = pooled.target->GetAllocatedSize();
+			if (!pooled.inUse && pooled.format == format && allocated.x >= width && allocated.y >= height) {
+				pooled.inUse = true;
+				pooled.target->Reshape(width, height);
+				return pooled.target;
+			}
+		}
+
+		//if there wasn't one make a new one, full screen passes never need depth so it only gets a colour target
+		TTN_PooledTarget newTarget;
+		newTarget.target = TTN_Framebuffer::Create();
+		newTarget.target->AddColorTarget(format);
+		newTarget.target->SetFilter(GL_LINEAR);
+		newTarget.target->Init(width, height);
+		newTarget.format = format;
+		newTarget.inUse = true;
+		s_targets.push_back(newTarget);
+
+		return newTarget.target;
+	}
+
+	//gives a target back to the pool
+	void TTN_RenderTargetPool::Release(const TTN_Framebuffer::sfboptr& target)
+	{
+		for (auto& pooled : s_targets) {
+			if (pooled.target == target) {
+				pooled.inUse = false;
+				return;
+			}
+		}
+	}
+
+	//deletes all the targets that aren't in use
+	void TTN_RenderTargetPool::Trim()
+	{
+		s_targets.erase(std::remove_if(s_targets.begin(), s_targets.end(), [](const TTN_PooledTarget& pooled) {
+			return !pooled.inUse;
+		}), s_targets.end());
+	}
+
+	//deletes every target in the pool
+	void TTN_RenderTargetPool::Clear()
+	{
+		s_targets.clear();
+	}
+
+	//gets the number of targets in use
+	size_t TTN_RenderTargetPool::GetActiveCount()
+	{
+		size_t count = 0;
+		for (auto& pooled : s_targets) {
+			if (pooled.inUse) count++;
+		}
+		return count;
+	}
+
+	//adds a target from outside the graph
+	void TTN_RenderGraph::ImportTarget(const std::string& name, const TTN_Framebuffer::sfboptr& target)
+	{
+		m_imported[name] = target;
+	}
+
+	//adds a pass
+	void TTN_RenderGraph::AddPass(const std::string& name, const std::vector<std::string>& inputs, const std::string& output,
+		PassFunction function, bool clearOutput, GLenum format)
+	{
+		TTN_RenderPass pass;
+		pass.name = name;
+		pass.inputs = inputs;
+		pass.output = output;
+		pass.function = function;
+		pass.clearOutput = clearOutput;
+		pass.format = format;
+		m_passes.push_back(pass);
+	}
+
+	//culls, runs the passes, and returns the result
+	TTN_Framebuffer::sfboptr TTN_RenderGraph::Execute(const std::string& result, unsigned width, unsigned height)
+	{
+		m_executedPasses = 0;
+
+		//walk backwards from the result marking every pass it depends on, anything left unmarked gets culled
+		std::vector<bool> keep = std::vector<bool>(m_passes.size(), false);
+		std::unordered_map<std::string, bool> needed;
+		needed[result] = true;
+		for (int i = (int)m_passes.size() - 1; i >= 0; i--) {
+			if (needed.find(m_passes[i].output) != needed.end()) {
+				keep[i] = true;
+				for (auto& input : m_passes[i].inputs)
+					needed[input] = true;
+			}
+		}
+
+		//find the last pass that reads each target, the target can go back to the pool once that pass is done
+		std::unordered_map<std::string, size_t> lastUse;
+		for (size_t i = 0; i < m_passes.size(); i++) {
+			if (!keep[i]) continue;
+			for (auto& input : m_passes[i].inputs)
+				lastUse[input] = i;
+		}
+
+		//the targets the graph has borrowed from the pool, by name
+		std::unordered_map<std::string, TTN_Framebuffer::sfboptr> transient;
+		//finds a target by name, whether it was imported or borrowed
+		auto findTarget = [&](const std::string& name) -> TTN_Framebuffer::sfboptr {
+			auto imported = m_imported.find(name);
+			if (imported != m_imported.end()) return imported->second;
+			auto borrowed = transient.find(name);
+			if (borrowed != transient.end()) return borrowed->second;
+			return nullptr;
+		};
+
+		//full screen passes overwrite every pixel, so turn blending off so they don't depend on what was in the target before
+		glDisable(GL_BLEND);
+
+		//run the passes
+		for (size_t i = 0; i < m_passes.size(); i++) {
+			if (!keep[i]) continue;
+			TTN_RenderPass& pass = m_passes[i];
+
+			//get the input targets
+			std::vector<TTN_Framebuffer::sfboptr> inputs;
+			for (auto& input : pass.inputs)
+				inputs.push_back(findTarget(input));
+
+			//get the output target, borrowing one from the pool if it isn't imported
+			TTN_Framebuffer::sfboptr output = findTarget(pass.output);
+			if (output == nullptr) {
+				output = TTN_RenderTargetPool::Acquire(width, height, pass.format);
+				transient[pass.output] = output;
+			}
+
+			//only clear if the pass won't write over everything anyways
+			if (pass.clearOutput) output->Clear();
+
+			//run the pass
+			pass.function(inputs, output);
+			m_executedPasses++;
+
+			//give back any borrowed inputs nothing else reads, the result is always kept until the end
+			for (auto& input : pass.inputs) {
+				auto borrowed = transient.find(input);
+				if (borrowed != transient.end() && lastUse[input] == i && input != result) {
+					TTN_RenderTargetPool::Release(borrowed->second);
+					transient.erase(borrowed);
+				}
+			}
+		}
+
+		//turn blending back on, the engine always draws with it on (it's turned on when the application starts), so it isn't queried
+		glEnable(GL_BLEND);
+
+		//get the result, and give everything back to the pool, the caller only reads it before the next graph borrows anything
+		TTN_Framebuffer::sfboptr resultTarget = findTarget(result);
+		for (auto& borrowed : transient)
+			TTN_RenderTargetPool::Release(borrowed.second);
+
+		return resultTarget;
+	}
+
+	//removes all the passes and imported targets
+	void TTN_RenderGraph::Reset()
+	{
+		m_passes.clear();
+		m_imported.clear();
+	}
+}
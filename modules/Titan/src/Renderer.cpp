@@ -50,6 +50,8 @@ namespace Titan {
 	void TTN_Renderer::SetMesh(TTN_Mesh::smptr mesh)
 	{
 		m_mesh = mesh;
+		//start at full detail, the new mesh might not have as many levels
+		m_lodLevel = 0;
 	}
 
 	//sets a shader
@@ -70,26 +72,49 @@ namespace Titan {
 		m_RenderLayer = renderLayer;
 	}
 
+	//picks the level of detail
+	void TTN_Renderer::UpdateLOD(float screenSize)
+	{
+		if (m_mesh == nullptr) return;
+		int levels = m_mesh->GetLODCount();
+
+		//step to coarser levels while the object is clearly smaller than the next level's size
+		while (m_lodLevel + 1 < levels && screenSize < m_mesh->GetLODScreenSize(m_lodLevel + 1) * (1.0f - s_lodHysteresis))
+			m_lodLevel++;
+		//and to finer levels while it's clearly bigger than the current level's size
+		while (m_lodLevel > 0 && screenSize > m_mesh->GetLODScreenSize(m_lodLevel) * (1.0f + s_lodHysteresis))
+			m_lodLevel--;
+		//in case the mesh lost levels
+		m_lodLevel = std::min(m_lodLevel, levels - 1);
+	}
+
 	//function that will send the uniforms with how to draw the object arounding to the camera to openGL
 	void TTN_Renderer::Render(glm::mat4 model, glm::mat4 VP)
+	{
+		//draw the level of detail being drawn with this renderer's shader
+		Render(GetActiveMesh().get(), m_Shader.get(), model, VP);
+	}
+
+	//draws a mesh with a shader
+	void TTN_Renderer::Render(TTN_Mesh* mesh, TTN_Shader* shader, const glm::mat4& model, const glm::mat4& VP)
 	{
 		//make sure the vao is acutally set up before continuing
-		if (m_mesh->GetVAOPointer() == nullptr)
+		if (mesh->GetVAOPointer() == nullptr)
 			//if it isn't, then stop then return so the later code doesn't break the entire program
 			return;
 
 		//bind the shader this model uses
-		m_Shader->Bind();
+		shader->Bind();
 		//send the uniforms to openGL 
-		if (m_Shader->GetVertexShaderDefaultStatus() != (int)TTN_DefaultShaders::VERT_SKYBOX && 
-			m_Shader->GetVertexShaderDefaultStatus() != (int)TTN_DefaultShaders::NOT_DEFAULT) {
-			m_Shader->SetUniformMatrix("MVP", VP * model);
-			m_Shader->SetUniformMatrix("Model", model);
-			m_Shader->SetUniformMatrix("NormalMat", glm::mat3(glm::transpose(glm::inverse(model))));
+		if (shader->GetVertexShaderDefaultStatus() != (int)TTN_DefaultShaders::VERT_SKYBOX && 
+			shader->GetVertexShaderDefaultStatus() != (int)TTN_DefaultShaders::NOT_DEFAULT) {
+			shader->SetUniformMatrix("MVP", VP * model);
+			shader->SetUniformMatrix("Model", model);
+			shader->SetUniformMatrix("NormalMat", glm::mat3(glm::transpose(glm::inverse(model))));
 		}
 		//render the VAO
-		m_mesh->GetVAOPointer()->Render();
+		mesh->GetVAOPointer()->Render();
 		//unbind the shader
-		m_Shader->UnBind();
+		shader->UnBind();
 	}
 }
\ No newline at end of file
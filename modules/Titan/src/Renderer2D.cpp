@@ -5,6 +5,8 @@
 #include "Titan/ttn_pch.h"
 //include the header
 #include "Titan/Renderer2D.h"
+//include the sprite batcher
+#include "Titan/SpriteBatcher.h"
 
 namespace Titan {
 	//default constructor
@@ -31,6 +33,8 @@ namespace Titan {
 			//send the uniforms to openGL 
 			s_shader->SetUniformMatrix("MVP", VP * model);
 			s_shader->SetUniform("u_Color", m_color);
+			//the part of the texture the sprite covers, all of it unless it's an atlas region
+			s_shader->SetUniform("u_UvRect", m_sprite->GetUVRect());
 
 			//bind the texture
 			m_sprite->Bind(0);
@@ -79,6 +83,9 @@ namespace Titan {
 		s_shader->LoadShaderStageFromFile("shaders/ttn_sprite_vert.glsl", GL_VERTEX_SHADER);
 		s_shader->LoadShaderStageFromFile("shaders/ttn_sprite_frag.glsl", GL_FRAGMENT_SHADER);
 		s_shader->Link();
+
+		//and set up the batcher scenes draw their sprites through
+		TTN_SpriteBatcher::Init();
 	}
 
 }
\ No newline at end of file
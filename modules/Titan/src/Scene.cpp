@@ -6,6 +6,123 @@
 #include "Titan/Scene.h"
 
 namespace Titan {
+	//helpers for the spatial queries
+	namespace {
+		//policy for walking bullet's dbvt trees, collects the collision object of every leaf the walk reaches
+		struct TTN_DbvtCollector : btDbvt::ICollide {
+			std::vector<const btCollisionObject*> objects;
+
+			void Process(const btDbvtNode* leaf) {
+				btBroadphaseProxy* proxy = static_cast<btBroadphaseProxy*>(leaf->data);
+				objects.push_back(static_cast<const btCollisionObject*>(proxy->m_clientObject));
+			}
+		};
+
+		//gets the entity number bullet has stored on a collision object
+		entt::entity EntityFromObject(const btCollisionObject* object) {
+			return static_cast<entt::entity>(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(object->getUserPointer())));
+		}
+
+		//gets an oriented box that bounds a collision object, exact for box shapes and the world aabb for anything else
+		void GetObjectBox(const btCollisionObject* object, btTransform& trans, btVector3& halfExtents) {
+			const btCollisionShape* shape = object->getCollisionShape();
+			if (shape->getShapeType() == BOX_SHAPE_PROXYTYPE) {
+				trans = object->getWorldTransform();
+				halfExtents = static_cast<const btBoxShape*>(shape)->getHalfExtentsWithMargin();
+			}
+			else {
+				btVector3 min, max;
+				shape->getAabb(object->getWorldTransform(), min, max);
+				trans = btTransform(btMatrix3x3::getIdentity(), (min + max) * 0.5f);
+				halfExtents = (max - min) * 0.5f;
+			}
+		}
+
+		//tests a segment (in the box's local space) against a box, writes out the fraction along the segment and the local normal on a hit
+		bool SegmentVsBox(const btVector3& from, const btVector3& to, const btVector3& halfExtents, btScalar& fraction, btVector3& normal) {
+			btVector3 dir = to - from;
+			btScalar tMin = 0.0f, tMax = 1.0f;
+			normal = btVector3(0.0f, 0.0f, 0.0f);
+
+			//clip the segment against each pair of slabs
+			for (int i = 0; i < 3; i++) {
+				//if the segment is parallel to the slab it has to start inside it
+				if (btFabs(dir[i]) < SIMD_EPSILON) {
+					if (from[i] < -halfExtents[i] || from[i] > halfExtents[i]) return false;
+					continue;
+				}
+
+				btScalar invDir = 1.0f / dir[i];
+				btScalar t1 = (-halfExtents[i] - from[i]) * invDir;
+				btScalar t2 = (halfExtents[i] - from[i]) * invDir;
+				btScalar sign = -1.0f;
+				if (t1 > t2) {
+					std::swap(t1, t2);
+					sign = 1.0f;
+				}
+
+				//keep track of the face the segment entered through for the normal
+				if (t1 > tMin) {
+					tMin = t1;
+					normal = btVector3(0.0f, 0.0f, 0.0f);
+					normal[i] = sign;
+				}
+				if (t2 < tMax) tMax = t2;
+				if (tMin > tMax) return false;
+			}
+
+			fraction = tMin;
+			return true;
+		}
+
+		//tests a sphere against an oriented box
+		bool SphereVsBox(const btVector3& center, btScalar radius, const btTransform& trans, const btVector3& halfExtents) {
+			//move the sphere into the box's space and find the closest point on the box to it
+			btVector3 local = trans.invXform(center);
+			btVector3 closest = local;
+			closest.setMax(-halfExtents);
+			closest.setMin(halfExtents);
+			return (local - closest).length2() <= radius * radius;
+		}
+
+		//tests an axis aligned box against an oriented box using the separating axis theorem
+		bool AabbVsBox(const btVector3& center, const btVector3& a, const btTransform& trans, const btVector3& b) {
+			//the rotation of the box relative to the world axes, and the offset between their centers
+			const btMatrix3x3& R = trans.getBasis();
+			btVector3 t = trans.getOrigin() - center;
+			btScalar absR[3][3];
+			for (int i = 0; i < 3; i++)
+				for (int j = 0; j < 3; j++)
+					absR[i][j] = btFabs(R[i][j]) + SIMD_EPSILON;
+
+			//the world axes
+			for (int i = 0; i < 3; i++) {
+				btScalar rb = b[0] * absR[i][0] + b[1] * absR[i][1] + b[2] * absR[i][2];
+				if (btFabs(t[i]) > a[i] + rb) return false;
+			}
+			//the box's axes
+			for (int j = 0; j < 3; j++) {
+				btScalar ra = a[0] * absR[0][j] + a[1] * absR[1][j] + a[2] * absR[2][j];
+				btScalar dist = t[0] * R[0][j] + t[1] * R[1][j] + t[2] * R[2][j];
+				if (btFabs(dist) > ra + b[j]) return false;
+			}
+			//the cross products of the two sets of axes
+			for (int i = 0; i < 3; i++) {
+				int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+				for (int j = 0; j < 3; j++) {
+					int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+					btScalar ra = a[i1] * absR[i2][j] + a[i2] * absR[i1][j];
+					btScalar rb = b[j1] * absR[i][j2] + b[j2] * absR[i][j1];
+					btScalar dist = t[i2] * R[i1][j] - t[i1] * R[i2][j];
+					if (btFabs(dist) > ra + rb) return false;
+				}
+			}
+
+			//if no axis seperates them they overlap
+			return true;
+		}
+	}
+
 	//default constructor
 
 	TTN_Scene::TTN_Scene(std::string name)
@@ -14,7 +131,7 @@ namespace Titan {
 		//setup basic data and systems
 		m_ShouldRender = true;
 		m_Registry = new entt::registry();
-		m_RenderGroup = std::make_unique<RenderGroupType>(m_Registry->group<TTN_Transform, TTN_Renderer>());
+		m_RenderGroup = std::make_unique<RenderGroupType>(m_Registry->group<TTN_Transform, TTN_Renderer>(entt::exclude<TTN_Inactive>));
 		m_AmbientColor = glm::vec3(1.0f);
 		m_AmbientStrength = 1.0f;
 
@@ -32,10 +149,16 @@ namespace Titan {
 
 		m_Paused = false;
 
-		//init the basic effect
-		glm::ivec2 windowSize = TTN_Backend::GetWindowSize();
-		m_emptyEffect = TTN_PostEffect::Create();
-		m_emptyEffect->Init(windowSize.x, windowSize.y);
+		//init the target the scene renders into, this is the only post processing target with depth
+		//headless scenes never render, and there's no context to make it with
+		if (!TTN_Backend::GetHeadless()) {
+			glm::ivec2 windowSize = TTN_Backend::GetWindowSize();
+			m_sceneTarget = TTN_Framebuffer::Create();
+			m_sceneTarget->AddColorTarget(GL_RGBA8);
+			m_sceneTarget->AddDepthTarget();
+			m_sceneTarget->SetFilter(GL_LINEAR);
+			m_sceneTarget->Init(windowSize.x, windowSize.y);
+		}
 	}
 
 	//construct with lightning data
@@ -45,7 +168,7 @@ namespace Titan {
 		///setup basic data and systems
 		m_ShouldRender = true;
 		m_Registry = new entt::registry();
-		m_RenderGroup = std::make_unique<RenderGroupType>(m_Registry->group<TTN_Transform, TTN_Renderer>());
+		m_RenderGroup = std::make_unique<RenderGroupType>(m_Registry->group<TTN_Transform, TTN_Renderer>(entt::exclude<TTN_Inactive>));
 
 		//setting up physics world
 		collisionConfig = new btDefaultCollisionConfiguration(); //default collision config
@@ -61,10 +184,16 @@ namespace Titan {
 
 		m_Paused = false;
 
-		//init the basic effect
-		glm::ivec2 windowSize = TTN_Backend::GetWindowSize();
-		m_emptyEffect = TTN_PostEffect::Create();
-		m_emptyEffect->Init(windowSize.x, windowSize.y);
+		//init the target the scene renders into, this is the only post processing target with depth
+		//headless scenes never render, and there's no context to make it with
+		if (!TTN_Backend::GetHeadless()) {
+			glm::ivec2 windowSize = TTN_Backend::GetWindowSize();
+			m_sceneTarget = TTN_Framebuffer::Create();
+			m_sceneTarget->AddColorTarget(GL_RGBA8);
+			m_sceneTarget->AddDepthTarget();
+			m_sceneTarget->SetFilter(GL_LINEAR);
+			m_sceneTarget->Init(windowSize.x, windowSize.y);
+		}
 	}
 
 	//destructor
@@ -104,6 +233,35 @@ namespace Titan {
 		return entity;
 	}
 
+	//function to create a batch of entities from a prefab, returns their entity numbers
+	std::vector<entt::entity> TTN_Scene::Instantiate(const TTN_Prefab::sprefabptr& prefab, size_t count, const std::vector<TTN_Transform>& transforms)
+	{
+		//create all of the entities at once
+		std::vector<entt::entity> entities = std::vector<entt::entity>(count);
+		m_Registry->create(entities.begin(), entities.end());
+
+		//give them all the prefab's name
+		m_Registry->insert<TTN_Name>(entities.begin(), entities.end(), TTN_Name(prefab->GetName()));
+
+		//give them their transforms, the prefab's builders rely on them so they have to go first
+		if (transforms.size() == count)
+			m_Registry->insert<TTN_Transform>(entities.begin(), entities.end(), transforms.begin(), transforms.end());
+		else {
+			//if there's not one transform per instance, use the prefab's transform for all of them
+			if (!transforms.empty()) LOG_WARN("Instantiate was given {} transforms for {} instances, using the prefab's transform", transforms.size(), count);
+			m_Registry->insert<TTN_Transform>(entities.begin(), entities.end(), prefab->GetTransform());
+		}
+
+		//stamp the rest of the components on
+		prefab->Stamp(*m_Registry, entities);
+
+		//reconstruct scenegraph once as entt was shuffled
+		ReconstructScenegraph();
+
+		//return the entity ids
+		return entities;
+	}
+
 	//function to delete an entity
 	void TTN_Scene::DeleteEntity(entt::entity entity)
 	{
@@ -123,6 +281,131 @@ namespace Titan {
 		ReconstructScenegraph();
 	}
 
+	//function to queue an entity to be deleted at the end of the frame
+	void TTN_Scene::QueueDestroy(entt::entity entity)
+	{
+		m_DestroyQueue.push_back(entity);
+	}
+
+	//function to delete all of the queued entities in one go
+	void TTN_Scene::FlushDestroyQueue()
+	{
+		//if nothing is queued there's nothing to do
+		if (m_DestroyQueue.empty() && m_ActiveQueue.empty()) return;
+
+		//an entity might have been queued more than once, so sort the queue and get rid of any duplicates
+		std::sort(m_DestroyQueue.begin(), m_DestroyQueue.end());
+		m_DestroyQueue.erase(std::unique(m_DestroyQueue.begin(), m_DestroyQueue.end()), m_DestroyQueue.end());
+		//and get rid of anything that has already been deleted some other way
+		m_DestroyQueue.erase(std::remove_if(m_DestroyQueue.begin(), m_DestroyQueue.end(),
+			[&](entt::entity entity) { return !m_Registry->valid(entity); }), m_DestroyQueue.end());
+
+		//pooled entities go back to their pools instead of being deleted
+		m_DestroyQueue.erase(std::remove_if(m_DestroyQueue.begin(), m_DestroyQueue.end(), [&](entt::entity entity) {
+			if (!m_Registry->has<TTN_PooledEntity>(entity)) return false;
+			Get<TTN_PooledEntity>(entity).pool->Release(entity);
+			return true;
+		}), m_DestroyQueue.end());
+
+		//remove all of the bullet physics bodies in a single pass
+		for (auto entity : m_DestroyQueue) {
+			if (m_Registry->has<TTN_Physics>(entity)) {
+				btRigidBody* body = Get<TTN_Physics>(entity).GetRigidBody();
+				delete body->getMotionState();
+				delete body->getCollisionShape();
+				m_physicsWorld->removeRigidBody(body);
+				delete body;
+			}
+		}
+
+		//delete all of the entities from the registry at once
+		m_Registry->destroy(m_DestroyQueue.begin(), m_DestroyQueue.end());
+		m_DestroyQueue.clear();
+
+		//switch off everything that was just returned to a pool, along with anything else still queued
+		ApplyActiveQueue();
+
+		//and reconstruct the scenegraph only once as entt was shuffled
+		ReconstructScenegraph();
+	}
+
+	//function to queue an entity to be switched on or off
+	void TTN_Scene::QueueSetActive(entt::entity entity, bool active)
+	{
+		m_ActiveQueue.push_back(std::make_pair(entity, active));
+	}
+
+	//function to switch all the queued entities on or off
+	bool TTN_Scene::ApplyActiveQueue()
+	{
+		if (m_ActiveQueue.empty()) return false;
+		TTN_PROFILE_SCOPE("Scene::ApplyActiveQueue");
+
+		//they're applied in the order they were queued, so if an entity was queued more than once the last one wins
+		for (auto& queued : m_ActiveQueue) {
+			if (m_Registry->valid(queued.first))
+				SetActiveInternal(queued.first, queued.second);
+		}
+		m_ActiveQueue.clear();
+
+		return true;
+	}
+
+	//function to switch an entity on or off, switched off entities are skipped by all of the scene's systems
+	void TTN_Scene::SetActive(entt::entity entity, bool active)
+	{
+		SetActiveInternal(entity, active);
+
+		//reconstruct scenegraph as entt was shuffled
+		ReconstructScenegraph();
+	}
+
+	//function to switch a group of entities on or off
+	void TTN_Scene::SetActive(const std::vector<entt::entity>& entities, bool active)
+	{
+		for (auto entity : entities)
+			SetActiveInternal(entity, active);
+
+		//reconstruct scenegraph only once as entt was shuffled
+		ReconstructScenegraph();
+	}
+
+	//function to check if an entity is switched on
+	bool TTN_Scene::GetActive(entt::entity entity)
+	{
+		return !m_Registry->has<TTN_Inactive>(entity);
+	}
+
+	//switches an entity on or off without reconstructing the scenegraph
+	void TTN_Scene::SetActiveInternal(entt::entity entity, bool active)
+	{
+		//if it's already in that state there's nothing to do
+		if (GetActive(entity) == active) return;
+
+		if (active) {
+			//switch it back on, the update will add it's physics body back to the world
+			m_Registry->remove<TTN_Inactive>(entity);
+		}
+		else {
+			//switch it off
+			m_Registry->emplace<TTN_Inactive>(entity);
+
+			//take it's physics body out of the world but keep it allocated so it can be reused
+			if (m_Registry->has<TTN_Physics>(entity) && Get<TTN_Physics>(entity).GetIsInWorld()) {
+				m_physicsWorld->removeRigidBody(Get<TTN_Physics>(entity).GetRigidBody());
+				Get<TTN_Physics>(entity).SetIsInWorld(false);
+			}
+		}
+	}
+
+	//function to create a pool of entities from a prefab, the scene keeps track of it so it can be shown in debug tools
+	TTN_EntityPool::spoolptr TTN_Scene::CreatePool(TTN_Prefab::sprefabptr prefab, size_t initialSize)
+	{
+		TTN_EntityPool::spoolptr pool = TTN_EntityPool::Create(this, prefab, initialSize);
+		m_Pools.push_back(pool);
+		return pool;
+	}
+
 	//sets the underlying entt registry of the scene
 	void TTN_Scene::SetScene(entt::registry* reg)
 	{
@@ -155,6 +438,9 @@ namespace Titan {
 		delete dispatcher;
 		delete collisionConfig;
 
+		//get rid of the entity pools, their entities are about to be deleted with the registry
+		m_Pools.clear();
+
 		//delete registry
 		if (m_Registry != nullptr) {
 			delete m_Registry;
@@ -168,8 +454,9 @@ namespace Titan {
 		//reconstruct any scenegraph relationships
 		auto transView = m_Registry->view<TTN_Transform>();
 		for (auto entity : transView) {
-			//if it should have a parent
-			if (Get<TTN_Transform>(entity).GetParentEntity() != nullptr) {
+			//if it should have a parent that still exists
+			if (Get<TTN_Transform>(entity).GetParentEntity() != nullptr && m_Registry->valid(*Get<TTN_Transform>(entity).GetParentEntity()) &&
+				m_Registry->has<TTN_Transform>(*Get<TTN_Transform>(entity).GetParentEntity())) {
 				//then reatach that parent
 				Get<TTN_Transform>(entity).SetParent(&Get<TTN_Transform>(*Get<TTN_Transform>(entity).GetParentEntity()),
 					Get<TTN_Transform>(entity).GetParentEntity());
@@ -180,76 +467,305 @@ namespace Titan {
 	//update the scene, running physics simulation, animations, and particle systems
 	void TTN_Scene::Update(float deltaTime)
 	{
+		//let the resolution scale controller react to how long the last frame took
+		UpdateResolutionScale(deltaTime);
+
+		//switch on anything taken from a pool since the last update, reconstructing the scenegraph once for all of them
+		if (ApplyActiveQueue()) ReconstructScenegraph();
+
 		//only run the updates if the scene is not paused
 		if (!m_Paused) {
-			//call the step simulation for bullet
-			m_physicsWorld->stepSimulation(deltaTime);
-
-			//run through all of the physicsbody in the scene
-			auto physicsBodyView = m_Registry->view<TTN_Physics>();
-			for (auto entity : physicsBodyView) {
-				//if the physics body isn't in the world, add it
-				if (!Get<TTN_Physics>(entity).GetIsInWorld()) {
-					Get<TTN_Physics>(entity).SetEntity(entity);
-					m_physicsWorld->addRigidBody(Get<TTN_Physics>(entity).GetRigidBody());
-					Get<TTN_Physics>(entity).SetIsInWorld(true);
-				}
+			//build this frame's systems as a graph so the ones that don't share data can run at the same time on the job system
+			TTN_FrameGraph frameGraph;
+
+			//the systems' views are made here before any of them run, making a view adds the component's pool to the registry the first time it's seen
+			//which isn't safe while the other systems are reading the registry, like in a menu scene that's never had a physics body or animator
+			auto physicsBodyView = m_Registry->view<TTN_Physics>(entt::exclude<TTN_Inactive>);
+			auto transAndPhysicsView = m_Registry->view<TTN_Transform, TTN_Physics>(entt::exclude<TTN_Inactive>);
+			auto animatorView = m_Registry->view<TTN_MorphAnimator>(entt::exclude<TTN_Inactive>);
+			auto psView = m_Registry->view<TTN_ParticeSystemComponent>(entt::exclude<TTN_Inactive>);
+
+			//physics system, steps bullet and copies the results back into the transforms
+			frameGraph.AddSystem("physics", [this, deltaTime, physicsBodyView, transAndPhysicsView]() {
+				TTN_PROFILE_SCOPE("Physics");
+				//call the step simulation for bullet
+				m_physicsWorld->stepSimulation(deltaTime);
+
+				//run through all of the physicsbody in the scene
+				for (auto entity : physicsBodyView) {
+					//if the physics body isn't in the world, add it
+					if (!Get<TTN_Physics>(entity).GetIsInWorld()) {
+						Get<TTN_Physics>(entity).SetEntity(entity);
+						m_physicsWorld->addRigidBody(Get<TTN_Physics>(entity).GetRigidBody());
+						Get<TTN_Physics>(entity).SetIsInWorld(true);
+					}
 
-				//make sure the physics body are active on every frame
-				Get<TTN_Physics>(entity).GetRigidBody()->setActivationState(true);
+					//make sure the physics body are active on every frame
+					Get<TTN_Physics>(entity).GetRigidBody()->setActivationState(true);
 
-				//call the physics body's update
-				Get<TTN_Physics>(entity).Update(deltaTime);
-			}
+					//call the physics body's update
+					Get<TTN_Physics>(entity).Update(deltaTime);
+				}
 
-			//construct the collisions for the frame
-			ConstructCollisions();
+				//construct the collisions for the frame
+				ConstructCollisions();
 
-			//run through all of the entities with both a physics body and a transform in the scene
-			auto transAndPhysicsView = m_Registry->view<TTN_Transform, TTN_Physics>();
-			for (auto entity : transAndPhysicsView) {
-				if (!Get<TTN_Physics>(entity).GetIsStatic()) {
-					//copy the position of the physics body into the position of the transform
-					Get<TTN_Transform>(entity).SetPos(Get<TTN_Physics>(entity).GetTrans().GetPos());
+				//run through all of the entities with both a physics body and a transform in the scene
+				for (auto entity : transAndPhysicsView) {
+					if (!Get<TTN_Physics>(entity).GetIsStatic()) {
+						//copy the position of the physics body into the position of the transform
+						Get<TTN_Transform>(entity).SetPos(Get<TTN_Physics>(entity).GetTrans().GetPos());
+					}
 				}
-			}
-
-			//run through all the of entities with an animator and renderer in the scene and run it's update
-			auto manimatorRendererView = m_Registry->view<TTN_MorphAnimator>();
-			for (auto entity : manimatorRendererView) {
-				//update the active animation
-				Get<TTN_MorphAnimator>(entity).getActiveAnimRef().Update(deltaTime);
-			}
+			});
+
+			//animation system, each animator only touches it's own data so they can be split across the workers
+			frameGraph.AddSystem("animation", [this, deltaTime, animatorView]() {
+				TTN_PROFILE_SCOPE("Animation");
+				//run through all the of entities with an animator in the scene and run it's update
+				TTN_JobSystem::ParallelForEach(animatorView, [this, deltaTime](entt::entity entity) {
+					//update the active animation
+					Get<TTN_MorphAnimator>(entity).getActiveAnimRef().Update(deltaTime);
+				});
+			});
+
+			//particle system, kept on one job as emitting new particles uses the shared random number generator
+			frameGraph.AddSystem("particles", [this, deltaTime, psView]() {
+				TTN_PROFILE_SCOPE("Particles");
+				//run through all the of the entities with a particle system and run their updates
+				for (auto entity : psView) {
+					//update the particle system
+					Get<TTN_ParticeSystemComponent>(entity).GetParticleSystemPointer()->Update(deltaTime);
+				}
+			});
 
-			//run through all the of the entities with a particle system and run their updates
-			auto psView = m_Registry->view<TTN_ParticeSystemComponent>();
-			for (auto entity : psView) {
-				//update the particle system
-				Get<TTN_ParticeSystemComponent>(entity).GetParticleSystemPointer()->Update(deltaTime);
-			}
+			//run all the systems and wait for them to finish
+			frameGraph.Run();
 
-			//list of entities to delete this frame
-			std::vector<entt::entity> entitiesToDelete = std::vector<entt::entity>();
-			//run through all the entities with a limited lifetime, run their updates and delete them if their lifetimes have ended
-			auto deleteView = m_Registry->view<TTN_DeleteCountDown>();
+			//run through all the entities with a limited lifetime, run their updates and queue them for deletion if their lifetimes have ended
+			auto deleteView = m_Registry->view<TTN_DeleteCountDown>(entt::exclude<TTN_Inactive>);
 			for (auto entity : deleteView) {
 				//update the countdown
 				Get<TTN_DeleteCountDown>(entity).Update(deltaTime);
 				//check if it should delete
 				if (Get<TTN_DeleteCountDown>(entity).GetLifeLeft() <= 0.0f) {
-					//if it should, add the entity to a list of entities to delete
-					entitiesToDelete.push_back(entity);
+					//if it should, queue it to be deleted at the end of the frame
+					QueueDestroy(entity);
 				}
 			}
-			//loop through and delete all the entities
-			std::vector<entt::entity>::iterator it = entitiesToDelete.begin();
-			while (it != entitiesToDelete.end()) {
-				DeleteEntity(*it);
-				it = entitiesToDelete.erase(it);
-			}
 		}
 	}
 
+	//draws the render group's shadow casters into the shadow map
+	void TTN_Scene::RenderShadows(const glm::mat4& view, const glm::mat4& projection)
+	{
+		TTN_PROFILE_SCOPE("Shadows");
+		TTN_PROFILE_GPU_SCOPE("Shadows");
+		//only draw them if there's a light to cast them
+		if (m_sunStrength <= 0.0f || !m_sunCastShadows) return;
+
+		//gather the casters
+		std::vector<TTN_ShadowCaster> casters;
+		m_RenderGroup->each([&](entt::entity entity, TTN_Transform& transform, TTN_Renderer& renderer) {
+			//skip anything that can't or shouldn't be drawn into it
+			if (!renderer.GetCastShadows() || renderer.GetMesh() == nullptr || renderer.GetShader() == nullptr
+				|| renderer.GetMesh()->GetVAOPointer() == nullptr
+				|| renderer.GetShader()->GetVertexShaderDefaultStatus() == (int)TTN_DefaultShaders::VERT_SKYBOX)
+				return;
+
+			TTN_ShadowCaster caster;
+			caster.Id = (uint32_t)entity;
+			caster.Model = transform.GetGlobal();
+			caster.Mesh = renderer.GetActiveMesh();
+			//animated objects change shape even when they don't move
+			caster.Static = renderer.GetStatic() && !Has<TTN_MorphAnimator>(entity);
+
+			//move the mesh's bounding box into world space
+			glm::vec3 center = glm::vec3(caster.Model * glm::vec4((caster.Mesh->GetBoundsMin() + caster.Mesh->GetBoundsMax()) * 0.5f, 1.0f));
+			glm::mat3 absModel = glm::mat3(glm::abs(caster.Model[0]), glm::abs(caster.Model[1]), glm::abs(caster.Model[2]));
+			glm::vec3 extents = absModel * ((caster.Mesh->GetBoundsMax() - caster.Mesh->GetBoundsMin()) * 0.5f);
+
+			//displacement maps can push the surface out of the mesh's box
+			if (renderer.GetMat() != nullptr && (renderer.GetShader()->GetVertexShaderDefaultStatus() == (int)TTN_DefaultShaders::VERT_COLOR_HEIGHTMAP
+				|| renderer.GetShader()->GetVertexShaderDefaultStatus() == (int)TTN_DefaultShaders::VERT_NO_COLOR_HEIGHTMAP)) {
+				caster.HeightMap = renderer.GetMat()->GetHeightMap();
+				caster.HeightInfluence = renderer.GetMat()->GetHeightInfluence();
+				extents += glm::vec3(std::abs(caster.HeightInfluence));
+			}
+			caster.BoundsMin = center - extents;
+			caster.BoundsMax = center + extents;
+
+			//morph animation frames
+			if (Has<TTN_MorphAnimator>(entity)) {
+				caster.CurrentFrame = Get<TTN_MorphAnimator>(entity).getActiveAnimRef().getCurrentMeshIndex();
+				caster.NextFrame = Get<TTN_MorphAnimator>(entity).getActiveAnimRef().getNextMeshIndex();
+				caster.T = Get<TTN_MorphAnimator>(entity).getActiveAnimRef().getInterpolationParameter();
+			}
+
+			casters.push_back(caster);
+		});
+
+		m_shadowMap.Render(casters, m_sunDirection, view, projection);
+	}
+
+	//culls the render group against the camera
+	void TTN_Scene::CullRenderGroup(const glm::mat4& viewProj)
+	{
+		TTN_PROFILE_SCOPE("Culling");
+		//how much the projection scales things vertically, to work out how much of the screen an object covers
+		float projectionScale = Get<TTN_Camera>(m_Cam).GetProj()[1][1];
+
+		m_culler.Begin();
+		m_RenderGroup->each([&](entt::entity entity, TTN_Transform& transform, TTN_Renderer& renderer) {
+			TTN_Mesh::smptr mesh = renderer.GetMesh();
+			TTN_Shader::sshptr shader = renderer.GetShader();
+
+			//skyboxes, custom vertex shaders, and meshes without bounds are always drawn
+			if (mesh == nullptr || shader == nullptr || mesh->GetBoundingRadius() <= 0.0f
+				|| shader->GetVertexShaderDefaultStatus() == (int)TTN_DefaultShaders::VERT_SKYBOX
+				|| shader->GetVertexShaderDefaultStatus() == (int)TTN_DefaultShaders::NOT_DEFAULT) {
+				m_culler.AddAlwaysVisible();
+				return;
+			}
+
+			//displacement maps push the surface out along the normals
+			float displacement = 0.0f;
+			if (renderer.GetMat() != nullptr && (shader->GetVertexShaderDefaultStatus() == (int)TTN_DefaultShaders::VERT_COLOR_HEIGHTMAP
+				|| shader->GetVertexShaderDefaultStatus() == (int)TTN_DefaultShaders::VERT_NO_COLOR_HEIGHTMAP))
+				displacement = std::abs(renderer.GetMat()->GetHeightInfluence());
+
+			glm::mat4 model = transform.GetGlobal();
+			if (renderer.GetStatic()) {
+				//static objects go in the bvh as world space boxes
+				glm::vec3 center = glm::vec3(model * glm::vec4((mesh->GetBoundsMin() + mesh->GetBoundsMax()) * 0.5f, 1.0f));
+				glm::mat3 absModel = glm::mat3(glm::abs(model[0]), glm::abs(model[1]), glm::abs(model[2]));
+				glm::vec3 extents = absModel * ((mesh->GetBoundsMax() - mesh->GetBoundsMin()) * 0.5f + glm::vec3(displacement));
+				if (m_frustumCulling) m_culler.AddStatic((uint32_t)entity, center - extents, center + extents);
+				else m_culler.AddAlwaysVisible();
+
+				//pick the level of detail from the sphere around the box
+				if (mesh->GetLODCount() > 1) {
+					float distance = std::max(std::abs((viewProj * glm::vec4(center, 1.0f)).w), 0.0001f);
+					renderer.UpdateLOD(glm::length(extents) * projectionScale / distance);
+				}
+			}
+			else {
+				//moving objects are tested as spheres, scaled by the largest axis of the transform
+				glm::vec3 center = glm::vec3(model * glm::vec4(mesh->GetBoundingCenter(), 1.0f));
+				float scale = std::max(std::max(glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1]))), glm::length(glm::vec3(model[2])));
+				if (m_frustumCulling) m_culler.AddDynamic(center, (mesh->GetBoundingRadius() + displacement) * scale);
+				else m_culler.AddAlwaysVisible();
+
+				//pick the level of detail from how much of the screen's height the sphere covers, w is the view depth (or 1 for orthographic cameras)
+				if (mesh->GetLODCount() > 1) {
+					float distance = std::max(std::abs((viewProj * glm::vec4(center, 1.0f)).w), 0.0001f);
+					renderer.UpdateLOD((mesh->GetBoundingRadius() + displacement) * scale * projectionScale / distance);
+				}
+			}
+		});
+		m_culler.Cull(viewProj);
+	}
+
+	//draws the waiting morph animated objects
+	void TTN_Scene::FlushMorphBatch(const glm::mat4& viewProj)
+	{
+		//if there's nothing waiting there's nothing to draw
+		if (m_morphBatch.empty()) return;
+
+		//send the instances to the gpu
+		if (m_morphInstanceBuffer == nullptr) m_morphInstanceBuffer = TTN_ShaderStorageBuffer::Create(GL_STREAM_DRAW);
+		m_morphInstanceBuffer->LoadData(m_morphBatch.data(), m_morphBatch.size());
+		m_morphInstanceBuffer->BindBase(s_morphInstanceBinding);
+		//and the frames they all read from
+		m_morphBatchMesh->BindFrames();
+
+		//the rest of the shader's uniforms were set up by the first object in the batch
+		m_morphBatchShader->Bind();
+		m_morphBatchShader->SetUniform("u_UseInstances", 1);
+		m_morphBatchShader->SetUniformMatrix("u_ViewProjection", viewProj);
+		m_morphBatchShader->SetUniform("u_FrameVertexCount", m_morphBatchMesh->GetVertCount());
+
+		//draw them all at once
+		m_morphBatchMesh->GetVAOPointer()->RenderInstanced(m_morphBatch.size());
+		m_morphBatchShader->SetUniform("u_UseInstances", 0);
+		m_morphBatchShader->UnBind();
+
+		m_trianglesDrawn += m_morphBatchMesh->GetTriangleCount() * m_morphBatch.size();
+		m_morphInstancesDrawn += m_morphBatch.size();
+		m_morphDrawCalls++;
+		m_morphBatch.clear();
+	}
+
+	//sets the directional light uniforms
+	void TTN_Scene::SetSunUniforms(TTN_Shader* shader, const TTN_RenderView& view)
+	{
+		shader->SetUniform("u_SunDirection", view.SunDirection);
+		shader->SetUniform("u_SunColor", view.SunColor);
+		shader->SetUniform("u_SunStrength", view.SunStrength);
+
+		//only sample the shadows if they were drawn
+		if (view.SunShadows) m_shadowMap.SetUniforms(shader);
+		else shader->SetUniform("u_NumCascades", 0);
+	}
+
+	//gets a view with the scene's lighting
+	TTN_RenderView TTN_Scene::GetLightingView() const
+	{
+		TTN_RenderView view;
+		view.AmbientColor = m_AmbientColor;
+		view.AmbientStrength = m_AmbientStrength;
+		view.SunDirection = m_sunDirection;
+		view.SunColor = m_sunColor;
+		view.SunStrength = std::max(m_sunStrength, 0.0f);
+		//the shadows are only drawn when the sun's on and casting them
+		view.SunShadows = (m_sunStrength > 0.0f && m_sunCastShadows);
+		return view;
+	}
+
+	//binds the clustered light buffers and sets their uniforms on a custom shader
+	void TTN_Scene::SetClusteredLightingUniforms(const TTN_Shader::sshptr& shader)
+	{
+		m_lightClusters.Bind();
+		m_lightClusters.SetUniforms(shader.get(), glm::uvec2(m_sceneTarget->m_width, m_sceneTarget->m_height));
+	}
+
+	//binds the shadow atlas and sets the sun uniforms on a custom shader
+	void TTN_Scene::SetSunLightingUniforms(const TTN_Shader::sshptr& shader)
+	{
+		m_shadowMap.Bind();
+		SetSunUniforms(shader.get(), GetLightingView());
+		//the cascade is picked from the view depth
+		shader->SetUniformMatrix("u_View", glm::inverse(Get<TTN_Transform>(m_Cam).GetGlobal()));
+	}
+
+	//turns on or off the automatic resolution scale controller
+	void TTN_Scene::SetAutoResolutionScale(bool autoScale, float targetFrameTime, float minScale, float maxScale)
+	{
+		m_autoResolutionScale = autoScale;
+		m_targetFrameTime = targetFrameTime;
+		m_smoothedFrameTime = targetFrameTime;
+		m_minResolutionScale = minScale;
+		m_maxResolutionScale = maxScale;
+		m_resolutionScale = std::clamp(m_resolutionScale, m_minResolutionScale, m_maxResolutionScale);
+	}
+
+	//updates the automatic resolution scale
+	void TTN_Scene::UpdateResolutionScale(float deltaTime)
+	{
+		if (!m_autoResolutionScale) return;
+
+		//smooth the frame time so a single slow frame doesn't make the resolution jump around
+		m_smoothedFrameTime = glm::mix(m_smoothedFrameTime, deltaTime, 0.1f);
+
+		//lower the resolution if it's running slow, and only raise it again once there's a good amount of time to spare
+		if (m_smoothedFrameTime > m_targetFrameTime * 1.05f)
+			m_resolutionScale -= 0.02f;
+		else if (m_smoothedFrameTime < m_targetFrameTime * 0.85f)
+			m_resolutionScale += 0.01f;
+
+		m_resolutionScale = std::clamp(m_resolutionScale, m_minResolutionScale, m_maxResolutionScale);
+	}
+
 	//function that executes after the main render
 	void TTN_Scene::PostRender()
 	{
@@ -257,73 +773,93 @@ namespace Titan {
 		glm::mat4 viewMat = glm::inverse(Get<TTN_Transform>(m_Cam).GetGlobal());
 
 		//create a view of all the entities with a particle system and a transform
-		auto psTransView = m_Registry->view<TTN_ParticeSystemComponent, TTN_Transform>();
+		auto psTransView = m_Registry->view<TTN_ParticeSystemComponent, TTN_Transform>(entt::exclude<TTN_Inactive>);
 		for (auto entity : psTransView) {
 			//render the particle system
 			Get<TTN_ParticeSystemComponent>(entity).GetParticleSystemPointer()->Render(Get<TTN_Transform>(entity).GetGlobalPos(),
 				viewMat, Get<TTN_Camera>(m_Cam).GetProj());
 		}
 
-		//unbind the empty effect and run through all the post effect
-		m_emptyEffect->UnbindBuffer();
-
-		//if there are post processing effects that can be applied
-		if (m_PostProcessingEffects.size() > 0) {
-			//track the index of the last effect that was applied
-			int index = -1;
-			//and iterate through all the post processing effects
-			for (int i = 0; i < m_PostProcessingEffects.size(); i++) {
-				//if the effect should be applied
-				if (m_PostProcessingEffects[i]->GetShouldApply()) {
-					//apply the effect
-					if (index == -1)
-						m_PostProcessingEffects[i]->ApplyEffect(m_emptyEffect);
-					else
-						m_PostProcessingEffects[i]->ApplyEffect(m_PostProcessingEffects[index]);
-
-					//and save the index as this was most recent effect applied
-					index = i;
-				}
+		//unbind the scene target
+		m_sceneTarget->Unbind();
+
+		//build the post processing chain as a render graph, the graph culls anything that doesn't lead to the final image
+		//and hands out pooled targets so the whole chain only ever needs two of them
+		m_postGraph.Reset();
+		m_postGraph.ImportTarget("scene", m_sceneTarget);
+		std::string lastOutput = "scene";
+
+		//effects that only read their own pixel get grouped into runs that are drawn with a single fused shader
+		std::vector<TTN_PostEffect::spostptr> run;
+		//adds a pass for the current run
+		auto addRun = [&]() {
+			if (run.empty()) return;
+
+			std::string output = "post" + std::to_string(m_postGraph.GetPassCount());
+			std::vector<TTN_PostEffect::spostptr> effects = run;
+			m_postGraph.AddPass(output, { lastOutput }, output,
+				[effects](const std::vector<TTN_Framebuffer::sfboptr>& inputs, const TTN_Framebuffer::sfboptr& target) {
+					//a single effect doesn't need a fused shader
+					if (effects.size() == 1) effects[0]->ApplyEffect(inputs[0], target);
+					else TTN_UberPost::Apply(effects, inputs[0], target);
+				});
+			lastOutput = output;
+
+			run.clear();
+		};
+
+		for (int i = 0; i < m_PostProcessingEffects.size(); i++) {
+			//only add the effects that should be applied
+			if (!m_PostProcessingEffects[i]->GetShouldApply()) continue;
+
+			TTN_PostEffect::spostptr effect = m_PostProcessingEffects[i];
+			//if it can join the current run, add it
+			if (TTN_UberPost::CanFuse(run, effect)) {
+				run.push_back(effect);
+				continue;
 			}
-			//at the end, draw to the screen
-			if (index == -1) {
-				//if none should be applied, just draw the empty effect
-				m_emptyEffect->DrawToScreen();
-				//and save it as the last effect played
-				TTN_Backend::SetLastEffect(m_emptyEffect);
+
+			//otherwise finish the current run
+			addRun();
+
+			//and either start a new run with it or, if it needs neighbouring pixels, give it it's own pass
+			if (effect->GetFusedType() != TTN_FusedEffectType::NONE) {
+				run.push_back(effect);
 			}
 			else {
-				//if they should be applied, draw from the last effect
-				m_PostProcessingEffects[index]->DrawToScreen();
-				//and save it
-				TTN_Backend::SetLastEffect(m_PostProcessingEffects[index]);
+				run.push_back(effect);
+				addRun();
 			}
 		}
-		//if there are no post processing effects to apply, just save the empty effect
-		else {
-			m_emptyEffect->DrawToScreen();
-			//and save it as the last effect played
-			TTN_Backend::SetLastEffect(m_emptyEffect);
-		}
+		//finish whatever run is left
+		addRun();
+
+		//run the graph and draw whatever it finished with to the screen
+		TTN_Framebuffer::sfboptr finalFrame = m_postGraph.Execute(lastOutput, m_sceneTarget->m_width, m_sceneTarget->m_height);
+		glm::ivec2 windowSize = TTN_Backend::GetWindowSize();
+		glViewport(0, 0, windowSize.x, windowSize.y);
+		TTN_PostEffect::DrawToScreen(finalFrame);
+		//and save it so a scene drawn on top can use it as it's background
+		TTN_Backend::SetLastFrame(finalFrame);
 	}
 
 	//renders all the messes in our game
 	void TTN_Scene::Render()
 	{
-		//clear all the post processing effects
-		m_emptyEffect->Clear();
-		for (int i = 0; i < m_PostProcessingEffects.size(); i++)
-			m_PostProcessingEffects[i]->Clear();
-
-		//get the view and projection martix
-		glm::mat4 vp;
 		//update the camera for the scene
 		//set the camera's position to it's transform
 		Get<TTN_Camera>(m_Cam).SetPosition(Get<TTN_Transform>(m_Cam).GetPos());
-		//save the view and projection matrix
-		vp = Get<TTN_Camera>(m_Cam).GetProj();
-		glm::mat4 viewMat = glm::inverse(Get<TTN_Transform>(m_Cam).GetGlobal());
-		vp *= viewMat;
+		//save the view and projection martix, and everything else the draws need from the camera and the lighting
+		TTN_RenderView view = GetLightingView();
+		view.Projection = Get<TTN_Camera>(m_Cam).GetProj();
+		view.View = glm::inverse(Get<TTN_Transform>(m_Cam).GetGlobal());
+		view.ViewProjection = view.Projection * view.View;
+		view.CameraPosition = Get<TTN_Transform>(m_Cam).GetPos();
+		//the scene target is the window scaled by the resolution scale
+		glm::ivec2 windowSize = TTN_Backend::GetWindowSize();
+		view.TargetSize = glm::uvec2(std::max(1u, (unsigned)(windowSize.x * m_resolutionScale)), std::max(1u, (unsigned)(windowSize.y * m_resolutionScale)));
+		glm::mat4 vp = view.ViewProjection;
+		glm::mat4 viewMat = view.View;
 
 		//sort our render group
 		m_RenderGroup->sort<TTN_Renderer>([](const TTN_Renderer& l, const TTN_Renderer& r) {
@@ -342,19 +878,165 @@ namespace Titan {
 
 		ReconstructScenegraph();
 
+		//without a gpu the render group is still culled and recorded, so what the scene would draw can be checked, but nothing gets submitted
+		if (TTN_Backend::GetHeadless()) {
+			CullRenderGroup(vp);
+			RecordRenderGroup(view);
+			return;
+		}
+
+		//size the scene target, this doesn't reallocate unless it grows past the headroom
+		m_sceneTarget->Reshape(view.TargetSize.x, view.TargetSize.y);
+
+		//clear the scene target, the post processing targets get written over completely so they never need clearing
+		m_sceneTarget->Clear();
+
+		//draw the shadow map before the scene target gets bound
+		RenderShadows(viewMat, Get<TTN_Camera>(m_Cam).GetProj());
+
 		//before going through see if it needs to render another scene as the background first 
-		if (TTN_Backend::GetLastEffect() != nullptr) {
-			//if it does, apply the buffer from that scene before drawing
-			m_emptyEffect->ApplyEffect(TTN_Backend::GetLastEffect());
+		if (TTN_Backend::GetLastFrame() != nullptr) {
+			//if it does, copy the image from that scene before drawing
+			TTN_PostEffect::Copy(TTN_Backend::GetLastFrame(), m_sceneTarget);
+		}
+
+		//bind the scene target
+		m_sceneTarget->Bind(); //this gets unbound in postRender
+		//and draw to the scaled size
+		m_sceneTarget->SetViewport();
+
+		//gather the lights and sort them into clusters so each fragment only gets lit by the lights that can reach it
+		{
+			TTN_PROFILE_SCOPE("LightClusters");
+			//the list only lasts until it's uploaded, so it comes from the frame arena
+			std::pmr::vector<TTN_GPULight> gpuLights(TTN_FrameArena::GetResource());
+			gpuLights.reserve(m_Lights.size());
+			for (auto lightEntity : m_Lights) {
+				auto& light = Get<TTN_Light>(lightEntity);
+				TTN_GPULight gpuLight;
+				//the linear term gets the constant attenuation, which is what the shaders have always been sent
+				float linear = light.GetConstantAttenuation();
+				float brightness = std::max(std::max(light.GetColor().r, light.GetColor().g), light.GetColor().b) *
+					(light.GetAmbientStrength() + 1.0f + light.GetSpecularStrength());
+				float range = TTN_LightClusters::CalculateRange(light.GetConstantAttenuation(), linear, light.GetQuadraticAttenuation(), brightness);
+				gpuLight.PositionRange = glm::vec4(Get<TTN_Transform>(lightEntity).GetGlobalPos(), range);
+				gpuLight.ColorAmbient = glm::vec4(light.GetColor(), light.GetAmbientStrength());
+				gpuLight.SpecularAttenuation = glm::vec4(light.GetSpecularStrength(), light.GetConstantAttenuation(), linear, light.GetQuadraticAttenuation());
+				gpuLights.push_back(gpuLight);
+			}
+			m_lightClusters.Build(gpuLights, viewMat, Get<TTN_Camera>(m_Cam).GetProj());
 		}
+		m_lightClusters.Bind();
+		//and bind the shadow atlas
+		m_shadowMap.Bind();
 
-		//bind the empty effect
-		m_emptyEffect->BindBuffer(0); //this gets unbound in postRender
+		//work out which objects are in view and pick their levels of detail
+		CullRenderGroup(vp);
 
-		//go through every entity with a transform and a mesh renderer and render the mesh
+		//record everything that's left in view, then submit it
+		//the list doesn't need the scene to be drawn, but the draws stay on this thread until openGL is moved onto a render thread of it's own
+		RecordRenderGroup(view);
+		SubmitRenderGroup(GetRenderCommands());
+
+		//2D sprite rendering
+		//every sprite goes into the batcher, which sorts them by layer, depth, and texture and draws them in as few draws as it can
+		TTN_SpriteBatcher::Begin(vp);
+		auto render2DView = m_Registry->view<TTN_Transform, TTN_Renderer2D>(entt::exclude<TTN_Inactive>);
+		for (entt::entity entity : render2DView) {
+			TTN_Renderer2D& renderer2D = render2DView.get<TTN_Renderer2D>(entity);
+			TTN_SpriteBatcher::Submit(renderer2D.GetSprite().get(), render2DView.get<TTN_Transform>(entity).GetGlobal(), renderer2D.GetColor(), renderer2D.GetRenderLayer());
+		}
+		TTN_SpriteBatcher::End();
+		m_spriteDrawCalls = TTN_SpriteBatcher::GetDrawCalls();
+	}
+
+	//records the visible objects in the render group
+	void TTN_Scene::RecordRenderGroup(const TTN_RenderView& view)
+	{
+		TTN_PROFILE_SCOPE("RecordRenderGroup");
+		//record into the list that isn't the latest, so the latest one stays whole until this one's done
+		TTN_RenderCommandList& commands = m_renderCommands[1 - m_renderCommandIndex];
+		commands.Begin(view);
+
+		//go through every entity with a transform and a mesh renderer, in the order they were sorted and culled
+		size_t drawIndex = 0;
 		m_RenderGroup->each([&](entt::entity entity, TTN_Transform& transform, TTN_Renderer& renderer) {
-			//get the shader pointer
-			TTN_Shader::sshptr shader = renderer.GetShader();
+			//skip it if it's outside the camera's view
+			if (!m_culler.IsVisible(drawIndex++)) return;
+
+			TTN_DrawPacket& packet = commands.AddDraw(renderer.GetActiveMesh(), renderer.GetShader(), renderer.GetMat());
+			packet.Entity = entity;
+			packet.Model = transform.GetGlobal();
+
+			//wheter or not it's morph animated, and if it can be drawn instanced
+			int vertShader = renderer.GetShader()->GetVertexShaderDefaultStatus();
+			packet.Morph = (vertShader == (int)TTN_DefaultShaders::VERT_MORPH_ANIMATION_NO_COLOR
+				|| vertShader == (int)TTN_DefaultShaders::VERT_MORPH_ANIMATION_COLOR);
+			bool animated = Has<TTN_MorphAnimator>(entity);
+			packet.Instanced = (m_instancedMorphs && packet.Morph && animated);
+
+			//save the frames it's blending between
+			if (animated) {
+				auto& anim = Get<TTN_MorphAnimator>(entity).getActiveAnimRef();
+				packet.CurrentFrame = anim.getCurrentMeshIndex();
+				packet.NextFrame = anim.getNextMeshIndex();
+				packet.T = anim.getInterpolationParameter();
+			}
+		});
+
+		//this frame's list is now the latest one
+		m_renderCommandIndex = 1 - m_renderCommandIndex;
+	}
+
+	//draws a recorded list
+	void TTN_Scene::SubmitRenderGroup(const TTN_RenderCommandList& commands)
+	{
+		TTN_PROFILE_SCOPE("DrawRenderGroup");
+		const TTN_RenderView& view = commands.GetView();
+		const glm::mat4& vp = view.ViewProjection;
+		m_trianglesDrawn = 0;
+		m_morphDrawCalls = 0;
+		m_morphInstancesDrawn = 0;
+
+		//when bindless textures are supported the default shaders read every material from one buffer, so upload any that changed and bind it
+		bool materialBuffer = TTN_Material::GetUseMaterialBuffer();
+		TTN_Material::BindMaterialBuffer();
+		//gets the index in the material buffer a draw uses, objects without a material use the default one
+		auto materialIndex = [](const TTN_Material* material) {
+			return (material != nullptr) ? material->GetIndex() : TTN_Material::GetDefault()->GetIndex();
+		};
+
+		//adds a morph animated object to the waiting instanced batch
+		auto addMorphInstance = [&](const TTN_DrawPacket& packet, const TTN_Material* material) {
+			TTN_MorphInstance instance;
+			instance.Model = packet.Model;
+			instance.NormalMat = glm::mat4(glm::mat3(glm::transpose(glm::inverse(instance.Model))));
+			instance.Frames = glm::vec4((float)packet.CurrentFrame, (float)packet.NextFrame, packet.T, (float)materialIndex(material));
+			m_morphBatch.push_back(instance);
+		};
+
+		//go through every recorded draw and render it
+		for (const TTN_DrawPacket& packet : commands.GetDraws()) {
+			//get the mesh, shader, and material from the list's tables
+			TTN_Mesh* mesh = commands.GetMesh(packet);
+			TTN_Shader* shader = commands.GetShader(packet);
+			TTN_Material* material = commands.GetMaterial(packet);
+			//wheter it gets it's material from the material buffer instead of uniforms and bound textures, the blinn-phong default shaders do when it's in use
+			int fragShader = shader->GetFragShaderDefaultStatus();
+			bool usesMaterialBuffer = materialBuffer && (fragShader == (int)TTN_DefaultShaders::FRAG_BLINN_PHONG_NO_TEXTURE
+				|| fragShader == (int)TTN_DefaultShaders::FRAG_BLINN_PHONG_ALBEDO_ONLY || fragShader == (int)TTN_DefaultShaders::FRAG_BLINN_PHONG_ALBEDO_AND_SPECULAR);
+
+			//if it shares the waiting batch's mesh, shader, and material, everything's already been set up so it just joins the batch
+			//with the material buffer each instance reads it's own material, so it only has to have the same textures
+			bool sameMaterial = (material == m_morphBatchMat) || (usesMaterialBuffer && material != nullptr
+				&& m_morphBatchMat != nullptr && material->GetSameTextures(*m_morphBatchMat));
+			if (packet.Instanced && !m_morphBatch.empty() && mesh == m_morphBatchMesh
+				&& shader == m_morphBatchShader && sameMaterial) {
+				addMorphInstance(packet, material);
+				continue;
+			}
+			//otherwise the batch has to be drawn first, as setting this object up would change the state it needs
+			FlushMorphBatch(vp);
 
 			//bind the shader
 			shader->Bind();
@@ -362,61 +1044,31 @@ namespace Titan {
 			//sets some uniforms
 			if (shader->GetFragShaderDefaultStatus() != (int)TTN_DefaultShaders::NOT_DEFAULT) {
 				//scene level ambient lighting
-				shader->SetUniform("u_AmbientCol", m_AmbientColor);
-				shader->SetUniform("u_AmbientStrength", m_AmbientStrength);
-
-				//stuff from the light
-				glm::vec3 lightPositions[16];
-				glm::vec3 lightColor[16];
-				float lightAmbientStr[16];
-				float lightSpecStr[16];
-				float lightAttenConst[16];
-				float lightAttenLinear[16];
-				float lightAttenQuadartic[16];
-
-				for (int i = 0; i < 16 && i < m_Lights.size(); i++) {
-					auto& light = Get<TTN_Light>(m_Lights[i]);
-					auto& lightTrans = Get<TTN_Transform>(m_Lights[i]);
-					lightPositions[i] = lightTrans.GetPos();
-					lightColor[i] = light.GetColor();
-					lightAmbientStr[i] = light.GetAmbientStrength();
-					lightSpecStr[i] = light.GetSpecularStrength();
-					lightAttenConst[i] = light.GetConstantAttenuation();
-					lightAttenLinear[i] = light.GetConstantAttenuation();
-					lightAttenQuadartic[i] = light.GetQuadraticAttenuation();
-				}
+				shader->SetUniform("u_AmbientCol", view.AmbientColor);
+				shader->SetUniform("u_AmbientStrength", view.AmbientStrength);
 
-				//send all the data about the lights to glsl
-				shader->SetUniform("u_LightPos", lightPositions[0], 16);
-				shader->SetUniform("u_LightCol", lightColor[0], 16);
-				shader->SetUniform("u_AmbientLightStrength", lightAmbientStr[0], 16);
-				shader->SetUniform("u_SpecularLightStrength", lightSpecStr[0], 16);
-				shader->SetUniform("u_LightAttenuationConstant", lightAttenConst[0], 16);
-				shader->SetUniform("u_LightAttenuationLinear", lightAttenLinear[0], 16);
-				shader->SetUniform("u_LightAttenuationQuadratic", lightAttenQuadartic[0], 16);
-
-				//and tell it how many lights there actually are
-				shader->SetUniform("u_NumOfLights", (int)m_Lights.size());
+				//clustered lighting data, the lights themselves are in the shader storage buffers bound before the loop
+				m_lightClusters.SetUniforms(shader, view.TargetSize);
 
 				//stuff from the camera
-				shader->SetUniform("u_CamPos", Get<TTN_Transform>(m_Cam).GetPos());
+				shader->SetUniform("u_CamPos", view.CameraPosition);
 
-				//if it has a material send some lighting and shading data from that material
-				if (renderer.GetMat() != nullptr) {
+				//if it has a material send some lighting and shading data from that material, unless the shader reads it from the material buffer
+				if (material != nullptr && !usesMaterialBuffer) {
 					//and material details about the lighting and shading
-					shader->SetUniform("u_hasAmbientLighting", (int)(renderer.GetMat()->GetHasAmbient()));
-					shader->SetUniform("u_hasSpecularLighting", (int)(renderer.GetMat()->GetHasSpecular()));
+					shader->SetUniform("u_hasAmbientLighting", (int)(material->GetHasAmbient()));
+					shader->SetUniform("u_hasSpecularLighting", (int)(material->GetHasSpecular()));
 					//the ! is because it has to be reversed in the shader
-					shader->SetUniform("u_hasOutline", (int)(!renderer.GetMat()->GetHasOutline()));
-					shader->SetUniform("u_OutlineSize", renderer.GetMat()->GetOutlineSize());
+					shader->SetUniform("u_hasOutline", (int)(!material->GetHasOutline()));
+					shader->SetUniform("u_OutlineSize", material->GetOutlineSize());
 
 					//wheter or not ramps for toon shading should be used
-					shader->SetUniform("u_useDiffuseRamp", (int)renderer.GetMat()->GetUseDiffuseRamp());
-					shader->SetUniform("u_useSpecularRamp", (int)renderer.GetMat()->GetUseSpecularRamp());
+					shader->SetUniform("u_useDiffuseRamp", (int)material->GetUseDiffuseRamp());
+					shader->SetUniform("u_useSpecularRamp", (int)material->GetUseSpecularRamp());
 
 					//bind the ramps as textures
-					renderer.GetMat()->GetDiffuseRamp()->Bind(10);
-					renderer.GetMat()->GetSpecularRamp()->Bind(11);
+					material->GetDiffuseRamp()->Bind(10);
+					material->GetSpecularRamp()->Bind(11);
 				}
 			}
 
@@ -425,76 +1077,48 @@ namespace Titan {
 				&& shader->GetFragShaderDefaultStatus() != (int)TTN_DefaultShaders::NOT_DEFAULT) {
 				//sets some uniforms
 				//scene level ambient lighting
-				shader->SetUniform("u_AmbientCol", m_AmbientColor);
-				shader->SetUniform("u_AmbientStrength", m_AmbientStrength);
-
-				//stuff from the light
-				glm::vec3 lightPositions[16];
-				glm::vec3 lightColor[16];
-				float lightAmbientStr[16];
-				float lightSpecStr[16];
-				float lightAttenConst[16];
-				float lightAttenLinear[16];
-				float lightAttenQuadartic[16];
-
-				for (int i = 0; i < 16 && i < m_Lights.size(); i++) {
-					auto& light = Get<TTN_Light>(m_Lights[i]);
-					auto& lightTrans = Get<TTN_Transform>(m_Lights[i]);
-					lightPositions[i] = lightTrans.GetGlobalPos();
-					lightColor[i] = light.GetColor();
-					lightAmbientStr[i] = light.GetAmbientStrength();
-					lightSpecStr[i] = light.GetSpecularStrength();
-					lightAttenConst[i] = light.GetConstantAttenuation();
-					lightAttenLinear[i] = light.GetConstantAttenuation();
-					lightAttenQuadartic[i] = light.GetQuadraticAttenuation();
-				}
+				shader->SetUniform("u_AmbientCol", view.AmbientColor);
+				shader->SetUniform("u_AmbientStrength", view.AmbientStrength);
 
-				//send all the data about the lights to glsl
-				shader->SetUniform("u_LightPos", lightPositions[0], 16);
-				shader->SetUniform("u_LightCol", lightColor[0], 16);
-				shader->SetUniform("u_AmbientLightStrength", lightAmbientStr[0], 16);
-				shader->SetUniform("u_SpecularLightStrength", lightSpecStr[0], 16);
-				shader->SetUniform("u_LightAttenuationConstant", lightAttenConst[0], 16);
-				shader->SetUniform("u_LightAttenuationLinear", lightAttenLinear[0], 16);
-				shader->SetUniform("u_LightAttenuationQuadratic", lightAttenQuadartic[0], 16);
-
-				//and tell it how many lights there actually are
-				shader->SetUniform("u_NumOfLights", (int)m_Lights.size());
+				//clustered lighting data, the lights themselves are in the shader storage buffers bound before the loop
+				m_lightClusters.SetUniforms(shader, view.TargetSize);
+				//directional light and it's shadows
+				SetSunUniforms(shader, view);
 				
 				//stuff from the camera
-				shader->SetUniform("u_CamPos", Get<TTN_Transform>(m_Cam).GetPos());
+				shader->SetUniform("u_CamPos", view.CameraPosition);
 
-				//if it has a material send some lighting and shading data from that material
-				if (renderer.GetMat() != nullptr) {
+				//if it has a material send some lighting and shading data from that material, unless the shader reads it from the material buffer
+				if (material != nullptr && !usesMaterialBuffer) {
 					//and material details about the lighting and shading
-					shader->SetUniform("u_hasAmbientLighting", (int)(renderer.GetMat()->GetHasAmbient()));
-					shader->SetUniform("u_hasSpecularLighting", (int)(renderer.GetMat()->GetHasSpecular()));
+					shader->SetUniform("u_hasAmbientLighting", (int)(material->GetHasAmbient()));
+					shader->SetUniform("u_hasSpecularLighting", (int)(material->GetHasSpecular()));
 					//the ! is because it has to be reversed in the shader
-					shader->SetUniform("u_hasOutline", (int)(!renderer.GetMat()->GetHasOutline()));
-					shader->SetUniform("u_OutlineSize", renderer.GetMat()->GetOutlineSize());
+					shader->SetUniform("u_hasOutline", (int)(!material->GetHasOutline()));
+					shader->SetUniform("u_OutlineSize", material->GetOutlineSize());
 
 					//wheter or not ramps for toon shading should be used
-					shader->SetUniform("u_useDiffuseRamp", (int)renderer.GetMat()->GetUseDiffuseRamp());
-					shader->SetUniform("u_useSpecularRamp", (int)renderer.GetMat()->GetUseSpecularRamp());
+					shader->SetUniform("u_useDiffuseRamp", (int)material->GetUseDiffuseRamp());
+					shader->SetUniform("u_useSpecularRamp", (int)material->GetUseSpecularRamp());
 
 					//bind the ramps as textures
-					renderer.GetMat()->GetDiffuseRamp()->Bind(10);
-					renderer.GetMat()->GetSpecularRamp()->Bind(11);
+					material->GetDiffuseRamp()->Bind(10);
+					material->GetSpecularRamp()->Bind(11);
 				}
 			}
 
 			//if the mesh has a material send data from that
-			if (renderer.GetMat() != nullptr)
+			if (material != nullptr)
 			{
 				//give openGL the shiniess
-				if (shader->GetFragShaderDefaultStatus() != 8) shader->SetUniform("u_Shininess", renderer.GetMat()->GetShininess());
+				if (shader->GetFragShaderDefaultStatus() != 8) shader->SetUniform("u_Shininess", material->GetShininess());
 				//if they're using a texture
 				if (shader->GetFragShaderDefaultStatus() == 4 || shader->GetFragShaderDefaultStatus() == 5)
 
 					//give openGL the shinniess if it's not a skybox being renderered
 					if (shader->GetFragShaderDefaultStatus() != (int)TTN_DefaultShaders::FRAG_SKYBOX
 						&& shader->GetFragShaderDefaultStatus() != (int)TTN_DefaultShaders::NOT_DEFAULT)
-						shader->SetUniform("u_Shininess", renderer.GetMat()->GetShininess());
+						shader->SetUniform("u_Shininess", material->GetShininess());
 
 				//texture slot to dynamically send textures across different types of shaders
 				int textureSlot = 0;
@@ -503,45 +1127,44 @@ namespace Titan {
 				if (shader->GetVertexShaderDefaultStatus() == (int)TTN_DefaultShaders::VERT_COLOR_HEIGHTMAP
 					|| shader->GetVertexShaderDefaultStatus() == (int)TTN_DefaultShaders::VERT_NO_COLOR_HEIGHTMAP)
 				{
-					//bind it to the slot
-					renderer.GetMat()->GetHeightMap()->Bind(textureSlot);
-					//update the texture slot for future textures to use
-					textureSlot++;
-					//and pass in the influence
-					shader->SetUniform("u_influence", renderer.GetMat()->GetHeightInfluence());
+					//with the material buffer the height map's handle and influence are read from it instead
+					if (!materialBuffer) {
+						//bind it to the slot
+						material->GetHeightMap()->Bind(textureSlot);
+						//update the texture slot for future textures to use
+						textureSlot++;
+						//and pass in the influence
+						shader->SetUniform("u_influence", material->GetHeightInfluence());
+					}
 				}
 
 				//if they're using an animator
 				if (shader->GetVertexShaderDefaultStatus() == (int)TTN_DefaultShaders::VERT_MORPH_ANIMATION_NO_COLOR
 					|| shader->GetVertexShaderDefaultStatus() == (int)TTN_DefaultShaders::VERT_MORPH_ANIMATION_COLOR) {
-					//try to get an animator component
-					if (Has<TTN_MorphAnimator>(entity)) {
-						shader->SetUniform("t", Get<TTN_MorphAnimator>(entity).getActiveAnimRef().getInterpolationParameter());
-					}
-					else
-						shader->SetUniform("t", 0.0f);
+					//the interpolation parameter, 0 if it has no animator
+					shader->SetUniform("t", packet.T);
 				}
 
-				//if they're using an albedo texture
-				if (shader->GetFragShaderDefaultStatus() == (int)TTN_DefaultShaders::FRAG_BLINN_PHONG_ALBEDO_ONLY
-					|| shader->GetFragShaderDefaultStatus() == (int)TTN_DefaultShaders::FRAG_BLINN_PHONG_ALBEDO_AND_SPECULAR)
+				//if they're using an albedo texture, and it's not read from the material buffer
+				if ((shader->GetFragShaderDefaultStatus() == (int)TTN_DefaultShaders::FRAG_BLINN_PHONG_ALBEDO_ONLY
+					|| shader->GetFragShaderDefaultStatus() == (int)TTN_DefaultShaders::FRAG_BLINN_PHONG_ALBEDO_AND_SPECULAR) && !usesMaterialBuffer)
 
 				{
 					//bind it so openGL can see it
-					renderer.GetMat()->GetAlbedo()->Bind(textureSlot);
+					material->GetAlbedo()->Bind(textureSlot);
 					//update the texture slot for future textures to use
 					textureSlot++;
 				}
 
-				//if they're using a specular map
-				if (shader->GetFragShaderDefaultStatus() == 5)
+				//if they're using a specular map, and it's not read from the material buffer
+				if (shader->GetFragShaderDefaultStatus() == 5 && !usesMaterialBuffer)
 
 					//if they're using a specular map
 					if (shader->GetFragShaderDefaultStatus() == (int)TTN_DefaultShaders::FRAG_BLINN_PHONG_ALBEDO_AND_SPECULAR)
 
 					{
 						//bind it so openGL can see it
-						renderer.GetMat()->GetSpecularMap()->Bind(textureSlot);
+						material->GetSpecularMap()->Bind(textureSlot);
 						//update the texture slot for future textures to use
 						textureSlot++;
 					}
@@ -550,11 +1173,11 @@ namespace Titan {
 				if (shader->GetFragShaderDefaultStatus() == (int)TTN_DefaultShaders::FRAG_SKYBOX)
 				{
 					//bind the skybox texture
-					renderer.GetMat()->GetSkybox()->Bind(textureSlot);
+					material->GetSkybox()->Bind(textureSlot);
 					//set the rotation uniform
 					shader->SetUniformMatrix("u_EnvironmentRotation", glm::mat3(glm::rotate(glm::mat4(1.0f), glm::radians(180.0f), glm::vec3(1, 0, 0))));
 					//set the skybox matrix uniform
-					shader->SetUniformMatrix("u_SkyboxMatrix", Get<TTN_Camera>(m_Cam).GetProj() * glm::mat4(glm::mat3(viewMat)));
+					shader->SetUniformMatrix("u_SkyboxMatrix", view.Projection * glm::mat4(glm::mat3(view.View)));
 				}
 			}
 			//otherwise send a default shinnies value
@@ -562,37 +1185,38 @@ namespace Titan {
 				shader->SetUniform("u_Shininess", 128.0f);
 			}
 
-			//if the entity has an animator
-			if (Has<TTN_MorphAnimator>(entity)) {
-				//set up the vao on the mesh properly
-				renderer.GetMesh()->SetUpVao(Get<TTN_MorphAnimator>(entity).getActiveAnimRef().getCurrentMeshIndex(),
-					Get<TTN_MorphAnimator>(entity).getActiveAnimRef().getNextMeshIndex());
+			//the default shaders find the object's material in the material buffer with it's index, which is the only material data they need per draw
+			if (materialBuffer && shader->GetVertexShaderDefaultStatus() != (int)TTN_DefaultShaders::NOT_DEFAULT)
+				shader->SetUniform("u_MaterialIndex", (int)materialIndex(material));
+
+			//set up the vao on the mesh, it's only built the first time
+			mesh->SetUpVao();
+
+			//morph animated objects that can be instanced start a new batch, it gets drawn once something that can't join it comes up
+			if (packet.Instanced) {
+				m_morphBatchMesh = mesh;
+				m_morphBatchShader = shader;
+				m_morphBatchMat = material;
+				addMorphInstance(packet, material);
+				continue;
 			}
-			//if it doesn't
-			else {
-				//set up the vao with both mesh indices on zero
-				renderer.GetMesh()->SetUpVao();
+
+			//other morph animated objects read the frames they're blending from the mesh's packed frame buffer
+			if (packet.Morph) {
+				mesh->BindFrames();
+				shader->SetUniform("u_UseInstances", 0);
+				shader->SetUniform("u_FrameVertexCount", mesh->GetVertCount());
+				//the animator's frames, or just the first frame if it has no animator
+				shader->SetUniform("u_CurrentFrame", packet.CurrentFrame);
+				shader->SetUniform("u_NextFrame", packet.NextFrame);
 			}
 
 			//and finish by rendering the mesh
-			renderer.Render(transform.GetGlobal(), vp);
-		});
-
-		//2D sprite rendering
-		//make a vector to store all the entities to render
-		std::vector<entt::entity> tempSpriteEntitiesToRender = std::vector<entt::entity>();
-		//go through every entity with a 2d renderer and a transform, addding them to the list of entities to render
-		auto render2DView = m_Registry->view<TTN_Transform, TTN_Renderer2D>();
-		for (entt::entity entity : render2DView) {
-			tempSpriteEntitiesToRender.push_back(entity);
+			TTN_Renderer::Render(mesh, shader, packet.Model, vp);
+			m_trianglesDrawn += mesh->GetTriangleCount();
 		}
-
-		//sort the entities by their z positions
-		mergeSortEntitiesZ(tempSpriteEntitiesToRender, 0, tempSpriteEntitiesToRender.size() - 1);
-
-		//and loop through, rendering them in reverse order
-		for (int i = tempSpriteEntitiesToRender.size() - 1; i >= 0; i--)
-			Get<TTN_Renderer2D>(tempSpriteEntitiesToRender[i]).Render(Get<TTN_Transform>(tempSpriteEntitiesToRender[i]).GetGlobal(), vp);
+		//draw whatever's left in the last batch
+		FlushMorphBatch(vp);
 	}
 
 	//sets wheter or not the scene should be rendered
@@ -651,6 +1275,8 @@ namespace Titan {
 	{
 		//clear all the collisions from the previous frame
 		collisions.clear();
+		//the next collision object in the pool to try
+		size_t pooled = 0;
 
 		int numManifolds = m_physicsWorld->getDispatcher()->getNumManifolds();
 		//iterate through all the manifolds
@@ -677,8 +1303,10 @@ namespace Titan {
 					glm::vec3 collisionLocation = (glm::vec3(location.getX(), location.getY(), location.getZ())
 						+ glm::vec3(location2.getX(), location2.getY(), location2.getZ())) * 0.5f;
 					
-					//and make a collision object
-					TTN_Collision::scolptr newCollision = TTN_Collision::Create();
+					//and fill in a collision object, reusing one from an earlier frame if nothing's still holding onto it
+					while (pooled < m_collisionPool.size() && m_collisionPool[pooled].use_count() > 1) pooled++;
+					if (pooled == m_collisionPool.size()) m_collisionPool.push_back(TTN_Collision::Create());
+					const TTN_Collision::scolptr& newCollision = m_collisionPool[pooled];
 					newCollision->SetBody1(static_cast<entt::entity>(reinterpret_cast<uint32_t>(b0->getUserPointer())));
 					newCollision->SetBody2(static_cast<entt::entity>(reinterpret_cast<uint32_t>(b1->getUserPointer())));
 					newCollision->SetCollisionPoint(collisionLocation);
@@ -691,10 +1319,175 @@ namespace Titan {
 							break;
 						}
 					}
-					//if it's a new collision then add to the list of collisions
-					if (shouldAdd) collisions.push_back(newCollision);
+					//if it's a new collision then add to the list of collisions, otherwise the object gets used for the next one
+					if (shouldAdd) {
+						collisions.push_back(newCollision);
+						pooled++;
+					}
+				}
+			}
+		}
+	}
+
+	//casts a ray through the physics world, returns true and fills in the closest hit if it hit anything
+	bool TTN_Scene::Raycast(glm::vec3 from, glm::vec3 to, TTN_RaycastHit& hit)
+	{
+		TTN_SpatialQuery query;
+		query.type = TTN_QueryType::RAYCAST;
+		query.start = from;
+		query.end = to;
+
+		TTN_QueryResult result = RunQuery(query);
+		if (result.hit) hit = result.closest;
+		return result.hit;
+	}
+
+	//gets all the entities whose physics bodies overlap a sphere
+	std::vector<entt::entity> TTN_Scene::SphereOverlap(glm::vec3 center, float radius)
+	{
+		TTN_SpatialQuery query;
+		query.type = TTN_QueryType::SPHERE_OVERLAP;
+		query.start = center;
+		query.radius = radius;
+
+		return RunQuery(query).entities;
+	}
+
+	//gets all the entities whose physics bodies overlap an axis aligned box
+	std::vector<entt::entity> TTN_Scene::BoxOverlap(glm::vec3 center, glm::vec3 halfExtents)
+	{
+		TTN_SpatialQuery query;
+		query.type = TTN_QueryType::BOX_OVERLAP;
+		query.start = center;
+		query.halfExtents = halfExtents;
+
+		return RunQuery(query).entities;
+	}
+
+	//sweeps a sphere through the physics world, returns true and fills in the closest hit if it hit anything
+	bool TTN_Scene::SweepSphere(glm::vec3 from, glm::vec3 to, float radius, TTN_RaycastHit& hit)
+	{
+		TTN_SpatialQuery query;
+		query.type = TTN_QueryType::SWEEP_SPHERE;
+		query.start = from;
+		query.end = to;
+		query.radius = radius;
+
+		TTN_QueryResult result = RunQuery(query);
+		if (result.hit) hit = result.closest;
+		return result.hit;
+	}
+
+	//runs a batch of queries across the job system's workers, the results are in the same order as the queries
+	std::vector<TTN_QueryResult> TTN_Scene::BatchQuery(const std::vector<TTN_SpatialQuery>& queries)
+	{
+		std::vector<TTN_QueryResult> results = std::vector<TTN_QueryResult>(queries.size());
+
+		//a few chunks per thread so faster threads can steal the leftovers, but small batches aren't worth splitting so each chunk gets at least a handful of queries
+		const size_t minQueriesPerChunk = 8;
+		size_t grainSize = std::max(minQueriesPerChunk, queries.size() / ((TTN_JobSystem::GetWorkerCount() + 1) * 4));
+
+		//each chunk writes only to it's own part of the results
+		TTN_JobSystem::ParallelFor(queries.size(), [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++)
+				results[i] = RunQuery(queries[i]);
+		}, grainSize);
+
+		return results;
+	}
+
+	//runs a single query, walks the broadphase trees to find candidates and then tests them against their actual boxes
+	TTN_QueryResult TTN_Scene::RunQuery(const TTN_SpatialQuery& query) const
+	{
+		TTN_QueryResult result;
+		//the scene always makes a dbvt broadphase, it stores the dynamic and static bodies in seperate trees
+		btDbvtBroadphase* broadphase = static_cast<btDbvtBroadphase*>(overlappingPairCache);
+
+		btVector3 start = btVector3(query.start.x, query.start.y, query.start.z);
+		btVector3 end = btVector3(query.end.x, query.end.y, query.end.z);
+		bool isCast = (query.type == TTN_QueryType::RAYCAST || query.type == TTN_QueryType::SWEEP_SPHERE);
+		//a cast that doesn't go anywhere is just an overlap at it's start
+		if (isCast && (end - start).length2() < SIMD_EPSILON) {
+			if (query.type == TTN_QueryType::RAYCAST) return result;
+			isCast = false;
+		}
+
+		//collect the candidate bodies from the broadphase
+		TTN_DbvtCollector candidates;
+		if (isCast) {
+			//setup the data the dbvt ray walk needs, the same way bullet's own broadphase ray test does
+			btVector3 rayDir = (end - start).normalized();
+			btVector3 rayDirInverse;
+			unsigned int signs[3];
+			for (int i = 0; i < 3; i++) {
+				rayDirInverse[i] = (rayDir[i] == btScalar(0.0f)) ? btScalar(BT_LARGE_FLOAT) : btScalar(1.0f) / rayDir[i];
+				signs[i] = rayDirInverse[i] < 0.0f;
+			}
+			btScalar lambdaMax = rayDir.dot(end - start);
+			//sweeps grow the nodes by the radius of the sphere
+			btVector3 expand = btVector3(query.radius, query.radius, query.radius);
+			if (query.type == TTN_QueryType::RAYCAST) expand.setZero();
+
+			//the stack is local so several queries can walk the trees at once
+			btAlignedObjectArray<const btDbvtNode*> stack;
+			for (int set = 0; set < 2; set++)
+				broadphase->m_sets[set].rayTestInternal(broadphase->m_sets[set].m_root, start, end, rayDirInverse, signs, lambdaMax,
+					-expand, expand, stack, candidates);
+		}
+		else {
+			//overlaps just find every leaf that touches the bounds of the query
+			btVector3 halfExtents = (query.type == TTN_QueryType::BOX_OVERLAP) ?
+				btVector3(query.halfExtents.x, query.halfExtents.y, query.halfExtents.z) : btVector3(query.radius, query.radius, query.radius);
+			btDbvtVolume volume = btDbvtVolume::FromCE(start, halfExtents);
+			for (int set = 0; set < 2; set++)
+				broadphase->m_sets[set].collideTV(broadphase->m_sets[set].m_root, volume, candidates);
+		}
+
+		//test the candidates against their actual boxes
+		for (const btCollisionObject* object : candidates.objects) {
+			btTransform trans;
+			btVector3 halfExtents;
+			GetObjectBox(object, trans, halfExtents);
+
+			if (isCast) {
+				//sweeps cast against the box grown by the radius, which is slightly generous around the edges and corners
+				if (query.type == TTN_QueryType::SWEEP_SPHERE) halfExtents += btVector3(query.radius, query.radius, query.radius);
+
+				btScalar fraction;
+				btVector3 normal;
+				if (SegmentVsBox(trans.invXform(start), trans.invXform(end), halfExtents, fraction, normal) &&
+					(!result.hit || fraction < result.closest.fraction)) {
+					//if it's the closest hit so far save it
+					btVector3 worldNormal = trans.getBasis() * normal;
+					btVector3 point = start.lerp(end, fraction) - worldNormal * ((query.type == TTN_QueryType::SWEEP_SPHERE) ? query.radius : 0.0f);
+
+					result.hit = true;
+					result.closest.entity = EntityFromObject(object);
+					result.closest.fraction = fraction;
+					result.closest.normal = glm::vec3(worldNormal.x(), worldNormal.y(), worldNormal.z());
+					result.closest.point = glm::vec3(point.x(), point.y(), point.z());
 				}
 			}
+			else {
+				bool overlaps = (query.type == TTN_QueryType::BOX_OVERLAP) ?
+					AabbVsBox(start, btVector3(query.halfExtents.x, query.halfExtents.y, query.halfExtents.z), trans, halfExtents) :
+					SphereVsBox(start, query.radius, trans, halfExtents);
+
+				if (overlaps) result.entities.push_back(EntityFromObject(object));
+			}
 		}
+
+		//a sweep that started overlapping something counts as hitting it right away
+		if (query.type == TTN_QueryType::SWEEP_SPHERE && !isCast && !result.entities.empty()) {
+			result.closest.entity = result.entities[0];
+			result.closest.point = query.start;
+			result.closest.fraction = 0.0f;
+			result.entities.clear();
+		}
+
+		//overlaps count as a hit if they found anything
+		if (!isCast && !result.entities.empty()) result.hit = true;
+
+		return result;
 	}
-}
\ No newline at end of file
+}
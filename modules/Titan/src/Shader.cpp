@@ -1,10 +1,12 @@
 //Titan Engine, by Atlas X Games
 // Shader.cpp - source file for the class that wraps around an openGL shader program
 
-//precompile header, this file uses logging, fstream, and sstream
+//precompile header, this file uses logging, string, fstream, and sstream
 #include "Titan/ttn_pch.h"
 //include the header
 #include "Titan/Shader.h"
+//include the texture base class, to check for bindless texture support
+#include "Titan/ITexture.h"
 
 namespace Titan {
 	//default constructor, makes an empty shader program
@@ -40,6 +42,17 @@ namespace Titan {
 				fragShaderTTNIdentity = 0;
 		}
 
+		//the default shaders read their materials from the material buffer when bindless textures are supported, so turn that on right after the version line
+		std::string source;
+		if (setDefault && TTN_ITexture::GetBindlessSupported()) {
+			source = sourceCode;
+			size_t versionEnd = source.find('\n');
+			if (versionEnd != std::string::npos) {
+				source.insert(versionEnd + 1, "#define TTN_BINDLESS\n");
+				sourceCode = source.c_str();
+			}
+		}
+
 		//Create the new shader steage (vs, fs, etc.)
 		GLuint handle = glCreateShader(shaderType);
 
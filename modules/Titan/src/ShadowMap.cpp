@@ -0,0 +1,368 @@
+//Titan Engine, by Atlas X Games
+// ShadowMap.cpp - source file for the class that renders cascaded shadow maps for the scene's directional light
+
+//precompile header, this file uses vector, array, and glm
+#include "Titan/ttn_pch.h"
+//include the header
+#include "Titan/ShadowMap.h"
+
+namespace Titan {
+	//mixes some bytes into a running FNV-1a hash
+	static void HashBytes(uint64_t& hash, const void* data, size_t size)
+	{
+		const unsigned char* bytes = (const unsigned char*)data;
+		for (size_t i = 0; i < size; i++) {
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+	}
+
+	//mixes everything about a caster that changes what it draws into a hash
+	static void HashCaster(uint64_t& hash, const TTN_ShadowCaster& caster)
+	{
+		HashBytes(hash, &caster.Id, sizeof(caster.Id));
+		HashBytes(hash, &caster.Model, sizeof(glm::mat4));
+		HashBytes(hash, &caster.CurrentFrame, sizeof(int));
+		HashBytes(hash, &caster.NextFrame, sizeof(int));
+		HashBytes(hash, &caster.T, sizeof(float));
+		//the mesh changes when the level of detail does
+		const TTN_Mesh* mesh = caster.Mesh.get();
+		HashBytes(hash, &mesh, sizeof(mesh));
+	}
+
+	//destructor
+	TTN_ShadowMap::~TTN_ShadowMap()
+	{
+		//delete the timer queries if they were made
+		if (m_queries[0][0] != 0) glDeleteQueries(2 * s_maxCascades, &m_queries[0][0]);
+	}
+
+	//sets the size of the atlas
+	void TTN_ShadowMap::SetResolution(unsigned atlasSize)
+	{
+		//keep it even so the tiles split cleanly
+		atlasSize = std::max(atlasSize - atlasSize % 2, 2u);
+		if (atlasSize == m_resolution) return;
+		m_resolution = atlasSize;
+
+		//remake the atlases at the new size next time they're drawn
+		m_atlas = nullptr;
+		m_staticAtlas = nullptr;
+		Invalidate();
+	}
+
+	//sets the number of cascades
+	void TTN_ShadowMap::SetCascadeCount(int count)
+	{
+		m_cascadeCount = std::clamp(count, 1, s_maxCascades);
+		Invalidate();
+	}
+
+	//forces every cascade to be redrawn
+	void TTN_ShadowMap::Invalidate()
+	{
+		m_signatures.fill(0);
+		m_staticSignatures.fill(0);
+	}
+
+	//creates the atlas and the depth shader
+	void TTN_ShadowMap::Init()
+	{
+		//the atlas is depth only, linear filtering lets the hardware do a 2x2 pcf on every comparison
+		m_atlas = TTN_Framebuffer::Create();
+		m_atlas->AddDepthTarget();
+		m_atlas->SetFilter(GL_LINEAR);
+		m_atlas->Init(m_resolution, m_resolution);
+
+		//make the depth texture a comparison texture so the shaders can use it as a sampler2DShadow
+		GLuint depthHandle = m_atlas->GetDepthTexture()->GetHandle();
+		glTextureParameteri(depthHandle, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+		glTextureParameteri(depthHandle, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+
+		//the static atlas is only ever copied from, so it doesn't need filtering or comparisons
+		m_staticAtlas = TTN_Framebuffer::Create();
+		m_staticAtlas->AddDepthTarget();
+		m_staticAtlas->Init(m_resolution, m_resolution);
+
+		//load the depth shader once
+		if (m_depthShader == nullptr) {
+			m_depthShader = TTN_Shader::Create();
+			m_depthShader->LoadShaderStageFromFile("shaders/ttn_shadow_depth_vert.glsl", GL_VERTEX_SHADER);
+			m_depthShader->LoadShaderStageFromFile("shaders/ttn_shadow_depth_frag.glsl", GL_FRAGMENT_SHADER);
+			m_depthShader->Link();
+		}
+
+		//and the timer queries
+		if (m_queries[0][0] == 0) glGenQueries(2 * s_maxCascades, &m_queries[0][0]);
+	}
+
+	//reads back the timer queries from two frames ago
+	void TTN_ShadowMap::ReadTimers()
+	{
+		for (int i = 0; i < s_maxCascades; i++) {
+			//cascades that weren't drawn didn't take any time
+			if (!m_queryPending[m_queryFrame][i]) {
+				m_gpuTimes[i] = 0.0f;
+				continue;
+			}
+
+			//two frames is almost always long enough for the result to be ready, so this rarely waits
+			GLuint64 nanoseconds = 0;
+			glGetQueryObjectui64v(m_queries[m_queryFrame][i], GL_QUERY_RESULT, &nanoseconds);
+			m_gpuTimes[i] = (float)nanoseconds / 1000000.0f;
+			m_queryPending[m_queryFrame][i] = false;
+		}
+	}
+
+	//fits the cascades and draws the ones that have changed
+	void TTN_ShadowMap::Render(const std::vector<TTN_ShadowCaster>& casters, glm::vec3 lightDirection, const glm::mat4& view, const glm::mat4& projection)
+	{
+		//the light has to point somewhere
+		if (glm::length(lightDirection) < 0.0001f) return;
+		lightDirection = glm::normalize(lightDirection);
+
+		if (m_atlas == nullptr) Init();
+
+		//swap the query buffers and read the results from the last time this buffer was used
+		m_queryFrame = 1 - m_queryFrame;
+		ReadTimers();
+
+		//unprojects a point from normalized device coordinates to view space
+		glm::mat4 inverseProj = glm::inverse(projection);
+		auto unproject = [&](glm::vec3 ndc) {
+			glm::vec4 point = inverseProj * glm::vec4(ndc, 1.0f);
+			return glm::vec3(point) / point.w;
+		};
+
+		//the four edges of the view frustum, these work for both perspective and orthographic cameras
+		glm::vec2 corners[4] = { glm::vec2(-1.0f, -1.0f), glm::vec2(1.0f, -1.0f), glm::vec2(-1.0f, 1.0f), glm::vec2(1.0f, 1.0f) };
+		glm::vec3 nearPoints[4], farPoints[4];
+		for (int i = 0; i < 4; i++) {
+			nearPoints[i] = unproject(glm::vec3(corners[i], -1.0f));
+			farPoints[i] = unproject(glm::vec3(corners[i], 1.0f));
+		}
+
+		//the depth range the cascades cover
+		float nearDepth = std::max(-unproject(glm::vec3(0.0f, 0.0f, -1.0f)).z, 0.01f);
+		float farDepth = std::max(std::min(-unproject(glm::vec3(0.0f, 0.0f, 1.0f)).z, m_maxDistance), nearDepth + 0.01f);
+
+		//split it, blending between even splits and logarithmic splits that give the near cascades more detail
+		for (int i = 0; i < m_cascadeCount; i++) {
+			float fraction = (float)(i + 1) / m_cascadeCount;
+			float uniformSplit = nearDepth + (farDepth - nearDepth) * fraction;
+			float logSplit = nearDepth * std::pow(farDepth / nearDepth, fraction);
+			m_splits[i] = glm::mix(uniformSplit, logSplit, m_splitLambda);
+		}
+
+		//rotation that looks down the light direction
+		glm::vec3 up = (std::abs(lightDirection.y) > 0.99f) ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+		glm::mat4 lightView = glm::lookAt(glm::vec3(0.0f), lightDirection, up);
+		glm::mat4 inverseView = glm::inverse(view);
+
+		//each cascade gets a quarter of the atlas
+		unsigned tileSize = m_resolution / 2;
+		//every caster's bounding box in light space, shared by all the cascades
+		std::vector<glm::vec3> lightMin(casters.size()), lightMax(casters.size());
+		glm::mat3 lightRotation = glm::mat3(lightView);
+		glm::mat3 absRotation = glm::mat3(glm::abs(lightRotation[0]), glm::abs(lightRotation[1]), glm::abs(lightRotation[2]));
+		for (size_t c = 0; c < casters.size(); c++) {
+			glm::vec3 center = lightRotation * ((casters[c].BoundsMin + casters[c].BoundsMax) * 0.5f);
+			glm::vec3 extents = absRotation * ((casters[c].BoundsMax - casters[c].BoundsMin) * 0.5f);
+			lightMin[c] = center - extents;
+			lightMax[c] = center + extents;
+		}
+
+		std::vector<size_t> visibleStatic, visibleDynamic;
+		visibleStatic.reserve(casters.size());
+		visibleDynamic.reserve(casters.size());
+		for (int i = 0; i < s_maxCascades; i++) {
+			m_cached[i] = false;
+			m_staticCached[i] = false;
+			if (i >= m_cascadeCount) {
+				m_casterCounts[i] = 0;
+				continue;
+			}
+
+			//find the corners of this slice of the view frustum in world space
+			float sliceNear = (i == 0) ? nearDepth : m_splits[i - 1];
+			float sliceFar = m_splits[i];
+			glm::vec3 sliceCorners[8];
+			glm::vec3 center = glm::vec3(0.0f);
+			for (int c = 0; c < 4; c++) {
+				float edgeNear = -nearPoints[c].z;
+				float edgeFar = -farPoints[c].z;
+				float range = (edgeFar - edgeNear != 0.0f) ? edgeFar - edgeNear : 1.0f;
+				sliceCorners[c * 2] = glm::vec3(inverseView * glm::vec4(glm::mix(nearPoints[c], farPoints[c], (sliceNear - edgeNear) / range), 1.0f));
+				sliceCorners[c * 2 + 1] = glm::vec3(inverseView * glm::vec4(glm::mix(nearPoints[c], farPoints[c], (sliceFar - edgeNear) / range), 1.0f));
+				center += sliceCorners[c * 2] + sliceCorners[c * 2 + 1];
+			}
+			center /= 8.0f;
+
+			//fit a sphere around the slice, a sphere keeps the same size as the camera turns so the shadows don't shimmer
+			float radius = 0.0f;
+			for (int c = 0; c < 8; c++) radius = std::max(radius, glm::length(sliceCorners[c] - center));
+			radius = std::ceil(radius * 16.0f) / 16.0f;
+
+			//snap the center to whole texels so the shadows don't crawl as the camera moves
+			float texelSize = (2.0f * radius) / tileSize;
+			m_texelSizes[i] = texelSize;
+			glm::vec3 lightCenter = lightRotation * center;
+			lightCenter.x = std::floor(lightCenter.x / texelSize) * texelSize;
+			lightCenter.y = std::floor(lightCenter.y / texelSize) * texelSize;
+
+			//the box the cascade covers in light space, extended towards the light so casters outside the view still cast into it
+			glm::vec3 boxMin = glm::vec3(lightCenter.x - radius, lightCenter.y - radius, lightCenter.z - radius);
+			glm::vec3 boxMax = glm::vec3(lightCenter.x + radius, lightCenter.y + radius, lightCenter.z + radius + m_casterDistance);
+			//light space looks down -z, so the near plane is at the highest z
+			glm::mat4 lightProj = glm::ortho(boxMin.x, boxMax.x, boxMin.y, boxMax.y, -boxMax.z, -boxMin.z);
+			m_lightMatrices[i] = lightProj * lightView;
+
+			//cull the casters to the cascade and hash everything that would change what gets drawn, static and moving casters seperately
+			visibleStatic.clear();
+			visibleDynamic.clear();
+			uint64_t staticSignature = 14695981039346656037ull;
+			uint64_t dynamicSignature = 14695981039346656037ull;
+			HashBytes(staticSignature, &m_lightMatrices[i], sizeof(glm::mat4));
+			for (size_t c = 0; c < casters.size(); c++) {
+				if (lightMax[c].x < boxMin.x || lightMin[c].x > boxMax.x ||
+					lightMax[c].y < boxMin.y || lightMin[c].y > boxMax.y ||
+					lightMax[c].z < boxMin.z || lightMin[c].z > boxMax.z)
+					continue;
+
+				if (casters[c].Static) {
+					visibleStatic.push_back(c);
+					HashCaster(staticSignature, casters[c]);
+				}
+				else {
+					visibleDynamic.push_back(c);
+					HashCaster(dynamicSignature, casters[c]);
+				}
+			}
+			//the whole tile changes if either set of casters does
+			uint64_t signature = staticSignature;
+			HashBytes(signature, &dynamicSignature, sizeof(dynamicSignature));
+			//0 is saved for cascades that have to be redrawn
+			if (staticSignature == 0) staticSignature = 1;
+			if (signature == 0) signature = 1;
+
+			//if nothing in the cascade has changed, keep what was drawn last time
+			if (signature == m_signatures[i]) {
+				m_cached[i] = true;
+				m_staticCached[i] = true;
+				continue;
+			}
+			m_signatures[i] = signature;
+			m_casterCounts[i] = visibleStatic.size() + visibleDynamic.size();
+
+			glBeginQuery(GL_TIME_ELAPSED, m_queries[m_queryFrame][i]);
+
+			//only redraw the static casters if they or the light have changed
+			if (staticSignature == m_staticSignatures[i])
+				m_staticCached[i] = true;
+			else {
+				m_staticSignatures[i] = staticSignature;
+				DrawCasters(m_staticAtlas, i, casters, visibleStatic, true);
+			}
+
+			//start the tile from the static casters' depth, and draw the moving ones over it
+			GLint tileX = (i % 2) * tileSize;
+			GLint tileY = (i / 2) * tileSize;
+			glCopyImageSubData(m_staticAtlas->GetDepthTexture()->GetHandle(), GL_TEXTURE_2D, 0, tileX, tileY, 0,
+				m_atlas->GetDepthTexture()->GetHandle(), GL_TEXTURE_2D, 0, tileX, tileY, 0, tileSize, tileSize, 1);
+			if (!visibleDynamic.empty()) DrawCasters(m_atlas, i, casters, visibleDynamic, false);
+
+			glEndQuery(GL_TIME_ELAPSED);
+			m_queryPending[m_queryFrame][i] = true;
+		}
+
+		m_atlas->Unbind();
+	}
+
+	//draws some of the casters into a cascade's tile
+	void TTN_ShadowMap::DrawCasters(const TTN_Framebuffer::sfboptr& atlas, int cascade, const std::vector<TTN_ShadowCaster>& casters,
+		const std::vector<size_t>& indices, bool clear)
+	{
+		//set the viewport to just this cascade's tile
+		unsigned tileSize = m_resolution / 2;
+		atlas->Bind();
+		GLint tileX = (cascade % 2) * tileSize;
+		GLint tileY = (cascade / 2) * tileSize;
+		glViewport(tileX, tileY, tileSize, tileSize);
+		if (clear) {
+			glEnable(GL_SCISSOR_TEST);
+			glScissor(tileX, tileY, tileSize, tileSize);
+			glClear(GL_DEPTH_BUFFER_BIT);
+			glDisable(GL_SCISSOR_TEST);
+		}
+
+		m_depthShader->Bind();
+		for (size_t c : indices) {
+			const TTN_ShadowCaster& caster = casters[c];
+			m_depthShader->SetUniformMatrix("MVP", m_lightMatrices[cascade] * caster.Model);
+			m_depthShader->SetUniformMatrix("NormalMat", glm::mat3(glm::transpose(glm::inverse(caster.Model))));
+			m_depthShader->SetUniform("t", caster.T);
+			m_depthShader->SetUniform("u_useHeightMap", (int)(caster.HeightMap != nullptr));
+			if (caster.HeightMap != nullptr) {
+				caster.HeightMap->Bind(0);
+				m_depthShader->SetUniform("u_influence", caster.HeightInfluence);
+			}
+
+			//animated casters read their frames from the packed frame buffer
+			bool morph = (caster.Mesh->GetFrameCount() > 1);
+			m_depthShader->SetUniform("u_Morph", (int)morph);
+			if (morph) {
+				caster.Mesh->BindFrames();
+				m_depthShader->SetUniform("u_CurrentFrame", caster.CurrentFrame);
+				m_depthShader->SetUniform("u_NextFrame", caster.NextFrame);
+				m_depthShader->SetUniform("u_FrameVertexCount", caster.Mesh->GetVertCount());
+			}
+
+			caster.Mesh->SetUpVao();
+			caster.Mesh->GetVAOPointer()->Render();
+		}
+		m_depthShader->UnBind();
+	}
+
+	//binds the atlas
+	void TTN_ShadowMap::Bind() const
+	{
+		if (m_atlas != nullptr) m_atlas->BindDepthAsTexture(s_atlasSlot);
+	}
+
+	//sets the uniforms for sampling the cascades
+	void TTN_ShadowMap::SetUniforms(TTN_Shader* shader) const
+	{
+		//this runs for every draw, so the names are only made once, most of them are too long to fit in a string without allocating
+		static const std::string numCascadesName = "u_NumCascades";
+		static const std::string matricesName = "u_ShadowMatrices[0]";
+		static const std::string splitsName = "u_CascadeSplits[0]";
+		static const std::string normalOffsetName = "u_ShadowNormalOffset[0]";
+		static const std::string texelSizeName = "u_ShadowTexelSize";
+
+		//if it's never been drawn there's nothing to sample
+		if (m_atlas == nullptr) {
+			shader->SetUniform(numCascadesName, 0);
+			return;
+		}
+
+		std::array<glm::mat4, s_maxCascades> matrices;
+		std::array<float, s_maxCascades> normalOffsets = { 0.0f, 0.0f, 0.0f, 0.0f };
+		for (int i = 0; i < m_cascadeCount; i++) {
+			//move from clip space to the cascade's tile of the atlas
+			glm::vec2 tileOffset = glm::vec2((float)(i % 2), (float)(i / 2)) * 0.5f;
+			glm::mat4 toAtlas = glm::translate(glm::mat4(1.0f), glm::vec3(tileOffset + glm::vec2(0.25f), 0.5f)) *
+				glm::scale(glm::mat4(1.0f), glm::vec3(0.25f, 0.25f, 0.5f));
+			matrices[i] = toAtlas * m_lightMatrices[i];
+
+			//push the sample point out along the normal by a few texels of the cascade
+			normalOffsets[i] = m_bias * m_texelSizes[i];
+		}
+
+		//the matrices go up as one array
+		shader->SetUniformMatrix(matricesName, matrices[0], false, m_cascadeCount);
+		shader->SetUniform(splitsName, m_splits[0], s_maxCascades);
+		shader->SetUniform(normalOffsetName, normalOffsets[0], s_maxCascades);
+		shader->SetUniform(numCascadesName, m_cascadeCount);
+		shader->SetUniform(texelSizeName, 1.0f / m_resolution);
+	}
+}
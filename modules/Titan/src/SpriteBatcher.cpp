@@ -0,0 +1,196 @@
+//Titan Engine, by Atlas X Games
+// SpriteBatcher.cpp - source file for the class that sorts 2D sprites and draws them in batches
+
+//precompile header, this file uses vector, cstring, and glm
+#include "Titan/ttn_pch.h"
+//include the header
+#include "Titan/SpriteBatcher.h"
+//include the profiler
+#include "Titan/Profiler.h"
+
+namespace Titan {
+	namespace {
+		//the corners of a sprite's quad and their uvs, two triangles
+		const glm::vec4 s_quadCorners[6] = {
+			glm::vec4(-0.5f, 0.5f, 0.0f, 1.0f),
+			glm::vec4(0.5f, -0.5f, 0.0f, 1.0f),
+			glm::vec4(-0.5f, -0.5f, 0.0f, 1.0f),
+			glm::vec4(-0.5f, 0.5f, 0.0f, 1.0f),
+			glm::vec4(0.5f, 0.5f, 0.0f, 1.0f),
+			glm::vec4(0.5f, -0.5f, 0.0f, 1.0f)
+		};
+		const glm::vec2 s_quadUvs[6] = {
+			glm::vec2(0.0f, 1.0f),
+			glm::vec2(1.0f, 0.0f),
+			glm::vec2(0.0f, 0.0f),
+			glm::vec2(0.0f, 1.0f),
+			glm::vec2(1.0f, 1.0f),
+			glm::vec2(1.0f, 0.0f)
+		};
+
+		//turns a float into an unsigned int that sorts in the same order
+		uint32_t SortableFloat(float value)
+		{
+			uint32_t bits;
+			std::memcpy(&bits, &value, sizeof(float));
+			//negative numbers get every bit flipped so they sort backwards, positive ones just get the sign bit set so they come after them
+			return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+		}
+	}
+
+	//sets up the shader and buffers
+	void TTN_SpriteBatcher::Init()
+	{
+		//the vertex buffer is refilled for every batch
+		s_vbo = TTN_VertexBuffer::Create(GL_STREAM_DRAW);
+		s_vbo->LoadData<TTN_SpriteVertex>(nullptr, 0);
+
+		s_vao = TTN_VertexArrayObject::Create();
+		s_vao->AddVertexBuffer(s_vbo, {
+			BufferAttribute(0, 3, GL_FLOAT, false, sizeof(TTN_SpriteVertex), offsetof(TTN_SpriteVertex, Position), AttribUsage::Position),
+			BufferAttribute(1, 2, GL_FLOAT, false, sizeof(TTN_SpriteVertex), offsetof(TTN_SpriteVertex, Uv), AttribUsage::Texture),
+			BufferAttribute(2, 4, GL_FLOAT, false, sizeof(TTN_SpriteVertex), offsetof(TTN_SpriteVertex, Color), AttribUsage::Color),
+			BufferAttribute(3, 1, GL_FLOAT, false, sizeof(TTN_SpriteVertex), offsetof(TTN_SpriteVertex, Texture), AttribUsage::User0)
+		});
+
+		//create and load the shader program
+		s_shader = TTN_Shader::Create();
+		s_shader->LoadShaderStageFromFile("shaders/ttn_sprite_batch_vert.glsl", GL_VERTEX_SHADER);
+		s_shader->LoadShaderStageFromFile("shaders/ttn_sprite_batch_frag.glsl", GL_FRAGMENT_SHADER);
+		s_shader->Link();
+
+		//the samplers always read from the first few slots, the textures are bound to them as each batch is drawn
+		int slots[s_maxTextures];
+		for (int i = 0; i < s_maxTextures; i++) slots[i] = i;
+		s_shader->Bind();
+		s_shader->SetUniform("s_Textures", slots[0], s_maxTextures);
+		s_shader->UnBind();
+	}
+
+	//starts collecting sprites
+	void TTN_SpriteBatcher::Begin(const glm::mat4& VP)
+	{
+		s_viewProjection = VP;
+		s_entries.clear();
+		s_keys.clear();
+	}
+
+	//adds a sprite
+	void TTN_SpriteBatcher::Submit(TTN_Texture2D* sprite, const glm::mat4& model, const glm::vec4& color, int layer)
+	{
+		//there's nothing to draw without a texture
+		if (sprite == nullptr) return;
+
+		//higher z values first so they're drawn back to front with depth testing on, then lower layers, then grouped by texture so sprites with the same texture end up next to each other
+		//the layer only breaks ties, putting it first would draw a far sprite on a high layer over nearer ones and the depth test would cut holes in it
+		//sprites from the same atlas share it's page, so they group together
+		uint64_t layerBits = (uint64_t)(uint16_t)(std::clamp(layer, -32768, 32767) + 32768);
+		uint64_t depthBits = (uint64_t)(~SortableFloat(model[3].z));
+		uint64_t textureBits = (uint64_t)(sprite->GetAtlasPage()->GetHandle() & 0xFFFF);
+
+		TTN_SpriteKey key;
+		key.Key = (depthBits << 32) | (layerBits << 16) | textureBits;
+		key.Index = (uint32_t)s_entries.size();
+		s_keys.push_back(key);
+		s_entries.push_back({ sprite, model, color });
+	}
+
+	//sorts and draws the sprites
+	void TTN_SpriteBatcher::End()
+	{
+		TTN_PROFILE_SCOPE("SpriteBatcher");
+		s_drawCalls = 0;
+		s_spritesDrawn = 0;
+		if (s_shader == nullptr || s_entries.empty()) return;
+
+		RadixSort();
+
+		//build the batches in sorted order
+		s_vertices.clear();
+		s_batchTextureCount = 0;
+		for (const TTN_SpriteKey& key : s_keys) {
+			const TTN_SpriteEntry& entry = s_entries[key.Index];
+			//the texture that actually gets bound, the page if the sprite's an atlas region
+			TTN_Texture2D* texture = entry.Sprite->GetAtlasPage();
+			const glm::vec4& uvRect = entry.Sprite->GetUVRect();
+
+			//find the texture's slot in the batch, if it isn't in it and every slot is taken then the batch has to be drawn first
+			int slot = 0;
+			while (slot < s_batchTextureCount && s_batchTextures[slot] != texture) slot++;
+			if (slot == s_maxTextures) {
+				Flush();
+				slot = 0;
+			}
+			if (slot == s_batchTextureCount) s_batchTextures[s_batchTextureCount++] = texture;
+
+			//add the quad, already in world space so the whole batch shares one matrix
+			for (int i = 0; i < 6; i++) {
+				TTN_SpriteVertex vertex;
+				vertex.Position = glm::vec3(entry.Model * s_quadCorners[i]);
+				vertex.Uv = glm::vec2(uvRect.x, uvRect.y) + s_quadUvs[i] * glm::vec2(uvRect.z, uvRect.w);
+				vertex.Color = entry.Color;
+				vertex.Texture = (float)slot;
+				s_vertices.push_back(vertex);
+			}
+			s_spritesDrawn++;
+		}
+
+		//draw whatever's left
+		Flush();
+	}
+
+	//sorts the keys
+	void TTN_SpriteBatcher::RadixSort()
+	{
+		s_sortScratch.resize(s_keys.size());
+		std::vector<TTN_SpriteKey>* source = &s_keys;
+		std::vector<TTN_SpriteKey>* destination = &s_sortScratch;
+
+		for (int shift = 0; shift < 64; shift += 8) {
+			//count how many keys have each value of this byte
+			size_t counts[256] = { 0 };
+			for (const TTN_SpriteKey& key : *source) counts[(key.Key >> shift) & 0xFF]++;
+
+			//if they all have the same value this pass wouldn't move anything
+			if (counts[((*source)[0].Key >> shift) & 0xFF] == source->size()) continue;
+
+			//turn the counts into where each value starts
+			size_t offset = 0;
+			for (int i = 0; i < 256; i++) {
+				size_t count = counts[i];
+				counts[i] = offset;
+				offset += count;
+			}
+
+			//move the keys over in order, keys with the same byte keep their order so the earlier passes aren't undone
+			for (const TTN_SpriteKey& key : *source) (*destination)[counts[(key.Key >> shift) & 0xFF]++] = key;
+			std::swap(source, destination);
+		}
+
+		//make sure the sorted keys end up in s_keys
+		if (source != &s_keys) s_keys.swap(s_sortScratch);
+	}
+
+	//draws the current batch
+	void TTN_SpriteBatcher::Flush()
+	{
+		if (s_vertices.empty()) return;
+
+		//stream the quads into the vertex buffer
+		s_vbo->LoadData(s_vertices.data(), s_vertices.size());
+
+		//bind the shader and the batch's textures
+		s_shader->Bind();
+		s_shader->SetUniformMatrix("u_ViewProjection", s_viewProjection);
+		for (int i = 0; i < s_batchTextureCount; i++) s_batchTextures[i]->Bind(i);
+
+		//and draw every quad at once
+		s_vao->Render(s_vertices.size());
+		s_shader->UnBind();
+		s_drawCalls++;
+
+		//start the next batch
+		s_vertices.clear();
+		s_batchTextureCount = 0;
+	}
+}
@@ -25,13 +25,23 @@ namespace Titan {
 	}
 
 	TTN_Texture2DData::st2ddptr TTN_Texture2DData::LoadFromFile(const std::string& file, bool flipped, bool forceRgba)
+	{
+		SetFlipOnLoad(flipped);
+		return DecodeFile(file, forceRgba);
+	}
+
+	void TTN_Texture2DData::SetFlipOnLoad(bool flipped)
+	{
+		stbi_set_flip_vertically_on_load(flipped);
+	}
+
+	TTN_Texture2DData::st2ddptr TTN_Texture2DData::DecodeFile(const std::string& file, bool forceRgba)
 	{
 		// Variables that will store properties about our image
 		int width, height, numChannels;
 		const int targetChannels = forceRgba ? 4 : 0;
 
-		// Use STBI to load the image
-		stbi_set_flip_vertically_on_load(flipped);
+		// Use STBI to load the image, with whatever flip setting it already has
 		uint8_t* data = stbi_load(file.c_str(), &width, &height, &numChannels, targetChannels);
 
 		// If we could not load any data, warn and return null
@@ -100,6 +110,33 @@ namespace Titan {
 		RecreateTexture();
 	}
 
+	//destructor
+	TTN_Texture2D::~TTN_Texture2D()
+	{
+		//a region shares it's page's handle, so clear it before the base class deletes it
+		if (m_atlasPage != nullptr) {
+			_handle = 0;
+			_bindlessHandle = 0;
+		}
+	}
+
+	//creates a region of an atlas page
+	TTN_Texture2D::st2dptr TTN_Texture2D::CreateAtlasRegion(const st2dptr& page, const glm::vec4& uvRect, uint32_t width, uint32_t height)
+	{
+		//make an empty texture so no openGL texture gets created for it
+		st2dptr region = CreateEmpty();
+		region->m_atlasPage = page;
+		region->m_uvRect = uvRect;
+		//it has the page's settings but the region's size
+		region->m_data = page->m_data;
+		region->m_data.width = width;
+		region->m_data.height = height;
+		region->m_data.data = nullptr;
+		//and binds the page's texture
+		region->_handle = page->_handle;
+		return region;
+	}
+
 	//loads a texture in from a file
 	TTN_Texture2D::st2dptr TTN_Texture2D::LoadFromFile(const std::string& fileName, bool flipped, bool forceRgba)
 	{
@@ -192,6 +229,12 @@ namespace Titan {
 	void TTN_Texture2D::RecreateTexture()
 	{
 		if (_handle != 0) {
+			//the bindless handle goes with the old texture, so anything that saved it has to get the new one
+			if (_bindlessHandle != 0) {
+				if (glIsTextureHandleResidentARB(_bindlessHandle)) glMakeTextureHandleNonResidentARB(_bindlessHandle);
+				_bindlessHandle = 0;
+				s_handleGeneration++;
+			}
 			glDeleteTextures(1, &_handle);
 			_handle = 0;
 		}
@@ -0,0 +1,292 @@
+//Titan Engine, by Atlas X Games
+// TextureAtlas.cpp - source file for the class that packs many small images into a few large textures
+
+//precompile header, this file uses string, vector, unordered_map, memory, filesystem, fstream, and cstring
+#include "Titan/ttn_pch.h"
+//include the header
+#include "Titan/TextureAtlas.h"
+
+//stb's skyline rectangle packer, and it's image writer for the cached pages
+#include <stb_rect_pack.h>
+#include <stb_image_write.h>
+
+//cereal, the cache's layout is written with the portable binary archive
+#include <cereal/archives/portable_binary.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/common.hpp>
+
+namespace Titan {
+	namespace {
+		//identifies a cache file, and the version of it's layout
+		const uint32_t s_cacheMagic = 0x4C545441; //"ATTL"
+		const uint32_t s_cacheVersion = 1;
+
+		//gets the size and last write time of a file, so a cache can tell if an image has changed
+		bool GetFileStamp(const std::string& file, uint64_t& size, int64_t& time)
+		{
+			std::error_code error;
+			size = (uint64_t)std::filesystem::file_size(file, error);
+			if (error) return false;
+			time = (int64_t)std::filesystem::last_write_time(file, error).time_since_epoch().count();
+			return !error;
+		}
+
+		//gets the file a cached page is saved in
+		std::string GetPagePath(const std::string& cachePath, size_t page)
+		{
+			return cachePath + "_" + std::to_string(page) + ".png";
+		}
+	}
+
+	//packs the images
+	bool TTN_TextureAtlas::Build(const std::vector<std::pair<std::string, std::string>>& images, const std::string& cachePath)
+	{
+		m_pages.clear();
+		m_regions.clear();
+
+		std::vector<std::vector<uint8_t>> pixels;
+		std::vector<glm::ivec2> sizes;
+		std::vector<TTN_AtlasRegion> placements;
+
+		//if the images haven't changed since they were last packed, just load the packed pages
+		if (!cachePath.empty() && LoadCache(cachePath, images, pixels, sizes, placements)) {
+			CreateTextures(pixels, sizes, placements);
+			LOG_INFO("Loaded {} images in {} atlas pages from {}", placements.size(), sizes.size(), cachePath);
+			return true;
+		}
+
+		//load every image as rgba, and make a rectangle for it with room for the padding
+		std::vector<TTN_Texture2DData::st2ddptr> data(images.size());
+		std::vector<stbrp_rect> rects;
+		rects.reserve(images.size());
+		bool loadedAll = true;
+		for (size_t i = 0; i < images.size(); i++) {
+			data[i] = TTN_Texture2DData::LoadFromFile(images[i].second, true, true);
+			if (data[i] == nullptr) {
+				LOG_ERROR("Could not load {} into a texture atlas", images[i].second);
+				loadedAll = false;
+				continue;
+			}
+
+			int width = (int)data[i]->GetWidth() + 2 * s_padding;
+			int height = (int)data[i]->GetHeight() + 2 * s_padding;
+			if (width > s_maxPageSize || height > s_maxPageSize) {
+				LOG_ERROR("{} is too big to fit in a texture atlas page", images[i].second);
+				loadedAll = false;
+				continue;
+			}
+
+			stbrp_rect rect = {};
+			rect.id = (int)i;
+			rect.w = (stbrp_coord)width;
+			rect.h = (stbrp_coord)height;
+			rects.push_back(rect);
+		}
+
+		//pack as many as will fit on a page, and start a new page for the rest until they're all placed
+		std::vector<stbrp_node> nodes(s_maxPageSize);
+		std::vector<int> sources;
+		while (!rects.empty()) {
+			stbrp_context context;
+			stbrp_init_target(&context, s_maxPageSize, s_maxPageSize, nodes.data(), (int)nodes.size());
+			stbrp_pack_rects(&context, rects.data(), (int)rects.size());
+
+			//the page only needs to be big enough for what went on it
+			int page = (int)sizes.size();
+			glm::ivec2 used = glm::ivec2(0);
+			std::vector<stbrp_rect> leftover;
+			for (const stbrp_rect& rect : rects) {
+				if (!rect.was_packed) {
+					leftover.push_back(rect);
+					continue;
+				}
+
+				const TTN_Texture2DData::st2ddptr& image = data[rect.id];
+				placements.push_back({ images[rect.id].first, page, rect.x + s_padding, rect.y + s_padding,
+					(int)image->GetWidth(), (int)image->GetHeight() });
+				sources.push_back(rect.id);
+				used = glm::max(used, glm::ivec2(rect.x + rect.w, rect.y + rect.h));
+			}
+
+			//every rect fits on an empty page, so this should never happen, but make sure it can't loop forever
+			if (leftover.size() == rects.size()) {
+				LOG_ERROR("Could not pack the remaining {} images into a texture atlas page", leftover.size());
+				loadedAll = false;
+				break;
+			}
+
+			sizes.push_back(used);
+			rects.swap(leftover);
+		}
+
+		//copy the images into the pages
+		pixels.resize(sizes.size());
+		for (size_t i = 0; i < sizes.size(); i++) pixels[i].assign((size_t)sizes[i].x * sizes[i].y * 4, 0);
+		for (size_t i = 0; i < placements.size(); i++) {
+			const TTN_AtlasRegion& placement = placements[i];
+			const uint8_t* source = static_cast<const uint8_t*>(data[sources[i]]->GetDataPtr());
+			std::vector<uint8_t>& page = pixels[placement.Page];
+			int pageWidth = sizes[placement.Page].x;
+
+			//every row and column in the padding is a copy of the nearest edge of the image
+			for (int y = -s_padding; y < placement.Height + s_padding; y++) {
+				const uint8_t* sourceRow = source + (size_t)std::clamp(y, 0, placement.Height - 1) * placement.Width * 4;
+				uint8_t* row = page.data() + ((size_t)(placement.Y + y) * pageWidth + placement.X) * 4;
+
+				std::memcpy(row, sourceRow, (size_t)placement.Width * 4);
+				for (int x = 1; x <= s_padding; x++) {
+					std::memcpy(row - x * 4, sourceRow, 4);
+					std::memcpy(row + (placement.Width + x - 1) * 4, sourceRow + (placement.Width - 1) * 4, 4);
+				}
+			}
+		}
+
+		CreateTextures(pixels, sizes, placements);
+		LOG_INFO("Packed {} images into {} atlas pages", placements.size(), sizes.size());
+
+		//only cache a complete atlas, so a missing image gets tried again next time
+		if (!cachePath.empty() && loadedAll) SaveCache(cachePath, images, pixels, sizes, placements);
+
+		return loadedAll;
+	}
+
+	//gets the region for an image
+	TTN_Texture2D::st2dptr TTN_TextureAtlas::GetRegion(const std::string& accessName) const
+	{
+		auto it = m_regions.find(accessName);
+		return (it != m_regions.end()) ? it->second : nullptr;
+	}
+
+	//makes the openGL textures for the pages, and the regions in them
+	void TTN_TextureAtlas::CreateTextures(const std::vector<std::vector<uint8_t>>& pixels, const std::vector<glm::ivec2>& sizes, const std::vector<TTN_AtlasRegion>& placements)
+	{
+		for (size_t i = 0; i < sizes.size(); i++) {
+			//the pages are for sprites, so they're clamped and don't get mipmaps that would blend neighbouring images together
+			TTN_Texture2DDesc desc;
+			desc.width = (uint32_t)sizes[i].x;
+			desc.height = (uint32_t)sizes[i].y;
+			desc.format = Texture_Internal_Format::RGBA8;
+			desc.horiWrapMode = Texture_Wrap_Mode::ClampToEdge;
+			desc.vertWrapMode = Texture_Wrap_Mode::ClampToEdge;
+			desc.minificationFilter = Texture_Min_Filter::Min_Linear;
+			desc.GenerateMipMaps = false;
+			TTN_Texture2D::st2dptr page = std::make_shared<TTN_Texture2D>(desc);
+
+			TTN_Texture2DData::st2ddptr data = std::make_shared<TTN_Texture2DData>(desc.width, desc.height, Texture_Pixel_Format::RGBA,
+				Texture_Pixel_Data_Type::UByte, (void*)pixels[i].data(), Texture_Internal_Format::RGBA8);
+			data->DebugName = "Atlas page " + std::to_string(i);
+			page->LoadData(data);
+
+			m_pages.push_back(page);
+		}
+
+		//the regions' uv rects are in the page's uvs, the images were loaded flipped so row 0 of the page is the bottom of the texture
+		for (const TTN_AtlasRegion& placement : placements) {
+			glm::vec2 pageSize = glm::vec2(sizes[placement.Page]);
+			glm::vec4 uvRect = glm::vec4(placement.X / pageSize.x, placement.Y / pageSize.y, placement.Width / pageSize.x, placement.Height / pageSize.y);
+			m_regions[placement.AccessName] = TTN_Texture2D::CreateAtlasRegion(m_pages[placement.Page], uvRect, (uint32_t)placement.Width, (uint32_t)placement.Height);
+		}
+	}
+
+	//saves the packed pages
+	void TTN_TextureAtlas::SaveCache(const std::string& cachePath, const std::vector<std::pair<std::string, std::string>>& images,
+		const std::vector<std::vector<uint8_t>>& pixels, const std::vector<glm::ivec2>& sizes, const std::vector<TTN_AtlasRegion>& placements)
+	{
+		std::error_code error;
+		std::filesystem::path parent = std::filesystem::path(cachePath).parent_path();
+		if (!parent.empty()) std::filesystem::create_directories(parent, error);
+
+		//the pages are saved as pngs the right way up, so they can be looked at
+		stbi_flip_vertically_on_write(1);
+		for (size_t i = 0; i < sizes.size(); i++) {
+			if (!stbi_write_png(GetPagePath(cachePath, i).c_str(), sizes[i].x, sizes[i].y, 4, pixels[i].data(), sizes[i].x * 4)) {
+				LOG_WARN("Could not save atlas page {}", GetPagePath(cachePath, i));
+				stbi_flip_vertically_on_write(0);
+				return;
+			}
+		}
+		stbi_flip_vertically_on_write(0);
+
+		std::ofstream file(cachePath + ".atlas", std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!file.is_open()) {
+			LOG_WARN("Could not save the texture atlas cache {}", cachePath);
+			return;
+		}
+		cereal::PortableBinaryOutputArchive archive(file);
+
+		//the images and their stamps, so it can tell when it's out of date
+		archive(s_cacheMagic, s_cacheVersion, (uint32_t)images.size());
+		for (const auto& image : images) {
+			uint64_t size = 0;
+			int64_t time = 0;
+			GetFileStamp(image.second, size, time);
+			archive(image.first, image.second, size, time);
+		}
+
+		//the pages and where every image is in them
+		archive((uint32_t)sizes.size());
+		for (const glm::ivec2& size : sizes) archive(size.x, size.y);
+		archive((uint32_t)placements.size());
+		for (const TTN_AtlasRegion& placement : placements)
+			archive(placement.AccessName, placement.Page, placement.X, placement.Y, placement.Width, placement.Height);
+	}
+
+	//loads the cache back
+	bool TTN_TextureAtlas::LoadCache(const std::string& cachePath, const std::vector<std::pair<std::string, std::string>>& images,
+		std::vector<std::vector<uint8_t>>& pixels, std::vector<glm::ivec2>& sizes, std::vector<TTN_AtlasRegion>& placements)
+	{
+		std::ifstream file(cachePath + ".atlas", std::ios::in | std::ios::binary);
+		if (!file.is_open()) return false;
+
+		try {
+			cereal::PortableBinaryInputArchive archive(file);
+
+			//make sure it's a cache of the same images, and that none of them have changed
+			uint32_t magic = 0, version = 0, imageCount = 0;
+			archive(magic, version, imageCount);
+			if (magic != s_cacheMagic || version != s_cacheVersion || imageCount != images.size()) return false;
+			for (const auto& image : images) {
+				std::string accessName, fileName;
+				uint64_t cachedSize = 0, size = 0;
+				int64_t cachedTime = 0, time = 0;
+				archive(accessName, fileName, cachedSize, cachedTime);
+				if (accessName != image.first || fileName != image.second) return false;
+				if (!GetFileStamp(image.second, size, time) || size != cachedSize || time != cachedTime) return false;
+			}
+
+			uint32_t pageCount = 0;
+			archive(pageCount);
+			sizes.resize(pageCount);
+			for (glm::ivec2& size : sizes) archive(size.x, size.y);
+
+			uint32_t placementCount = 0;
+			archive(placementCount);
+			placements.resize(placementCount);
+			for (TTN_AtlasRegion& placement : placements)
+				archive(placement.AccessName, placement.Page, placement.X, placement.Y, placement.Width, placement.Height);
+		}
+		catch (cereal::Exception&) {
+			LOG_WARN("The texture atlas cache {} is corrupt, repacking it", cachePath);
+			sizes.clear();
+			placements.clear();
+			return false;
+		}
+
+		//load the pages, they're only opened once the cache is known to be good
+		pixels.resize(sizes.size());
+		for (size_t i = 0; i < sizes.size(); i++) {
+			TTN_Texture2DData::st2ddptr page = TTN_Texture2DData::LoadFromFile(GetPagePath(cachePath, i), true, true);
+			if (page == nullptr || (int)page->GetWidth() != sizes[i].x || (int)page->GetHeight() != sizes[i].y) {
+				pixels.clear();
+				sizes.clear();
+				placements.clear();
+				return false;
+			}
+
+			const uint8_t* data = static_cast<const uint8_t*>(page->GetDataPtr());
+			pixels[i].assign(data, data + page->GetDataSize());
+		}
+
+		return true;
+	}
+}
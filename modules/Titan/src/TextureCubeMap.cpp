@@ -2,7 +2,7 @@
 // Texture2D.cpp - source file for the class that represents 2d texture images
 
 
-//precompile header, this file uses stb_image.h, filesystem, and memory
+//precompile header, this file uses stb_image.h, filesystem, fstream, and memory
 #include "Titan/ttn_pch.h"
 //include the header
 #include "Titan/TextureCubeMap.h"
@@ -43,7 +43,7 @@ namespace Titan {
 		return result;
 	}
 
-	TTN_TextureCubeMapData::stcmdptr TTN_TextureCubeMapData::LoadFromImages(const std::string& rootImagePath)
+	std::vector<std::string> TTN_TextureCubeMapData::GetFacePaths(const std::string& rootImagePath)
 	{
 		namespace fs = std::filesystem;
 		fs::path imagePath = fs::path(rootImagePath);
@@ -60,20 +60,37 @@ namespace Titan {
 			"_neg_z"
 		};
 
+		std::vector<std::string> paths;
+		for (int ix = 0; ix < 6; ix++) {
+			fs::path facePath = rootFile;
+			facePath += PATHS[ix];
+			facePath += extension;
+			paths.push_back(facePath.string());
+		}
+
+		return paths;
+	}
+
+	TTN_TextureCubeMapData::stcmdptr TTN_TextureCubeMapData::LoadFromImages(const std::string& rootImagePath)
+	{
+		std::vector<std::string> paths = GetFacePaths(rootImagePath);
+
 		std::vector<TTN_Texture2DData::st2ddptr> data;
 		data.resize(6);
 
-		for (int ix = 0; ix < 6; ix++) {
-			fs::path imagePath = rootFile;
-			imagePath += PATHS[ix];
-			imagePath += extension;
-			if (fs::exists(imagePath)) {
-				data[ix] = TTN_Texture2DData::LoadFromFile(imagePath.string());
+		// Decoding is by far the slowest part, so decode each face on it's own job
+		// stbi's flip flag is global, so it's set once here and the jobs leave it alone instead of writing it while the others decode
+		TTN_Texture2DData::SetFlipOnLoad(true);
+		TTN_JobSystem::ParallelFor(6, [&](size_t begin, size_t end) {
+			for (size_t ix = begin; ix < end; ix++) {
+				if (std::filesystem::exists(paths[ix])) {
+					data[ix] = TTN_Texture2DData::DecodeFile(paths[ix]);
+				}
+				else {
+					LOG_WARN("Image \"{}\" could not be found!", paths[ix]);
+				}
 			}
-			else {
-				LOG_WARN("Image \"{}\" could not be found!", imagePath.string());
-			}
-		}
+		}, 1);
 
 		return CreateFromImages(data);
 	}
@@ -110,8 +127,15 @@ namespace Titan {
 	//loads from data
 	void TTN_TextureCubeMap::LoadData(const TTN_TextureCubeMapData::stcmdptr& data)
 	{
+		m_pixelFormat = data->GetPixelFormat();
+		m_pixelType = data->GetPixelType();
+
 		if (m_data.Size != data->GetSize()) {
 			m_data.Size = data->GetSize();
+			// If it's going to generate mips it needs storage for all of them
+			if (m_data.GenerateMipMaps) {
+				m_data.MipLevels = 1 + (uint32_t)std::floor(std::log2((float)m_data.Size));
+			}
 			if (m_data.Format == Texture_Internal_Format::Interal_Format_Unknown) {
 				m_data.Format = data->GetRecommendedInternalFormat();
 			}
@@ -138,12 +162,147 @@ namespace Titan {
 	//loads from 6 images
 	TTN_TextureCubeMap::stcmptr TTN_TextureCubeMap::LoadFromImages(const std::string& filePath)
 	{
+		namespace fs = std::filesystem;
+
+		//if there's a baked cubemap that's newer than every face, load that instead
+		std::string bakedPath = GetBakedPath(filePath);
+		std::error_code error;
+		if (fs::exists(bakedPath, error)) {
+			auto bakedTime = fs::last_write_time(bakedPath, error);
+			bool upToDate = !error;
+			for (auto& facePath : TTN_TextureCubeMapData::GetFacePaths(filePath)) {
+				if (fs::exists(facePath, error) && fs::last_write_time(facePath, error) > bakedTime) upToDate = false;
+			}
+
+			if (upToDate) {
+				TTN_TextureCubeMap::stcmptr baked = LoadBaked(bakedPath);
+				if (baked != nullptr) return baked;
+			}
+		}
+
+		//otherwise decode the images
 		TTN_TextureCubeMapData::stcmdptr data = TTN_TextureCubeMapData::LoadFromImages(filePath);
 		TTN_TextureCubeMap::stcmptr result = TTN_TextureCubeMap::Create();
+
+		//if it's going to be baked, generate the mips now so they get saved with it
+		if (s_bakeOnLoad) {
+			result->m_data.GenerateMipMaps = true;
+			result->m_data.MinificationFilter = Texture_Min_Filter::LinearMipLinear;
+		}
 		result->LoadData(data);
+
+		if (s_bakeOnLoad) {
+			result->SaveBaked(bakedPath);
+		}
+
 		return result;
 	}
 
+	//the header at the start of a baked cubemap
+	struct TTN_BakedCubeMapHeader {
+		char     Magic[4];
+		uint32_t Version;
+		uint32_t Size;
+		uint32_t MipLevels;
+		uint32_t InternalFormat;
+		uint32_t PixelFormat;
+		uint32_t PixelType;
+	};
+
+	//gets the path of the baked cubemap
+	std::string TTN_TextureCubeMap::GetBakedPath(const std::string& rootImagePath)
+	{
+		std::filesystem::path path = std::filesystem::path(rootImagePath);
+		path.replace_extension(".ttncube");
+		return path.string();
+	}
+
+	//loads a baked cubemap
+	TTN_TextureCubeMap::stcmptr TTN_TextureCubeMap::LoadBaked(const std::string& filePath)
+	{
+		std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+		if (!file.is_open()) return nullptr;
+		size_t fileSize = (size_t)file.tellg();
+		file.seekg(0);
+
+		//read the header and check it
+		TTN_BakedCubeMapHeader header;
+		file.read(reinterpret_cast<char*>(&header), sizeof(header));
+		if (!file || std::string(header.Magic, 4) != "TCUB" || header.Version != 1 || header.Size == 0 || header.MipLevels == 0) {
+			LOG_WARN("Baked cubemap \"{}\" is invalid, ignoring it", filePath);
+			return nullptr;
+		}
+
+		//read every face of every mip in a single read
+		std::vector<char> payload = std::vector<char>(fileSize - sizeof(header));
+		file.read(payload.data(), payload.size());
+		if (!file) return nullptr;
+
+		//make the texture with storage for every mip
+		TTN_TextureCubeMap::stcmptr result = TTN_TextureCubeMap::Create();
+		result->m_data.Size = header.Size;
+		result->m_data.MipLevels = header.MipLevels;
+		result->m_data.Format = (Texture_Internal_Format)header.InternalFormat;
+		result->m_data.MinificationFilter = (header.MipLevels > 1) ? Texture_Min_Filter::LinearMipLinear : Texture_Min_Filter::Min_Linear;
+		result->m_pixelFormat = (Texture_Pixel_Format)header.PixelFormat;
+		result->m_pixelType = (Texture_Pixel_Data_Type)header.PixelType;
+		result->RecreateTexture();
+
+		//upload all 6 faces of each mip with one call per level, the rows are tightly packed
+		size_t texelSize = GetTexelSize(result->m_pixelFormat, result->m_pixelType);
+		size_t offset = 0;
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		for (uint32_t level = 0; level < header.MipLevels; level++) {
+			uint32_t levelSize = std::max(1u, header.Size >> level);
+			size_t levelBytes = (size_t)levelSize * levelSize * texelSize * 6;
+			if (offset + levelBytes > payload.size()) {
+				LOG_WARN("Baked cubemap \"{}\" is truncated, ignoring it", filePath);
+				glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+				return nullptr;
+			}
+
+			glTextureSubImage3D(result->_handle, level, 0, 0, 0, levelSize, levelSize, 6, result->m_pixelFormat, result->m_pixelType, payload.data() + offset);
+			offset += levelBytes;
+		}
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+		return result;
+	}
+
+	//saves the texture as a baked cubemap
+	bool TTN_TextureCubeMap::SaveBaked(const std::string& filePath) const
+	{
+		if (_handle == 0 || m_data.Size == 0) return false;
+
+		std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+		//if it can't be written (like a read only folder) it just loads from the images next time
+		if (!file.is_open()) return false;
+
+		TTN_BakedCubeMapHeader header;
+		memcpy(header.Magic, "TCUB", 4);
+		header.Version = 1;
+		header.Size = m_data.Size;
+		header.MipLevels = m_data.MipLevels;
+		header.InternalFormat = (uint32_t)m_data.Format;
+		header.PixelFormat = (uint32_t)m_pixelFormat;
+		header.PixelType = (uint32_t)m_pixelType;
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		//read back each mip and write it out
+		size_t texelSize = GetTexelSize(m_pixelFormat, m_pixelType);
+		std::vector<char> level;
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		for (uint32_t ix = 0; ix < m_data.MipLevels; ix++) {
+			uint32_t levelSize = std::max(1u, m_data.Size >> ix);
+			level.resize((size_t)levelSize * levelSize * texelSize * 6);
+			glGetTextureImage(_handle, ix, m_pixelFormat, m_pixelType, (GLsizei)level.size(), level.data());
+			file.write(level.data(), level.size());
+		}
+		glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+		return (bool)file;
+	}
+
 	//sets the minification filter
 	void TTN_TextureCubeMap::SetMinFilter(Texture_Min_Filter filter)
 	{
@@ -173,7 +332,7 @@ namespace Titan {
 		glCreateTextures(GL_TEXTURE_CUBE_MAP, 1, &_handle);
 		if (m_data.Size > 0 && m_data.Format != Texture_Internal_Format::Interal_Format_Unknown)
 		{
-			glTextureStorage2D(_handle, 1, m_data.Format, m_data.Size, m_data.Size);
+			glTextureStorage2D(_handle, m_data.MipLevels, m_data.Format, m_data.Size, m_data.Size);
 			glTextureParameteri(_handle, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 			glTextureParameteri(_handle, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 			glTextureParameteri(_handle, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
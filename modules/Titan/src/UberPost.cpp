@@ -0,0 +1,118 @@
+//Titan Engine by Atlas X Games
+//UberPost.cpp - Source file for the class that fuses per pixel post processing effects into a single shader pass
+
+//include the precompile header, this file uses unordered_map and sstream
+#include "Titan/ttn_pch.h"
+//include the header
+#include "Titan/UberPost.h"
+
+namespace Titan {
+	//checks if an effect can join a fused run
+	bool TTN_UberPost::CanFuse(const std::vector<TTN_PostEffect::spostptr>& run, const TTN_PostEffect::spostptr& effect)
+	{
+		//effects that need neighbouring pixels can't be fused
+		if (effect->GetFusedType() == TTN_FusedEffectType::NONE) return false;
+		//every effect needs a byte of the key
+		if (run.size() >= s_maxEffects) return false;
+
+		//every effect in the run gets it's own textures, so make sure there's room for this one's
+		int textures = effect->GetFusedTextureCount();
+		for (auto& fused : run)
+			textures += fused->GetFusedTextureCount();
+		return textures <= s_maxTextures;
+	}
+
+	//gets the key for a run of effects
+	uint64_t TTN_UberPost::GetKey(const std::vector<TTN_PostEffect::spostptr>& effects)
+	{
+		//fusable types are never 0, so an empty byte means there's no effect in that place
+		uint64_t key = 0;
+		for (size_t i = 0; i < effects.size() && i < s_maxEffects; i++)
+			key |= (uint64_t)((uint32_t)effects[i]->GetFusedType() & 0xFF) << (i * 8);
+		return key;
+	}
+
+	//gets the name of an effect in a fused shader
+	const std::string& TTN_UberPost::GetFusedName(size_t index)
+	{
+		//the names are only made once, so applying the effects every frame doesn't build them again
+		static const std::array<std::string, s_maxEffects> names = []() {
+			std::array<std::string, s_maxEffects> result;
+			for (size_t i = 0; i < s_maxEffects; i++)
+				result[i] = "u_Fused" + std::to_string(i);
+			return result;
+		}();
+		return names[index];
+	}
+
+	//applies a run of fusable effects in one pass
+	void TTN_UberPost::Apply(const std::vector<TTN_PostEffect::spostptr>& effects, const TTN_Framebuffer::sfboptr& source, const TTN_Framebuffer::sfboptr& target)
+	{
+		//get the shader for this set of effects and bind it
+		TTN_Shader::sshptr shader = GetShader(effects);
+		shader->Bind();
+
+		//let every effect set it's uniforms and textures, each one under it's own name and slots
+		int slot = s_firstTextureSlot;
+		for (size_t i = 0; i < effects.size(); i++) {
+			effects[i]->BindFused(shader, GetFusedName(i), slot);
+			slot += effects[i]->GetFusedTextureCount();
+		}
+
+		//bind the source and render to the full screen quad
+		shader->SetUniform("u_UVScale", source->GetUVScale());
+		source->BindColorAsTexture(0, 0);
+		target->RenderToFSQ();
+
+		//unbind everything
+		source->UnbindTexture(0);
+		slot = s_firstTextureSlot;
+		for (auto& effect : effects) {
+			effect->UnbindFused(slot);
+			slot += effect->GetFusedTextureCount();
+		}
+		shader->UnBind();
+	}
+
+	//gets the fused shader for a run of effects
+	TTN_Shader::sshptr TTN_UberPost::GetShader(const std::vector<TTN_PostEffect::spostptr>& effects)
+	{
+		//if this set of effects has been used before, just use that shader
+		uint64_t key = GetKey(effects);
+		auto cached = s_variants.find(key);
+		if (cached != s_variants.end()) return cached->second;
+
+		//otherwise build the fragment shader, starting with the inputs every post effect shares
+		std::stringstream source;
+		source << "#version 420\n";
+		source << "layout(location = 0) in vec2 inUV;\n";
+		source << "out vec4 frag_color;\n";
+		source << "layout (binding = 0) uniform sampler2D u_FinishedFrame;\n";
+
+		//add each effect's uniforms and function
+		int slot = s_firstTextureSlot;
+		for (size_t i = 0; i < effects.size(); i++) {
+			source << effects[i]->GetFusedSource(GetFusedName(i), slot);
+			slot += effects[i]->GetFusedTextureCount();
+		}
+
+		//and a main that samples the frame once and runs it through every effect in order
+		source << "void main() {\n";
+		source << "	vec4 color = texture(u_FinishedFrame, inUV);\n";
+		for (size_t i = 0; i < effects.size(); i++)
+			source << "	color = " << GetFusedName(i) << "(color);\n";
+		source << "	frag_color = color;\n";
+		source << "}\n";
+
+		//compile it with the shared full screen vertex shader
+		TTN_Shader::sshptr shader = TTN_Shader::Create();
+		shader->LoadShaderStageFromFile("shaders/Post/ttn_passthrough_vert.glsl", GL_VERTEX_SHADER);
+		std::string fragSource = source.str();
+		shader->LoadShaderStage(fragSource.c_str(), GL_FRAGMENT_SHADER);
+		shader->Link();
+
+		//save it for next time and return it
+		s_variants[key] = shader;
+		return shader;
+	}
+}
@@ -119,7 +119,7 @@ namespace Titan {
 	}
 
 	//calls the openGL functions to acutally draw the triangles contained within the VAO
-	void TTN_VertexArrayObject::Render() const
+	void TTN_VertexArrayObject::Render(size_t numOfVerts) const
 	{
 		//bind the VAO so we can use it
 		Bind();
@@ -129,7 +129,7 @@ namespace Titan {
 			glDrawElements(GL_TRIANGLES, _ibo->GetElementCount(), _ibo->GetElementType(), nullptr);
 		else
 			//otherwise it must only have vbos, so use those vbos to draw the triangles
-			glDrawArrays(GL_TRIANGLES, 0, _vertexCount);
+			glDrawArrays(GL_TRIANGLES, 0, (numOfVerts == 0) ? _vertexCount : (GLsizei)numOfVerts);
 		//unbind the VAO
 		UnBind();
 	}
@@ -13,6 +13,9 @@
 //////////////////////////////////////////////////////////////////////////
 #pragma once
 
+#include <string>
+#include <vector>
+#include <unordered_map>
 #include "GLM/glm.hpp"
 #include "glad/glad.h"
 #include "stb_truetype.h"
@@ -47,7 +50,13 @@ namespace  TTK
 	
 	class TrueTypeTextureFont {
 	public:
-		TrueTypeTextureFont(const char* fileName, uint32_t size);
+		/*
+		 * Loads a TrueType font and bakes the printable ASCII range into an atlas
+		 * @param fileName The path to the .ttf file
+		 * @param size The pixel height to bake the glyphs at
+		 * @param sdf True to bake signed distance fields, which stay sharp at any scale, so one atlas serves every text size
+		 */
+		TrueTypeTextureFont(const char* fileName, uint32_t size, bool sdf = false);
 		~TrueTypeTextureFont();
 		
 		GlyphInfo GetGlyph(int codePoint, float offsetX, float offsetY) const;
@@ -57,6 +66,7 @@ namespace  TTK
 		virtual glm::vec2 MeausureString(const char* text, const float scale = 1.0f);
 
 		virtual GLint GetTexture() const { return myTexture; }
+		bool IsSDF() const { return myIsSDF; }
 
 	protected:
 		friend class FontRenderer;
@@ -69,9 +79,15 @@ namespace  TTK
 		const uint32_t FONT_OVERSAMPLE_Y = 2;
 		const uint32_t FIRST_CHAR = ' ';
 		const uint32_t CHAR_COUNT = '~' - ' ';
+		// Pixels of distance stored around each SDF glyph, and the value of the glyph's edge
+		const int SDF_PADDING = 6;
+		const uint8_t SDF_EDGE = 128;
+
+		bool PackSDF(uint8_t* atlasData);
 
 		stbtt_packedchar* myCharInfo;
 		uint32_t          myFontSize;
+		bool              myIsSDF;
 		stbtt_fontinfo    myFontInfo;
 		float             myPixelHeightScale;
 		float             myEmToPixel;
@@ -101,17 +117,71 @@ namespace  TTK
 			glm::vec2 UV;
 		};
 
+		// A string laid out relative to its origin, kept so strings that don't change between frames skip shaping
+		struct GlyphRun {
+			const TrueTypeTextureFont* Font;
+			float                  Scale;
+			std::string            Text;
+			std::vector<glm::vec2> Positions;
+			std::vector<glm::vec2> UVs;
+			uint64_t               LastUsedFrame;
+		};
+
+		// A range of quads that all use the same font
+		struct Batch {
+			const TrueTypeTextureFont* Font;
+			size_t                     FirstQuad;
+			size_t                     QuadCount;
+		};
+
 	public:
 		~FontRenderer();
 
+		/*
+		 * Queues a string to be drawn, nothing is drawn until Flush or EndFrame
+		 * @param font The font to draw with
+		 * @param text The text to draw
+		 * @param pos The position of the text, in screen coordinates
+		 * @param color The color of the text
+		 * @param scale The multiplier on the font's baked size
+		 */
 		void Render(const TrueTypeTextureFont& font, const char* text, const glm::vec2& pos, const glm::vec4& color, float scale = 1.0f);
+		/*
+		 * Uploads every queued string in one buffer update and draws them, one draw per run of strings sharing a font
+		 */
+		void Flush();
+
+		/*
+		 * Flushes the queued text and ages the glyph run cache, should be called once a frame
+		 */
+		static void EndFrame() {
+			if (m_Instance != nullptr)
+				m_Instance->__EndFrame();
+		}
+
+		size_t GetCachedRunCount() const { return m_Runs.size(); }
 		
 	private:
+		friend class TrueTypeTextureFont;
+
 		FontRenderer();
-				
+
+		const GlyphRun& __GetRun(const TrueTypeTextureFont& font, const char* text, float scale);
+		void __EndFrame();
+		void __ForgetFont(const TrueTypeTextureFont* font);
+		void __ReserveQuads(size_t quads);
+
+		// Frames a cached run can go unused before it's thrown out
+		const uint64_t RUN_CACHE_FRAMES = 120;
+
 		GLuint   m_ShaderHandle;
 		GLuint   m_VAO, m_VBO, m_EBO;
-		Vert     m_MeshData[256 * 4];
-		GLuint   m_IndexData[256 * 6];
+		// The number of quads the GPU buffers can hold, they grow as needed
+		size_t   m_QuadCapacity;
+		uint64_t m_FrameIndex;
+
+		std::vector<Vert>  m_MeshData;
+		std::vector<Batch> m_Batches;
+		std::unordered_map<size_t, GlyphRun> m_Runs;
 	};
 }
\ No newline at end of file
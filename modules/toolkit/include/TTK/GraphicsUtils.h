@@ -15,6 +15,7 @@
 
 #include <string>
 #include <glm/glm.hpp>
+#include "glad/glad.h"
 
 struct GLFWwindow;
 
@@ -206,6 +207,19 @@ namespace TTK
 		 */
 		static void SetDepthEnabled(bool isEnabled = true);
 
+		/*
+		 * Enables or disables blending, and tells TTK it's the state to leave blending in after drawing text
+		 * @param isEnabled Whether or not blending is enabled
+		 */
+		static void SetBlendEnabled(bool isEnabled = true);
+
+		/*
+		 * Sets the blend function, and tells TTK it's the one to put back after drawing text
+		 * @param src The source factor
+		 * @param dst The destination factor
+		 */
+		static void SetBlendFunc(GLenum src, GLenum dst);
+
 		/*
 		 * Sets the view matrix for TTK to use when rendering, to not use a camera, call this with either no parameters,
 		 * or the identity matrix
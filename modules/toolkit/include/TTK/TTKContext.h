@@ -63,6 +63,16 @@ namespace TTK
 		
 		void SetWindowSize(int windowWidth, int windowHeight);
 
+		// The blending and depth writes the host draws with, TTK changes them for its own draws and puts them back to these afterwards
+		// They're read from OpenGL once when the context is made, call these (or the TTK::Graphics versions) if the host changes them later
+		void SetBlendEnabled(bool value) { m_BlendEnabled = value; }
+		bool GetBlendEnabled() const { return m_BlendEnabled; }
+		void SetBlendFunc(GLenum srcRgb, GLenum dstRgb, GLenum srcAlpha, GLenum dstAlpha);
+		void SetDepthWriteEnabled(bool value) { m_DepthWriteEnabled = value; }
+		bool GetDepthWriteEnabled() const { return m_DepthWriteEnabled; }
+		// Puts the blending and depth writes back to the host's, without querying OpenGL
+		void RestoreHostState() const;
+
 		void RenderText(const char* text, const glm::vec2& position, const glm::vec4& color, float scale = 1.0f);
 		
 		void DrawTeapot(const glm::mat4& mat, const glm::vec4& color = glm::vec4(1.0f)) const;
@@ -97,6 +107,9 @@ namespace TTK
 		GLBuff m_Tris, m_Lines, m_Points;
 
 		int m_WindowWidth, m_WindowHeight;
+		bool m_BlendEnabled;
+		GLenum m_BlendSrcRgb, m_BlendDstRgb, m_BlendSrcAlpha, m_BlendDstAlpha;
+		bool m_DepthWriteEnabled;
 
 		GLBuff __InitBuff(GLenum mode, GLuint shader, void* dataSource, size_t elemSize, size_t maxElems);
 		void __Flush(GLBuff& buff);
@@ -12,6 +12,7 @@
 
 #include "TTK/FontRenderer.h"
 #include <fstream>
+#include <string_view>
 #include "Logging.h"
 #include <GLM/gtc/matrix_transform.hpp>
 #include "TTK/TTKContext.h"
@@ -53,9 +54,12 @@ char* readFile(const char* filename) {
 
 TTK::FontRenderer* TTK::FontRenderer::m_Instance = nullptr;
 
-TTK::TrueTypeTextureFont::TrueTypeTextureFont(const char* fileName, uint32_t size)
+TTK::TrueTypeTextureFont::TrueTypeTextureFont(const char* fileName, uint32_t size, bool sdf)
 {
 	myFontSize = size;
+	myIsSDF = sdf;
+	myTexture = 0;
+	m_TexHandle = 0;
 
 	unsigned char* fontData = (unsigned char*)readFile(fileName);
 	uint8_t* atlasData = new uint8_t[static_cast<size_t>(ATLAS_WIDTH) * ATLAS_HEIGHT];
@@ -75,25 +79,33 @@ TTK::TrueTypeTextureFont::TrueTypeTextureFont(const char* fileName, uint32_t siz
 	myPixelHeightScale = stbtt_ScaleForPixelHeight(&myFontInfo, static_cast<float>(size));
 	myEmToPixel = stbtt_ScaleForMappingEmToPixels(&myFontInfo, 1.0f);
 
-	stbtt_pack_context context;
-	if (!stbtt_PackBegin(&context, atlasData, ATLAS_WIDTH, ATLAS_HEIGHT, 0, 1, nullptr)) {
-		LOG_ERROR("Failed to pack font texture");
-		delete[] atlasData;
-		delete[] fontData;
-		return;
-	}
-
-	stbtt_PackSetOversampling(&context, FONT_OVERSAMPLE_X, FONT_OVERSAMPLE_Y);
-	if (!stbtt_PackFontRange(&context, fontData, 0, static_cast<float>(size), FIRST_CHAR, CHAR_COUNT, myCharInfo)) {
-		LOG_ERROR("Failed to pack font range");
-		delete[] atlasData;
-		delete[] fontData;
-		return;
+	if (myIsSDF) {
+		// SDF glyphs are baked at 1x, the distance field handles the filtering oversampling is used for
+		memset(atlasData, 0, static_cast<size_t>(ATLAS_WIDTH) * ATLAS_HEIGHT);
+		if (!PackSDF(atlasData)) {
+			LOG_ERROR("Failed to pack SDF font texture");
+			delete[] atlasData;
+			delete[] fontData;
+			return;
+		}
 	}
-	stbtt_PackEnd(&context);
+	else {
+		stbtt_pack_context context;
+		if (!stbtt_PackBegin(&context, atlasData, ATLAS_WIDTH, ATLAS_HEIGHT, 0, 1, nullptr)) {
+			LOG_ERROR("Failed to pack font texture");
+			delete[] atlasData;
+			delete[] fontData;
+			return;
+		}
 
-	for (uint32_t ix = FIRST_CHAR; ix < FIRST_CHAR + CHAR_COUNT; ix++) {
-		// TODO: Grab glyph data
+		stbtt_PackSetOversampling(&context, FONT_OVERSAMPLE_X, FONT_OVERSAMPLE_Y);
+		if (!stbtt_PackFontRange(&context, fontData, 0, static_cast<float>(size), FIRST_CHAR, CHAR_COUNT, myCharInfo)) {
+			LOG_ERROR("Failed to pack font range");
+			delete[] atlasData;
+			delete[] fontData;
+			return;
+		}
+		stbtt_PackEnd(&context);
 	}
 
 	// Create and upload the texture to store our font in
@@ -101,7 +113,7 @@ TTK::TrueTypeTextureFont::TrueTypeTextureFont(const char* fileName, uint32_t siz
 	glCreateTextures(GL_TEXTURE_2D, 1, &myTexture);
 	glTextureParameteri(myTexture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 	glTextureParameteri(myTexture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	glTextureParameteri(myTexture, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
+	glTextureParameteri(myTexture, GL_TEXTURE_MIN_FILTER, myIsSDF ? GL_LINEAR : GL_NEAREST_MIPMAP_LINEAR);
 	glTextureParameteri(myTexture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	LOG_ASSERT(glGetError() == GL_NONE, "Some error has occured!");
 	glTextureStorage2D(myTexture, 1, GL_R8, ATLAS_WIDTH, ATLAS_HEIGHT);
@@ -117,10 +129,57 @@ TTK::TrueTypeTextureFont::TrueTypeTextureFont(const char* fileName, uint32_t siz
 
 TTK::TrueTypeTextureFont::~TrueTypeTextureFont()
 {
+	// Make sure the renderer isn't holding on to anything that points at this font
+	if (FontRenderer::m_Instance != nullptr)
+		FontRenderer::m_Instance->__ForgetFont(this);
 	delete[] myCharInfo;
 	glDeleteTextures(1, &myTexture);
 }
 
+bool TTK::TrueTypeTextureFont::PackSDF(uint8_t* atlasData) {
+	// Shelf packing, glyphs go left to right and start a new row when they run out of room
+	const float pixelDistScale = static_cast<float>(SDF_EDGE) / SDF_PADDING;
+	uint32_t x = 0, y = 0, rowHeight = 0;
+
+	for (uint32_t ix = 0; ix < CHAR_COUNT; ix++) {
+		int codePoint = FIRST_CHAR + ix;
+		int width = 0, height = 0, xOff = 0, yOff = 0;
+		uint8_t* glyph = stbtt_GetCodepointSDF(&myFontInfo, myPixelHeightScale, codePoint, SDF_PADDING, SDF_EDGE, pixelDistScale, &width, &height, &xOff, &yOff);
+
+		if (x + width + 1 > ATLAS_WIDTH) {
+			x = 0;
+			y += rowHeight + 1;
+			rowHeight = 0;
+		}
+		if (y + height > ATLAS_HEIGHT) {
+			stbtt_FreeSDF(glyph, nullptr);
+			return false;
+		}
+
+		for (int row = 0; row < height; row++)
+			memcpy(atlasData + static_cast<size_t>(y + row) * ATLAS_WIDTH + x, glyph + static_cast<size_t>(row) * width, width);
+		stbtt_FreeSDF(glyph, nullptr);
+
+		// Fill in the same info stbtt_PackFontRange would, so GetGlyph works the same for both kinds of atlas
+		int advance, leftBearing;
+		stbtt_GetCodepointHMetrics(&myFontInfo, codePoint, &advance, &leftBearing);
+		stbtt_packedchar& info = myCharInfo[ix];
+		info.x0 = static_cast<unsigned short>(x);
+		info.y0 = static_cast<unsigned short>(y);
+		info.x1 = static_cast<unsigned short>(x + width);
+		info.y1 = static_cast<unsigned short>(y + height);
+		info.xoff = static_cast<float>(xOff);
+		info.yoff = static_cast<float>(yOff);
+		info.xoff2 = static_cast<float>(xOff + width);
+		info.yoff2 = static_cast<float>(yOff + height);
+		info.xadvance = advance * myPixelHeightScale;
+
+		x += width + 1;
+		rowHeight = glm::max(rowHeight, static_cast<uint32_t>(height));
+	}
+	return true;
+}
+
 TTK::GlyphInfo TTK::TrueTypeTextureFont::GetGlyph(int codePoint, float offsetX, float offsetY) const {
 	stbtt_aligned_quad quad;
 
@@ -197,32 +256,43 @@ glm::vec2 TTK::TrueTypeTextureFont::MeausureString(const char* text, const float
 
 TTK::FontRenderer::~FontRenderer()
 {
-	glDeleteShader(m_ShaderHandle);
+	glDeleteProgram(m_ShaderHandle);
+	glDeleteBuffers(1, &m_VBO);
+	glDeleteBuffers(1, &m_EBO);
 	glDeleteVertexArrays(1, &m_VAO);
 }
 
-void TTK::FontRenderer::Render(const TrueTypeTextureFont& font, const char* text, const glm::vec2& pos, const glm::vec4& color, float scale)
+const TTK::FontRenderer::GlyphRun& TTK::FontRenderer::__GetRun(const TrueTypeTextureFont& font, const char* text, float scale)
 {
-	size_t length = strlen(text);
-	
-	float multiplier = scale;
-
-	// The number of quads ACTUALLY drawn Shit-For-Brains
-	int quads = 0;
+	// Runs are found by hashing everything that changes the layout, the position and color are applied when the run is drawn
+	size_t hash = std::hash<std::string_view>()(text);
+	hash ^= std::hash<const void*>()(&font) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+	hash ^= std::hash<float>()(scale) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+
+	auto it = m_Runs.find(hash);
+	if (it != m_Runs.end() && it->second.Font == &font && it->second.Scale == scale && it->second.Text == text) {
+		it->second.LastUsedFrame = m_FrameIndex;
+		return it->second;
+	}
 
-	glm::vec2 originPos = glm::vec2(pos.x, pos.y);
+	// Either it's new or it collided with another run, in which case the other one gets replaced
+	GlyphRun& run = m_Runs[hash];
+	run.Font = &font;
+	run.Scale = scale;
+	run.Text = text;
+	run.Positions.clear();
+	run.UVs.clear();
+	run.LastUsedFrame = m_FrameIndex;
 
-	static GlyphInfo glyph;
+	size_t length = run.Text.size();
+	
+	float multiplier = scale;
 
-	Col8 gpuCol;
-	gpuCol.R = static_cast<char>(color.r * 255);
-	gpuCol.G = static_cast<char>(color.g * 255);
-	gpuCol.B = static_cast<char>(color.b * 255);
-	gpuCol.A = static_cast<char>(color.a * 255);
+	GlyphInfo glyph;
 
 	float xOff{ 0 }, yOff{ 0 };
 
-	for (int i = 0; i < length; i++) {
+	for (size_t i = 0; i < length; i++) {
 		glyph = font.GetGlyph(text[i], xOff, yOff);
 		xOff = glyph.OffsetX;
 		yOff = glyph.OffsetY;
@@ -241,89 +311,159 @@ void TTK::FontRenderer::Render(const TrueTypeTextureFont& font, const char* text
 			xOff += glyph.OffsetX * 4;
 		}
 		else {
-			m_MeshData[quads * 4 + 0].Position = originPos + glyph.Positions[0] * multiplier;
-			m_MeshData[quads * 4 + 0].UV = glyph.UVs[0];
-			m_MeshData[quads * 4 + 0].Color = gpuCol;
-
-			m_MeshData[quads * 4 + 1].Position = originPos + glyph.Positions[1] * multiplier;
-			m_MeshData[quads * 4 + 1].UV = glyph.UVs[1];
-			m_MeshData[quads * 4 + 1].Color = gpuCol;
+			for (int corner = 0; corner < 4; corner++) {
+				run.Positions.push_back(glyph.Positions[corner] * multiplier);
+				run.UVs.push_back(glyph.UVs[corner]);
+			}
+		}
+	}
 
-			m_MeshData[quads * 4 + 2].Position = originPos + glyph.Positions[2] * multiplier;
-			m_MeshData[quads * 4 + 2].UV = glyph.UVs[2];
-			m_MeshData[quads * 4 + 2].Color = gpuCol;
+	return run;
+}
 
-			m_MeshData[quads * 4 + 3].Position = originPos + glyph.Positions[3] * multiplier;
-			m_MeshData[quads * 4 + 3].UV = glyph.UVs[3];
-			m_MeshData[quads * 4 + 3].Color = gpuCol;
+void TTK::FontRenderer::Render(const TrueTypeTextureFont& font, const char* text, const glm::vec2& pos, const glm::vec4& color, float scale)
+{
+	const GlyphRun& run = __GetRun(font, text, scale);
+	size_t quads = run.Positions.size() / 4;
+	if (quads == 0)
+		return;
 
+	Col8 gpuCol;
+	gpuCol.R = static_cast<char>(color.r * 255);
+	gpuCol.G = static_cast<char>(color.g * 255);
+	gpuCol.B = static_cast<char>(color.b * 255);
+	gpuCol.A = static_cast<char>(color.a * 255);
 
-			m_IndexData[quads * 6 + 0] = quads * 4 + 0;
-			m_IndexData[quads * 6 + 1] = quads * 4 + 1;
-			m_IndexData[quads * 6 + 2] = quads * 4 + 2;
+	// Strings drawn with the same font as the one before them join its batch
+	if (m_Batches.empty() || m_Batches.back().Font != &font)
+		m_Batches.push_back({ &font, m_MeshData.size() / 4, 0 });
+	m_Batches.back().QuadCount += quads;
+
+	for (size_t ix = 0; ix < run.Positions.size(); ix++) {
+		Vert vert;
+		vert.Position = pos + run.Positions[ix];
+		vert.Color = gpuCol;
+		vert.UV = run.UVs[ix];
+		m_MeshData.push_back(vert);
+	}
+}
 
-			m_IndexData[quads * 6 + 3] = quads * 4 + 0;
-			m_IndexData[quads * 6 + 4] = quads * 4 + 2;
-			m_IndexData[quads * 6 + 5] = quads * 4 + 3;
+void TTK::FontRenderer::Flush()
+{
+	if (m_Batches.empty())
+		return;
 
-			quads++;
-		}
-	}
+	size_t quads = m_MeshData.size() / 4;
+	__ReserveQuads(quads);
 
-	length = quads;
+	// Orphan the old storage so we don't wait on draws still reading it, then stream every string in at once
+	glNamedBufferData(m_VBO, m_QuadCapacity * 4 * sizeof(Vert), nullptr, GL_STREAM_DRAW);
+	glNamedBufferSubData(m_VBO, 0, quads * 4 * sizeof(Vert), m_MeshData.data());
 
-	// Update and render our meshes
-	bool blendState = glIsEnabled(GL_BLEND);
-	GLboolean depthMaskEnabled = false;
-	glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMaskEnabled);
+	// The state is set outright instead of being queried and restored, since queries stall the pipeline
+	// Blending and depth writes are put back to what the context says the host draws with
 	glDepthMask(GL_FALSE);
 	glEnable(GL_BLEND);
 	glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ZERO);
-	glGetError();
 	glm::mat4 proj = TTK::Context::Instance().GetOrthoProjection();
 	glUseProgram(m_ShaderHandle);
 	glProgramUniformMatrix4fv(m_ShaderHandle, 0, 1, false, &proj[0][0]);
-	glProgramUniformHandleui64ARB(m_ShaderHandle, 1, font.m_TexHandle);	
 	glBindVertexArray(m_VAO);
-	glNamedBufferSubData(m_VBO, 0, length * 4 * sizeof(Vert), m_MeshData);
-	glNamedBufferSubData(m_EBO, 0, length * 6 * sizeof(GLuint), m_IndexData);
-	glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(length * 6), GL_UNSIGNED_INT, nullptr);
+	for (const Batch& batch : m_Batches) {
+		glProgramUniformHandleui64ARB(m_ShaderHandle, 1, batch.Font->m_TexHandle);
+		glProgramUniform1i(m_ShaderHandle, 2, batch.Font->myIsSDF ? 1 : 0);
+		glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(batch.QuadCount * 6), GL_UNSIGNED_INT, reinterpret_cast<void*>(batch.FirstQuad * 6 * sizeof(GLuint)));
+	}
 	glBindVertexArray(0);
-	LOG_ASSERT(glGetError() == GL_NONE, "Failed to draw our text mesh!");
-	if (!blendState) glDisable(GL_BLEND);
-	glDepthMask(depthMaskEnabled);
+	TTK::Context::Instance().RestoreHostState();
+
+	m_MeshData.clear();
+	m_Batches.clear();
+}
+
+void TTK::FontRenderer::__EndFrame()
+{
+	Flush();
+
+	// Throw out runs that haven't been drawn in a while
+	m_FrameIndex++;
+	for (auto it = m_Runs.begin(); it != m_Runs.end();) {
+		if (m_FrameIndex - it->second.LastUsedFrame > RUN_CACHE_FRAMES)
+			it = m_Runs.erase(it);
+		else
+			++it;
+	}
+}
+
+void TTK::FontRenderer::__ForgetFont(const TrueTypeTextureFont* font)
+{
+	// Text still waiting on the font has to be drawn while its atlas is still around
+	for (const Batch& batch : m_Batches) {
+		if (batch.Font == font) {
+			Flush();
+			break;
+		}
+	}
+
+	for (auto it = m_Runs.begin(); it != m_Runs.end();) {
+		if (it->second.Font == font)
+			it = m_Runs.erase(it);
+		else
+			++it;
+	}
+}
+
+void TTK::FontRenderer::__ReserveQuads(size_t quads)
+{
+	if (quads <= m_QuadCapacity)
+		return;
+	m_QuadCapacity = glm::max(quads, m_QuadCapacity * 2);
+
+	// Every quad uses the same pattern of indices, so they only need to be uploaded when the buffer grows
+	std::vector<GLuint> indices(m_QuadCapacity * 6);
+	for (size_t ix = 0; ix < m_QuadCapacity; ix++) {
+		GLuint vert = static_cast<GLuint>(ix * 4);
+		indices[ix * 6 + 0] = vert + 0;
+		indices[ix * 6 + 1] = vert + 1;
+		indices[ix * 6 + 2] = vert + 2;
+
+		indices[ix * 6 + 3] = vert + 0;
+		indices[ix * 6 + 4] = vert + 2;
+		indices[ix * 6 + 5] = vert + 3;
+	}
+	glNamedBufferData(m_EBO, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+	glNamedBufferData(m_VBO, m_QuadCapacity * 4 * sizeof(Vert), nullptr, GL_STREAM_DRAW);
 }
 
 TTK::FontRenderer::FontRenderer() {
 	LOG_INFO("Initializing font renderer");
 
-	memset(m_MeshData, 0, sizeof(m_MeshData));
-	memset(m_IndexData, 0, sizeof(m_IndexData));
+	m_QuadCapacity = 0;
+	m_FrameIndex = 0;
+	m_MeshData.reserve(256 * 4);
 
 	glCreateVertexArrays(1, &m_VAO);
 	glBindVertexArray(m_VAO);
 	GLuint buffers[2];
 	glCreateBuffers(2, buffers);
+	m_VBO = buffers[0];
+	m_EBO = buffers[1];
+	__ReserveQuads(256);
 	glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
-	glNamedBufferData(buffers[0], 256 * 4 * sizeof(Vert), m_MeshData, GL_DYNAMIC_DRAW);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[1]);
-	glNamedBufferData(buffers[1], 256 * 6 * sizeof(GLuint), m_IndexData, GL_DYNAMIC_DRAW);
 	glEnableVertexAttribArray(0);
 	glEnableVertexAttribArray(1);
 	glEnableVertexAttribArray(2);
 	#pragma warning(push)
 	#pragma warning(disable: 6011)
 	Vert* v = nullptr;
-	glVertexAttribPointer(0, 3, GL_FLOAT, false, sizeof(Vert), &v->Position);
+	glVertexAttribPointer(0, 2, GL_FLOAT, false, sizeof(Vert), &v->Position);
 	glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, false, sizeof(Vert), &v->Color);
 	glVertexAttribPointer(2, 2, GL_FLOAT, false, sizeof(Vert), &v->UV);
 	#pragma warning(pop)
 	
 	glBindVertexArray(0);
 
-	m_VBO = buffers[0];
-	m_EBO = buffers[1];
-
 	const char* vsSource = R"LIT(#version 430
             layout (location = 0) in vec2 vertexPosition;
             layout (location = 1) in vec4 vertexColor;
@@ -340,12 +480,21 @@ TTK::FontRenderer::FontRenderer() {
 	const char* fsSource = R"LIT(#version 430
 			#extension GL_ARB_bindless_texture : enable
             layout(bindless_sampler, location = 1) uniform sampler2D xSampler;
+            layout (location = 2) uniform int xIsSDF;
             layout (location = 0) in vec4 fragColor;
             layout (location = 1) in vec2 fragUv;            	
             out vec4 frag_color;            	
             void main() {
                 frag_color = fragColor;
-				frag_color.a = texture2D(xSampler, fragUv).r;
+				float sampled = texture2D(xSampler, fragUv).r;
+				if (xIsSDF != 0) {
+					// The glyph's edge is at 0.5, smooth it over about a pixel on screen whatever size it's drawn at
+					float width = fwidth(sampled) * 0.75;
+					frag_color.a = smoothstep(0.5 - width, 0.5 + width, sampled);
+				}
+				else {
+					frag_color.a = sampled;
+				}
             })LIT";
 
 	m_ShaderHandle = glCreateProgram();
@@ -45,6 +45,19 @@ void TTK::Graphics::SetDepthEnabled(bool isEnabled) {
 		glDisable(GL_DEPTH_TEST);
 }
 
+void TTK::Graphics::SetBlendEnabled(bool isEnabled) {
+	TTK::Context::Instance().SetBlendEnabled(isEnabled);
+	if (isEnabled)
+		glEnable(GL_BLEND);
+	else
+		glDisable(GL_BLEND);
+}
+
+void TTK::Graphics::SetBlendFunc(GLenum src, GLenum dst) {
+	TTK::Context::Instance().SetBlendFunc(src, dst, src, dst);
+	glBlendFunc(src, dst);
+}
+
 void TTK::Graphics::SetCameraMatrix(const glm::mat4& view) {
 	TTK::Context::Instance().SetView(view);
 }
@@ -63,6 +76,7 @@ void TTK::Graphics::ClearScreen() {
 
 void TTK::Graphics::EndFrame() {
 	TTK::Context::Instance().Flush();
+	TTK::FontRenderer::EndFrame();
 }
 
 void TTK::Graphics::DrawGrid(float gridWidth, AlignMode mode) {
@@ -34,6 +34,22 @@ glm::mat4 TTK::Context::GetOrthoProjection() const {
 	return glm::ortho(0.0f, static_cast<float>(m_WindowWidth), static_cast<float>(m_WindowHeight), 0.0f, -100.0f, 100.0f);
 }
 
+void TTK::Context::SetBlendFunc(GLenum srcRgb, GLenum dstRgb, GLenum srcAlpha, GLenum dstAlpha) {
+	m_BlendSrcRgb = srcRgb;
+	m_BlendDstRgb = dstRgb;
+	m_BlendSrcAlpha = srcAlpha;
+	m_BlendDstAlpha = dstAlpha;
+}
+
+void TTK::Context::RestoreHostState() const {
+	if (m_BlendEnabled)
+		glEnable(GL_BLEND);
+	else
+		glDisable(GL_BLEND);
+	glBlendFuncSeparate(m_BlendSrcRgb, m_BlendDstRgb, m_BlendSrcAlpha, m_BlendDstAlpha);
+	glDepthMask(m_DepthWriteEnabled ? GL_TRUE : GL_FALSE);
+}
+
 void TTK::Context::SetWindowSize(int windowWidth, int windowHeight) {
 	m_WindowWidth = windowWidth;
 	m_WindowHeight = windowHeight;
@@ -108,6 +124,17 @@ void TTK::Context::Flush() {
 TTK::Context::Context() {
 	m_Projection = glm::ortho(0.0f, 800.0f, 0.0f, 600.0f);
 	m_ViewMatrix = glm::mat4(1.0f);
+	// Only queried once here, so the per frame flushes never have to stall on a query
+	m_BlendEnabled = glIsEnabled(GL_BLEND) == GL_TRUE;
+	GLint blendFunc[4];
+	glGetIntegerv(GL_BLEND_SRC_RGB, &blendFunc[0]);
+	glGetIntegerv(GL_BLEND_DST_RGB, &blendFunc[1]);
+	glGetIntegerv(GL_BLEND_SRC_ALPHA, &blendFunc[2]);
+	glGetIntegerv(GL_BLEND_DST_ALPHA, &blendFunc[3]);
+	SetBlendFunc(blendFunc[0], blendFunc[1], blendFunc[2], blendFunc[3]);
+	GLboolean depthWrite = GL_TRUE;
+	glGetBooleanv(GL_DEPTH_WRITEMASK, &depthWrite);
+	m_DepthWriteEnabled = depthWrite == GL_TRUE;
 	m_DefaultFont = new TrueTypeTextureFont("C:\\\\Windows\\Fonts\\consola.ttf", 32);
 	
 	const char* vsSource = R"LIT(#version 430
@@ -12,9 +12,26 @@ layout(binding=0) uniform sampler2D waterText;
 uniform vec3  u_AmbientCol;
 uniform float u_AmbientStrength;
 
+//the view matrix, used to pick a shadow cascade
+uniform mat4  u_View;
+
+//the directional light and it's cascaded shadow map
+uniform vec3  u_SunDirection;
+uniform vec3  u_SunColor;
+uniform float u_SunStrength;
+layout(binding = 12) uniform sampler2DShadow s_ShadowAtlas;
+uniform mat4  u_ShadowMatrices[4];
+uniform float u_CascadeSplits[4];
+uniform float u_ShadowNormalOffset[4];
+uniform int   u_NumCascades;
+uniform float u_ShadowTexelSize;
+
 //result
 out vec4 frag_color;
 
+//functions
+float GetShadow(vec3 norm);
+
 void main() {
 	//sample the textures
 	vec4 textureColor = texture(waterText, inUV);
@@ -25,9 +42,41 @@ void main() {
 	//combine everything
 	vec3 result = u_AmbientCol * u_AmbientStrength; // global ambient light
 
+	//add the directional light's diffuse, shadowed by the cascades
+	vec3 N = normalize(inNormal);
+	float dif = max(dot(N, normalize(-u_SunDirection)), 0.0);
+	result = result + dif * u_SunColor * u_SunStrength * GetShadow(N);
+
 	//add that to the texture color
 	result = result * textureColor.rgb;
 
 	//save the result and pass it on
 	frag_color = vec4(result, textureColor.a);
+}
+
+float GetShadow(vec3 norm) {
+	//no cascades means the shadows are off
+	if(u_NumCascades == 0) return 1.0;
+
+	//pick the cascade from the view depth, past the last one there's no shadow
+	float depth = -(u_View * vec4(inPos, 1.0)).z;
+	if(depth > u_CascadeSplits[u_NumCascades - 1]) return 1.0;
+	int cascade = 0;
+	while(cascade < u_NumCascades - 1 && depth > u_CascadeSplits[cascade])
+		cascade++;
+
+	//push the point out along the normal so surfaces don't shadow themselves, then move into the cascade's tile of the atlas
+	vec3 shadowCoord = (u_ShadowMatrices[cascade] * vec4(inPos + norm * u_ShadowNormalOffset[cascade], 1.0)).xyz;
+	vec2 tileMin = vec2(cascade % 2, cascade / 2) * 0.5 + vec2(u_ShadowTexelSize);
+	vec2 tileMax = tileMin + vec2(0.5 - 2.0 * u_ShadowTexelSize);
+
+	//3x3 pcf, each tap is already a 2x2 bilinear comparison, clamped so it never reads the next cascade over
+	float lit = 0.0;
+	for(int x = -1; x <= 1; x++) {
+		for(int y = -1; y <= 1; y++) {
+			vec2 uv = clamp(shadowCoord.xy + vec2(x, y) * u_ShadowTexelSize, tileMin, tileMax);
+			lit += texture(s_ShadowAtlas, vec3(uv, shadowCoord.z));
+		}
+	}
+	return lit / 9.0;
 }
\ No newline at end of file
@@ -49,12 +49,10 @@ void Game::Update(float deltaTime)
 			Get<TTN_Physics>(boats[i]).GetRigidBody()->setGravity(btVector3(0.0f, 0.0f, 0.0f));
 		}
 
-		//go through all the entities with enemy compontents
-		auto enemyView = GetScene()->view<EnemyComponent>();
-		for (auto entity : enemyView) {
-			//and run their update
+		//go through all the entities with enemy compontents and run their updates, spread across the job system as each boat only moves itself
+		TTN_JobSystem::ParallelForEach(GetScene()->view<EnemyComponent>(), [this, deltaTime](entt::entity entity) {
 			Get<EnemyComponent>(entity).Update(deltaTime);
-		}
+		});
 
 		//updates the flamethrower logic
 		FlamethrowerUpdate(deltaTime);
@@ -74,17 +72,20 @@ void Game::Update(float deltaTime)
 		printf("GAME OVER");
 	}
 
-	TTN_AudioEvent& music = engine.GetEvent("music");
+	//without a window there's no sound or ui to update
+	if (!TTN_Application::GetHeadless()) {
+		TTN_AudioEvent& music = engine.GetEvent("music");
 
-	//get ref to bus
-	TTN_AudioBus& musicBus = engine.GetBus("MusicBus");
+		//get ref to bus
+		TTN_AudioBus& musicBus = engine.GetBus("MusicBus");
 
-	//get ref to listener
-	TTN_AudioListener& listener = engine.GetListener();
-	engine.Update();
+		//get ref to listener
+		TTN_AudioListener& listener = engine.GetListener();
+		engine.Update();
 
-	//call the update on ImGui
-	ImGui();
+		//call the update on ImGui
+		ImGui();
+	}
 
 	//don't forget to call the base class' update
 	TTN_Scene::Update(deltaTime);
@@ -135,38 +136,10 @@ void Game::PostRender()
 		shaderProgramTerrain->SetUniform("u_hasOutline", (int)m_mats[0]->GetHasOutline());
 		shaderProgramTerrain->SetUniform("u_useDiffuseRamp", m_mats[0]->GetUseDiffuseRamp());
 		shaderProgramTerrain->SetUniform("u_useSpecularRamp", (int)m_mats[0]->GetUseSpecularRamp());
-		//stuff from the light
-		glm::vec3 lightPositions[16];
-		glm::vec3 lightColor[16];
-		float lightAmbientStr[16];
-		float lightSpecStr[16];
-		float lightAttenConst[16];
-		float lightAttenLinear[16];
-		float lightAttenQuadartic[16];
-
-		for (int i = 0; i < 16 && i < m_Lights.size(); i++) {
-			auto& light = Get<TTN_Light>(m_Lights[i]);
-			auto& lightTrans = Get<TTN_Transform>(m_Lights[i]);
-			lightPositions[i] = lightTrans.GetPos();
-			lightColor[i] = light.GetColor();
-			lightAmbientStr[i] = light.GetAmbientStrength();
-			lightSpecStr[i] = light.GetSpecularStrength();
-			lightAttenConst[i] = light.GetConstantAttenuation();
-			lightAttenLinear[i] = light.GetConstantAttenuation();
-			lightAttenQuadartic[i] = light.GetQuadraticAttenuation();
-		}
-
-		//send all the data about the lights to glsl
-		shaderProgramTerrain->SetUniform("u_LightPos", lightPositions[0], 16);
-		shaderProgramTerrain->SetUniform("u_LightCol", lightColor[0], 16);
-		shaderProgramTerrain->SetUniform("u_AmbientLightStrength", lightAmbientStr[0], 16);
-		shaderProgramTerrain->SetUniform("u_SpecularLightStrength", lightSpecStr[0], 16);
-		shaderProgramTerrain->SetUniform("u_LightAttenuationConstant", lightAttenConst[0], 16);
-		shaderProgramTerrain->SetUniform("u_LightAttenuationLinear", lightAttenLinear[0], 16);
-		shaderProgramTerrain->SetUniform("u_LightAttenuationQuadratic", lightAttenQuadartic[0], 16);
-
-		//and tell it how many lights there actually are
-		shaderProgramTerrain->SetUniform("u_NumOfLights", (int)m_Lights.size());
+		//send the lights, sorted into clusters by the scene
+		SetClusteredLightingUniforms(shaderProgramTerrain);
+		//and the sun and it's shadows
+		SetSunLightingUniforms(shaderProgramTerrain);
 
 		//stuff from the camera
 		shaderProgramTerrain->SetUniform("u_CamPos", Get<TTN_Transform>(camera).GetPos());
@@ -207,6 +180,8 @@ void Game::PostRender()
 		//send lighting from the scene
 		shaderProgramWater->SetUniform("u_AmbientCol", TTN_Scene::GetSceneAmbientColor());
 		shaderProgramWater->SetUniform("u_AmbientStrength", TTN_Scene::GetSceneAmbientLightStrength());
+		//and the sun and it's shadows
+		SetSunLightingUniforms(shaderProgramWater);
 
 		//render the water (just use the same plane as the terrain)
 		terrainPlain->GetVAOPointer()->Render();
@@ -288,20 +263,8 @@ void Game::MouseButtonChecks()
 	//if the game is not paused
 	if (!m_paused) {
 		//if the cannon is not in the middle of firing, fire when the player is pressing the left mouse button
-		if (Get<TTN_MorphAnimator>(cannon).getActiveAnim() == 0 && playerShootCooldownTimer <= 0.0f &&
-			TTN_Application::TTN_Input::GetMouseButton(TTN_MouseButton::Left)) {
-			//play the firing animation
-			Get<TTN_MorphAnimator>(cannon).SetActiveAnim(1);
-			Get<TTN_MorphAnimator>(cannon).getActiveAnimRef().Restart();
-			//create a new cannonball
-			CreateCannonball();
-			//reset the cooldown
-			playerShootCooldownTimer = playerShootCooldown;
-			//and play the smoke particle effect
-			Get<TTN_Transform>(smokePS).SetPos(glm::vec3(0.0f, -0.2f, 0.0f) + 1.5f * playerDir);
-			Get<TTN_ParticeSystemComponent>(smokePS).GetParticleSystemPointer()->
-				SetEmitterRotation(glm::vec3(rotAmmount.y, -rotAmmount.x, 0.0f));
-			Get<TTN_ParticeSystemComponent>(smokePS).GetParticleSystemPointer()->Burst(500);
+		if (GetCanFire() && TTN_Application::TTN_Input::GetMouseButton(TTN_MouseButton::Left)) {
+			FireCannon();
 		}
 	}
 }
@@ -316,6 +279,10 @@ void Game::MouseButtonUpChecks()
 //sets up all the assets in the scene
 void Game::SetUpAssets()
 {
+	//without a window there's no opengl context or audio device, so the scene runs without any assets and nothing ever draws it
+	if (TTN_Application::GetHeadless())
+		return;
+
 	//// SOUNDS ////
 	//engine.Instance();
 	engine.Init();
@@ -366,6 +333,13 @@ void Game::SetUpAssets()
 	birdMesh = TTN_AssetSystem::GetMesh("Bird mesh");
 	damMesh = TTN_AssetSystem::GetMesh("Dam mesh");
 
+	//the boats, birds and cannon get simpler levels of detail to draw when they're small on screen, this does nothing if they already have them
+	TTN_MeshSimplifier::GenerateLODs(boat1Mesh, 2);
+	TTN_MeshSimplifier::GenerateLODs(boat2Mesh, 2);
+	TTN_MeshSimplifier::GenerateLODs(boat3Mesh, 2);
+	TTN_MeshSimplifier::GenerateLODs(birdMesh, 2);
+	TTN_MeshSimplifier::GenerateLODs(cannonMesh, 2);
+
 	///TEXTURES////
 	cannonText = TTN_Texture2D::LoadFromFile("textures/metal.png");
 	skyboxText = TTN_TextureCubeMap::LoadFromImages("textures/skybox/sky.png");
@@ -546,6 +520,8 @@ void Game::SetUpEntities()
 
 		//setup a mesh renderer for the dam
 		TTN_Renderer damRenderer = TTN_Renderer(damMesh, shaderProgramTextured, damMat);
+		//the dam never moves
+		damRenderer.SetStatic(true);
 		//attach that renderer to the entity
 		AttachCopy(dam, damRenderer);
 
@@ -565,6 +541,8 @@ void Game::SetUpEntities()
 			//setup a mesh renderer for the cannon
 			TTN_Renderer ftRenderer = TTN_Renderer(flamethrowerMesh, shaderProgramTextured);
 			ftRenderer.SetMat(flamethrowerMat);
+			//the flamethrowers never move
+			ftRenderer.SetStatic(true);
 			//attach that renderer to the entity
 			AttachCopy<TTN_Renderer>(flamethrowers[i], ftRenderer);
 
@@ -728,15 +706,20 @@ void Game::SetUpOtherData()
 		expolsionParticle.SetOneStartSpeed(4.5f);
 	}
 
-	//setup up the color correction effect
-	glm::ivec2 windowSize = TTN_Backend::GetWindowSize();
-	m_colorCorrectEffect = TTN_ColorCorrect::Create();
-	m_colorCorrectEffect->Init(windowSize.x, windowSize.y);
-	//set it so it doesn't render
-	m_colorCorrectEffect->SetShouldApply(false);
-	m_colorCorrectEffect->SetCube(TTN_AssetSystem::GetLUT("Warm LUT"));
-	//and add it to this scene's list of effects
-	m_PostProcessingEffects.push_back(m_colorCorrectEffect);
+	//set up the prefabs now that the particle templates exist
+	SetUpPrefabs();
+
+	//setup up the color correction effect, headless scenes never render so they don't need it
+	if (!TTN_Application::GetHeadless()) {
+		glm::ivec2 windowSize = TTN_Backend::GetWindowSize();
+		m_colorCorrectEffect = TTN_ColorCorrect::Create();
+		m_colorCorrectEffect->Init(windowSize.x, windowSize.y);
+		//set it so it doesn't render
+		m_colorCorrectEffect->SetShouldApply(false);
+		m_colorCorrectEffect->SetCube(TTN_AssetSystem::GetLUT("Warm LUT"));
+		//and add it to this scene's list of effects
+		m_PostProcessingEffects.push_back(m_colorCorrectEffect);
+	}
 
 	//set all 3 effects to false
 	m_applyWarmLut = false;
@@ -754,6 +737,81 @@ void Game::SetUpOtherData()
 		m_mats[i]->SetOutlineSize(m_outlineSize);
 }
 
+//sets up the prefabs used to spawn boats, cannonballs, expolsions, and flames
+void Game::SetUpPrefabs()
+{
+	//boat prefabs
+	{
+		TTN_Material::smatptr boatMats[3] = { boat1Mat, boat2Mat, boat3Mat };
+		TTN_Mesh::smptr boatMeshes[3] = { boat1Mesh, boat2Mesh, boat3Mesh };
+
+		for (int i = 0; i < 3; i++) {
+			boatPrefabs[i] = TTN_Prefab::Create("Boat");
+			boatPrefabs[i]->Add(TTN_Renderer(boatMeshes[i], shaderProgramTextured, boatMats[i]));
+			boatPrefabs[i]->Add(TTN_Tag("Boat"));
+
+			//each boat needs it's own physics body, boats on the left (positive x) move right to left and vice versa
+			boatPrefabs[i]->AddBuilder<TTN_Physics>([](entt::entity entity, const TTN_Transform& trans) {
+				TTN_Transform boatTrans = trans;
+				TTN_Physics pbody = TTN_Physics(boatTrans.GetPos(), glm::vec3(0.0f), glm::vec3(2.0f, 4.0f, 8.95f), entity, TTN_PhysicsBodyType::DYNAMIC);
+				pbody.SetLinearVelocity(glm::vec3((boatTrans.GetPos().x > 0.0f) ? -25.0f : 25.0f, 0.0f, 0.0f));
+				return pbody;
+			});
+
+			//and it's own enemy component, left side paths are 0-2 and right side paths are 3-5
+			boatPrefabs[i]->AddBuilder<EnemyComponent>([this, i](entt::entity entity, const TTN_Transform& trans) {
+				TTN_Transform boatTrans = trans;
+				int randPath = rand() % 3 + ((boatTrans.GetPos().x > 0.0f) ? 0 : 3);
+				return EnemyComponent(entity, this, i, randPath, 0.0f);
+			});
+		}
+	}
+
+	//cannonball prefab
+	{
+		cannonBallPrefab = TTN_Prefab::Create("Cannonball");
+		cannonBallPrefab->Add(TTN_Renderer(sphereMesh, shaderProgramTextured, cannonMat));
+		cannonBallPrefab->Add(TTN_Tag("Ball"));
+		cannonBallPrefab->AddBuilder<TTN_Physics>([](entt::entity entity, const TTN_Transform& trans) {
+			TTN_Transform ballTrans = trans;
+			//the pool builds the balls ahead of time with a default transform, and acquiring one only moves it's body
+			//so the collider is always made the size CreateCannonball scales the balls to
+			return TTN_Physics(ballTrans.GetPos(), glm::vec3(0.0f), glm::vec3(0.35f), entity);
+		});
+	}
+
+	//expolsion prefab
+	{
+		expolsionPrefab = TTN_Prefab::Create("Expolsion");
+		expolsionPrefab->Add(TTN_DeleteCountDown(2.0f));
+		expolsionPrefab->AddBuilder<TTN_ParticeSystemComponent>([this](entt::entity entity, const TTN_Transform& trans) {
+			//setup a particle system and burst it
+			TTN_ParticleSystem::spsptr ps = std::make_shared<TTN_ParticleSystem>(500, 0, expolsionParticle, 0.0f, false);
+			ps->MakeSphereEmitter();
+			ps->VelocityReadGraphCallback(FastStart);
+			ps->ColorReadGraphCallback(SlowStart);
+			ps->ScaleReadGraphCallback(ZeroOneZero);
+			return TTN_ParticeSystemComponent(ps);
+		});
+	}
+
+	//flame prefab
+	{
+		flamePrefab = TTN_Prefab::Create("Flame");
+		flamePrefab->Add(TTN_DeleteCountDown(3.0f));
+		flamePrefab->AddBuilder<TTN_ParticeSystemComponent>([this](entt::entity entity, const TTN_Transform& trans) {
+			TTN_ParticleSystem::spsptr ps = std::make_shared<TTN_ParticleSystem>(1200, 300, fireParticle, 2.0f, true);
+			ps->MakeConeEmitter(15.0f, glm::vec3(90.0f, 0.0f, 0.0f));
+			return TTN_ParticeSystemComponent(ps);
+		});
+	}
+
+	//pools for the entities that get created and destroyed constantly, sized for what a normal game uses at once so they rarely have to grow
+	cannonBallPool = CreatePool(cannonBallPrefab, 8);
+	expolsionPool = CreatePool(expolsionPrefab, 8);
+	flamePool = CreatePool(flamePrefab, 12);
+}
+
 //restarts the game
 void Game::RestartData()
 {
@@ -834,37 +892,33 @@ void Game::StopFiring()
 	}
 }
 
+//fires the cannon along the direction the player is facing, playing the animation and smoke
+void Game::FireCannon()
+{
+	//play the firing animation
+	Get<TTN_MorphAnimator>(cannon).SetActiveAnim(1);
+	Get<TTN_MorphAnimator>(cannon).getActiveAnimRef().Restart();
+	//create a new cannonball
+	CreateCannonball();
+	//reset the cooldown
+	playerShootCooldownTimer = playerShootCooldown;
+	//and play the smoke particle effect
+	Get<TTN_Transform>(smokePS).SetPos(glm::vec3(0.0f, -0.2f, 0.0f) + 1.5f * playerDir);
+	Get<TTN_ParticeSystemComponent>(smokePS).GetParticleSystemPointer()->
+		SetEmitterRotation(glm::vec3(rotAmmount.y, -rotAmmount.x, 0.0f));
+	Get<TTN_ParticeSystemComponent>(smokePS).GetParticleSystemPointer()->Burst(500);
+}
+
 //function to create a cannonball, used when the player fires
 void Game::CreateCannonball()
 {
-	//create the cannonball
-	{
-		//create the entity
-		cannonBalls.push_back(CreateEntity());
-
-		//set up a renderer for the cannonball
-		TTN_Renderer cannonBallRenderer = TTN_Renderer(sphereMesh, shaderProgramTextured, cannonMat);
-		//attach that renderer to the entity
-		AttachCopy(cannonBalls[cannonBalls.size() - 1], cannonBallRenderer);
-
-		//set up a transform for the cannonball
-		TTN_Transform cannonBallTrans = TTN_Transform();
-		cannonBallTrans.SetPos(Get<TTN_Transform>(cannon).GetGlobalPos());
-		cannonBallTrans.SetScale(glm::vec3(0.35f));
-		//attach that transform to the entity
-		AttachCopy(cannonBalls[cannonBalls.size() - 1], cannonBallTrans);
+	//set up a transform for the cannonball
+	TTN_Transform cannonBallTrans = TTN_Transform();
+	cannonBallTrans.SetPos(Get<TTN_Transform>(cannon).GetGlobalPos());
+	cannonBallTrans.SetScale(glm::vec3(0.35f));
 
-		//set up a physics body for the cannonball
-		TTN_Physics cannonBallPhysBod = TTN_Physics(cannonBallTrans.GetPos(), glm::vec3(0.0f), cannonBallTrans.GetScale(),
-			cannonBalls[cannonBalls.size() - 1]);
-
-		//attach that physics body to the entity
-		AttachCopy(cannonBalls[cannonBalls.size() - 1], cannonBallPhysBod);
-
-		TTN_Tag ballTag = TTN_Tag("Ball"); //sets boat path number to ttn_tag
-		AttachCopy<TTN_Tag>(cannonBalls[cannonBalls.size() - 1], ballTag);
-	}
-	//TTN_Physics& tt = Get<TTN_Physics>(cannonBalls[cannonBalls.size() - 1]);
+	//get a cannonball from the pool
+	cannonBalls.push_back(cannonBallPool->Acquire(cannonBallTrans));
 
 	//after the cannonball has been created, get the physics body and apply a force along the player's direction
 	Get<TTN_Physics>(cannonBalls[cannonBalls.size() - 1]).AddForce((cannonBallForce * playerDir));
@@ -880,7 +934,7 @@ void Game::DeleteCannonballs()
 			it++;
 		}
 		else {
-			DeleteEntity(*it);
+			QueueDestroy(*it);
 			it = cannonBalls.erase(it);
 		}
 	}
@@ -889,27 +943,10 @@ void Game::DeleteCannonballs()
 //function that will create an expolsion particle effect at a given input location
 void Game::CreateExpolsion(glm::vec3 location)
 {
-	//we don't really need to save the entity number for any reason, so we just make the variable local
-	entt::entity newExpolsion = CreateEntity(2.0f);
-
-	//setup a transfrom for the particle system
-	TTN_Transform PSTrans = TTN_Transform(location, glm::vec3(0.0f), glm::vec3(1.0f));
-	//attach that transform to the entity
-	AttachCopy(newExpolsion, PSTrans);
-	glm::vec3 tempLoc = Get<TTN_Transform>(newExpolsion).GetGlobalPos();
-
-	//setup a particle system for the particle system
-	TTN_ParticleSystem::spsptr ps = std::make_shared<TTN_ParticleSystem>(500, 0, expolsionParticle, 0.0f, false);
-	ps->MakeSphereEmitter();
-	ps->VelocityReadGraphCallback(FastStart);
-	ps->ColorReadGraphCallback(SlowStart);
-	ps->ScaleReadGraphCallback(ZeroOneZero);
-	//setup a particle system component
-	TTN_ParticeSystemComponent psComponent = TTN_ParticeSystemComponent(ps);
-	//attach the particle system component to the entity
-	AttachCopy(newExpolsion, psComponent);
-
-	//get a reference to that particle system and burst it
+	//get an expolsion from the pool, it goes back to the pool on it's own when it's lifetime runs out
+	entt::entity newExpolsion = expolsionPool->Acquire(TTN_Transform(location, glm::vec3(0.0f), glm::vec3(1.0f)));
+
+	//burst it's particle system
 	Get<TTN_ParticeSystemComponent>(newExpolsion).GetParticleSystemPointer()->Burst(500);
 }
 
@@ -921,28 +958,11 @@ void Game::Flamethrower() {
 		FlameTimer = FlameThrowerCoolDown;
 		//set the active flag to true
 		Flaming = true;
-		//and through and create the fire particle systems
-		for (int i = 0; i < 6; i++) {
-			//fire particle entities
-			{
-				flames.push_back(CreateEntity(3.0f));
-
-				//setup a transfrom for the particle system
-				TTN_Transform firePSTrans = TTN_Transform(Get<TTN_Transform>(flamethrowers[i]).GetGlobalPos() + glm::vec3(0.0f, 0.0f, 2.0f), glm::vec3(0.0f, 90.0f, 0.0f), glm::vec3(1.0f));
 
-				//attach that transform to the entity
-				AttachCopy(flames[i], firePSTrans);
-
-				//setup a particle system for the particle system
-				TTN_ParticleSystem::spsptr ps = std::make_shared<TTN_ParticleSystem>(1200, 300, fireParticle, 2.0f, true);
-				ps->MakeConeEmitter(15.0f, glm::vec3(90.0f, 0.0f, 0.0f));
-
-				//setup a particle system component
-				TTN_ParticeSystemComponent psComponent = TTN_ParticeSystemComponent(ps);
-				//attach the particle system component to the entity
-				AttachCopy(flames[i], psComponent);
-			}
-		}
+		//get a fire particle system from the pool for each flamethrower, they go back to the pool when their lifetime runs out
+		for (int i = 0; i < 6; i++)
+			flames.push_back(flamePool->Acquire(TTN_Transform(Get<TTN_Transform>(flamethrowers[i]).GetGlobalPos() + glm::vec3(0.0f, 0.0f, 2.0f),
+				glm::vec3(0.0f, 90.0f, 0.0f), glm::vec3(1.0f))));
 	}
 	//otherwise nothing happens
 	else {
@@ -969,17 +989,16 @@ void Game::FlamethrowerUpdate(float deltaTime)
 			Flaming = false;
 		}
 
-		//while it's flaming, iterate through the vector of boats, deleting the boat if it is at or below z = 20
-		std::vector<entt::entity>::iterator it = boats.begin();
-		while (it != boats.end()) {
-			if (Get<TTN_Transform>(*it).GetPos().z >= 27.0f) {
-				it++;
-			}
-			else {
-				m_boatsRemainingThisWave--;
-				DeleteEntity(*it);
-				it = boats.erase(it);
-			}
+		//while it's flaming, ask the physics world for everything in the flame zone (below z = 27) and delete any boats in it
+		std::vector<entt::entity> burnt = BoxOverlap(glm::vec3(0.0f, 0.0f, 27.0f - flameZoneHalfExtents.z), flameZoneHalfExtents);
+		for (auto entity : burnt) {
+			//skip anything that isn't a boat still on the list (cannonballs, sinking boats, etc.)
+			std::vector<entt::entity>::iterator it = std::find(boats.begin(), boats.end(), entity);
+			if (it == boats.end()) continue;
+
+			m_boatsRemainingThisWave--;
+			QueueDestroy(*it);
+			boats.erase(it);
 		}
 	}
 }
@@ -989,27 +1008,9 @@ void Game::FlamethrowerUpdate(float deltaTime)
 //spawn a boat on the left side of the map
 void Game::SpawnBoatLeft()
 {
-	//create the entity
-	boats.push_back(CreateEntity());
+	//gets the type of boat
 	int randomBoat = rand() % 3;
 
-	//create a renderer
-	TTN_Renderer boatRenderer = TTN_Renderer(boat1Mesh, shaderProgramTextured, boat1Mat);
-	//setup renderer for green boat
-	if (randomBoat == 0) {
-		boatRenderer = TTN_Renderer(boat1Mesh, shaderProgramTextured, boat1Mat);
-	}
-	//setup renderer for red boat
-	else if (randomBoat == 1) {
-		boatRenderer = TTN_Renderer(boat2Mesh, shaderProgramTextured, boat2Mat);
-	}
-	//set up renderer for yellow boat
-	else if (randomBoat == 2) {
-		boatRenderer = TTN_Renderer(boat3Mesh, shaderProgramTextured, boat3Mat);
-	}
-	//attach the renderer to the boat
-	AttachCopy<TTN_Renderer>(boats[boats.size() - 1], boatRenderer);
-
 	//create a transform for the boat
 	TTN_Transform boatTrans = TTN_Transform(glm::vec3(21.0f, 10.0f, 0.0f), glm::vec3(0.0f), glm::vec3(1.0f));
 	//set up the transform for the green boat
@@ -1030,49 +1031,17 @@ void Game::SpawnBoatLeft()
 		boatTrans.SetScale(glm::vec3(0.15f, 0.15f, 0.15f));
 		boatTrans.SetPos(glm::vec3(90.0f, -7.5f, 115.0f));
 	}
-	//attach the transform
-	AttachCopy<TTN_Transform>(boats[boats.size() - 1], boatTrans);
-
-	//create an attach a transform
-	TTN_Physics pbody = TTN_Physics(boatTrans.GetPos(), glm::vec3(0.0f), glm::vec3(2.0f, 4.0f, 8.95f), boats[boats.size() - 1], TTN_PhysicsBodyType::DYNAMIC);
-	pbody.SetLinearVelocity(glm::vec3(-25.0f, 0.0f, 0.0f));//-2.0f
-	AttachCopy<TTN_Physics>(boats[boats.size() - 1], pbody);
-
-	//creates and attaches a tag to the boat
-	TTN_Tag boatTag = TTN_Tag("Boat");
-	AttachCopy<TTN_Tag>(boats[boats.size() - 1], boatTag);
-
-	//create and attach the enemy component to the boat
-	int randPath = rand() % 3; // generates path number between 0-2 (left side paths, right side path nums are 3-5)
-	EnemyComponent en = EnemyComponent(boats[boats.size() - 1], this, randomBoat, randPath, 0.0f);
-	AttachCopy(boats[boats.size() - 1], en);
+
+	//create the boat from it's prefab, which sets up the renderer, physics body, tag, and enemy component
+	boats.push_back(Instantiate(boatPrefabs[randomBoat], 1, { boatTrans })[0]);
 }
 
 //spawn a boat on the right side of the map
 void Game::SpawnBoatRight()
 {
-	boats.push_back(CreateEntity());
-
 	//gets the type of boat
 	int randomBoat = rand() % 3;
 
-	//create a renderer
-	TTN_Renderer boatRenderer = TTN_Renderer(boat1Mesh, shaderProgramTextured, boat1Mat);
-	//set up renderer for green boat
-	if (randomBoat == 0) {
-		boatRenderer = TTN_Renderer(boat1Mesh, shaderProgramTextured, boat1Mat);
-	}
-	//set up renderer for red boat
-	else if (randomBoat == 1) {
-		boatRenderer = TTN_Renderer(boat2Mesh, shaderProgramTextured, boat2Mat);
-	}
-	//set up renderer for yellow boat
-	else if (randomBoat == 2) {
-		boatRenderer = TTN_Renderer(boat3Mesh, shaderProgramTextured, boat3Mat);
-	}
-	//attach the renderer to the entity
-	AttachCopy<TTN_Renderer>(boats[boats.size() - 1], boatRenderer);
-
 	//create a transform for the boat
 	TTN_Transform boatTrans = TTN_Transform();
 	//set up the transform for the green boat
@@ -1093,22 +1062,9 @@ void Game::SpawnBoatRight()
 		boatTrans.SetScale(glm::vec3(0.15f, 0.15f, 0.15f));
 		boatTrans.SetPos(glm::vec3(-90.0f, -7.5f, 115.0f));
 	}
-	//attach the transform
-	AttachCopy<TTN_Transform>(boats[boats.size() - 1], boatTrans);
-
-	//create and attach a physics body to the boats
-	TTN_Physics pbody = TTN_Physics(boatTrans.GetPos(), glm::vec3(0.0f), glm::vec3(2.0f, 4.0f, 8.95f), boats[boats.size() - 1]);
-	pbody.SetLinearVelocity(glm::vec3(25.0f, 0.0f, 0.0f));//-2.0f
-	AttachCopy<TTN_Physics>(boats[boats.size() - 1], pbody);
-
-	//creates and attaches a tag to the boat
-	TTN_Tag boatTag = TTN_Tag("Boat");
-	AttachCopy<TTN_Tag>(boats[boats.size() - 1], boatTag);
-
-	//create and attach the enemy component to the boat
-	int randPath = rand() % 3 + 3; // generates path number between 3-5 (right side paths, left side path nums are 0-2)
-	EnemyComponent en = EnemyComponent(boats[boats.size() - 1], this, randomBoat, randPath, 0.0f);
-	AttachCopy(boats[boats.size() - 1], en);
+
+	//create the boat from it's prefab, which sets up the renderer, physics body, tag, and enemy component
+	boats.push_back(Instantiate(boatPrefabs[randomBoat], 1, { boatTrans })[0]);
 }
 
 //updates the waves
@@ -1152,7 +1108,7 @@ void Game::Collisions()
 {
 	//collision checks
 	//get the collisions from the base scene
-	std::vector<TTN_Collision::scolptr> collisionsThisFrame = TTN_Scene::GetCollisions();
+	const std::vector<TTN_Collision::scolptr>& collisionsThisFrame = TTN_Scene::GetCollisions();
 
 	//iterate through the collisions
 	for (int i = 0; i < collisionsThisFrame.size(); i++) {
@@ -1174,8 +1130,8 @@ void Game::Collisions()
 					std::vector<entt::entity>::iterator it = cannonBalls.begin();
 					while (it != cannonBalls.end()) {
 						if (entity1Ptr == *it || entity2Ptr == *it) {
-							//and delete it
-							DeleteEntity(*it);
+							//and queue it for deletion
+							QueueDestroy(*it);
 							it = cannonBalls.erase(it);
 						}
 						else {
@@ -1264,7 +1220,7 @@ void Game::ImGui()
 	ImGui::Begin("Editor");
 
 	if (ImGui::CollapsingHeader("Light Controls")) {
-		ImGui::Text("Maximum number of lights: 16");
+		ImGui::Text("Number of lights: %d", (int)m_Lights.size());
 
 		//scene level lighting
 		float sceneAmbientLight[3], sceneAmbientStr;
@@ -1303,47 +1259,50 @@ void Game::ImGui()
 			attenLine = tempLightRef.GetLinearAttenuation();
 			attenQuad = tempLightRef.GetQuadraticAttenuation();
 
+			//the labels are written into a buffer on the stack so the window doesn't allocate every frame
+			char label[64];
+
 			//position
-			std::string tempPosString = "Light " + std::to_string(i) + " Position";
-			if (ImGui::SliderFloat3(tempPosString.c_str(), pos, -100.0f, 100.0f)) {
+			snprintf(label, sizeof(label), "Light %d Position", i);
+			if (ImGui::SliderFloat3(label, pos, -100.0f, 100.0f)) {
 				tempLightTransRef.SetPos(glm::vec3(pos[0], pos[1], pos[2]));
 			}
 
 			//color
-			std::string tempColorString = "Light " + std::to_string(i) + " Color";
-			if (ImGui::ColorPicker3(tempColorString.c_str(), color)) {
+			snprintf(label, sizeof(label), "Light %d Color", i);
+			if (ImGui::ColorPicker3(label, color)) {
 				tempLightRef.SetColor(glm::vec3(color[0], color[1], color[2]));
 			}
 
 			//strenghts
-			std::string tempAmbientStrString = "Light " + std::to_string(i) + " Ambient strenght";
-			if (ImGui::SliderFloat(tempAmbientStrString.c_str(), &ambientStr, 0.0f, 10.0f)) {
+			snprintf(label, sizeof(label), "Light %d Ambient strenght", i);
+			if (ImGui::SliderFloat(label, &ambientStr, 0.0f, 10.0f)) {
 				tempLightRef.SetAmbientStrength(ambientStr);
 			}
 
-			std::string tempSpecularStrString = "Light " + std::to_string(i) + " Specular strenght";
-			if (ImGui::SliderFloat(tempSpecularStrString.c_str(), &specularStr, 0.0f, 10.0f)) {
+			snprintf(label, sizeof(label), "Light %d Specular strenght", i);
+			if (ImGui::SliderFloat(label, &specularStr, 0.0f, 10.0f)) {
 				tempLightRef.SetSpecularStrength(specularStr);
 			}
 
 			//attenutaition
-			std::string tempAttenConst = "Light " + std::to_string(i) + " Constant Attenuation";
-			if (ImGui::SliderFloat(tempAttenConst.c_str(), &attenConst, 0.0f, 100.0f)) {
+			snprintf(label, sizeof(label), "Light %d Constant Attenuation", i);
+			if (ImGui::SliderFloat(label, &attenConst, 0.0f, 100.0f)) {
 				tempLightRef.SetConstantAttenuation(attenConst);
 			}
 
-			std::string tempAttenLine = "Light " + std::to_string(i) + " Linear Attenuation";
-			if (ImGui::SliderFloat(tempAttenLine.c_str(), &attenLine, 0.0f, 100.0f)) {
+			snprintf(label, sizeof(label), "Light %d Linear Attenuation", i);
+			if (ImGui::SliderFloat(label, &attenLine, 0.0f, 100.0f)) {
 				tempLightRef.SetLinearAttenuation(attenLine);
 			}
 
-			std::string tempAttenQuad = "Light " + std::to_string(i) + " Quadratic Attenuation";
-			if (ImGui::SliderFloat(tempAttenQuad.c_str(), &attenQuad, 0.0f, 100.0f)) {
+			snprintf(label, sizeof(label), "Light %d Quadratic Attenuation", i);
+			if (ImGui::SliderFloat(label, &attenQuad, 0.0f, 100.0f)) {
 				tempLightRef.SetQuadraticAttenuation(attenQuad);
 			}
 
-			std::string tempButton = "Remove Light " + std::to_string(i);
-			if (ImGui::Button(tempButton.c_str())) {
+			snprintf(label, sizeof(label), "Remove Light %d", i);
+			if (ImGui::Button(label)) {
 				DeleteEntity(*it);
 				it = m_Lights.erase(it);
 			}
@@ -1352,13 +1311,26 @@ void Game::ImGui()
 			it++;
 		}
 
-		//if there are less than 16 lights, give a button that allows the user to add a new light
-		if (i < 15) {
-			if (ImGui::Button("Add New Light")) {
+		//give a button that allows the user to add a new light, lights are clustered so there's no hard limit anymore
+		if (ImGui::Button("Add New Light")) {
+			m_Lights.push_back(CreateEntity());
+
+			TTN_Transform newTrans = TTN_Transform();
+			TTN_Light newLight = TTN_Light();
+
+			AttachCopy(m_Lights[m_Lights.size() - 1], newTrans);
+			AttachCopy(m_Lights[m_Lights.size() - 1], newLight);
+		}
+
+		//benchmark, scatters a hundred small coloured lights over the water to test how the clustered lighting holds up
+		if (ImGui::Button("Add 100 Benchmark Lights")) {
+			for (int j = 0; j < 100; j++) {
 				m_Lights.push_back(CreateEntity());
 
-				TTN_Transform newTrans = TTN_Transform();
-				TTN_Light newLight = TTN_Light();
+				TTN_Transform newTrans = TTN_Transform(glm::vec3(TTN_Random::RandomFloat(-100.0f, 100.0f), TTN_Random::RandomFloat(-5.0f, 10.0f),
+					TTN_Random::RandomFloat(0.0f, 120.0f)), glm::vec3(0.0f), glm::vec3(1.0f));
+				TTN_Light newLight = TTN_Light(glm::vec3(TTN_Random::RandomFloat(0.2f, 1.0f), TTN_Random::RandomFloat(0.2f, 1.0f),
+					TTN_Random::RandomFloat(0.2f, 1.0f)), 0.0f, 1.0f, 1.0f, 0.5f, 0.2f);
 
 				AttachCopy(m_Lights[m_Lights.size() - 1], newTrans);
 				AttachCopy(m_Lights[m_Lights.size() - 1], newLight);
@@ -1366,6 +1338,42 @@ void Game::ImGui()
 		}
 	}
 
+	if (ImGui::CollapsingHeader("Sun and Shadows")) {
+		//directional light
+		float sunStrength = GetSunStrength();
+		if (ImGui::SliderFloat("Sun Strength", &sunStrength, 0.0f, 2.0f)) {
+			SetSunStrength(sunStrength);
+		}
+
+		glm::vec3 sunDirection = GetSunDirection();
+		if (ImGui::SliderFloat3("Sun Direction", &sunDirection.x, -1.0f, 1.0f)) {
+			SetSunDirection(sunDirection);
+		}
+
+		bool castShadows = GetSunCastShadows();
+		if (ImGui::Checkbox("Cast Shadows", &castShadows)) {
+			SetSunCastShadows(castShadows);
+		}
+
+		//shadow map settings
+		TTN_ShadowMap& shadowMap = GetShadowMap();
+		int cascades = shadowMap.GetCascadeCount();
+		if (ImGui::SliderInt("Cascades", &cascades, 1, TTN_ShadowMap::s_maxCascades)) {
+			shadowMap.SetCascadeCount(cascades);
+		}
+
+		float shadowDistance = shadowMap.GetMaxDistance();
+		if (ImGui::SliderFloat("Shadow Distance", &shadowDistance, 10.0f, 500.0f)) {
+			shadowMap.SetMaxDistance(shadowDistance);
+		}
+
+		//timings for each cascade, cached cascades weren't redrawn so they don't cost anything, and cascades with cached statics only redrew the moving casters
+		for (int i = 0; i < shadowMap.GetCascadeCount(); i++) {
+			ImGui::Text("Cascade %d (to %.1f): %.3f ms, %d casters%s", i, shadowMap.GetCascadeSplit(i), shadowMap.GetCascadeTime(i),
+				(int)shadowMap.GetCascadeCasterCount(i), shadowMap.GetCascadeCached(i) ? ", cached" : (shadowMap.GetCascadeStaticCached(i) ? ", statics cached" : ""));
+		}
+	}
+
 	if (ImGui::CollapsingHeader("Camera Controls")) {
 		//control the x axis position
 		auto& a = Get<TTN_Transform>(camera);
@@ -1554,5 +1562,38 @@ void Game::ImGui()
 		}
 	}
 
+	if (ImGui::CollapsingHeader("Entity Pools")) {
+		//show how big each pool is, how much of it is in use, and the most that's been in use at once
+		for (auto& pool : GetPools()) {
+			ImGui::Text("%s: %d in use / %d allocated (high water mark %d)", pool->GetName().c_str(),
+				(int)pool->GetActiveCount(), (int)pool->GetSize(), (int)pool->GetHighWaterMark());
+		}
+	}
+
+	if (ImGui::CollapsingHeader("Culling")) {
+		bool culling = GetFrustumCulling();
+		if (ImGui::Checkbox("Frustum Culling", &culling)) {
+			SetFrustumCulling(culling);
+		}
+
+		//how many objects were drawn and skipped last frame
+		ImGui::Text("Visible: %d, Culled: %d", (int)GetVisibleCount(), (int)GetCulledCount());
+		ImGui::Text("Triangles drawn: %d", (int)GetTrianglesDrawn());
+		ImGui::Text("Sprite draws: %d", (int)GetSpriteDrawCalls());
+	}
+
+	if (ImGui::CollapsingHeader("Profiler")) {
+		ImGui::Checkbox("Show Profiler", &m_showProfiler);
+		ImGui::Checkbox("Show Allocations", &m_showAllocations);
+		//how much the frame arena on the main thread used
+		ImGui::Text("Frame arena: %.1f KB used, %.1f KB peak, %.1f KB reserved", (float)TTN_FrameArena::Get().GetUsed() / 1024.0f,
+			(float)TTN_FrameArena::Get().GetPeak() / 1024.0f, (float)TTN_FrameArena::Get().GetCapacity() / 1024.0f);
+	}
+
 	ImGui::End();
+
+	//the profiler gets it's own window so the timeline has room
+	if (m_showProfiler) TTN_Profiler::DrawImGui(&m_showProfiler);
+	//and so do the allocations
+	if (m_showAllocations) TTN_AllocationTracker::DrawImGui(&m_showAllocations);
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 //include required features from titan
 #include "Titan/Application.h"
 #include "Titan/ObjLoader.h"
+#include "Titan/MeshSimplifier.h"
 #include "Titan/Interpolation.h"
 #include "Titan/Sound.h"
 #include "Titan/LUT.h"
@@ -45,6 +46,8 @@ public:
 	bool GetGameIsPaused() { return m_paused; }
 	void SetGameIsPaused(bool paused) { m_paused = paused; }
 	int GetDamHealth() { return Dam_health; }
+	//wheter or not the cannon has finished it's last shot and cooled down
+	bool GetCanFire() { return Get<TTN_MorphAnimator>(cannon).getActiveAnim() == 0 && playerShootCooldownTimer <= 0.0f; }
 
 	//function to restart the game reseting all the data
 
@@ -153,6 +156,7 @@ protected:
 	//////// DAM AND FLAMETHROWER CONTROL DATA ///////
 	float FlameThrowerCoolDown = 10.0f; //how long the player has to wait between flamethrower uses
 	float FlameActiceTime = 3.0f; //how long the flamethrower lasts
+	glm::vec3 flameZoneHalfExtents = glm::vec3(200.0f, 50.0f, 50.0f); //half size of the box in front of the dam that the flamethrowers burn, it ends at z = 27
 	int Dam_MaxHealth = 100; //the maximum health of the dam
 
 	bool Flaming; //if flamethrowers are active right now
@@ -192,11 +196,23 @@ protected:
 	TTN_ParticleTemplate fireParticle;//fire particles
 	TTN_ParticleTemplate expolsionParticle;//expolsion particles
 
+	///////PREFABS//////////
+	TTN_Prefab::sprefabptr boatPrefabs[3];//the green, red, and yellow boats
+	TTN_Prefab::sprefabptr cannonBallPrefab;//cannonballs the player fires
+	TTN_Prefab::sprefabptr expolsionPrefab;//expolsions when boats are destroyed
+	TTN_Prefab::sprefabptr flamePrefab;//flames from the flamethrowers
+
+	///////POOLS//////////
+	TTN_EntityPool::spoolptr cannonBallPool;//reusable cannonballs
+	TTN_EntityPool::spoolptr expolsionPool;//reusable expolsions
+	TTN_EntityPool::spoolptr flamePool;//reusable flames
+
 	//set up functions, called by InitScene()
 protected:
 	void SetUpAssets();
 	void SetUpEntities();
 	void SetUpOtherData();
+	void SetUpPrefabs();
 	void RestartData();
 	
 	//update functions, called by Update()
@@ -221,6 +237,7 @@ protected:
 
 	//other functions, ussually called in relation to something happening like player input or a collision
 protected:
+	void FireCannon();
 	void CreateCannonball();
 	void DeleteCannonballs();
 
@@ -246,6 +263,11 @@ protected:
 	//variables for if the specular and diffuse ramps should be used
 	bool m_useDiffuseRamp = false;
 	bool m_useSpecularRamp = false;
+
+	//wheter or not the profiler window is open
+	bool m_showProfiler = false;
+	//wheter or not the allocations window is open
+	bool m_showAllocations = false;
 };
 
 inline float SmoothStep(float t) {
@@ -0,0 +1,121 @@
+//Dam Defense, by Atlas X Games
+//WaveBenchmark.cpp, the source file for the class that plays the game headless with a scripted player, used to benchmark the simulation
+
+//import the class
+#include "WaveBenchmark.h"
+
+//constructor
+WaveBenchmark::WaveBenchmark(int boatMultiplier)
+	: Game(), m_boatMultiplier(std::max(boatMultiplier, 1))
+{
+	//scale the waves, the spawn rate scales with the boat count so the waves take as long at every multiplier
+	m_enemiesPerWave *= m_boatMultiplier;
+	m_timeBetweenEnemySpawns /= (float)m_boatMultiplier;
+}
+
+//update the scene
+void WaveBenchmark::Update(float deltaTime)
+{
+	//the scripted player fires at a random boat whenever the cannon is ready, the same way clicking does
+	if (!boats.empty() && GetCanFire()) {
+		glm::vec3 cannonPos = Get<TTN_Transform>(cannon).GetGlobalPos();
+		glm::vec3 targetPos = Get<TTN_Transform>(boats[TTN_Random::RandomInt(0, (int)boats.size() - 1)]).GetGlobalPos();
+		//aim a little above the boat so the ball's drop carries it into the boat
+		playerDir = glm::normalize(targetPos + glm::vec3(0.0f, 0.01f * glm::distance(targetPos, cannonPos), 0.0f) - cannonPos);
+		FireCannon();
+	}
+
+	//and uses the flamethrowers as soon as they're off cooldown, the same way pressing 2 does
+	if (!Flaming && FlameTimer <= 0.0f)
+		Flamethrower();
+
+	//run the game
+	int healthBefore = Dam_health;
+	Game::Update(deltaTime);
+
+	//count the damage and repair the dam, so every multiplier runs for the full number of frames
+	m_damDamage += healthBefore - Dam_health;
+	Dam_health = Dam_MaxHealth;
+}
+
+//runs the benchmark
+int WaveBenchmark::Run(int frames, uint32_t seed)
+{
+	const int multipliers[3] = { 1, 10, 100 };
+	frames = std::max(frames, 1);
+
+	LOG_INFO("wave benchmark, {} frames at {} ms per frame, seed {}", frames, TTN_Application::GetFixedDeltaTime() * 1000.0f, seed);
+	for (int multiplier : multipliers) {
+		//reseed so every run plays out the same way
+		TTN_Random::SetSeed(seed);
+
+		WaveBenchmark* wave = new WaveBenchmark(multiplier);
+		wave->InitScene();
+		TTN_Application::scenes.push_back(wave);
+
+		//time each frame
+		std::vector<double> frameTimes;
+		frameTimes.reserve(frames);
+		for (int i = 0; i < frames; i++) {
+			auto start = std::chrono::steady_clock::now();
+			TTN_Application::Update();
+			auto end = std::chrono::steady_clock::now();
+			frameTimes.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+		}
+
+		//work out the percentiles
+		std::sort(frameTimes.begin(), frameTimes.end());
+		auto percentile = [&frameTimes](double p) {
+			return frameTimes[(size_t)(p * (double)(frameTimes.size() - 1))];
+		};
+		LOG_INFO("{}x boats: p50 {:.3f} ms, p90 {:.3f} ms, p99 {:.3f} ms, max {:.3f} ms (reached wave {}, {} boats alive, dam took {} damage)",
+			multiplier, percentile(0.5), percentile(0.9), percentile(0.99), frameTimes.back(),
+			wave->GetWave(), wave->GetBoatsAlive(), wave->GetDamDamage());
+
+		//take the scene back out before the next run
+		TTN_Application::scenes.pop_back();
+		delete wave;
+	}
+
+	return 0;
+}
+
+//runs the allocation test
+int WaveBenchmark::RunAllocationTest(int frames, uint32_t seed)
+{
+	//without the tracker compiled in there's nothing to count with
+	if (!TTN_AllocationTracker::GetAvailable()) {
+		LOG_ERROR("the allocation test needs a build with TTN_TRACK_ALLOCATIONS defined, like the debug build");
+		return 1;
+	}
+
+	//the first quarter of the run warms up, it's when the pools, command lists, and other reused buffers grow to the sizes the game needs
+	frames = std::max(frames, 4);
+	int warmupFrames = frames / 4;
+
+	TTN_Random::SetSeed(seed);
+	WaveBenchmark* wave = new WaveBenchmark(1);
+	wave->InitScene();
+	TTN_Application::scenes.push_back(wave);
+
+	//after the warm up every frame has to run without a single heap allocation, anywhere
+	int failedFrames = 0;
+	size_t allocations = 0;
+	for (int i = 0; i < frames; i++) {
+		TTN_Application::Update();
+		if (i < warmupFrames || TTN_AllocationTracker::GetLastFrameCount() == 0) continue;
+
+		failedFrames++;
+		allocations += TTN_AllocationTracker::GetLastFrameCount();
+		for (const auto& site : TTN_AllocationTracker::GetLastFrame())
+			LOG_ERROR("frame {}: {} made {} allocations ({} bytes)", i, site.Name, site.Count, site.Bytes);
+	}
+
+	LOG_INFO("allocation test: {} frames after a {} frame warm up, {} allocated ({} allocations in total)",
+		frames - warmupFrames, warmupFrames, failedFrames, allocations);
+
+	TTN_Application::scenes.pop_back();
+	delete wave;
+
+	return (failedFrames == 0) ? 0 : 1;
+}
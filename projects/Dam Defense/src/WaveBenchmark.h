@@ -0,0 +1,38 @@
+//Dam Defense, by Atlas X Games
+//WaveBenchmark.h, the header file for the class that plays the game headless with a scripted player, used to benchmark the simulation
+#pragma once
+
+//include the game, the benchmark runs it's real logic
+#include "Game.h"
+
+using namespace Titan;
+
+class WaveBenchmark : public Game {
+public:
+	//constructor, the multiplier scales how many boats each wave has and how fast they spawn
+	WaveBenchmark(int boatMultiplier = 1);
+
+	//default destrcutor
+	~WaveBenchmark() = default;
+
+	//update the scene, plays the player's part then runs the game
+	void Update(float deltaTime);
+
+	//getters
+	size_t GetBoatsAlive() { return boats.size(); }
+	int GetWave() { return m_currentWave; }
+	int GetDamDamage() { return m_damDamage; }
+
+	//runs the game at 1x, 10x, and 100x the boats headless for a number of frames each, and logs the frame time percentiles
+	//TTN_Application::InitHeadless has to have been called first, returns the exit code for main
+	static int Run(int frames, uint32_t seed);
+
+	//runs the game at 1x headless, and checks that once the first quarter of the frames have warmed it up, no frame makes a single heap allocation
+	//needs a build with TTN_TRACK_ALLOCATIONS defined, returns the exit code for main, which is 1 if anything allocated
+	static int RunAllocationTest(int frames, uint32_t seed);
+
+private:
+	int m_boatMultiplier;
+	//total damage the dam has taken, it's repaired every frame so the game never ends early
+	int m_damDamage = 0;
+};
@@ -9,17 +9,41 @@
 #include "LoadingScene.h"
 #include "MainMenu.h"
 #include "PauseMenu.h"
+#include "WaveBenchmark.h"
 
 using namespace Titan;
 
 //asset setup function
 void PrepareAssetLoading();
 
+//runs the headless wave benchmark or allocation test instead of the game
+int RunBenchmark(int argc, char** argv, bool allocationTest);
+
 //main function, runs the program
-int main() { 
+int main(int argc, char** argv) { 
 	Logger::Init(); //initliaze otter's base logging system
+
+	//if it was launched with --benchmark or --allocation-test, run them without a window and exit
+	for (int i = 1; i < argc; i++) {
+		if (std::string(argv[i]) == "--benchmark")
+			return RunBenchmark(argc, argv, false);
+		if (std::string(argv[i]) == "--allocation-test")
+			return RunBenchmark(argc, argv, true);
+	}
+
 	TTN_Application::Init("Dam Defense", 1920, 1080); //initliaze titan's application
 
+	//--record <file> saves the input each frame to a file, and --playback <file> plays one back, so a run can be repeated exactly
+	bool playingBack = false;
+	uint32_t seed = 0;
+	for (int i = 1; i + 1 < argc; i++) {
+		if (std::string(argv[i]) == "--seed") seed = (uint32_t)std::strtoul(argv[i + 1], nullptr, 10);
+	}
+	for (int i = 1; i + 1 < argc; i++) {
+		if (std::string(argv[i]) == "--record") TTN_InputRecorder::StartRecording(argv[i + 1], seed);
+		else if (std::string(argv[i]) == "--playback") playingBack = TTN_InputRecorder::StartPlayback(argv[i + 1]);
+	}
+
 	//data to track loading progress
 	bool set1Loaded = false;
 	bool set2Loaded = false;
@@ -97,8 +121,8 @@ int main() {
 			paused->InitScene();
 		}
 
-		//check if the game should quit
-		if (titleScreenUI->GetShouldQuit() || paused->GetShouldQuit()) {
+		//check if the game should quit, or the recording it was playing back has ended
+		if (titleScreenUI->GetShouldQuit() || paused->GetShouldQuit() || (playingBack && TTN_InputRecorder::GetPlaybackFinished())) {
 			TTN_Application::Quit();
 			break;
 		}
@@ -140,12 +164,32 @@ int main() {
 	return 0; 
 } 
 
+//runs the headless wave benchmark or allocation test, --frames and --seed can be passed to change how long it runs and what it's seeded with
+int RunBenchmark(int argc, char** argv, bool allocationTest) {
+	int frames = 3600;
+	uint32_t seed = 0;
+	for (int i = 1; i + 1 < argc; i++) {
+		if (std::string(argv[i]) == "--frames") frames = std::atoi(argv[i + 1]);
+		else if (std::string(argv[i]) == "--seed") seed = (uint32_t)std::strtoul(argv[i + 1], nullptr, 10);
+	}
+
+	//step at a fixed 60 frames per second so every run does the same work
+	TTN_Application::InitHeadless(1.0f / 60.0f, seed);
+	int result = allocationTest ? WaveBenchmark::RunAllocationTest(frames, seed) : WaveBenchmark::Run(frames, seed);
+	TTN_Application::Quit();
+
+	return result;
+}
+
 void PrepareAssetLoading() {
+	//the ui images are packed into atlases, which get cached here so they're only repacked when an image changes
+	TTN_AssetSystem::SetAtlasCacheDirectory("cache/atlases");
+
 	//Set 0 assets that get loaded right as the program begins after Titan and Logger init 
-	TTN_AssetSystem::AddTexture2DToBeLoaded("BG", "textures/Background.png", 0); //dark grey background for splash card, loading screen and pause menu
-	TTN_AssetSystem::AddTexture2DToBeLoaded("AtlasXLogo", "textures/Atlas X Games Logo.png", 0); //team logo for splash card
-	TTN_AssetSystem::AddTexture2DToBeLoaded("Loading-Text", "textures/text/loading.png", 0); //loading text for loading screen
-	TTN_AssetSystem::AddTexture2DToBeLoaded("Loading-Circle", "textures/loading-circle.png", 0); //circle to rotate while loading
+	TTN_AssetSystem::AddTexture2DToAtlas("BG", "textures/Background.png", "Loading UI", 0); //dark grey background for splash card, loading screen and pause menu
+	TTN_AssetSystem::AddTexture2DToAtlas("AtlasXLogo", "textures/Atlas X Games Logo.png", "Loading UI", 0); //team logo for splash card
+	TTN_AssetSystem::AddTexture2DToAtlas("Loading-Text", "textures/text/loading.png", "Loading UI", 0); //loading text for loading screen
+	TTN_AssetSystem::AddTexture2DToAtlas("Loading-Circle", "textures/loading-circle.png", "Loading UI", 0); //circle to rotate while loading
 
 	//Set 1 assets to be loaded while the splash card and loading screen play
 	TTN_AssetSystem::AddMeshToBeLoaded("Skybox mesh", "models/SkyboxMesh.obj", 1); //mesh for the skybox
@@ -175,30 +219,30 @@ void PrepareAssetLoading() {
 	TTN_AssetSystem::AddTexture2DToBeLoaded("blue ramp", "textures/ramps/blue ramp.png");
 	TTN_AssetSystem::AddTexture2DToBeLoaded("Normal Map", "textures/terrain nomral map.png");
 
-	TTN_AssetSystem::AddTexture2DToBeLoaded("Button Base", "textures/Button_1.png", 1); //button when not being hovered over
-	TTN_AssetSystem::AddTexture2DToBeLoaded("Button Hovering", "textures/Button_2.png", 1); //button when being hovered over
-	TTN_AssetSystem::AddTexture2DToBeLoaded("Play-Text", "textures/text/play.png", 1); //rendered text of word Play
-	TTN_AssetSystem::AddTexture2DToBeLoaded("Arcade-Text", "textures/text/Arcade.png", 1); //rendered text of word Arcade
-	TTN_AssetSystem::AddTexture2DToBeLoaded("Options-Text", "textures/text/Options.png", 1); //rendered text of word Options
-	TTN_AssetSystem::AddTexture2DToBeLoaded("Quit-Text", "textures/text/Quit.png", 1); //rendered text of word Quit
-	TTN_AssetSystem::AddTexture2DToBeLoaded("Game logo", "textures/Dam Defense logo.png", 1); //logo for the game
+	TTN_AssetSystem::AddTexture2DToAtlas("Button Base", "textures/Button_1.png", "Menu UI", 1); //button when not being hovered over
+	TTN_AssetSystem::AddTexture2DToAtlas("Button Hovering", "textures/Button_2.png", "Menu UI", 1); //button when being hovered over
+	TTN_AssetSystem::AddTexture2DToAtlas("Play-Text", "textures/text/play.png", "Menu UI", 1); //rendered text of word Play
+	TTN_AssetSystem::AddTexture2DToAtlas("Arcade-Text", "textures/text/Arcade.png", "Menu UI", 1); //rendered text of word Arcade
+	TTN_AssetSystem::AddTexture2DToAtlas("Options-Text", "textures/text/Options.png", "Menu UI", 1); //rendered text of word Options
+	TTN_AssetSystem::AddTexture2DToAtlas("Quit-Text", "textures/text/Quit.png", "Menu UI", 1); //rendered text of word Quit
+	TTN_AssetSystem::AddTexture2DToAtlas("Game logo", "textures/Dam Defense logo.png", "Menu UI", 1); //logo for the game
 	TTN_AssetSystem::AddMeshToBeLoaded("Sphere", "models/IcoSphereMesh.obj", 1);
 
 	//set 2, the game (excluding things already loaded into set 1)
 	for(int i = 0; i < 10; i++)
-		TTN_AssetSystem::AddTexture2DToBeLoaded(std::to_string(i) + "-Text", "textures/text/" + std::to_string(i) + ".png", 2); //numbers for health and score
+		TTN_AssetSystem::AddTexture2DToAtlas(std::to_string(i) + "-Text", "textures/text/" + std::to_string(i) + ".png", "HUD UI", 2); //numbers for health and score
 	for (int i = 1; i < 4; i++) {
 		TTN_AssetSystem::AddMeshToBeLoaded("Boat " + std::to_string(i), "models/Boat " + std::to_string(i) + ".obj", 2); //enemy boat meshes
 		TTN_AssetSystem::AddTexture2DToBeLoaded("Boat texture " + std::to_string(i), "textures/Boat " + std::to_string(i) + " Texture.png", 2); //enemy boat textures 
 	}
 	TTN_AssetSystem::AddMorphAnimationMeshesToBeLoaded("Bird mesh", "models/bird/bird", 2, 2); //bird mesh
 	TTN_AssetSystem::AddTexture2DToBeLoaded("Bird texture", "textures/BirdTexture.png", 2); //bird texture
-	TTN_AssetSystem::AddTexture2DToBeLoaded("Paused-Text", "textures/text/Paused.png", 2); //rendered text of the word paused
-	TTN_AssetSystem::AddTexture2DToBeLoaded("Resume-Text", "textures/text/Resume.png", 2); //rendered text of the word resume
-	TTN_AssetSystem::AddTexture2DToBeLoaded("Score-Text", "textures/text/Score.png", 2); //rendered text of the word Score
+	TTN_AssetSystem::AddTexture2DToAtlas("Paused-Text", "textures/text/Paused.png", "HUD UI", 2); //rendered text of the word paused
+	TTN_AssetSystem::AddTexture2DToAtlas("Resume-Text", "textures/text/Resume.png", "HUD UI", 2); //rendered text of the word resume
+	TTN_AssetSystem::AddTexture2DToAtlas("Score-Text", "textures/text/Score.png", "HUD UI", 2); //rendered text of the word Score
 
 	//set 3, win/lose screen
-	TTN_AssetSystem::AddTexture2DToBeLoaded("You Win-Text", "textures/text/You win!.png", 3); //rendered text of the pharse "You Win!" 
-	TTN_AssetSystem::AddTexture2DToBeLoaded("Game Over-Text", "textures/text/Game over.png", 3); //rendered text of the phrase "Game Over..." 
-	TTN_AssetSystem::AddTexture2DToBeLoaded("Play Again-Text", "textures/text/Play again.png", 3); //rendered text of the phrase "Play Again" 
+	TTN_AssetSystem::AddTexture2DToAtlas("You Win-Text", "textures/text/You win!.png", "Game Over UI", 3); //rendered text of the pharse "You Win!" 
+	TTN_AssetSystem::AddTexture2DToAtlas("Game Over-Text", "textures/text/Game over.png", "Game Over UI", 3); //rendered text of the phrase "Game Over..." 
+	TTN_AssetSystem::AddTexture2DToAtlas("Play Again-Text", "textures/text/Play again.png", "Game Over UI", 3); //rendered text of the phrase "Play Again" 
 }
\ No newline at end of file